@@ -84,4 +84,90 @@ bitmap_bit_range bit_range(const bitmap& bm) {
   return bitmap_bit_range{bm};
 }
 
+namespace {
+
+// Dispatches to the specialized algorithms of a concrete bitmap type if both
+// operands have the same type.
+template <class Specialized, class Generic>
+bitmap dispatch(const bitmap& lhs, const bitmap& rhs, Specialized f,
+                Generic g) {
+  auto visitor = [&](auto& x) -> bitmap {
+    using bitmap_type = std::decay_t<decltype(x)>;
+    if constexpr (!std::is_same_v<bitmap_type, null_bitmap>)
+      if (auto y = caf::get_if<bitmap_type>(&rhs))
+        return f(x, *y);
+    return g(lhs, rhs);
+  };
+  return caf::visit(visitor, lhs);
+}
+
+// Dispatches to the n-ary kernel of a concrete bitmap type if all operands
+// have the same type and the type provides one, and folds the operands
+// pairwise otherwise.
+template <class Kernel, class Fold>
+bitmap dispatch(const std::vector<const bitmap*>& xs, Kernel f, Fold g) {
+  if (xs.empty())
+    return {};
+  auto visitor = [&](auto& x) -> bitmap {
+    using bitmap_type = std::decay_t<decltype(x)>;
+    if constexpr (detail::has_nary_kernel<bitmap_type>::value) {
+      std::vector<const bitmap_type*> ys;
+      ys.reserve(xs.size());
+      for (auto ptr : xs) {
+        auto y = caf::get_if<bitmap_type>(ptr);
+        if (y == nullptr)
+          break;
+        ys.push_back(y);
+      }
+      if (ys.size() == xs.size())
+        return f(ys);
+    }
+    auto result = *xs[0];
+    for (size_t i = 1; i < xs.size(); ++i)
+      result = g(result, *xs[i]);
+    return result;
+  };
+  return caf::visit(visitor, *xs[0]);
+}
+
+} // namespace <anonymous>
+
+bitmap binary_and(const bitmap& lhs, const bitmap& rhs) {
+  auto f = [](auto& x, auto& y) { return binary_and(x, y); };
+  return dispatch(lhs, rhs, f, binary_and<bitmap, bitmap>);
+}
+
+bitmap binary_or(const bitmap& lhs, const bitmap& rhs) {
+  auto f = [](auto& x, auto& y) { return binary_or(x, y); };
+  return dispatch(lhs, rhs, f, binary_or<bitmap, bitmap>);
+}
+
+bitmap binary_xor(const bitmap& lhs, const bitmap& rhs) {
+  auto f = [](auto& x, auto& y) { return binary_xor(x, y); };
+  return dispatch(lhs, rhs, f, binary_xor<bitmap, bitmap>);
+}
+
+bitmap binary_nand(const bitmap& lhs, const bitmap& rhs) {
+  auto f = [](auto& x, auto& y) { return binary_nand(x, y); };
+  return dispatch(lhs, rhs, f, binary_nand<bitmap, bitmap>);
+}
+
+bitmap nary_and(const std::vector<const bitmap*>& xs) {
+  auto f = [](auto& ys) { return nary_and(ys); };
+  auto g = [](auto& x, auto& y) { return binary_and(x, y); };
+  return dispatch(xs, f, g);
+}
+
+bitmap nary_or(const std::vector<const bitmap*>& xs) {
+  auto f = [](auto& ys) { return nary_or(ys); };
+  auto g = [](auto& x, auto& y) { return binary_or(x, y); };
+  return dispatch(xs, f, g);
+}
+
+bitmap nary_xor(const std::vector<const bitmap*>& xs) {
+  auto f = [](auto& ys) { return nary_xor(ys); };
+  auto g = [](auto& x, auto& y) { return binary_xor(x, y); };
+  return dispatch(xs, f, g);
+}
+
 } // namespace vast
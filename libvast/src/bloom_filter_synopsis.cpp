@@ -0,0 +1,224 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/bloom_filter_synopsis.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include <caf/deserializer.hpp>
+#include <caf/serializer.hpp>
+#include <caf/settings.hpp>
+
+#include "vast/address.hpp"
+#include "vast/concept/hashable/xxhash.hpp"
+#include "vast/defaults.hpp"
+#include "vast/detail/overload.hpp"
+#include "vast/error.hpp"
+#include "vast/port.hpp"
+#include "vast/subnet.hpp"
+
+namespace vast {
+
+namespace {
+
+using prefix_list = std::array<unsigned, 3>;
+
+// The address prefixes in the filter, measured in top bits of the 128-bit
+// address representation.
+constexpr prefix_list v4_prefixes = {96 + 8, 96 + 16, 96 + 24};
+constexpr prefix_list v6_prefixes = {32, 48, 64};
+
+// Hashes a byte sequence. The seed separates different kinds of elements in
+// the same filter, e.g., addresses from network prefixes.
+uint64_t digest_bytes(const void* x, size_t n, uint64_t seed = 0) {
+  xxhash64 h{seed};
+  h(x, n);
+  return static_cast<xxhash64::result_type>(h);
+}
+
+// Hashes the network prefix of `x` with `top_bits` significant bits.
+uint64_t digest_prefix(address x, unsigned top_bits) {
+  x.mask(top_bits);
+  return digest_bytes(x.data().data(), x.data().size(), top_bits);
+}
+
+// Hashes a single value, or returns `none` for unsupported types.
+caf::optional<uint64_t> digest(data_view x) {
+  return caf::visit(detail::overload(
+    [](view<std::string> str) -> caf::optional<uint64_t> {
+      return digest_bytes(str.data(), str.size());
+    },
+    [](view<address> addr) -> caf::optional<uint64_t> {
+      return digest_bytes(addr.data().data(), addr.data().size());
+    },
+    [](view<port> p) -> caf::optional<uint64_t> {
+      // Ports of unknown protocol compare equal to any protocol, so the
+      // protocol must not contribute to the digest.
+      auto y = p.number();
+      return digest_bytes(&y, sizeof(y));
+    },
+    [](view<subnet> sn) -> caf::optional<uint64_t> {
+      std::array<uint8_t, 17> buf;
+      auto network = sn.network();
+      std::memcpy(buf.data(), network.data().data(), 16);
+      buf[16] = sn.length();
+      return digest_bytes(buf.data(), buf.size());
+    },
+    [](const auto&) -> caf::optional<uint64_t> {
+      return caf::none;
+    }
+  ), x);
+}
+
+bool is_address_type(const type& t) {
+  if (auto x = caf::get_if<alias_type>(&t))
+    return is_address_type(x->value_type);
+  return caf::holds_alternative<address_type>(t);
+}
+
+} // namespace <anonymous>
+
+bloom_filter_synopsis::bloom_filter_synopsis(vast::type x,
+                                             const synopsis_options& opts)
+  : synopsis{std::move(x)} {
+  // A partition never holds more distinct values than rows, but most columns
+  // repeat their values heavily. Sizing every filter for a full partition
+  // would keep megabytes per column resident in the meta index.
+  auto partition_size = caf::get_or(opts, "max-partition-size",
+                                    defaults::system::max_partition_size);
+  auto capacity = caf::get_or(
+    opts, "bloom-filter-capacity",
+    std::min(partition_size, defaults::system::bloom_filter_capacity));
+  auto fp_rate = caf::get_or(opts, "bloom-filter-fp-rate",
+                             defaults::system::bloom_filter_fp_rate);
+  if (capacity == 0)
+    capacity = 1;
+  if (!(fp_rate > 0.0 && fp_rate < 1.0))
+    fp_rate = defaults::system::bloom_filter_fp_rate;
+  // The optimal number of bits is m = -n ln(p) / ln(2)^2 and the optimal
+  // number of hash functions is k = m/n ln(2).
+  auto n = static_cast<double>(capacity);
+  auto ln2 = std::log(2.0);
+  auto m = std::ceil(-n * std::log(fp_rate) / (ln2 * ln2));
+  num_bits_ = std::max(uint64_t{64}, (static_cast<uint64_t>(m) + 63) / 64 * 64);
+  auto k = std::round(static_cast<double>(num_bits_) / n * ln2);
+  num_hashes_ = std::max(uint64_t{1}, static_cast<uint64_t>(k));
+}
+
+void bloom_filter_synopsis::add(data_view x) {
+  if (auto d = digest(x))
+    insert(*d);
+  if (auto addr = caf::get_if<view<address>>(&x))
+    for (auto top_bits : addr->is_v4() ? v4_prefixes : v6_prefixes)
+      insert(digest_prefix(*addr, top_bits));
+}
+
+caf::optional<bool> bloom_filter_synopsis::lookup(relational_operator op,
+                                                  data_view rhs) const {
+  switch (op) {
+    default:
+      return caf::none;
+    case equal:
+      return contains(rhs);
+    case in: {
+      // Containment of an address in a subnet.
+      if (auto sn = caf::get_if<view<subnet>>(&rhs)) {
+        if (!is_address_type(type()))
+          return caf::none;
+        auto network = sn->network();
+        auto top_bits = network.is_v4() ? 96u + sn->length() : sn->length();
+        if (top_bits == 128)
+          return contains(make_view(network));
+        auto& prefixes = network.is_v4() ? v4_prefixes : v6_prefixes;
+        if (std::find(prefixes.begin(), prefixes.end(), top_bits)
+            == prefixes.end())
+          return caf::none;
+        return contains(digest_prefix(network, top_bits));
+      }
+      // Membership in a list of values.
+      auto membership = [&](const auto& xs) -> caf::optional<bool> {
+        auto result = caf::optional<bool>{false};
+        for (auto x : *xs) {
+          auto r = contains(x);
+          if (r && *r)
+            return true;
+          if (!r)
+            result = caf::none;
+        }
+        return result;
+      };
+      if (auto xs = caf::get_if<view<set>>(&rhs))
+        return membership(*xs);
+      if (auto xs = caf::get_if<view<vector>>(&rhs))
+        return membership(*xs);
+      return caf::none;
+    }
+  }
+}
+
+bool bloom_filter_synopsis::equals(const synopsis& other) const noexcept {
+  if (typeid(other) != typeid(bloom_filter_synopsis))
+    return false;
+  auto& rhs = static_cast<const bloom_filter_synopsis&>(other);
+  return type() == rhs.type() && num_bits_ == rhs.num_bits_
+         && num_hashes_ == rhs.num_hashes_ && bits_ == rhs.bits_;
+}
+
+caf::error bloom_filter_synopsis::serialize(caf::serializer& sink) const {
+  return sink(num_bits_, num_hashes_, bits_);
+}
+
+caf::error bloom_filter_synopsis::deserialize(caf::deserializer& source) {
+  if (auto err = source(num_bits_, num_hashes_, bits_))
+    return err;
+  if (num_bits_ == 0 || num_bits_ % 64 != 0 || num_hashes_ == 0
+      || !(bits_.empty() || bits_.size() * 64 == num_bits_))
+    return make_error(ec::format_error, "invalid Bloom filter dimensions");
+  return caf::none;
+}
+
+void bloom_filter_synopsis::insert(uint64_t digest) {
+  if (bits_.empty())
+    bits_.resize(num_bits_ / 64);
+  // Derive all k hash values from one digest via double hashing.
+  auto h1 = digest & 0xffffffff;
+  auto h2 = digest >> 32;
+  for (uint64_t i = 0; i < num_hashes_; ++i) {
+    auto bit = (h1 + i * h2) % num_bits_;
+    bits_[bit / 64] |= uint64_t{1} << (bit % 64);
+  }
+}
+
+bool bloom_filter_synopsis::contains(uint64_t digest) const {
+  if (bits_.empty())
+    return false;
+  auto h1 = digest & 0xffffffff;
+  auto h2 = digest >> 32;
+  for (uint64_t i = 0; i < num_hashes_; ++i) {
+    auto bit = (h1 + i * h2) % num_bits_;
+    if (((bits_[bit / 64] >> (bit % 64)) & 1) == 0)
+      return false;
+  }
+  return true;
+}
+
+caf::optional<bool> bloom_filter_synopsis::contains(data_view x) const {
+  if (auto d = digest(x))
+    return contains(*d);
+  return caf::none;
+}
+
+} // namespace vast
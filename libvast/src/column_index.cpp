@@ -13,6 +13,14 @@
 
 #include "vast/column_index.hpp"
 
+#include <fstream>
+#include <vector>
+
+#include <caf/binary_deserializer.hpp>
+
+#include "vast/compression.hpp"
+#include "vast/concept/printable/vast/filesystem.hpp"
+#include "vast/error.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/load.hpp"
 #include "vast/logger.hpp"
@@ -22,6 +30,73 @@
 
 namespace vast {
 
+namespace {
+
+path delta_file(const path& filename) {
+  return filename + ".delta";
+}
+
+// Appends a delta segment, which consists of the LZ4-compressed pair of
+// position and value index, prefixed by its size.
+caf::error append_delta(const path& filename, value_index::size_type first,
+                        const value_index_ptr& delta) {
+  std::vector<char> segment;
+  if (auto err = save<compression::lz4>(nullptr, segment, first, delta))
+    return err;
+  auto file = delta_file(filename);
+  if (auto dir = file.parent(); !exists(dir))
+    if (auto res = mkdir(dir); !res)
+      return res.error();
+  std::ofstream fs{file.str(), std::ios::binary | std::ios::app};
+  if (!fs)
+    return make_error(ec::filesystem_error, "failed to open", file);
+  if (auto err = save(nullptr, *fs.rdbuf(), segment))
+    return err;
+  if (!fs.flush())
+    return make_error(ec::filesystem_error, "failed to write", file);
+  return caf::none;
+}
+
+// Merges all delta segments of a column index file into *idx*. Skips segments
+// that a previous compaction already merged into the file.
+caf::error merge_deltas(const path& filename,
+                        value_index::size_type& last_flush,
+                        value_index_ptr& idx) {
+  auto file = delta_file(filename);
+  if (!exists(file))
+    return caf::none;
+  auto chk = chunk::mmap(file);
+  if (chk == nullptr)
+    return make_error(ec::filesystem_error, "failed to mmap", file);
+  caf::binary_deserializer source{nullptr, chk->data(), chk->size()};
+  auto end = chk->data() + chk->size();
+  while (source.current() != end) {
+    std::vector<char> segment;
+    value_index::size_type first = 0;
+    value_index_ptr delta;
+    if (auto err = source(segment))
+      return err;
+    if (auto err = load<compression::lz4>(nullptr, segment, first, delta))
+      return err;
+    if (delta == nullptr)
+      return make_error(ec::format_error, "got an empty delta segment", file);
+    if (first + delta->offset() <= last_flush)
+      continue;
+    if (first != last_flush)
+      return make_error(ec::format_error, "got a delta segment at", first,
+                        "instead of", last_flush);
+    if (idx == nullptr) {
+      idx = std::move(delta);
+    } else if (auto merged = idx->merge(*delta, first); !merged) {
+      return merged.error();
+    }
+    last_flush = idx->offset();
+  }
+  return caf::none;
+}
+
+} // namespace <anonymous>
+
 // -- free functions -----------------------------------------------------------
 
 caf::expected<column_index_ptr> make_column_index(caf::actor_system& sys,
@@ -35,6 +110,27 @@ caf::expected<column_index_ptr> make_column_index(caf::actor_system& sys,
   return result;
 }
 
+caf::error compact_column_index(const path& filename) {
+  VAST_TRACE(VAST_ARG(filename));
+  if (!exists(delta_file(filename)))
+    return caf::none;
+  value_index::size_type last_flush = 0;
+  value_index_ptr idx;
+  if (exists(filename))
+    if (auto err = load(nullptr, filename, last_flush, idx))
+      return err;
+  if (auto err = merge_deltas(filename, last_flush, idx))
+    return err;
+  // Replace the file before removing the segments, such that a crash in
+  // between leaves segments that the next attempt skips.
+  if (auto err = save(nullptr, filename, last_flush, idx))
+    return err;
+  if (!rm(delta_file(filename)))
+    return make_error(ec::filesystem_error, "failed to remove",
+                      delta_file(filename));
+  return caf::none;
+}
+
 // -- constructors, destructors, and assignment operators ----------------------
 
 column_index::column_index(caf::actor_system& sys, type index_type,
@@ -47,6 +143,17 @@ column_index::column_index(caf::actor_system& sys, type index_type,
   // nop
 }
 
+column_index::column_index(caf::actor_system& sys, type index_type,
+                           chunk_ptr state, size_t column)
+  : col_(column),
+    has_skip_attribute_(vast::has_skip_attribute(index_type)),
+    index_type_(std::move(index_type)),
+    state_(std::move(state)),
+    read_only_(true),
+    sys_(sys) {
+  // nop
+}
+
 column_index::~column_index() {
   flush_to_disk();
 }
@@ -55,37 +162,78 @@ column_index::~column_index() {
 
 caf::error column_index::init() {
   VAST_TRACE("");
-  // Materialize the index when encountering persistent state.
+  // Deserialize the index from a slice of a sealed partition. A read-only
+  // index has no file, so it never touches the filesystem.
+  if (read_only_) {
+    if (state_ == nullptr) {
+      idx_ = factory<value_index>::make(index_type_);
+      if (idx_ == nullptr) {
+        VAST_ERROR(this, "failed to construct index");
+        return make_error(ec::unspecified, "failed to construct index");
+      }
+      VAST_DEBUG(this, "constructed empty read-only value index");
+      return caf::none;
+    }
+    caf::binary_deserializer source{nullptr, state_->data(), state_->size()};
+    if (auto err = source(last_flush_, idx_)) {
+      VAST_ERROR(this, "failed to deserialize value index", sys_.render(err));
+      return err;
+    }
+    VAST_DEBUG(this, "deserialized value index with offset", idx_->offset());
+    return caf::none;
+  }
+  // Materialize the index when encountering persistent state, i.e., the last
+  // full snapshot followed by the delta segments of incremental flushes.
   if (exists(filename_)) {
     if (auto err = load(nullptr, filename_, last_flush_, idx_)) {
       VAST_ERROR(this, "failed to load value index from disk", sys_.render(err));
       return err;
-    } else {
-      VAST_DEBUG(this, "loaded value index with offset", idx_->offset());
     }
-    return caf::none;
   }
-  // Otherwise construct a new one.
-  idx_ = factory<value_index>::make(index_type_);
-  if (idx_ == nullptr) {
-    VAST_ERROR(this, "failed to construct index");
-    return make_error(ec::unspecified, "failed to construct index");
+  if (auto err = merge_deltas(filename_, last_flush_, idx_)) {
+    VAST_ERROR(this, "failed to merge delta segments", sys_.render(err));
+    return err;
+  }
+  if (idx_ != nullptr) {
+    VAST_DEBUG(this, "loaded value index with offset", idx_->offset());
+  } else {
+    // Otherwise construct a new one.
+    idx_ = factory<value_index>::make(index_type_);
+    if (idx_ == nullptr) {
+      VAST_ERROR(this, "failed to construct index");
+      return make_error(ec::unspecified, "failed to construct index");
+    }
+    VAST_DEBUG(this, "constructed new value index");
   }
-  VAST_DEBUG(this, "constructed new value index");
+  if (idx_->mergeable())
+    delta_ = factory<value_index>::make(index_type_);
   return caf::none;
 }
 
 caf::error column_index::flush_to_disk() {
   VAST_TRACE("");
   // The value index is null if and only if `init()` failed.
-  if (idx_ == nullptr || !dirty())
+  if (read_only_ || idx_ == nullptr || !dirty())
     return caf::none;
-  // Check whether there's something to write.
-  auto offset = idx_->offset();
-  VAST_DEBUG(this, "flushes index (" << (offset - last_flush_) << '/' << offset,
+  if (delta_ == nullptr) {
+    auto offset = idx_->offset();
+    VAST_DEBUG(this, "flushes index (" << (offset - last_flush_) << '/'
+                                       << offset, "new/total bits)");
+    last_flush_ = offset;
+    return save(nullptr, filename_, last_flush_, idx_);
+  }
+  // Append only the new rows and fold them into the index afterwards, which
+  // keeps the cost of a flush proportional to the new data.
+  VAST_DEBUG(this, "flushes delta (" << delta_->offset() << '/'
+                                     << (last_flush_ + delta_->offset()),
              "new/total bits)");
-  last_flush_ = offset;
-  return save(nullptr, filename_, last_flush_, idx_);
+  if (auto err = append_delta(filename_, last_flush_, delta_))
+    return err;
+  if (auto merged = idx_->merge(*delta_, last_flush_); !merged)
+    return merged.error();
+  last_flush_ = idx_->offset();
+  delta_ = factory<value_index>::make(index_type_);
+  return caf::none;
 }
 
 // -- properties -------------------------------------------------------------
@@ -94,7 +242,15 @@ void column_index::add(const table_slice_ptr& x) {
   VAST_TRACE(VAST_ARG(x));
   if (has_skip_attribute_)
     return;
-  x->append_column_to_index(col_, *idx_);
+  if (delta_ == nullptr) {
+    x->append_column_to_index(col_, *idx_);
+    return;
+  }
+  if (x->offset() < last_flush_) {
+    VAST_ERROR(this, "cannot add rows before the last flush at", last_flush_);
+    return;
+  }
+  x->append_column_to_index(col_, *delta_, x->offset() - last_flush_);
 }
 
 caf::expected<bitmap> column_index::lookup(relational_operator op,
@@ -102,12 +258,23 @@ caf::expected<bitmap> column_index::lookup(relational_operator op,
   VAST_TRACE(VAST_ARG(op), VAST_ARG(rhs));
   VAST_ASSERT(idx_ != nullptr);
   auto result = idx_->lookup(op, rhs);
+  // The delta holds the rows since the last flush at relative positions.
+  if (result && delta_ != nullptr && delta_->offset() > 0) {
+    auto delta = delta_->lookup(op, rhs);
+    if (!delta)
+      return delta;
+    bitmap shifted{last_flush_, false};
+    shifted.append(*delta);
+    *result |= shifted;
+  }
   VAST_DEBUG(this, VAST_ARG(result));
   return result;
 }
 
 bool column_index::dirty() const noexcept {
   VAST_ASSERT(idx_ != nullptr);
+  if (delta_ != nullptr)
+    return delta_->offset() > 0;
   return idx_->offset() != last_flush_;
 }
 
@@ -0,0 +1,319 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/columnar_table_slice.hpp"
+
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+#include <caf/binary_deserializer.hpp>
+#include <caf/deserializer.hpp>
+#include <caf/serializer.hpp>
+
+#include "vast/address.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/narrow.hpp"
+#include "vast/detail/overload.hpp"
+#include "vast/error.hpp"
+#include "vast/logger.hpp"
+#include "vast/port.hpp"
+#include "vast/type.hpp"
+#include "vast/value_index.hpp"
+
+namespace vast {
+
+namespace {
+
+using column = columnar_table_slice::column;
+using column_kind = columnar_table_slice::column_kind;
+
+// Reads a trivially copyable value from a possibly unaligned location.
+template <class T>
+T read(const char* ptr) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  T result;
+  std::memcpy(&result, ptr, sizeof(T));
+  return result;
+}
+
+// Reads the fixed-width value at `row`.
+template <class T>
+T load(const char* base, const column& c, size_t row) {
+  return read<T>(base + c.values + row * sizeof(T));
+}
+
+// Returns the string value at `row`.
+std::string_view load_string(const char* base, const column& c, size_t row) {
+  auto offsets = base + c.offsets;
+  auto first = row == 0 ? uint64_t{0}
+                        : read<uint64_t>(offsets + (row - 1) * sizeof(uint64_t));
+  auto last = read<uint64_t>(offsets + row * sizeof(uint64_t));
+  return {base + c.values + first, last - first};
+}
+
+// Returns the address value at `row`.
+address load_address(const char* base, const column& c, size_t row) {
+  return address::v6(base + c.values + row * 16, address::network);
+}
+
+// Checks whether `row` holds a value.
+bool is_valid(const char* base, const column& c, size_t row) {
+  auto word = read<uint64_t>(base + c.validity + row / 64 * sizeof(uint64_t));
+  return (word >> (row % 64)) & 1;
+}
+
+} // namespace <anonymous>
+
+columnar_table_slice* columnar_table_slice::copy() const {
+  // The payload is immutable, so copies can share it.
+  return new columnar_table_slice(*this);
+}
+
+caf::error columnar_table_slice::serialize(caf::serializer& sink) const {
+  return sink(payload_, generic_);
+}
+
+caf::error columnar_table_slice::deserialize(caf::deserializer& source) {
+  chunk_ptr payload;
+  if (auto err = source(payload, generic_))
+    return err;
+  if (payload == nullptr)
+    return make_error(ec::format_error, "columnar table slice without payload");
+  return init(std::move(payload));
+}
+
+caf::error columnar_table_slice::load(chunk_ptr chunk) {
+  VAST_ASSERT(chunk != nullptr);
+  // The chunk contains the payload in the format written by `serialize`,
+  // i.e., a 32-bit size followed by the raw bytes, and then all generic
+  // columns. Instead of copying the payload, we point into the chunk.
+  caf::binary_deserializer source{nullptr, chunk->data(), chunk->size()};
+  uint32_t size;
+  if (auto err = source(size))
+    return err;
+  using detail::narrow_cast;
+  auto first = narrow_cast<size_t>(source.current() - chunk->data());
+  if (size == 0 || first + size >= chunk->size())
+    return make_error(ec::format_error, "truncated columnar table slice");
+  caf::binary_deserializer rest{nullptr, chunk->data() + first + size,
+                                chunk->size() - first - size};
+  if (auto err = rest(generic_))
+    return err;
+  return init(chunk->slice(first, size));
+}
+
+void columnar_table_slice::append_column_to_index(size_type col,
+                                                  value_index& idx,
+                                                  id first) const {
+  VAST_ASSERT(col < columns());
+  VAST_ASSERT(payload_ != nullptr);
+  auto base = payload_->data();
+  auto& c = columns_[col];
+  // Hand fixed-width arithmetic columns to the index in bulk. We copy the
+  // buffers because the payload may reside at an unaligned address.
+  auto bulk_append = [&](auto tag) {
+    using value_type = decltype(tag);
+    auto n = rows();
+    auto values = std::make_unique<value_type[]>(n);
+    std::vector<uint64_t> validity((n + 63) / 64);
+    std::memcpy(values.get(), base + c.values, n * sizeof(value_type));
+    std::memcpy(validity.data(), base + c.validity,
+                validity.size() * sizeof(uint64_t));
+    auto xs = span<const value_type>{values.get(),
+                                     static_cast<std::ptrdiff_t>(n)};
+    if (auto res = idx.append(xs, span<const uint64_t>{validity}, first);
+        !res)
+      VAST_ERROR(this, "failed to append column", col, "in bulk:",
+                 to_string(res.error()));
+  };
+  // Dispatch on the column kind once and then run a tight loop per column.
+  auto append = [&](auto get) {
+    for (size_type row = 0; row < rows(); ++row) {
+      auto res = is_valid(base, c, row) ? idx.append(get(row), first + row)
+                                        : idx.append(caf::none, first + row);
+      if (!res)
+        VAST_ERROR(this, "failed to append row", first + row, "of column",
+                   col, ":", to_string(res.error()));
+    }
+  };
+  switch (c.kind) {
+    case column_kind::boolean:
+      bulk_append(boolean{});
+      break;
+    case column_kind::integer:
+      bulk_append(integer{});
+      break;
+    case column_kind::count:
+      bulk_append(count{});
+      break;
+    case column_kind::real:
+      bulk_append(real{});
+      break;
+    case column_kind::timespan:
+      bulk_append(timespan{});
+      break;
+    case column_kind::timestamp:
+      bulk_append(timestamp{});
+      break;
+    case column_kind::port:
+      append([&](size_type row) { return load<port>(base, c, row); });
+      break;
+    case column_kind::address:
+      append([&](size_type row) { return load_address(base, c, row); });
+      break;
+    case column_kind::string:
+      append([&](size_type row) { return load_string(base, c, row); });
+      break;
+    case column_kind::generic: {
+      auto& xs = generic_[col];
+      append([&](size_type row) { return make_view(xs[row]); });
+      break;
+    }
+  }
+}
+
+data_view columnar_table_slice::at(size_type row, size_type col) const {
+  VAST_ASSERT(row < rows());
+  VAST_ASSERT(col < columns());
+  VAST_ASSERT(payload_ != nullptr);
+  auto base = payload_->data();
+  auto& c = columns_[col];
+  if (!is_valid(base, c, row))
+    return caf::none;
+  switch (c.kind) {
+    case column_kind::boolean:
+      return load<boolean>(base, c, row);
+    case column_kind::integer:
+      return load<integer>(base, c, row);
+    case column_kind::count:
+      return load<count>(base, c, row);
+    case column_kind::real:
+      return load<real>(base, c, row);
+    case column_kind::timespan:
+      return load<timespan>(base, c, row);
+    case column_kind::timestamp:
+      return load<timestamp>(base, c, row);
+    case column_kind::port:
+      return load<port>(base, c, row);
+    case column_kind::address:
+      return load_address(base, c, row);
+    case column_kind::string:
+      return load_string(base, c, row);
+    case column_kind::generic:
+      return make_view(generic_[col][row]);
+  }
+  VAST_ASSERT(!"missing column kind");
+  return caf::none;
+}
+
+caf::atom_value columnar_table_slice::implementation_id() const noexcept {
+  return class_id;
+}
+
+columnar_table_slice::column_kind
+columnar_table_slice::kind_of(const type& t) {
+  auto f = detail::overload(
+    [](const boolean_type&) { return column_kind::boolean; },
+    [](const integer_type&) { return column_kind::integer; },
+    [](const count_type&) { return column_kind::count; },
+    [](const real_type&) { return column_kind::real; },
+    [](const timespan_type&) { return column_kind::timespan; },
+    [](const timestamp_type&) { return column_kind::timestamp; },
+    [](const port_type&) { return column_kind::port; },
+    [](const address_type&) { return column_kind::address; },
+    [](const string_type&) { return column_kind::string; },
+    [](const alias_type& x) { return kind_of(x.value_type); },
+    [](const auto&) { return column_kind::generic; });
+  return caf::visit(f, t);
+}
+
+size_t columnar_table_slice::width_of(column_kind kind) noexcept {
+  switch (kind) {
+    case column_kind::boolean:
+      return sizeof(boolean);
+    case column_kind::integer:
+      return sizeof(integer);
+    case column_kind::count:
+      return sizeof(count);
+    case column_kind::real:
+      return sizeof(real);
+    case column_kind::timespan:
+      return sizeof(timespan);
+    case column_kind::timestamp:
+      return sizeof(timestamp);
+    case column_kind::port:
+      return sizeof(port);
+    case column_kind::address:
+      return 16;
+    case column_kind::string:
+    case column_kind::generic:
+      return 0;
+  }
+  return 0;
+}
+
+table_slice_ptr columnar_table_slice::make(table_slice_header header) {
+  return table_slice_ptr{new columnar_table_slice{std::move(header)}, false};
+}
+
+columnar_table_slice::columnar_table_slice(table_slice_header header)
+  : super{std::move(header)} {
+  columns_.resize(columns());
+  for (size_t i = 0; i < columns_.size(); ++i)
+    columns_[i].kind = kind_of(layout().fields[i].type);
+}
+
+caf::error columnar_table_slice::init(chunk_ptr payload) {
+  VAST_ASSERT(payload != nullptr);
+  auto base = payload->data();
+  auto size = payload->size();
+  auto word = sizeof(uint64_t);
+  if (size < word * (1 + 3 * columns()) || read<uint64_t>(base) != columns())
+    return make_error(ec::format_error, "invalid columnar table slice header");
+  if (generic_.size() != columns())
+    return make_error(ec::format_error, "invalid number of generic columns");
+  // Validate all buffer boundaries once so that accessors can skip checks.
+  auto validity_size = (rows() + 63) / 64 * word;
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    auto& c = columns_[i];
+    auto toc = base + word * (1 + 3 * i);
+    c.validity = read<uint64_t>(toc);
+    c.values = read<uint64_t>(toc + word);
+    c.offsets = read<uint64_t>(toc + 2 * word);
+    auto ok = c.validity + validity_size <= size;
+    switch (c.kind) {
+      default:
+        ok = ok && c.values + rows() * width_of(c.kind) <= size;
+        break;
+      case column_kind::string:
+        ok = ok && c.offsets + rows() * word <= size
+             && (rows() == 0
+                 || c.values + read<uint64_t>(base + c.offsets
+                                              + (rows() - 1) * word)
+                      <= size);
+        break;
+      case column_kind::generic:
+        ok = ok && generic_[i].size() == rows();
+        break;
+    }
+    if (!ok)
+      return make_error(ec::format_error, "invalid columnar table slice column",
+                        i);
+  }
+  payload_ = std::move(payload);
+  return caf::none;
+}
+
+} // namespace vast
@@ -0,0 +1,203 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/columnar_table_slice_builder.hpp"
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include <caf/make_counted.hpp>
+
+#include "vast/address.hpp"
+#include "vast/chunk.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/port.hpp"
+
+namespace vast {
+
+namespace {
+
+using column_kind = columnar_table_slice::column_kind;
+
+// Appends the fixed-width value in `x` to `bytes`, or a zeroed value for nil.
+template <class T>
+void store(std::vector<char>& bytes, const data_view& x) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  auto y = caf::holds_alternative<caf::none_t>(x) ? T{} : caf::get<T>(x);
+  auto ptr = reinterpret_cast<const char*>(&y);
+  bytes.insert(bytes.end(), ptr, ptr + sizeof(T));
+}
+
+// Appends the raw bytes of `xs` to `buf` at the next 8-byte boundary.
+// Returns the position of the first byte.
+template <class T>
+uint64_t pack(std::vector<char>& buf, const std::vector<T>& xs) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  buf.resize((buf.size() + 7) & ~size_t{7});
+  auto result = buf.size();
+  auto ptr = reinterpret_cast<const char*>(xs.data());
+  buf.insert(buf.end(), ptr, ptr + xs.size() * sizeof(T));
+  return result;
+}
+
+} // namespace <anonymous>
+
+caf::atom_value columnar_table_slice_builder::get_implementation_id() noexcept {
+  return columnar_table_slice::class_id;
+}
+
+columnar_table_slice_builder::columnar_table_slice_builder(record_type layout)
+  : super{std::move(layout)},
+    columns_(super::layout().fields.size()),
+    col_{0},
+    rows_{0} {
+  VAST_ASSERT(!columns_.empty());
+  for (auto& field : super::layout().fields)
+    kinds_.push_back(columnar_table_slice::kind_of(field.type));
+}
+
+table_slice_builder_ptr columnar_table_slice_builder::make(record_type layout) {
+  return caf::make_counted<columnar_table_slice_builder>(std::move(layout));
+}
+
+bool columnar_table_slice_builder::add(data_view x) {
+  if (!type_check(layout().fields[col_].type, x))
+    return false;
+  append(x);
+  if (++col_ == columns_.size()) {
+    col_ = 0;
+    ++rows_;
+  }
+  return true;
+}
+
+table_slice_ptr columnar_table_slice_builder::finish() {
+  // If we have an incomplete row, we fill the remaining columns with nil
+  // values. Better to have incomplete than no data.
+  if (col_ != 0) {
+    for (; col_ < columns_.size(); ++col_)
+      append(caf::none);
+    col_ = 0;
+    ++rows_;
+  }
+  // Pack all columns into a single buffer, starting with the table of
+  // contents.
+  auto word = sizeof(uint64_t);
+  std::vector<char> buf(word * (1 + 3 * columns_.size()));
+  auto toc = [&](size_t i, uint64_t x) {
+    std::memcpy(buf.data() + i * word, &x, word);
+  };
+  toc(0, columns_.size());
+  std::vector<std::vector<data>> generic(columns_.size());
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    auto& c = columns_[i];
+    toc(1 + 3 * i, pack(buf, c.validity));
+    toc(2 + 3 * i, pack(buf, c.bytes));
+    toc(3 + 3 * i, pack(buf, c.offsets));
+    generic[i] = std::move(c.values);
+  }
+  // Populate slice.
+  table_slice_header header{layout(), rows_, 0};
+  auto slice = new columnar_table_slice{std::move(header)};
+  table_slice_ptr result{slice, false};
+  slice->generic_ = std::move(generic);
+  auto err = slice->init(chunk::make(std::move(buf)));
+  VAST_ASSERT(!err);
+  // Reset state for the next slice.
+  columns_ = std::vector<column_buffer>(columns_.size());
+  rows_ = 0;
+  return result;
+}
+
+size_t columnar_table_slice_builder::rows() const noexcept {
+  return rows_;
+}
+
+void columnar_table_slice_builder::reserve(size_t num_rows) {
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    auto& c = columns_[i];
+    c.validity.reserve((num_rows + 63) / 64);
+    switch (kinds_[i]) {
+      default:
+        c.bytes.reserve(num_rows * columnar_table_slice::width_of(kinds_[i]));
+        break;
+      case column_kind::string:
+        c.offsets.reserve(num_rows);
+        break;
+      case column_kind::generic:
+        c.values.reserve(num_rows);
+        break;
+    }
+  }
+}
+
+caf::atom_value
+columnar_table_slice_builder::implementation_id() const noexcept {
+  return columnar_table_slice::class_id;
+}
+
+void columnar_table_slice_builder::append(data_view x) {
+  VAST_ASSERT(col_ < columns_.size());
+  auto& c = columns_[col_];
+  if (c.validity.size() <= rows_ / 64)
+    c.validity.push_back(0);
+  auto is_nil = caf::holds_alternative<caf::none_t>(x);
+  if (!is_nil)
+    c.validity[rows_ / 64] |= uint64_t{1} << (rows_ % 64);
+  switch (kinds_[col_]) {
+    case column_kind::boolean:
+      store<boolean>(c.bytes, x);
+      break;
+    case column_kind::integer:
+      store<integer>(c.bytes, x);
+      break;
+    case column_kind::count:
+      store<count>(c.bytes, x);
+      break;
+    case column_kind::real:
+      store<real>(c.bytes, x);
+      break;
+    case column_kind::timespan:
+      store<timespan>(c.bytes, x);
+      break;
+    case column_kind::timestamp:
+      store<timestamp>(c.bytes, x);
+      break;
+    case column_kind::port:
+      store<port>(c.bytes, x);
+      break;
+    case column_kind::address: {
+      auto first = c.bytes.size();
+      c.bytes.resize(first + 16);
+      if (!is_nil) {
+        auto& bytes = caf::get<address>(x).data();
+        std::memcpy(c.bytes.data() + first, bytes.data(), bytes.size());
+      }
+      break;
+    }
+    case column_kind::string: {
+      if (!is_nil) {
+        auto str = caf::get<view<std::string>>(x);
+        c.bytes.insert(c.bytes.end(), str.begin(), str.end());
+      }
+      c.offsets.push_back(c.bytes.size());
+      break;
+    }
+    case column_kind::generic:
+      c.values.push_back(materialize(x));
+      break;
+  }
+}
+
+} // namespace vast
@@ -15,6 +15,8 @@
 #define LZ4_FORCE_INLINE
 #include "lz4/lib/lz4.c"
 
+#include <cstring>
+
 #include "vast/compression.hpp"
 #include "vast/die.hpp"
 
@@ -67,4 +69,50 @@ bool uncompress(const char* in, size_t in_size, char* out) {
 } // namespace snappy
 #endif // VAST_HAVE_SNAPPY
 
+compression compress(compression method, const char* in, size_t in_size,
+                     std::vector<char>& out) {
+  auto before = out.size();
+  size_t n = 0;
+  switch (method) {
+    case compression::null:
+      break;
+    case compression::lz4:
+      out.resize(before + lz4::compress_bound(in_size));
+      n = lz4::compress(in, in_size, out.data() + before, out.size() - before);
+      break;
+#ifdef VAST_HAVE_SNAPPY
+    case compression::snappy:
+      out.resize(before + snappy::compress_bound(in_size));
+      n = snappy::compress(in, in_size, out.data() + before);
+      break;
+#endif // VAST_HAVE_SNAPPY
+  }
+  if (n > 0 && n < in_size) {
+    out.resize(before + n);
+    return method;
+  }
+  out.resize(before);
+  out.insert(out.end(), in, in + in_size);
+  return compression::null;
+}
+
+bool uncompress(compression method, const char* in, size_t in_size, char* out,
+                size_t out_size) {
+  switch (method) {
+    case compression::null:
+      if (in_size != out_size)
+        return false;
+      std::memcpy(out, in, in_size);
+      return true;
+    case compression::lz4:
+      return lz4::uncompress(in, in_size, out, out_size) == out_size;
+#ifdef VAST_HAVE_SNAPPY
+    case compression::snappy:
+      return snappy::uncompress_bound(in, in_size) == out_size
+             && snappy::uncompress(in, in_size, out);
+#endif // VAST_HAVE_SNAPPY
+  }
+  return false;
+}
+
 } // namespace vast
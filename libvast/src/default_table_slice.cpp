@@ -34,9 +34,10 @@ caf::error default_table_slice::deserialize(caf::deserializer& source) {
 }
 
 void default_table_slice::append_column_to_index(size_type col,
-                                                 value_index& idx) const {
+                                                 value_index& idx,
+                                                 id first) const {
   for (size_type row = 0; row < rows(); ++row)
-    idx.append(make_view(caf::get<vector>(xs_[row])[col]), offset() + row);
+    idx.append(make_view(caf::get<vector>(xs_[row])[col]), first + row);
 }
 
 data_view default_table_slice::at(size_type row, size_type col) const {
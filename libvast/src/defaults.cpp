@@ -13,8 +13,10 @@
 
 #include "vast/defaults.hpp"
 
+#include <algorithm>
 #include <random>
 #include <string>
+#include <thread>
 
 #include <caf/actor_system.hpp>
 #include <caf/actor_system_config.hpp>
@@ -32,6 +34,12 @@ caf::atom_value table_slice_type(const caf::actor_system& sys,
                 system::table_slice_type);
 }
 
+size_t jobs(const caf::settings& options) {
+  if (auto val = caf::get_if<size_t>(&options, "import.jobs"))
+    return *val;
+  return std::max(size_t{std::thread::hardware_concurrency()}, size_t{1});
+}
+
 size_t test::seed(const caf::settings& options) {
   std::string cat = category;
   if (auto val = caf::get_if<size_t>(&options, cat + ".seed"))
@@ -0,0 +1,171 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/detail/bitwise.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define VAST_BITWISE_X86 1
+#include <immintrin.h>
+#else
+#define VAST_BITWISE_X86 0
+#endif
+
+namespace vast::detail {
+namespace {
+
+struct and_op {
+  static uint64_t apply(uint64_t x, uint64_t y) {
+    return x & y;
+  }
+#if VAST_BITWISE_X86
+  static __m128i apply(__m128i x, __m128i y) {
+    return _mm_and_si128(x, y);
+  }
+  __attribute__((target("avx2")))
+  static __m256i apply(__m256i x, __m256i y) {
+    return _mm256_and_si256(x, y);
+  }
+#endif
+};
+
+struct or_op {
+  static uint64_t apply(uint64_t x, uint64_t y) {
+    return x | y;
+  }
+#if VAST_BITWISE_X86
+  static __m128i apply(__m128i x, __m128i y) {
+    return _mm_or_si128(x, y);
+  }
+  __attribute__((target("avx2")))
+  static __m256i apply(__m256i x, __m256i y) {
+    return _mm256_or_si256(x, y);
+  }
+#endif
+};
+
+struct xor_op {
+  static uint64_t apply(uint64_t x, uint64_t y) {
+    return x ^ y;
+  }
+#if VAST_BITWISE_X86
+  static __m128i apply(__m128i x, __m128i y) {
+    return _mm_xor_si128(x, y);
+  }
+  __attribute__((target("avx2")))
+  static __m256i apply(__m256i x, __m256i y) {
+    return _mm256_xor_si256(x, y);
+  }
+#endif
+};
+
+struct nand_op {
+  static uint64_t apply(uint64_t x, uint64_t y) {
+    return x & ~y;
+  }
+#if VAST_BITWISE_X86
+  // The andnot intrinsics negate their first argument.
+  static __m128i apply(__m128i x, __m128i y) {
+    return _mm_andnot_si128(y, x);
+  }
+  __attribute__((target("avx2")))
+  static __m256i apply(__m256i x, __m256i y) {
+    return _mm256_andnot_si256(y, x);
+  }
+#endif
+};
+
+template <class Op>
+void scalar(const uint64_t* x, const uint64_t* y, uint64_t* out, size_t n,
+            size_t i = 0) {
+  for (; i < n; ++i)
+    out[i] = Op::apply(x[i], y[i]);
+}
+
+#if VAST_BITWISE_X86
+
+// SSE2 is part of the x86-64 baseline and needs no runtime check.
+template <class Op>
+void sse2(const uint64_t* x, const uint64_t* y, uint64_t* out, size_t n) {
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    auto lhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+    auto rhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), Op::apply(lhs, rhs));
+  }
+  scalar<Op>(x, y, out, n, i);
+}
+
+template <class Op>
+__attribute__((target("avx2")))
+void avx2(const uint64_t* x, const uint64_t* y, uint64_t* out, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    auto lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+    auto rhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                        Op::apply(lhs, rhs));
+  }
+  scalar<Op>(x, y, out, n, i);
+}
+
+#endif
+
+// Vector instructions only pay off for longer stretches of words.
+constexpr size_t vector_threshold = 8;
+
+template <class Op>
+void dispatch(const uint64_t* x, const uint64_t* y, uint64_t* out, size_t n) {
+#if VAST_BITWISE_X86
+  if (n >= vector_threshold) {
+    if (bitwise_uses_avx2())
+      avx2<Op>(x, y, out, n);
+    else
+      sse2<Op>(x, y, out, n);
+    return;
+  }
+#endif
+  scalar<Op>(x, y, out, n);
+}
+
+} // namespace <anonymous>
+
+void bitwise_and(const uint64_t* x, const uint64_t* y, uint64_t* out,
+                 size_t n) {
+  dispatch<and_op>(x, y, out, n);
+}
+
+void bitwise_or(const uint64_t* x, const uint64_t* y, uint64_t* out,
+                size_t n) {
+  dispatch<or_op>(x, y, out, n);
+}
+
+void bitwise_xor(const uint64_t* x, const uint64_t* y, uint64_t* out,
+                 size_t n) {
+  dispatch<xor_op>(x, y, out, n);
+}
+
+void bitwise_nand(const uint64_t* x, const uint64_t* y, uint64_t* out,
+                  size_t n) {
+  dispatch<nand_op>(x, y, out, n);
+}
+
+bool bitwise_uses_avx2() {
+#if VAST_BITWISE_X86
+  static const bool result = __builtin_cpu_supports("avx2");
+  return result;
+#else
+  return false;
+#endif
+}
+
+} // namespace vast::detail
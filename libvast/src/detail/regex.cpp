@@ -0,0 +1,763 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/detail/regex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cctype>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <regex>
+#include <unordered_map>
+
+namespace vast::detail {
+namespace {
+
+// -- parsing ------------------------------------------------------------------
+
+constexpr size_t unbounded = std::numeric_limits<size_t>::max();
+
+// The largest bound of a counted repetition, e.g., `x{1000}`.
+constexpr size_t max_repetitions = 1000;
+
+using byte_set = std::bitset<256>;
+
+// A node in the abstract syntax tree of a regular expression.
+struct node {
+  enum kind_type { empty, bytes, concat, alternate, repeat };
+  kind_type kind = empty;
+  byte_set set;
+  std::vector<node> children;
+  size_t min = 0;
+  size_t max = 0;
+};
+
+// A recursive-descent parser for the supported subset of ECMAScript regular
+// expressions. Parsing fails on all other syntax.
+class parser {
+public:
+  explicit parser(std::string_view str) : str_{str} {
+    // nop
+  }
+
+  std::optional<node> parse() {
+    auto result = parse_alternation();
+    if (!ok_ || pos_ != str_.size())
+      return std::nullopt;
+    return result;
+  }
+
+private:
+  bool at_end() const {
+    return pos_ == str_.size();
+  }
+
+  char peek() const {
+    return str_[pos_];
+  }
+
+  node parse_alternation() {
+    auto first = parse_concatenation();
+    if (at_end() || peek() != '|')
+      return first;
+    node result;
+    result.kind = node::alternate;
+    result.children.push_back(std::move(first));
+    while (ok_ && !at_end() && peek() == '|') {
+      ++pos_;
+      result.children.push_back(parse_concatenation());
+    }
+    return result;
+  }
+
+  node parse_concatenation() {
+    node result;
+    result.kind = node::concat;
+    while (ok_ && !at_end() && peek() != '|' && peek() != ')')
+      result.children.push_back(parse_repetition());
+    return result;
+  }
+
+  node parse_repetition() {
+    auto result = parse_atom();
+    while (ok_ && !at_end()) {
+      size_t min = 0;
+      size_t max = unbounded;
+      switch (peek()) {
+        default:
+          return result;
+        case '*':
+          ++pos_;
+          break;
+        case '+':
+          ++pos_;
+          min = 1;
+          break;
+        case '?':
+          ++pos_;
+          max = 1;
+          break;
+        case '{':
+          if (!parse_bounds(min, max))
+            return fail();
+          break;
+      }
+      // Lazy quantifiers do not change whether a match exists.
+      if (!at_end() && peek() == '?')
+        ++pos_;
+      node x;
+      x.kind = node::repeat;
+      x.min = min;
+      x.max = max;
+      x.children.push_back(std::move(result));
+      result = std::move(x);
+    }
+    return result;
+  }
+
+  bool parse_number(size_t& x) {
+    auto begin = pos_;
+    x = 0;
+    while (!at_end() && std::isdigit(static_cast<uint8_t>(peek()))) {
+      x = x * 10 + (peek() - '0');
+      if (x > max_repetitions)
+        return false;
+      ++pos_;
+    }
+    return pos_ != begin;
+  }
+
+  bool parse_bounds(size_t& min, size_t& max) {
+    ++pos_; // '{'
+    if (!parse_number(min) || at_end())
+      return false;
+    if (peek() == ',') {
+      ++pos_;
+      if (!at_end() && peek() == '}')
+        max = unbounded;
+      else if (!parse_number(max) || max < min)
+        return false;
+    } else {
+      max = min;
+    }
+    if (at_end() || peek() != '}')
+      return false;
+    ++pos_;
+    return true;
+  }
+
+  node parse_atom() {
+    node result;
+    result.kind = node::bytes;
+    switch (peek()) {
+      default:
+        result.set.set(static_cast<uint8_t>(peek()));
+        ++pos_;
+        return result;
+      case '(':
+        ++pos_;
+        if (!at_end() && peek() == '?') {
+          // Only non-capturing groups are supported.
+          if (pos_ + 1 == str_.size() || str_[pos_ + 1] != ':')
+            return fail();
+          pos_ += 2;
+        }
+        result = parse_alternation();
+        if (at_end() || peek() != ')')
+          return fail();
+        ++pos_;
+        return result;
+      case '[':
+        if (!parse_class(result.set))
+          return fail();
+        return result;
+      case '.':
+        result.set.set();
+        result.set.reset('\n');
+        result.set.reset('\r');
+        ++pos_;
+        return result;
+      case '\\':
+        if (!parse_escape(result.set, false))
+          return fail();
+        return result;
+      case '^':
+      case '$':
+      case '*':
+      case '+':
+      case '?':
+      case '{':
+        return fail();
+    }
+  }
+
+  bool parse_escape(byte_set& set, bool in_class) {
+    if (++pos_ == str_.size())
+      return false;
+    auto c = static_cast<uint8_t>(peek());
+    ++pos_;
+    auto add_if = [&](auto predicate, bool negate) {
+      for (auto i = 0; i < 256; ++i)
+        if ((predicate(i) != 0) != negate)
+          set.set(i);
+    };
+    auto is_word = [](int x) { return std::isalnum(x) || x == '_'; };
+    auto is_space = [](int x) { return std::isspace(x); };
+    auto is_digit = [](int x) { return std::isdigit(x); };
+    switch (c) {
+      default:
+        // Backreferences, word boundaries, and other escapes of letters and
+        // digits are not supported.
+        if (std::isalnum(c))
+          return false;
+        set.set(c);
+        return true;
+      case 'd':
+        add_if(is_digit, false);
+        return true;
+      case 'D':
+        add_if(is_digit, true);
+        return true;
+      case 'w':
+        add_if(is_word, false);
+        return true;
+      case 'W':
+        add_if(is_word, true);
+        return true;
+      case 's':
+        add_if(is_space, false);
+        return true;
+      case 'S':
+        add_if(is_space, true);
+        return true;
+      case 'n':
+        set.set('\n');
+        return true;
+      case 'r':
+        set.set('\r');
+        return true;
+      case 't':
+        set.set('\t');
+        return true;
+      case 'f':
+        set.set('\f');
+        return true;
+      case 'v':
+        set.set('\v');
+        return true;
+      case '0':
+        set.set(0);
+        return true;
+      case 'x': {
+        if (str_.size() - pos_ < 2)
+          return false;
+        auto hex = [](char x) -> int {
+          if (x >= '0' && x <= '9')
+            return x - '0';
+          if (x >= 'a' && x <= 'f')
+            return x - 'a' + 10;
+          if (x >= 'A' && x <= 'F')
+            return x - 'A' + 10;
+          return -1;
+        };
+        auto hi = hex(str_[pos_]);
+        auto lo = hex(str_[pos_ + 1]);
+        if (hi < 0 || lo < 0)
+          return false;
+        pos_ += 2;
+        set.set(hi * 16 + lo);
+        return true;
+      }
+      case 'b':
+        // Inside a class, \b denotes a backspace.
+        if (!in_class)
+          return false;
+        set.set('\b');
+        return true;
+    }
+  }
+
+  bool parse_class(byte_set& set) {
+    ++pos_; // '['
+    auto negate = !at_end() && peek() == '^';
+    if (negate)
+      ++pos_;
+    while (!at_end() && peek() != ']') {
+      if (peek() == '\\') {
+        byte_set escaped;
+        if (!parse_escape(escaped, true))
+          return false;
+        set |= escaped;
+        continue;
+      }
+      // POSIX classes, collating symbols, and equivalence classes.
+      if (peek() == '[' && pos_ + 1 < str_.size()
+          && (str_[pos_ + 1] == ':' || str_[pos_ + 1] == '.'
+              || str_[pos_ + 1] == '='))
+        return false;
+      auto lo = static_cast<uint8_t>(peek());
+      ++pos_;
+      if (pos_ + 1 < str_.size() && peek() == '-' && str_[pos_ + 1] != ']') {
+        auto hi = static_cast<uint8_t>(str_[pos_ + 1]);
+        if (hi == '\\' || hi == '[' || hi < lo)
+          return false;
+        pos_ += 2;
+        for (int i = lo; i <= hi; ++i)
+          set.set(i);
+      } else {
+        set.set(lo);
+      }
+    }
+    if (at_end())
+      return false;
+    ++pos_; // ']'
+    if (negate)
+      set.flip();
+    return true;
+  }
+
+  node fail() {
+    ok_ = false;
+    return {};
+  }
+
+  std::string_view str_;
+  size_t pos_ = 0;
+  bool ok_ = true;
+};
+
+// -- automata -----------------------------------------------------------------
+
+// The maximum number of NFA states before falling back to `std::regex`.
+constexpr size_t max_nfa_states = 1 << 16;
+
+// The maximum number of cached DFA states before flushing the cache. Every
+// state takes about 0.5 KB plus its set of NFA states.
+constexpr size_t max_dfa_states = 1 << 8;
+
+// The maximum number of regexes per thread with cached DFA states.
+constexpr size_t max_cached_regexes = 8;
+
+// The number of matches on a thread after which the DFAs of a regex that was
+// not used in any of them get evicted.
+constexpr uint64_t max_idle_matches = 1 << 12;
+
+struct nfa_state {
+  // Consuming states transition on *bytes* to *out*, all other states have
+  // epsilon transitions to *epsilon*.
+  bool consuming = false;
+  byte_set bytes;
+  uint32_t out = 0;
+  std::vector<uint32_t> epsilon;
+};
+
+// A lazily constructed DFA whose states are sets of NFA states.
+struct dfa {
+  struct state {
+    std::vector<uint32_t> nfa;
+    bool accepting;
+    std::array<int16_t, 256> next;
+  };
+
+  static_assert(max_dfa_states <= std::numeric_limits<int16_t>::max());
+
+  std::vector<state> states;
+  std::map<std::vector<uint32_t>, int32_t> index;
+};
+
+// The DFAs for matching and for searching with one regex.
+struct dfa_pair {
+  dfa anchored;
+  dfa floating;
+  uint64_t last_use = 0;
+};
+
+// Returns the DFAs of the calling thread for the regex with the given ID.
+// Every thread builds its own DFA states, so that matching needs no locks.
+// The cache uses unique IDs instead of addresses, because a new regex may
+// reuse the address of a destroyed one. Since a destroyed regex cannot remove
+// its entries from the caches of other threads, entries that stay idle for
+// a while get evicted, and a full cache evicts the least recently used entry.
+dfa_pair& thread_local_dfas(uint64_t id) {
+  thread_local std::unordered_map<uint64_t, dfa_pair> cache;
+  thread_local uint64_t clock = 0;
+  ++clock;
+  if (clock % max_idle_matches == 0) {
+    for (auto i = cache.begin(); i != cache.end();) {
+      if (clock - i->second.last_use > max_idle_matches)
+        i = cache.erase(i);
+      else
+        ++i;
+    }
+  }
+  auto i = cache.find(id);
+  if (i == cache.end()) {
+    if (cache.size() >= max_cached_regexes) {
+      auto older = [](const auto& x, const auto& y) {
+        return x.second.last_use < y.second.last_use;
+      };
+      cache.erase(std::min_element(cache.begin(), cache.end(), older));
+    }
+    i = cache.emplace(id, dfa_pair{}).first;
+  }
+  i->second.last_use = clock;
+  return i->second;
+}
+
+uint64_t next_regex_id() {
+  static std::atomic<uint64_t> counter;
+  return counter++;
+}
+
+} // namespace <anonymous>
+
+struct regex::impl {
+  // Compiles *x* such that it continues with state *next*. Returns the entry
+  // state of the compiled fragment.
+  std::optional<uint32_t> compile(const node& x, uint32_t next) {
+    if (nfa.size() > max_nfa_states)
+      return std::nullopt;
+    switch (x.kind) {
+      case node::empty:
+        return next;
+      case node::bytes: {
+        nfa_state s;
+        s.consuming = true;
+        s.bytes = x.set;
+        s.out = next;
+        return add(std::move(s));
+      }
+      case node::concat: {
+        for (auto i = x.children.rbegin(); i != x.children.rend(); ++i) {
+          auto entry = compile(*i, next);
+          if (!entry)
+            return std::nullopt;
+          next = *entry;
+        }
+        return next;
+      }
+      case node::alternate: {
+        nfa_state s;
+        for (auto& child : x.children) {
+          auto entry = compile(child, next);
+          if (!entry)
+            return std::nullopt;
+          s.epsilon.push_back(*entry);
+        }
+        return add(std::move(s));
+      }
+      case node::repeat: {
+        auto& child = x.children.front();
+        if (x.max == unbounded) {
+          auto loop = add({});
+          auto body = compile(child, loop);
+          if (!body)
+            return std::nullopt;
+          nfa[loop].epsilon = {*body, next};
+          next = loop;
+        } else {
+          for (auto i = x.min; i < x.max; ++i) {
+            auto body = compile(child, next);
+            if (!body)
+              return std::nullopt;
+            nfa_state s;
+            s.epsilon = {*body, next};
+            next = add(std::move(s));
+          }
+        }
+        for (size_t i = 0; i < x.min; ++i) {
+          auto body = compile(child, next);
+          if (!body)
+            return std::nullopt;
+          next = *body;
+        }
+        return next;
+      }
+    }
+    return std::nullopt;
+  }
+
+  uint32_t add(nfa_state x) {
+    nfa.push_back(std::move(x));
+    return static_cast<uint32_t>(nfa.size() - 1);
+  }
+
+  // Computes the sorted set of consuming and accepting states reachable via
+  // epsilon transitions.
+  std::vector<uint32_t> closure(std::vector<uint32_t> seeds) const {
+    std::vector<uint32_t> result;
+    std::vector<bool> visited(nfa.size());
+    while (!seeds.empty()) {
+      auto i = seeds.back();
+      seeds.pop_back();
+      if (visited[i])
+        continue;
+      visited[i] = true;
+      if (nfa[i].consuming || i == accept)
+        result.push_back(i);
+      else
+        seeds.insert(seeds.end(), nfa[i].epsilon.begin(),
+                     nfa[i].epsilon.end());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  int32_t insert(dfa& d, std::vector<uint32_t> key) const {
+    if (auto i = d.index.find(key); i != d.index.end())
+      return i->second;
+    dfa::state s;
+    s.accepting = std::binary_search(key.begin(), key.end(), accept);
+    s.next.fill(-1);
+    s.nfa = key;
+    auto id = static_cast<int32_t>(d.states.size());
+    d.states.push_back(std::move(s));
+    d.index.emplace(std::move(key), id);
+    return id;
+  }
+
+  int32_t initial(dfa& d) const {
+    return insert(d, closure({start}));
+  }
+
+  // Transitions from DFA state *from* on byte *x*. A floating DFA re-enters
+  // the start state after every byte to find matches at any offset.
+  int32_t step(dfa& d, int32_t from, uint8_t x, bool floating) const {
+    if (auto to = d.states[from].next[x]; to >= 0)
+      return to;
+    std::vector<uint32_t> seeds;
+    for (auto i : d.states[from].nfa)
+      if (nfa[i].consuming && nfa[i].bytes[x])
+        seeds.push_back(nfa[i].out);
+    if (floating)
+      seeds.push_back(start);
+    auto key = closure(std::move(seeds));
+    if (d.states.size() >= max_dfa_states && d.index.count(key) == 0) {
+      d.states.clear();
+      d.index.clear();
+      return insert(d, std::move(key));
+    }
+    auto to = insert(d, std::move(key));
+    d.states[from].next[x] = static_cast<int16_t>(to);
+    return to;
+  }
+
+  bool prefilter(std::string_view x) const {
+    for (auto& literal : literals)
+      if (x.find(literal) == std::string_view::npos)
+        return false;
+    return true;
+  }
+
+  std::vector<nfa_state> nfa;
+  uint32_t start = 0;
+  uint32_t accept = 0;
+  bool begin_anchored = false;
+  bool end_anchored = false;
+  std::vector<std::string> literals;
+  std::optional<std::regex> fallback;
+  uint64_t id = next_regex_id();
+};
+
+regex::regex(std::string_view str) : impl_{std::make_unique<impl>()} {
+  auto compile = [&]() -> bool {
+    auto rx = str;
+    if (!rx.empty() && rx.front() == '^') {
+      impl_->begin_anchored = true;
+      rx.remove_prefix(1);
+    }
+    if (!rx.empty() && rx.back() == '$') {
+      // Only strip the anchor if it is not escaped.
+      size_t backslashes = 0;
+      for (auto i = rx.size() - 1; i > 0 && rx[i - 1] == '\\'; --i)
+        ++backslashes;
+      if (backslashes % 2 == 0) {
+        impl_->end_anchored = true;
+        rx.remove_suffix(1);
+      }
+    }
+    auto ast = parser{rx}.parse();
+    if (!ast)
+      return false;
+    // Anchors bind to the first and last alternative only.
+    if ((impl_->begin_anchored || impl_->end_anchored)
+        && ast->kind == node::alternate)
+      return false;
+    impl_->accept = impl_->add({});
+    auto entry = impl_->compile(*ast, impl_->accept);
+    if (!entry)
+      return false;
+    impl_->start = *entry;
+    impl_->literals = required_literals(str);
+    return true;
+  };
+  if (!compile()) {
+    impl_->nfa.clear();
+    impl_->fallback.emplace(str.begin(), str.end());
+  }
+}
+
+regex::~regex() {
+  // nop
+}
+
+bool regex::match(std::string_view x) const {
+  if (impl_->fallback)
+    return std::regex_match(x.begin(), x.end(), *impl_->fallback);
+  if (!impl_->prefilter(x))
+    return false;
+  auto& d = thread_local_dfas(impl_->id).anchored;
+  auto s = impl_->initial(d);
+  for (auto c : x) {
+    s = impl_->step(d, s, static_cast<uint8_t>(c), false);
+    if (d.states[s].nfa.empty())
+      return false;
+  }
+  return d.states[s].accepting;
+}
+
+bool regex::search(std::string_view x) const {
+  if (impl_->fallback)
+    return std::regex_search(x.begin(), x.end(), *impl_->fallback);
+  if (!impl_->prefilter(x))
+    return false;
+  auto floating = !impl_->begin_anchored;
+  auto& dfas = thread_local_dfas(impl_->id);
+  auto& d = floating ? dfas.floating : dfas.anchored;
+  auto s = impl_->initial(d);
+  for (auto c : x) {
+    if (d.states[s].accepting && !impl_->end_anchored)
+      return true;
+    s = impl_->step(d, s, static_cast<uint8_t>(c), floating);
+    if (d.states[s].nfa.empty())
+      return false;
+  }
+  return d.states[s].accepting;
+}
+
+bool regex::native() const {
+  return !impl_->fallback;
+}
+
+std::vector<std::string> required_literals(std::string_view rx) {
+  std::vector<std::string> result;
+  if (rx.find('|') != std::string_view::npos)
+    return result;
+  std::string run;
+  auto last_literal = false;
+  auto flush = [&] {
+    if (run.size() >= 3)
+      result.push_back(std::move(run));
+    run.clear();
+    last_literal = false;
+  };
+  // Skips a bracket expression that starts at `rx[i]` to its closing
+  // bracket. Returns `false` if the bracket expression does not terminate.
+  auto skip_class = [&](size_t& i) {
+    // A closing bracket right after the opening one is a literal.
+    i += (i + 1 < rx.size() && rx[i + 1] == '^') ? 2 : 1;
+    if (i < rx.size() && rx[i] == ']')
+      ++i;
+    // POSIX classes, e.g., [[:alpha:]], contain brackets themselves.
+    for (; i < rx.size() && rx[i] != ']'; ++i) {
+      if (rx[i] == '\\') {
+        ++i;
+      } else if (rx[i] == '[' && i + 1 < rx.size()
+                 && (rx[i + 1] == ':' || rx[i + 1] == '.'
+                     || rx[i + 1] == '=')) {
+        auto close = rx.find(std::string{rx[i + 1], ']'}, i + 2);
+        if (close == std::string_view::npos)
+          return false;
+        i = close + 1;
+      }
+    }
+    return i < rx.size();
+  };
+  // Skips to the closing delimiter, honoring escapes and bracket expressions.
+  // Returns `false` if the delimiter is missing.
+  auto skip = [&](size_t& i, char open, char close) {
+    auto depth = 0;
+    for (; i < rx.size(); ++i) {
+      if (rx[i] == '\\') {
+        ++i;
+      } else if (rx[i] == '[') {
+        if (!skip_class(i))
+          return false;
+      } else if (rx[i] == open && open != close) {
+        ++depth;
+      } else if (rx[i] == close && --depth <= 0) {
+        return true;
+      }
+    }
+    return false;
+  };
+  for (size_t i = 0; i < rx.size(); ++i) {
+    auto c = rx[i];
+    switch (c) {
+      default:
+        run += c;
+        last_literal = true;
+        break;
+      case '\\':
+        if (++i < rx.size() && !std::isalnum(static_cast<uint8_t>(rx[i]))) {
+          run += rx[i];
+          last_literal = true;
+        } else {
+          flush();
+          // Skip the operands of numeric escapes, e.g., \x41.
+          if (i < rx.size())
+            i += rx[i] == 'x' ? 2 : rx[i] == 'u' ? 4 : rx[i] == 'c' ? 1 : 0;
+        }
+        break;
+      case '*':
+      case '?':
+      case '{':
+        // The preceding atom may be absent.
+        if (last_literal)
+          run.pop_back();
+        flush();
+        if (c == '{' && !skip(i, '{', '}'))
+          return result;
+        break;
+      case '+':
+        // The preceding atom occurs at least once, but may repeat.
+        flush();
+        break;
+      case '[':
+        flush();
+        if (!skip_class(i))
+          return result;
+        break;
+      case '(':
+        flush();
+        if (!skip(i, '(', ')'))
+          return result;
+        break;
+      case '.':
+      case '^':
+      case '$':
+      case ')':
+        flush();
+        break;
+    }
+  }
+  flush();
+  return result;
+}
+
+} // namespace vast::detail
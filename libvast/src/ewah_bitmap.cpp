@@ -13,6 +13,9 @@
 
 #include "vast/ewah_bitmap.hpp"
 
+#include "vast/detail/bitwise.hpp"
+#include "vast/detail/word_eval.hpp"
+
 namespace vast {
 
 ewah_bitmap::ewah_bitmap(size_type n, bool bit) {
@@ -300,4 +303,134 @@ ewah_bitmap_range bit_range(const ewah_bitmap& bm) {
   return ewah_bitmap_range{bm};
 }
 
+namespace {
+
+using word_type = ewah_bitmap::word_type;
+
+// Exposes the blocks of an EWAH bitmap as segments of clean and dirty words
+// for detail::word_eval.
+class ewah_cursor {
+public:
+  explicit ewah_cursor(const ewah_bitmap& bm)
+    : blocks_{bm.blocks().data()},
+      end_{bm.blocks().size()} {
+    normalize();
+  }
+
+  bool clean() const {
+    return clean_ > 0 || (dirty_ == 0 && next_ >= end_);
+  }
+
+  uint64_t value() const {
+    return clean_ > 0 ? value_ : word_type::none;
+  }
+
+  const uint64_t* data() const {
+    return blocks_ + next_;
+  }
+
+  size_t size() const {
+    if (clean_ > 0)
+      return clean_;
+    if (dirty_ > 0)
+      return dirty_;
+    // The last block is dirty and not part of any marker's dirty count.
+    return next_ < end_ ? 1 : detail::word_eval_infinite;
+  }
+
+  void advance(size_t n) {
+    if (clean_ > 0) {
+      clean_ -= n;
+    } else if (dirty_ > 0) {
+      next_ += n;
+      dirty_ -= n;
+    } else if (next_ < end_) {
+      ++next_;
+    }
+    normalize();
+  }
+
+private:
+  // Reads markers until reaching a non-empty segment.
+  void normalize() {
+    while (clean_ == 0 && dirty_ == 0 && next_ + 1 < end_) {
+      auto marker = blocks_[next_++];
+      clean_ = word_type::marker_num_clean(marker);
+      dirty_ = word_type::marker_num_dirty(marker);
+      value_ = word_type::marker_type(marker) ? word_type::all
+                                              : word_type::none;
+    }
+  }
+
+  const uint64_t* blocks_;
+  size_t end_;
+  size_t next_ = 0;
+  size_t clean_ = 0;
+  size_t dirty_ = 0;
+  uint64_t value_ = 0;
+};
+
+using ewah_builder = detail::word_eval_builder<ewah_bitmap, word_type::width>;
+
+template <class Operation, class Kernel>
+ewah_bitmap eval(const ewah_bitmap& lhs, const ewah_bitmap& rhs, Operation op,
+                 Kernel kernel) {
+  ewah_builder result{std::max(lhs.size(), rhs.size())};
+  detail::word_eval(result, ewah_cursor{lhs}, ewah_cursor{rhs},
+                    word_type::all, op, kernel);
+  return result.finish();
+}
+
+template <class Operation, class Kernel>
+ewah_bitmap eval(const std::vector<const ewah_bitmap*>& xs, Operation op,
+                 Kernel kernel) {
+  std::vector<ewah_cursor> cursors;
+  cursors.reserve(xs.size());
+  ewah_bitmap::size_type size = 0;
+  for (auto x : xs) {
+    cursors.emplace_back(*x);
+    size = std::max(size, x->size());
+  }
+  ewah_builder result{size};
+  detail::word_eval(result, std::move(cursors), word_type::all, op, kernel);
+  return result.finish();
+}
+
+} // namespace <anonymous>
+
+ewah_bitmap binary_and(const ewah_bitmap& lhs, const ewah_bitmap& rhs) {
+  auto op = [](uint64_t x, uint64_t y) { return x & y; };
+  return eval(lhs, rhs, op, detail::bitwise_and);
+}
+
+ewah_bitmap binary_or(const ewah_bitmap& lhs, const ewah_bitmap& rhs) {
+  auto op = [](uint64_t x, uint64_t y) { return x | y; };
+  return eval(lhs, rhs, op, detail::bitwise_or);
+}
+
+ewah_bitmap binary_xor(const ewah_bitmap& lhs, const ewah_bitmap& rhs) {
+  auto op = [](uint64_t x, uint64_t y) { return x ^ y; };
+  return eval(lhs, rhs, op, detail::bitwise_xor);
+}
+
+ewah_bitmap binary_nand(const ewah_bitmap& lhs, const ewah_bitmap& rhs) {
+  auto op = [](uint64_t x, uint64_t y) { return x & ~y; };
+  return eval(lhs, rhs, op, detail::bitwise_nand);
+}
+
+ewah_bitmap nary_and(const std::vector<const ewah_bitmap*>& xs) {
+  auto op = [](uint64_t x, uint64_t y) { return x & y; };
+  return eval(xs, op, detail::bitwise_and);
+}
+
+ewah_bitmap nary_or(const std::vector<const ewah_bitmap*>& xs) {
+  auto op = [](uint64_t x, uint64_t y) { return x | y; };
+  return eval(xs, op, detail::bitwise_or);
+}
+
+ewah_bitmap nary_xor(const std::vector<const ewah_bitmap*>& xs) {
+  auto op = [](uint64_t x, uint64_t y) { return x ^ y; };
+  return eval(xs, op, detail::bitwise_xor);
+}
+
 } // namespace vast
@@ -412,6 +412,22 @@ bool exists(const path& p) {
 #endif // VAST_POSIX
 }
 
+size_t disk_usage(const path& p) {
+#ifdef VAST_POSIX
+  auto t = p.kind();
+  if (t == path::type::directory) {
+    size_t result = 0;
+    for (auto& entry : directory{p})
+      result += disk_usage(entry);
+    return result;
+  }
+  struct stat st;
+  if (t == path::type::regular_file && ::stat(p.str().data(), &st) == 0)
+    return static_cast<size_t>(st.st_size);
+#endif // VAST_POSIX
+  return 0;
+}
+
 caf::error create_symlink(const path& target, const path& link) {
   if (::symlink(target.str().c_str(), link.str().c_str()))
     return make_error(ec::filesystem_error, std::strerror(errno));
@@ -13,12 +13,29 @@
 
 #include "vast/format/writer.hpp"
 
+#include "vast/error.hpp"
+#include "vast/event.hpp"
+#include "vast/to_events.hpp"
+
 namespace vast::format {
 
 writer::~writer() {
   // nop
 }
 
+caf::expected<void> writer::write(const table_slice& x,
+                                  const ids& selection) {
+  std::vector<event> xs;
+  each_selected_row(x, selection, [&](auto row) {
+    to_events(xs, x, row, 1);
+    return true;
+  });
+  for (auto& e : xs)
+    if (auto r = write(e); !r)
+      return r.error();
+  return caf::no_error;
+}
+
 caf::expected<void> writer::flush() {
   return caf::no_error;
 }
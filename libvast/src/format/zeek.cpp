@@ -11,6 +11,8 @@
  * contained in the LICENSE file.                                             *
  ******************************************************************************/
 
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 
@@ -25,11 +27,14 @@
 #include "vast/detail/escapers.hpp"
 #include "vast/detail/fdoutbuf.hpp"
 #include "vast/detail/string.hpp"
+#include "vast/detail/type_traits.hpp"
 #include "vast/error.hpp"
 #include "vast/event.hpp"
 #include "vast/format/zeek.hpp"
 #include "vast/logger.hpp"
+#include "vast/table_slice.hpp"
 #include "vast/table_slice_builder.hpp"
+#include "vast/view.hpp"
 
 namespace vast::format::zeek {
 namespace {
@@ -164,31 +169,36 @@ void print_header(const type& t, std::ostream& out) {
 }
 
 struct streamer {
-  streamer(std::ostream& out) : out_{out} {
+  streamer(std::string& out) : out_{out} {
   }
 
   template <class T>
   void operator()(const T&, caf::none_t) const {
-    out_ << unset_field;
+    out_ += unset_field;
   }
 
   template <class T, class U>
-  auto operator()(const T&, const U& x) const
+  auto operator()(const T& t, const U& x) const
   -> std::enable_if_t<!std::is_same_v<U, caf::none_t>> {
-    out_ << to_string(x);
+    // Views without a dedicated overload take the detour over data.
+    if constexpr (detail::is_any_v<U, std::string_view, view<pattern>,
+                                   view<vector>, view<set>, view<map>>)
+      (*this)(t, materialize(x));
+    else
+      out_ += to_string(x);
   }
 
   void operator()(const integer_type&, integer i) const {
-    out_ << i;
+    out_ += std::to_string(i);
   }
 
   void operator()(const count_type&, count c) const {
-    out_ << c;
+    out_ += std::to_string(c);
   }
 
   void operator()(const real_type&, real r) const {
     auto p = real_printer<real, 6, 6>{};
-    auto out = std::ostreambuf_iterator<char>(out_);
+    auto out = std::back_inserter(out_);
     p.print(out, r);
   }
 
@@ -196,7 +206,7 @@ struct streamer {
     double d;
     convert(ts.time_since_epoch(), d);
     auto p = real_printer<real, 6, 6>{};
-    auto out = std::ostreambuf_iterator<char>(out_);
+    auto out = std::back_inserter(out_);
     p.print(out, d);
   }
 
@@ -204,23 +214,27 @@ struct streamer {
     double d;
     convert(span, d);
     auto p = real_printer<real, 6, 6>{};
-    auto out = std::ostreambuf_iterator<char>(out_);
+    auto out = std::back_inserter(out_);
     p.print(out, d);
   }
 
-  void operator()(const string_type&, const std::string& str) const {
-    auto out = std::ostreambuf_iterator<char>{out_};
+  void operator()(const string_type&, std::string_view str) const {
+    auto out = std::back_inserter(out_);
     auto f = str.begin();
     auto l = str.end();
     for ( ; f != l; ++f)
       if (!std::isprint(*f) || *f == separator || *f == set_separator)
         detail::hex_escaper(f, out);
       else
-        out_ << *f;
+        out_ += *f;
+  }
+
+  void operator()(const string_type& t, const std::string& str) const {
+    (*this)(t, std::string_view{str});
   }
 
   void operator()(const port_type&, const port& p) const {
-    out_ << p.number();
+    out_ += std::to_string(p.number());
   }
 
   void operator()(const record_type& r, const vector& v) const {
@@ -228,7 +242,7 @@ struct streamer {
     VAST_ASSERT(r.fields.size() == v.size());
     caf::visit(*this, r.fields[0].type, v[0]);
     for (auto i = 1u; i < v.size(); ++i) {
-      out_ << separator;
+      out_ += separator;
       caf::visit(*this, r.fields[i].type, v[i]);
     }
   }
@@ -249,19 +263,138 @@ struct streamer {
   void stream(Container& c, const type& value_type, const Sep& sep) const {
     if (c.empty()) {
       // Cannot occur if we have a record
-      out_ << empty_field;
+      out_ += empty_field;
       return;
     }
     auto f = c.begin();
     auto l = c.end();
     caf::visit(*this, value_type, *f);
     while (++f != l) {
-      out_ << sep;
+      out_ += sep;
       caf::visit(*this, value_type, *f);
     }
   }
 
-  std::ostream& out_;
+  std::string& out_;
+};
+
+// Splits a line into fields, reusing the storage of *xs*. Single-character
+// separators, the common case, are located with memchr.
+void split_fields(std::string_view line, std::string_view sep,
+                  std::vector<std::string_view>& xs) {
+  VAST_ASSERT(!sep.empty());
+  xs.clear();
+  if (sep.size() == 1) {
+    auto f = line.data();
+    auto l = f + line.size();
+    while (auto i = static_cast<const char*>(std::memchr(f, sep[0], l - f))) {
+      xs.emplace_back(f, i - f);
+      f = i + 1;
+    }
+    xs.emplace_back(f, l - f);
+    return;
+  }
+  size_t pos = 0;
+  for (auto i = line.find(sep); i != std::string_view::npos;
+       i = line.find(sep, pos)) {
+    xs.push_back(line.substr(pos, i - pos));
+    pos = i + sep.size();
+  }
+  xs.push_back(line.substr(pos));
+}
+
+// Parses a non-container field in place into a view. Strings refer to the
+// input line unless they contain escape sequences, in which case they refer
+// to the unescaped copy.
+struct field_parser {
+  template <class T>
+  bool operator()(const T&) const {
+    return false;
+  }
+
+  bool operator()(const boolean_type&) const {
+    return parse(parsers::tf);
+  }
+
+  bool operator()(const integer_type&) const {
+    return parse(parsers::i64);
+  }
+
+  bool operator()(const count_type&) const {
+    return parse(parsers::u64);
+  }
+
+  bool operator()(const real_type&) const {
+    return parse(parsers::real);
+  }
+
+  bool operator()(const timestamp_type&) const {
+    real x;
+    if (!parsers::real(field, x))
+      return false;
+    auto i = std::chrono::duration_cast<timespan>(double_seconds(x));
+    result = timestamp{i};
+    return true;
+  }
+
+  bool operator()(const timespan_type&) const {
+    real x;
+    if (!parsers::real(field, x))
+      return false;
+    result = std::chrono::duration_cast<timespan>(double_seconds(x));
+    return true;
+  }
+
+  bool operator()(const string_type&) const {
+    if (field.empty())
+      return false;
+    result = unescape();
+    return true;
+  }
+
+  bool operator()(const pattern_type&) const {
+    if (field.empty())
+      return false;
+    result = pattern_view{unescape()};
+    return true;
+  }
+
+  bool operator()(const address_type&) const {
+    return parse(parsers::addr);
+  }
+
+  bool operator()(const subnet_type&) const {
+    return parse(parsers::net);
+  }
+
+  bool operator()(const port_type&) const {
+    uint16_t x;
+    if (!parsers::u16(field, x))
+      return false;
+    result = port{x, protocol};
+    return true;
+  }
+
+  template <class Parser>
+  bool parse(const Parser& p) const {
+    typename Parser::attribute x;
+    if (!p(field, x))
+      return false;
+    result = x;
+    return true;
+  }
+
+  std::string_view unescape() const {
+    if (std::memchr(field.data(), '\\', field.size()) == nullptr)
+      return field;
+    unescaped = detail::byte_unescape(field);
+    return unescaped;
+  }
+
+  std::string_view field;
+  port::port_type protocol;
+  std::string& unescaped;
+  data_view& result;
 };
 
 } // namespace <anonymous>
@@ -294,35 +427,6 @@ const char* reader::name() const {
   return "zeek-reader";
 }
 
-void reader::patch(std::vector<data>& xs) {
-  auto protocol = port::unknown;
-  // Get the protocol from the proto field if available.
-  if (proto_field_) {
-    VAST_ASSERT(*proto_field_ < xs.size());
-    if (auto proto_string = caf::get_if<std::string>(&xs[*proto_field_])) {
-      auto p = parsers::port_type >> parsers::eoi;
-      if (!p(*proto_string, protocol))
-        VAST_DEBUG(this, "could not parse protocol", *proto_string);
-    }
-  }
-  // Or use a simple heuristic if not.
-  else {
-    if (type_.name() == "zeek.ftp" || type_.name() == "zeek.http"
-        || type_.name() == "zeek.irc" || type_.name() == "zeek.rdp"
-        || type_.name() == "zeek.smtp" || type_.name() == "zeek.ssh"
-        || type_.name() == "zeek.xmpp")
-      protocol = port::tcp;
-    else if (type_.name() == "zeek.dhcp" || type_.name() == "zeek.dns"
-             || type_.name() == "zeek.smnp")
-      protocol = port::udp;
-  }
-  // Assign the deduced proto to all port fields.
-  for (auto& pf : port_fields_) {
-    auto& p = caf::get<port>(xs[pf]);
-    p.type(protocol);
-  }
-}
-
 caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
                              consumer& f) {
   // Sanity checks.
@@ -344,8 +448,6 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
     if (lines_->done())
       return make_error(ec::end_of_input, "input exhausted");
   }
-  // Local buffer for parsing records.
-  std::vector<data> xs;
   // Counts successfully parsed records.
   size_t produced = 0;
   // Loop until reaching EOF or the configured limit of records.
@@ -375,39 +477,51 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
       // Ignore comments.
       VAST_DEBUG(this, "ignores comment at line", lines_->line_number());
     } else {
-      auto fields = detail::split(lines_->get(), separator_);
-      if (fields.size() != parsers_.size()) {
+      split_fields(line, separator_, fields_);
+      if (fields_.size() != layout_.fields.size()) {
         VAST_WARNING(this, "ignores invalid record at line",
-                     lines_->line_number(), ':', "got", fields.size(),
-                     "fields but need", parsers_.size());
+                     lines_->line_number(), ':', "got", fields_.size(),
+                     "fields but need", layout_.fields.size());
         continue;
       }
-      // Construct the record.
-      auto is_unset = [&](auto i) {
-        return std::equal(unset_field_.begin(), unset_field_.end(),
-                          fields[i].begin(), fields[i].end());
-      };
-      auto is_empty = [&](auto i) {
-        return std::equal(empty_field_.begin(), empty_field_.end(),
-                          fields[i].begin(), fields[i].end());
-      };
-      xs.resize(fields.size());
-      for (size_t i = 0; i < fields.size(); ++i) {
-        if (is_unset(i))
-          xs[i] = caf::none;
-        else if (is_empty(i))
-          xs[i] = construct(layout_.fields[i].type);
-        else if (!parsers_[i](fields[i], xs[i]))
+      // Deduce the transport protocol for port fields.
+      auto protocol = default_protocol_;
+      if (proto_field_) {
+        protocol = port::unknown;
+        auto proto = fields_[*proto_field_];
+        auto p = parsers::port_type >> parsers::eoi;
+        if (proto != unset_field_ && !p(proto, protocol))
+          VAST_DEBUG(this, "could not parse protocol", proto);
+      }
+      // Parse all fields before adding any of them, so that an invalid field
+      // does not leave a partial row in the builder.
+      for (size_t i = 0; i < fields_.size(); ++i) {
+        auto field = fields_[i];
+        auto& t = layout_.fields[i].type;
+        if (field == unset_field_) {
+          views_[i] = caf::none;
+        } else if (field == empty_field_) {
+          containers_[i] = construct(t);
+          views_[i] = make_data_view(containers_[i]);
+        } else if (is_container(t)) {
+          if (!parsers_[i](field, containers_[i]))
+            return finish(f, make_error(ec::parse_error, "field", i, "line",
+                                        lines_->line_number(),
+                                        std::string{field}));
+          views_[i] = make_data_view(containers_[i]);
+        } else {
+          auto parser = field_parser{field, protocol, unescaped_[i], views_[i]};
+          if (!caf::visit(parser, t))
             return finish(f, make_error(ec::parse_error, "field", i, "line",
                                         lines_->line_number(),
-                                        std::string{fields[i]}));
+                                        std::string{field}));
+        }
       }
-      patch(xs);
-      for (size_t i = 0; i < fields.size(); ++i) {
-        if (!builder_->add(make_data_view(xs[i])))
+      for (size_t i = 0; i < fields_.size(); ++i) {
+        if (!builder_->add(views_[i]))
           return finish(f, make_error(ec::type_clash, "field", i, "line",
                                       lines_->line_number(),
-                                      std::string{fields[i]}));
+                                      std::string{fields_[i]}));
       }
       if (builder_->rows() == max_slice_size)
         if (auto err = finish(f))
@@ -486,7 +600,6 @@ caf::error reader::parse_header() {
     return make_error(ec::format_error, "fields and types have different size");
   std::vector<record_field> record_fields;
   proto_field_ = caf::none;
-  port_fields_.clear();
   for (auto i = 0u; i < fields.size(); ++i) {
     auto t = parse_type(types[i]);
     if (!t)
@@ -494,8 +607,6 @@ caf::error reader::parse_header() {
     record_fields.emplace_back(std::string{fields[i]}, *t);
     if (fields[i] == "proto" && types[i] == "enum")
       proto_field_ = i;
-    if (caf::holds_alternative<port_type>(*t))
-      port_fields_.push_back(i);
   }
   // Construct type.
   layout_ = std::move(record_fields);
@@ -545,6 +656,19 @@ caf::error reader::parse_header() {
   parsers_.resize(layout_.fields.size());
   for (size_t i = 0; i < layout_.fields.size(); i++)
     parsers_[i] = make_parser(layout_.fields[i].type, set_separator_);
+  views_.resize(layout_.fields.size());
+  unescaped_.resize(layout_.fields.size());
+  containers_.resize(layout_.fields.size());
+  // Without a proto field, we guess the transport protocol of port fields
+  // from the log type.
+  default_protocol_ = port::unknown;
+  if (!proto_field_) {
+    if (path == "ftp" || path == "http" || path == "irc" || path == "rdp"
+        || path == "smtp" || path == "ssh" || path == "xmpp")
+      default_protocol_ = port::tcp;
+    else if (path == "dhcp" || path == "dns" || path == "smnp")
+      default_protocol_ = port::udp;
+  }
   return caf::none;
 }
 
@@ -564,10 +688,7 @@ writer::~writer() {
       *pair.second << footer;
 }
 
-expected<void> writer::write(const event& e) {
-  if (!caf::holds_alternative<record_type>(e.type()))
-    return make_error(ec::format_error, "cannot process non-record events");
-  std::ostream* os = nullptr;
+expected<std::ostream*> writer::stream(const type& layout) {
   if (dir_.empty()) {
     if (streams_.empty()) {
       VAST_DEBUG(this, "creates a new stream for STDOUT");
@@ -575,36 +696,67 @@ expected<void> writer::write(const event& e) {
       auto out = std::make_unique<std::ostream>(sb.release());
       streams_.emplace("", std::move(out));
     }
-    os = streams_.begin()->second.get();
-    if (e.type() != previous_layout_) {
-      print_header(e.type(), *os);
-      previous_layout_ = e.type();
+    auto os = streams_.begin()->second.get();
+    if (layout != previous_layout_) {
+      print_header(layout, *os);
+      previous_layout_ = layout;
     }
-  } else {
-    auto i = streams_.find(e.type().name());
-    if (i != streams_.end()) {
-      os = i->second.get();
-      VAST_ASSERT(os != nullptr);
-    } else {
-      VAST_DEBUG(this, "creates new stream for event", e.type().name());
-      if (!exists(dir_)) {
-        auto d = mkdir(dir_);
-        if (!d)
-          return d.error();
-      } else if (!dir_.is_directory()) {
-        return make_error(ec::format_error, "got existing non-directory path",
-                          dir_);
-      }
-      auto filename = dir_ / (e.type().name() + ".log");
-      auto fos = std::make_unique<std::ofstream>(filename.str());
-      print_header(e.type(), *fos);
-      auto i = streams_.emplace(e.type().name(), std::move(fos));
-      os = i.first->second.get();
+    return os;
+  }
+  auto i = streams_.find(layout.name());
+  if (i != streams_.end()) {
+    VAST_ASSERT(i->second != nullptr);
+    return i->second.get();
+  }
+  VAST_DEBUG(this, "creates new stream for event", layout.name());
+  if (!exists(dir_)) {
+    auto d = mkdir(dir_);
+    if (!d)
+      return d.error();
+  } else if (!dir_.is_directory()) {
+    return make_error(ec::format_error, "got existing non-directory path",
+                      dir_);
+  }
+  auto filename = dir_ / (layout.name() + ".log");
+  auto fos = std::make_unique<std::ofstream>(filename.str());
+  print_header(layout, *fos);
+  auto j = streams_.emplace(layout.name(), std::move(fos));
+  return j.first->second.get();
+}
+
+expected<void> writer::write(const event& e) {
+  if (!caf::holds_alternative<record_type>(e.type()))
+    return make_error(ec::format_error, "cannot process non-record events");
+  auto os = stream(e.type());
+  if (!os)
+    return os.error();
+  buffer_.clear();
+  caf::visit(streamer{buffer_}, e.type(), e.data());
+  buffer_ += '\n';
+  (*os)->write(buffer_.data(), buffer_.size());
+  return no_error;
+}
+
+expected<void> writer::write(const table_slice& x, const ids& selection) {
+  auto& layout = x.layout();
+  VAST_ASSERT(layout.fields.size() == x.columns());
+  auto os = stream(layout);
+  if (!os)
+    return os.error();
+  // Render all selected rows into the buffer, one column after another, and
+  // hand them to the stream at once.
+  buffer_.clear();
+  auto f = streamer{buffer_};
+  each_selected_row(x, selection, [&](auto row) {
+    for (size_t col = 0; col < x.columns(); ++col) {
+      if (col > 0)
+        buffer_ += separator;
+      caf::visit(f, layout.fields[col].type, x.at(row, col));
     }
-  }
-  VAST_ASSERT(os != nullptr);
-  caf::visit(streamer{*os}, e.type(), e.data());
-  *os << '\n';
+    buffer_ += '\n';
+    return true;
+  });
+  (*os)->write(buffer_.data(), buffer_.size());
   return no_error;
 }
 
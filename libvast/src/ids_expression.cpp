@@ -0,0 +1,188 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/ids_expression.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+#include <caf/none.hpp>
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/detail/assert.hpp"
+
+namespace vast {
+
+/// Flattens an expression into nodes in pre-order, tracking the position of
+/// each predicate the same way as `resolve`.
+struct ids_expression::builder {
+  size_t add(node_kind kind) {
+    auto i = self.nodes_.size();
+    self.nodes_.push_back({kind, parent, {}, nullptr, {}, true});
+    if (parent != npos)
+      self.nodes_[parent].children.push_back(i);
+    return i;
+  }
+
+  void operator()(caf::none_t) {
+    add(node_kind::none);
+  }
+
+  template <class Connective>
+  void operator()(const Connective& xs) {
+    VAST_ASSERT(xs.size() > 0);
+    auto kind = std::is_same_v<Connective, conjunction>
+                  ? node_kind::conjunction
+                  : node_kind::disjunction;
+    descend(add(kind), [&] {
+      for (size_t i = 0; i < xs.size(); ++i) {
+        position.back() = i;
+        caf::visit(*this, xs[i]);
+      }
+    });
+  }
+
+  void operator()(const negation& x) {
+    descend(add(node_kind::negation), [&] { caf::visit(*this, x.expr()); });
+  }
+
+  void operator()(const predicate&) {
+    self.predicates_.emplace(position, add(node_kind::predicate));
+  }
+
+  template <class F>
+  void descend(size_t i, F f) {
+    auto previous = parent;
+    parent = i;
+    position.emplace_back(0);
+    f();
+    position.pop_back();
+    parent = previous;
+  }
+
+  ids_expression& self;
+  offset position;
+  size_t parent;
+};
+
+ids_expression::ids_expression() : ids_expression{expression{}} {
+  // nop
+}
+
+ids_expression::ids_expression(const expression& expr) {
+  builder f{*this, offset{0}, npos};
+  caf::visit(f, expr);
+}
+
+bool ids_expression::bind(const offset& position, const ids& hits) {
+  auto i = predicates_.find(position);
+  if (i == predicates_.end())
+    return false;
+  auto& x = nodes_[i->second];
+  x.hits = &hits;
+  // A conjunction that stopped early may be up to date while operands below
+  // it are still stale, so we always walk up to the root.
+  for (auto j = x.parent; j != npos; j = nodes_[j].parent)
+    nodes_[j].stale = true;
+  return true;
+}
+
+const ids& ids_expression::evaluate() {
+  VAST_ASSERT(!nodes_.empty());
+  return evaluate(0);
+}
+
+const ids& ids_expression::evaluate(size_t i) {
+  auto& x = nodes_[i];
+  if (x.kind == node_kind::predicate)
+    return x.hits != nullptr ? *x.hits : x.result;
+  if (!x.stale)
+    return x.result;
+  switch (x.kind) {
+    default:
+      x.result = {};
+      break;
+    case node_kind::conjunction:
+      evaluate_conjunction(x);
+      break;
+    case node_kind::disjunction: {
+      std::vector<const ids*> operands;
+      operands.reserve(x.children.size());
+      for (auto child : x.children)
+        operands.push_back(&evaluate(child));
+      x.result = nary_or(operands);
+      break;
+    }
+    case node_kind::negation:
+      x.result = evaluate(x.children[0]);
+      x.result.flip();
+      break;
+  }
+  x.stale = false;
+  return x.result;
+}
+
+ids::size_type ids_expression::size(const node& x) const {
+  if (x.kind == node_kind::predicate)
+    return x.hits != nullptr ? x.hits->size() : 0;
+  ids::size_type result = 0;
+  for (auto child : x.children)
+    result = std::max(result, size(nodes_[child]));
+  return result;
+}
+
+void ids_expression::evaluate_conjunction(node& x) {
+  std::vector<const ids*> positive;
+  std::vector<const ids*> negative;
+  ids::size_type positive_size = 0;
+  auto negative_size = std::numeric_limits<ids::size_type>::max();
+  for (auto child : x.children) {
+    auto& y = nodes_[child];
+    if (y.kind == node_kind::negation) {
+      auto& operand = evaluate(y.children[0]);
+      negative_size = std::min(negative_size, operand.size());
+      negative.push_back(&operand);
+    } else {
+      auto& operand = evaluate(child);
+      // An operand without hits decides the conjunction, which leaves the
+      // remaining operands untouched until needed. The result still needs the
+      // size of a fully evaluated conjunction, because an enclosing negation
+      // flips all bits up to its size.
+      if (!any<1>(operand)) {
+        x.result = ids(size(x), false);
+        return;
+      }
+      positive_size = std::max(positive_size, operand.size());
+      positive.push_back(&operand);
+    }
+  }
+  if (negative.empty()) {
+    x.result = nary_and(positive);
+    return;
+  }
+  // Computing x & ~y as the difference x - y avoids materializing ~y. The
+  // complement only covers the size of its operand, so we clear everything
+  // beyond the shortest negated operand.
+  ids mask;
+  if (positive.empty() || positive_size > negative_size) {
+    mask = ids(negative_size, true);
+    positive.push_back(&mask);
+  }
+  auto lhs = nary_and(positive);
+  if (negative.size() == 1)
+    x.result = binary_nand(lhs, *negative[0]);
+  else
+    x.result = binary_nand(lhs, nary_or(negative));
+}
+
+} // namespace vast
@@ -0,0 +1,50 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/layout_registry.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/detail/narrow.hpp"
+
+namespace vast {
+
+layout_registry::id_type layout_registry::add(const record_type& layout) {
+  auto digest = to_digest(layout);
+  auto [first, last] = index_.equal_range(digest);
+  for (auto i = first; i != last; ++i)
+    if (layouts_[i->second] == layout)
+      return i->second;
+  auto result = detail::narrow_cast<id_type>(layouts_.size());
+  VAST_ASSERT(result == layouts_.size());
+  layouts_.push_back(layout);
+  index_.emplace(std::move(digest), result);
+  return result;
+}
+
+const record_type* layout_registry::find(id_type x) const {
+  return x < layouts_.size() ? &layouts_[x] : nullptr;
+}
+
+size_t layout_registry::size() const {
+  return layouts_.size();
+}
+
+bool operator==(const layout_registry& x, const layout_registry& y) {
+  return x.layouts_ == y.layouts_;
+}
+
+bool operator!=(const layout_registry& x, const layout_registry& y) {
+  return !(x == y);
+}
+
+} // namespace vast
@@ -13,12 +13,16 @@
 
 #include "vast/meta_index.hpp"
 
+#include <algorithm>
+#include <type_traits>
+
 #include "vast/data.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/detail/set_operations.hpp"
 #include "vast/detail/string.hpp"
 #include "vast/expression.hpp"
 #include "vast/logger.hpp"
+#include "vast/min_max_synopsis.hpp"
 #include "vast/synopsis_factory.hpp"
 #include "vast/system/atoms.hpp"
 #include "vast/table_slice.hpp"
@@ -26,11 +30,37 @@
 
 namespace vast {
 
+namespace {
+
+// Indexes the bounds of a column if all its synopses are min-max synopses
+// over T.
+template <class T, class Bounds>
+bool make_bounds(const std::vector<synopsis_ptr>& xs, Bounds& result) {
+  using index_type = detail::interval_index<T>;
+  std::vector<typename index_type::interval> intervals;
+  intervals.reserve(xs.size());
+  for (size_t i = 0; i < xs.size(); ++i) {
+    if (xs[i] == nullptr)
+      continue;
+    auto syn = dynamic_cast<const min_max_synopsis<T>*>(xs[i].get());
+    if (syn == nullptr)
+      return false;
+    intervals.push_back({syn->min(), syn->max(), i});
+  }
+  result = index_type{std::move(intervals)};
+  return true;
+}
+
+} // namespace <anonymous>
+
 void meta_index::add(const uuid& partition, const table_slice& slice) {
   auto& part_synopsis = partition_synopses_[partition];
   auto& layout = slice.layout();
-  if (blacklisted_layouts_.count(layout) == 1)
+  if (blacklisted_layouts_.count(layout) == 1) {
+    if (part_synopsis.empty())
+      make_opaque(partition);
     return;
+  }
   auto i = part_synopsis.find(layout);
   table_synopsis* table_syn;
   if (i != part_synopsis.end()) {
@@ -53,15 +83,44 @@ void meta_index::add(const uuid& partition, const table_slice& slice) {
       VAST_DEBUG(this, "could not create a synopsis for layout:", layout);
       blacklisted_layouts_.insert(layout);
     }
+    index_synopses(partition, layout, *table_syn);
+    make_transparent(partition);
   }
   VAST_ASSERT(table_syn->size() == slice.columns());
   for (size_t col = 0; col < slice.columns(); ++col)
     if (auto& syn = (*table_syn)[col])
-      for (size_t row = 0; row < slice.rows(); ++row) {
-        auto view = slice.at(row, col);
-        if (!caf::holds_alternative<caf::none_t>(view))
-          syn->add(std::move(view));
-      }
+      syn->add_column(slice, col);
+  // The bounds of the synopses may have changed, so we exclude them from the
+  // interval indexes until the next rebuild.
+  auto& layout_syn = layouts_[layout_ids_[layout]];
+  auto pos = layout_syn.positions[partition];
+  for (auto& col : layout_syn.columns)
+    if (pos < col.num_indexed && !col.is_stale[pos]) {
+      col.is_stale[pos] = true;
+      col.stale.push_back(pos);
+    }
+}
+
+void meta_index::add(const uuid& partition) {
+  if (partition_synopses_.try_emplace(partition).second)
+    make_opaque(partition);
+}
+
+void meta_index::merge(const uuid& partition, partition_synopsis synopses) {
+  auto& part_synopsis = partition_synopses_[partition];
+  for (auto& [layout, table_syn] : synopses) {
+    VAST_ASSERT(table_syn.size() == layout.fields.size());
+    auto [i, inserted] = part_synopsis.emplace(layout, std::move(table_syn));
+    if (!inserted) {
+      VAST_WARNING(this, "ignores synopses for a known layout:", layout);
+      continue;
+    }
+    index_synopses(partition, layout, i->second);
+  }
+  if (part_synopsis.empty())
+    make_opaque(partition);
+  else
+    make_transparent(partition);
 }
 
 std::vector<uuid> meta_index::lookup(const expression& expr) const {
@@ -70,16 +129,6 @@ std::vector<uuid> meta_index::lookup(const expression& expr) const {
   // overloads for inplace intersection/union and simplify the implementation
   // of this function a bit.
   using result_type = std::vector<uuid>;
-  auto all_partitions = [&] {
-    result_type result;
-    result.reserve(partition_synopses_.size());
-    std::transform(partition_synopses_.begin(),
-                   partition_synopses_.end(),
-                   std::back_inserter(result),
-                   [](auto& x) { return x.first; });
-    std::sort(result.begin(), result.end());
-    return result;
-  };
   return caf::visit(detail::overload(
     [&](const conjunction& x) -> result_type {
       VAST_ASSERT(!x.empty());
@@ -110,68 +159,11 @@ std::vector<uuid> meta_index::lookup(const expression& expr) const {
       return all_partitions();
     },
     [&](const predicate& x) -> result_type {
-      // Performs a lookup on all *matching* synopses with operator and data
-      // from the predicate of the expression. The match function uses a record
-      // field to determine whether the synopsis should be queried.
-      auto search = [&](auto match) {
-        VAST_ASSERT(caf::holds_alternative<data>(x.rhs));
-        auto& rhs = caf::get<data>(x.rhs);
-        result_type result;
-        auto found_matching_synopsis = false;
-        // We factor the nested loop into a lambda so that we can abort the
-        // iteration more easily with a return statement.
-        auto lookup = [&](auto& part_id, auto& part_syn) {
-          for (auto& [layout, table_syn] : part_syn)
-            for (size_t i = 0; i < table_syn.size(); ++i)
-              if (table_syn[i] && match(layout.fields[i])) {
-                found_matching_synopsis = true;
-                auto opt = table_syn[i]->lookup(x.op, make_view(rhs));
-                if (!opt || *opt) {
-                  result.push_back(part_id);
-                  return;
-                }
-              }
-        };
-        for (auto& [part_id, part_syn] : partition_synopses_)
-          lookup(part_id, part_syn);
-        std::sort(result.begin(), result.end());
-        return found_matching_synopsis ? result : all_partitions();
-      };
-      return caf::visit(detail::overload(
-        [&](const attribute_extractor& lhs, const data& d) -> result_type {
-          if (lhs.attr == system::time_atom::value) {
-            auto pred = [](auto& field) {
-              return has_attribute(field.type, "time");
-            };
-            return search(pred);
-          } else if (lhs.attr == system::type_atom::value) {
-            result_type result;
-            for (auto& [part_id, part_syn] : partition_synopses_)
-              for (auto& pair : part_syn)
-                if (evaluate(pair.first.name(), x.op, d)) {
-                  result.push_back(part_id);
-                  break;
-                }
-            return result;
-          }
-          VAST_WARNING(this, "cannot process attribute extractor:", lhs.attr);
-          return all_partitions();
-        },
-        [&](const key_extractor& lhs, const data&) -> result_type {
-          auto pred = [&](auto& field) {
-            return detail::ends_with(field.name, lhs.key);
-          };
-          return search(pred);
-        },
-        [&](const type_extractor& lhs, const data&) -> result_type {
-          auto pred = [&](auto& field) { return field.type == lhs.type; };
-          return search(pred);
-        },
-        [&](const auto&, const auto&) -> result_type {
-          VAST_WARNING(this, "cannot process predicate:", x);
-          return all_partitions();
-        }
-      ), x.lhs, x.rhs);
+      // Partitions without synopses are candidates for every predicate.
+      auto result = lookup(x);
+      if (!opaque_partitions_.empty())
+        detail::inplace_unify(result, opaque_partitions_);
+      return result;
     },
     [&](caf::none_t) -> result_type {
       VAST_ERROR(this, "received an empty expression");
@@ -181,16 +173,243 @@ std::vector<uuid> meta_index::lookup(const expression& expr) const {
   ), expr);
 }
 
+std::vector<uuid> meta_index::lookup(const predicate& x) const {
+  using result_type = std::vector<uuid>;
+  // Performs a lookup on all *matching* columns with operator and data
+  // from the predicate of the expression.
+  auto search = [&](const std::vector<column_id>& columns) {
+    VAST_ASSERT(caf::holds_alternative<data>(x.rhs));
+    if (columns.empty())
+      return all_partitions();
+    auto& rhs = caf::get<data>(x.rhs);
+    result_type result;
+    for (auto& col : columns)
+      lookup(col, x.op, make_view(rhs), result);
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+  };
+  // Selects the columns with synopses whose field satisfies a predicate.
+  auto select = [&](auto match) {
+    std::vector<column_id> result;
+    for (size_t i = 0; i < layouts_.size(); ++i) {
+      auto& layout_syn = layouts_[i];
+      for (size_t j = 0; j < layout_syn.columns.size(); ++j)
+        if (layout_syn.columns[j].synopses.front() != nullptr
+            && match(layout_syn.layout.fields[j]))
+          result.emplace_back(i, j);
+    }
+    return result;
+  };
+  return caf::visit(detail::overload(
+    [&](const attribute_extractor& lhs, const data& d) -> result_type {
+      if (lhs.attr == system::time_atom::value) {
+        auto pred = [](auto& field) {
+          return has_attribute(field.type, "time");
+        };
+        return search(select(pred));
+      } else if (lhs.attr == system::type_atom::value) {
+        result_type result;
+        for (auto& layout_syn : layouts_)
+          if (evaluate(layout_syn.layout.name(), x.op, d))
+            result.insert(result.end(), layout_syn.partitions.begin(),
+                          layout_syn.partitions.end());
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()),
+                     result.end());
+        return result;
+      }
+      VAST_WARNING(this, "cannot process attribute extractor:", lhs.attr);
+      return all_partitions();
+    },
+    [&](const key_extractor& lhs, const data&) -> result_type {
+      return search(resolve(lhs.key));
+    },
+    [&](const type_extractor& lhs, const data&) -> result_type {
+      auto pred = [&](auto& field) { return field.type == lhs.type; };
+      return search(select(pred));
+    },
+    [&](const auto&, const auto&) -> result_type {
+      VAST_WARNING(this, "cannot process predicate:", x);
+      return all_partitions();
+    }
+  ), x.lhs, x.rhs);
+}
+
 synopsis_options& meta_index::factory_options() {
   return synopsis_options_;
 }
 
+std::vector<uuid> meta_index::all_partitions() const {
+  std::vector<uuid> result;
+  result.reserve(partition_synopses_.size());
+  std::transform(partition_synopses_.begin(), partition_synopses_.end(),
+                 std::back_inserter(result),
+                 [](auto& x) { return x.first; });
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+void meta_index::make_opaque(const uuid& partition) {
+  auto i = std::lower_bound(opaque_partitions_.begin(),
+                            opaque_partitions_.end(), partition);
+  if (i == opaque_partitions_.end() || *i != partition)
+    opaque_partitions_.insert(i, partition);
+}
+
+void meta_index::make_transparent(const uuid& partition) {
+  auto i = std::lower_bound(opaque_partitions_.begin(),
+                            opaque_partitions_.end(), partition);
+  if (i != opaque_partitions_.end() && *i == partition)
+    opaque_partitions_.erase(i);
+}
+
+void meta_index::index_synopses(const uuid& partition,
+                                const record_type& layout,
+                                const table_synopsis& table_syn) {
+  auto [i, inserted] = layout_ids_.emplace(layout, layouts_.size());
+  if (inserted) {
+    auto& layout_syn = layouts_.emplace_back();
+    layout_syn.layout = layout;
+    layout_syn.columns.resize(table_syn.size());
+    key_columns_.clear();
+  }
+  auto& layout_syn = layouts_[i->second];
+  VAST_ASSERT(layout_syn.columns.size() == table_syn.size());
+  layout_syn.positions.emplace(partition, layout_syn.partitions.size());
+  layout_syn.partitions.push_back(partition);
+  for (size_t col = 0; col < table_syn.size(); ++col)
+    layout_syn.columns[col].synopses.push_back(table_syn[col]);
+}
+
+const std::vector<meta_index::column_id>&
+meta_index::resolve(const std::string& key) const {
+  if (auto i = key_columns_.find(key); i != key_columns_.end())
+    return i->second;
+  std::vector<column_id> result;
+  for (size_t i = 0; i < layouts_.size(); ++i) {
+    auto& layout_syn = layouts_[i];
+    for (size_t j = 0; j < layout_syn.columns.size(); ++j)
+      if (layout_syn.columns[j].synopses.front() != nullptr
+          && detail::ends_with(layout_syn.layout.fields[j].name, key))
+        result.emplace_back(i, j);
+  }
+  return key_columns_.emplace(key, std::move(result)).first->second;
+}
+
+void meta_index::lookup(const column_id& id, relational_operator op,
+                        data_view rhs, std::vector<uuid>& result) const {
+  auto& layout_syn = layouts_[id.first];
+  auto& col = layout_syn.columns[id.second];
+  auto& partitions = layout_syn.partitions;
+  auto check = [&](size_t pos) {
+    if (auto& syn = col.synopses[pos]) {
+      auto opt = syn->lookup(op, rhs);
+      if (!opt || *opt)
+        result.push_back(partitions[pos]);
+    }
+  };
+  auto scan = [&](size_t first) {
+    for (auto pos = first; pos < col.synopses.size(); ++pos)
+      check(pos);
+  };
+  // Only range and point queries can make use of the interval index.
+  switch (op) {
+    default:
+      scan(0);
+      return;
+    case equal:
+    case less:
+    case less_equal:
+    case greater:
+    case greater_equal:
+      if (!col.unbounded)
+        break;
+      scan(0);
+      return;
+  }
+  // (Re)build the interval index when the synopses outside of it would make
+  // up a significant fraction of the work.
+  auto n = col.synopses.size();
+  auto pending = col.stale.size() + (n - col.num_indexed);
+  if (caf::holds_alternative<caf::none_t>(col.bounds) || pending * 16 > n) {
+    col.bounds = caf::none;
+    col.num_indexed = 0;
+    col.stale.clear();
+    col.is_stale.clear();
+    auto& xs = col.synopses;
+    auto& bounds = col.bounds;
+    if (make_bounds<timestamp>(xs, bounds) || make_bounds<timespan>(xs, bounds)
+        || make_bounds<integer>(xs, bounds) || make_bounds<count>(xs, bounds)
+        || make_bounds<real>(xs, bounds)) {
+      col.num_indexed = n;
+      col.is_stale.resize(n, false);
+    } else {
+      col.unbounded = true;
+    }
+  }
+  auto f = detail::overload(
+    [&](caf::none_t) {
+      scan(0);
+    },
+    [&](const auto& bounds) {
+      using point_type = typename std::decay_t<decltype(bounds)>::point_type;
+      auto x = caf::get_if<view<point_type>>(&rhs);
+      if (x == nullptr) {
+        scan(0);
+        return;
+      }
+      auto emit = [&](size_t pos) {
+        if (!col.is_stale[pos])
+          result.push_back(partitions[pos]);
+      };
+      switch (op) {
+        default:
+          VAST_ASSERT(!"unsupported operator");
+          break;
+        case equal:
+          bounds.stab(*x, emit);
+          break;
+        case less:
+          bounds.min_below(*x, false, emit);
+          break;
+        case less_equal:
+          bounds.min_below(*x, true, emit);
+          break;
+        case greater:
+          bounds.max_above(*x, false, emit);
+          break;
+        case greater_equal:
+          bounds.max_above(*x, true, emit);
+          break;
+      }
+      for (auto pos : col.stale)
+        check(pos);
+      scan(col.num_indexed);
+    });
+  caf::visit(f, col.bounds);
+}
+
 caf::error inspect(caf::serializer& sink, const meta_index& x) {
   return sink(x.synopsis_options_, x.partition_synopses_);
 }
 
 caf::error inspect(caf::deserializer& source, meta_index& x) {
-  return source(x.synopsis_options_, x.partition_synopses_);
+  if (auto err = source(x.synopsis_options_, x.partition_synopses_))
+    return err;
+  // Restore the secondary structures.
+  x.opaque_partitions_.clear();
+  x.layouts_.clear();
+  x.layout_ids_.clear();
+  x.key_columns_.clear();
+  for (auto& [part_id, part_syn] : x.partition_synopses_) {
+    if (part_syn.empty())
+      x.opaque_partitions_.push_back(part_id);
+    for (auto& [layout, table_syn] : part_syn)
+      x.index_synopses(part_id, layout, table_syn);
+  }
+  std::sort(x.opaque_partitions_.begin(), x.opaque_partitions_.end());
+  return caf::none;
 }
 
 } // namespace vast
@@ -0,0 +1,50 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/min_max_synopsis.hpp"
+
+#include "vast/columnar_table_slice.hpp"
+
+namespace vast::detail {
+
+template <class T>
+bool update_min_max(const table_slice& slice, size_t col, T& min, T& max) {
+  if (slice.implementation_id() != columnar_table_slice::class_id)
+    return false;
+  auto& xs = static_cast<const columnar_table_slice&>(slice);
+  // We accumulate into locals, which the compiler can keep in registers.
+  auto lo = min;
+  auto hi = max;
+  auto update = [&](const T& x) {
+    if (x < lo)
+      lo = x;
+    if (x > hi)
+      hi = x;
+  };
+  if (!xs.for_each_value<T>(col, update))
+    return false;
+  min = lo;
+  max = hi;
+  return true;
+}
+
+template bool update_min_max(const table_slice&, size_t, integer&, integer&);
+template bool update_min_max(const table_slice&, size_t, count&, count&);
+template bool update_min_max(const table_slice&, size_t, real&, real&);
+template bool update_min_max(const table_slice&, size_t, timespan&,
+                             timespan&);
+template bool update_min_max(const table_slice&, size_t, timestamp&,
+                             timestamp&);
+
+} // namespace vast::detail
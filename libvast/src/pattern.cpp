@@ -11,10 +11,9 @@
  * contained in the LICENSE file.                                             *
  ******************************************************************************/
 
-#include <regex>
-
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/pattern.hpp"
+#include "vast/detail/regex.hpp"
 #include "vast/json.hpp"
 #include "vast/pattern.hpp"
 
@@ -22,21 +21,58 @@ namespace vast {
 
 pattern pattern::glob(std::string_view str) {
   std::string rx;
-  std::regex_replace(std::back_inserter(rx), str.begin(), str.end(),
-                     std::regex("\\."), "\\.");
-  rx = std::regex_replace(rx, std::regex("\\*"), ".*");
-  return pattern{std::regex_replace(rx, std::regex("\\?"), ".")};
+  rx.reserve(str.size() * 2);
+  for (auto c : str) {
+    switch (c) {
+      default:
+        rx += c;
+        break;
+      case '.':
+        rx += "\\.";
+        break;
+      case '*':
+        rx += ".*";
+        break;
+      case '?':
+        rx += '.';
+        break;
+    }
+  }
+  return pattern{std::move(rx)};
 }
 
 pattern::pattern(std::string str) : str_(std::move(str)) {
 }
 
+pattern::pattern(const pattern& other)
+  : str_{other.str_},
+    regex_{std::atomic_load(&other.regex_)} {
+  // nop
+}
+
+pattern& pattern::operator=(const pattern& other) {
+  str_ = other.str_;
+  regex_ = std::atomic_load(&other.regex_);
+  return *this;
+}
+
 bool pattern::match(std::string_view str) const {
-  return std::regex_match(str.begin(), str.end(), std::regex{str_});
+  return compiled()->match(str);
 }
 
 bool pattern::search(std::string_view str) const {
-  return std::regex_search(str.begin(), str.end(), std::regex{str_});
+  return compiled()->search(str);
+}
+
+std::shared_ptr<const detail::regex> pattern::compiled() const {
+  // Concurrent first uses may compile twice, but all of them agree on the
+  // result.
+  auto result = std::atomic_load(&regex_);
+  if (result == nullptr) {
+    result = std::make_shared<const detail::regex>(str_);
+    std::atomic_store(&regex_, result);
+  }
+  return result;
 }
 
 const std::string& pattern::string() const {
@@ -49,6 +85,7 @@ pattern& pattern::operator+=(const pattern& other) {
 
 pattern& pattern::operator+=(std::string_view other) {
   str_ += other;
+  regex_.reset();
   return *this;
 }
 
@@ -61,6 +98,7 @@ pattern& pattern::operator|=(std::string_view other) {
   str_ += ")|(";
   str_.append(other.begin(), other.end());
   str_ += ')';
+  regex_.reset();
   return *this;
 }
 
@@ -73,6 +111,7 @@ pattern& pattern::operator&=(std::string_view other) {
   str_ += ")(";
   str_.append(other.begin(), other.end());
   str_ += ')';
+  regex_.reset();
   return *this;
 }
 
@@ -0,0 +1,753 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/roaring_bitmap.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace vast {
+namespace {
+
+using container = roaring_bitmap::container;
+using block_type = roaring_bitmap::block_type;
+using size_type = roaring_bitmap::size_type;
+using word_type = roaring_bitmap::word_type;
+
+constexpr size_t words_per_container
+  = roaring_bitmap::container_bits / word_type::width;
+
+// -- container algorithms -----------------------------------------------------
+
+// Sets the bits [first, last] in a bitset.
+void set_range(std::vector<block_type>& words, uint32_t first,
+               uint32_t last) {
+  auto first_word = first / word_type::width;
+  auto last_word = last / word_type::width;
+  auto first_mask = word_type::all << (first % word_type::width);
+  auto last_mask = word_type::all >> (word_type::width - 1
+                                      - last % word_type::width);
+  if (first_word == last_word) {
+    words[first_word] |= first_mask & last_mask;
+    return;
+  }
+  words[first_word] |= first_mask;
+  for (auto i = first_word + 1; i < last_word; ++i)
+    words[i] = word_type::all;
+  words[last_word] |= last_mask;
+}
+
+// Finds the next position at or after *i* with bit value *bit* in a bitset.
+// Returns `roaring_bitmap::container_bits` if there is none.
+uint32_t find_next(const std::vector<block_type>& words, uint32_t i,
+                   bool bit) {
+  while (i < roaring_bitmap::container_bits) {
+    auto w = words[i / word_type::width];
+    if (!bit)
+      w = ~w;
+    w &= word_type::all << (i % word_type::width);
+    if (w != 0)
+      return (i / word_type::width) * word_type::width
+             + word_type::count_trailing_zeros(w);
+    i = (i / word_type::width + 1) * word_type::width;
+  }
+  return roaring_bitmap::container_bits;
+}
+
+// Invokes *f* with the first and last position of every run of 1-bits.
+template <class F>
+void for_each_run(const container& c, F f) {
+  switch (c.kind) {
+    case container::array: {
+      if (c.values.empty())
+        return;
+      uint32_t first = c.values.front();
+      uint32_t last = first;
+      for (auto i = c.values.begin() + 1; i != c.values.end(); ++i) {
+        if (*i != last + 1) {
+          f(first, last);
+          first = *i;
+        }
+        last = *i;
+      }
+      f(first, last);
+      break;
+    }
+    case container::dense: {
+      auto i = find_next(c.words, 0, true);
+      while (i < roaring_bitmap::container_bits) {
+        auto end = find_next(c.words, i, false);
+        f(i, end - 1);
+        i = find_next(c.words, end, true);
+      }
+      break;
+    }
+    case container::run:
+      for (size_t i = 0; i < c.values.size(); i += 2)
+        f(uint32_t{c.values[i]}, uint32_t{c.values[i + 1]});
+      break;
+  }
+}
+
+uint32_t count_runs(const container& c) {
+  switch (c.kind) {
+    default:
+      return static_cast<uint32_t>(c.values.size() / 2);
+    case container::array: {
+      if (c.values.empty())
+        return 0;
+      uint32_t result = 1;
+      for (size_t i = 1; i < c.values.size(); ++i)
+        if (c.values[i] != c.values[i - 1] + 1)
+          ++result;
+      return result;
+    }
+    case container::dense: {
+      // A run starts wherever a 1-bit follows a 0-bit.
+      uint32_t result = 0;
+      block_type carry = 0;
+      for (auto w : c.words) {
+        result += word_type::popcount(w & ~((w << 1) | carry));
+        carry = w >> (word_type::width - 1);
+      }
+      return result;
+    }
+  }
+}
+
+std::vector<block_type> to_words(const container& c) {
+  if (c.kind == container::dense)
+    return c.words;
+  std::vector<block_type> result(words_per_container);
+  for_each_run(c, [&](uint32_t first, uint32_t last) {
+    set_range(result, first, last);
+  });
+  return result;
+}
+
+void make_array(container& c) {
+  std::vector<uint16_t> values;
+  values.reserve(c.cardinality);
+  for_each_run(c, [&](uint32_t first, uint32_t last) {
+    for (auto i = first; i <= last; ++i)
+      values.push_back(static_cast<uint16_t>(i));
+  });
+  c.values = std::move(values);
+  c.words = {};
+  c.kind = container::array;
+}
+
+void make_dense(container& c) {
+  c.words = to_words(c);
+  c.values = {};
+  c.kind = container::dense;
+}
+
+void make_run(container& c) {
+  std::vector<uint16_t> values;
+  for_each_run(c, [&](uint32_t first, uint32_t last) {
+    values.push_back(static_cast<uint16_t>(first));
+    values.push_back(static_cast<uint16_t>(last));
+  });
+  c.values = std::move(values);
+  c.words = {};
+  c.kind = container::run;
+}
+
+// Converts a container into its smallest representation.
+void shrink(container& c) {
+  auto run_bytes = size_t{4} * count_runs(c);
+  auto dense_bytes = words_per_container * sizeof(block_type);
+  auto array_bytes = c.cardinality <= roaring_bitmap::max_array_size
+                       ? size_t{2} * c.cardinality
+                       : dense_bytes + 1;
+  if (run_bytes < std::min(array_bytes, dense_bytes)) {
+    if (c.kind != container::run)
+      make_run(c);
+  } else if (array_bytes <= dense_bytes) {
+    if (c.kind != container::array)
+      make_array(c);
+  } else if (c.kind != container::dense) {
+    make_dense(c);
+  }
+}
+
+// Constructs the smallest container from a bitset.
+container from_words(size_type key, std::vector<block_type> words) {
+  container result;
+  result.key = key;
+  result.kind = container::dense;
+  for (auto w : words)
+    result.cardinality += word_type::popcount(w);
+  result.words = std::move(words);
+  shrink(result);
+  return result;
+}
+
+bool contains(const container& c, uint16_t x) {
+  switch (c.kind) {
+    default: {
+      // Find the last run starting at or before x.
+      size_t lo = 0;
+      size_t hi = c.values.size() / 2;
+      while (lo < hi) {
+        auto mid = (lo + hi) / 2;
+        if (c.values[2 * mid] <= x)
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+      return lo > 0 && x <= c.values[2 * (lo - 1) + 1];
+    }
+    case container::array:
+      return std::binary_search(c.values.begin(), c.values.end(), x);
+    case container::dense:
+      return word_type::test(c.words[x / word_type::width],
+                             x % word_type::width);
+  }
+}
+
+// Appends a single 1-bit to a container.
+// @pre `x` is greater than all positions in `c`.
+void append_value(container& c, uint16_t x) {
+  switch (c.kind) {
+    case container::array:
+      c.values.push_back(x);
+      if (c.values.size() > roaring_bitmap::max_array_size)
+        make_dense(c);
+      break;
+    case container::dense:
+      c.words[x / word_type::width] |= word_type::mask(x % word_type::width);
+      break;
+    case container::run:
+      if (!c.values.empty() && c.values.back() + 1 == x)
+        c.values.back() = x;
+      else
+        c.values.insert(c.values.end(), {x, x});
+      break;
+  }
+  ++c.cardinality;
+}
+
+// Appends the 1-bits [first, last] to a container.
+// @pre `first` is greater than all positions in `c`.
+void append_range(container& c, uint16_t first, uint16_t last) {
+  uint32_t n = last - first + 1;
+  if (c.cardinality == 0 && n > 1)
+    c.kind = container::run;
+  if (c.kind == container::array) {
+    if (c.cardinality + n <= roaring_bitmap::max_array_size) {
+      for (uint32_t i = first; i <= last; ++i)
+        c.values.push_back(static_cast<uint16_t>(i));
+      c.cardinality += n;
+      return;
+    }
+    make_dense(c);
+  }
+  if (c.kind == container::dense) {
+    set_range(c.words, first, last);
+  } else if (!c.values.empty() && c.values.back() + 1 == first) {
+    c.values.back() = last;
+  } else {
+    c.values.insert(c.values.end(), {first, last});
+  }
+  c.cardinality += n;
+}
+
+// Computes the 1-based *i*-th 1-bit of a container.
+// @pre `i > 0 && i <= c.cardinality`
+uint32_t select_in(const container& c, uint32_t i) {
+  switch (c.kind) {
+    default: {
+      for (size_t j = 0; j < c.values.size(); j += 2) {
+        uint32_t length = c.values[j + 1] - c.values[j] + 1;
+        if (i <= length)
+          return c.values[j] + i - 1;
+        i -= length;
+      }
+      break;
+    }
+    case container::array:
+      return c.values[i - 1];
+    case container::dense:
+      for (size_t j = 0; j < c.words.size(); ++j) {
+        auto count = static_cast<uint32_t>(word_type::popcount(c.words[j]));
+        if (i <= count)
+          return static_cast<uint32_t>(j * word_type::width
+                                       + select<1>(c.words[j], i));
+        i -= count;
+      }
+      break;
+  }
+  VAST_ASSERT(!"select beyond cardinality");
+  return 0;
+}
+
+// Computes the number of 1-bits in a container at or before position *x*.
+uint32_t rank_in(const container& c, uint16_t x) {
+  switch (c.kind) {
+    default: {
+      uint32_t result = 0;
+      for (size_t j = 0; j < c.values.size() && c.values[j] <= x; j += 2)
+        result += std::min<uint32_t>(c.values[j + 1], x) - c.values[j] + 1;
+      return result;
+    }
+    case container::array:
+      return static_cast<uint32_t>(
+        std::upper_bound(c.values.begin(), c.values.end(), x)
+        - c.values.begin());
+    case container::dense: {
+      uint32_t result = 0;
+      auto last = x / word_type::width;
+      for (size_t j = 0; j < last; ++j)
+        result += word_type::popcount(c.words[j]);
+      return result + rank<1>(c.words[last], x % word_type::width);
+    }
+  }
+}
+
+// -- binary operations --------------------------------------------------------
+
+container filter_array(const container& array, const container& other,
+                       bool keep) {
+  container result;
+  result.key = array.key;
+  for (auto x : array.values)
+    if (contains(other, x) == keep)
+      result.values.push_back(x);
+  result.cardinality = static_cast<uint32_t>(result.values.size());
+  return result;
+}
+
+template <class Operation>
+container combine_words(const container& lhs, const container& rhs,
+                        Operation op) {
+  auto words = to_words(lhs);
+  if (rhs.kind == container::dense) {
+    for (size_t i = 0; i < words_per_container; ++i)
+      words[i] = op(words[i], rhs.words[i]);
+  } else {
+    auto other = to_words(rhs);
+    for (size_t i = 0; i < words_per_container; ++i)
+      words[i] = op(words[i], other[i]);
+  }
+  return from_words(lhs.key, std::move(words));
+}
+
+container intersect(const container& lhs, const container& rhs) {
+  if (lhs.kind == container::array && rhs.kind == container::array) {
+    container result;
+    result.key = lhs.key;
+    std::set_intersection(lhs.values.begin(), lhs.values.end(),
+                          rhs.values.begin(), rhs.values.end(),
+                          std::back_inserter(result.values));
+    result.cardinality = static_cast<uint32_t>(result.values.size());
+    return result;
+  }
+  if (lhs.kind == container::array)
+    return filter_array(lhs, rhs, true);
+  if (rhs.kind == container::array)
+    return filter_array(rhs, lhs, true);
+  return combine_words(lhs, rhs, [](auto x, auto y) { return x & y; });
+}
+
+container unite(const container& lhs, const container& rhs) {
+  if (lhs.kind == container::array && rhs.kind == container::array
+      && lhs.cardinality + rhs.cardinality <= roaring_bitmap::max_array_size) {
+    container result;
+    result.key = lhs.key;
+    std::set_union(lhs.values.begin(), lhs.values.end(), rhs.values.begin(),
+                   rhs.values.end(), std::back_inserter(result.values));
+    result.cardinality = static_cast<uint32_t>(result.values.size());
+    return result;
+  }
+  return combine_words(lhs, rhs, [](auto x, auto y) { return x | y; });
+}
+
+container subtract(const container& lhs, const container& rhs) {
+  if (lhs.kind == container::array)
+    return filter_array(lhs, rhs, false);
+  return combine_words(lhs, rhs, [](auto x, auto y) { return x & ~y; });
+}
+
+container symmetric_difference(const container& lhs, const container& rhs) {
+  if (lhs.kind == container::array && rhs.kind == container::array) {
+    container result;
+    result.key = lhs.key;
+    std::set_symmetric_difference(lhs.values.begin(), lhs.values.end(),
+                                  rhs.values.begin(), rhs.values.end(),
+                                  std::back_inserter(result.values));
+    result.cardinality = static_cast<uint32_t>(result.values.size());
+    if (result.cardinality > roaring_bitmap::max_array_size)
+      make_dense(result);
+    return result;
+  }
+  return combine_words(lhs, rhs, [](auto x, auto y) { return x ^ y; });
+}
+
+// Merges the containers of two bitmaps by key. The flags determine whether to
+// keep containers that exist only on one side.
+template <bool KeepLHS, bool KeepRHS, class Operation>
+std::vector<container> merge(const std::vector<container>& lhs,
+                             const std::vector<container>& rhs,
+                             Operation op) {
+  std::vector<container> result;
+  auto l = lhs.begin();
+  auto r = rhs.begin();
+  while (l != lhs.end() && r != rhs.end()) {
+    if (l->key < r->key) {
+      if constexpr (KeepLHS)
+        result.push_back(*l);
+      ++l;
+    } else if (r->key < l->key) {
+      if constexpr (KeepRHS)
+        result.push_back(*r);
+      ++r;
+    } else {
+      auto c = op(*l++, *r++);
+      if (c.cardinality > 0)
+        result.push_back(std::move(c));
+    }
+  }
+  if constexpr (KeepLHS)
+    result.insert(result.end(), l, lhs.end());
+  if constexpr (KeepRHS)
+    result.insert(result.end(), r, rhs.end());
+  return result;
+}
+
+} // namespace <anonymous>
+
+// -- roaring_bitmap -----------------------------------------------------------
+
+roaring_bitmap::roaring_bitmap(size_type n, bool bit) {
+  append_bits(bit, n);
+}
+
+bool roaring_bitmap::empty() const {
+  return num_bits_ == 0;
+}
+
+roaring_bitmap::size_type roaring_bitmap::size() const {
+  return num_bits_;
+}
+
+const std::vector<roaring_bitmap::container>&
+roaring_bitmap::containers() const {
+  return containers_;
+}
+
+bool roaring_bitmap::operator[](size_type i) const {
+  VAST_ASSERT(i < num_bits_);
+  auto key = i / container_bits;
+  auto pred = [](const container& c, size_type k) { return c.key < k; };
+  auto c = std::lower_bound(containers_.begin(), containers_.end(), key, pred);
+  return c != containers_.end() && c->key == key
+         && contains(*c, static_cast<uint16_t>(i % container_bits));
+}
+
+void roaring_bitmap::append_bit(bool bit) {
+  VAST_ASSERT(num_bits_ < max_size);
+  if (bit) {
+    auto& c = back(num_bits_ / container_bits);
+    append_value(c, static_cast<uint16_t>(num_bits_ % container_bits));
+  }
+  ++num_bits_;
+}
+
+void roaring_bitmap::append_bits(bool bit, size_type n) {
+  if (n == 0)
+    return;
+  VAST_ASSERT(max_size - num_bits_ >= n);
+  if (bit)
+    set_range(num_bits_, num_bits_ + n - 1);
+  num_bits_ += n;
+}
+
+void roaring_bitmap::append_block(block_type bits, size_type n) {
+  VAST_ASSERT(n <= word_type::width);
+  VAST_ASSERT(max_size - num_bits_ >= n);
+  if (n < word_type::width)
+    bits &= word_type::lsb_mask(n);
+  while (bits != 0) {
+    auto i = num_bits_ + word_type::count_trailing_zeros(bits);
+    append_value(back(i / container_bits),
+                 static_cast<uint16_t>(i % container_bits));
+    bits &= bits - 1;
+  }
+  num_bits_ += n;
+}
+
+void roaring_bitmap::flip() {
+  std::vector<container> result;
+  auto num_containers = (num_bits_ + container_bits - 1) / container_bits;
+  auto c = containers_.begin();
+  for (size_type key = 0; key < num_containers; ++key) {
+    auto bits = std::min(container_bits, num_bits_ - key * container_bits);
+    if (c == containers_.end() || c->key != key) {
+      container full;
+      full.key = key;
+      full.kind = container::run;
+      full.cardinality = static_cast<uint32_t>(bits);
+      full.values = {0, static_cast<uint16_t>(bits - 1)};
+      result.push_back(std::move(full));
+      continue;
+    }
+    auto words = to_words(*c++);
+    for (auto& w : words)
+      w = ~w;
+    // Clear the bits beyond the end of the bitmap in the last container.
+    if (bits < container_bits) {
+      auto last = bits / word_type::width;
+      if (bits % word_type::width != 0)
+        words[last++] &= word_type::lsb_mask(bits % word_type::width);
+      std::fill(words.begin() + last, words.end(), block_type{0});
+    }
+    auto flipped = from_words(key, std::move(words));
+    if (flipped.cardinality > 0)
+      result.push_back(std::move(flipped));
+  }
+  containers_ = std::move(result);
+}
+
+void roaring_bitmap::optimize() {
+  for (auto& c : containers_)
+    shrink(c);
+}
+
+roaring_bitmap& roaring_bitmap::operator&=(const roaring_bitmap& other) {
+  containers_ = merge<false, false>(containers_, other.containers_,
+                                    intersect);
+  num_bits_ = std::max(num_bits_, other.num_bits_);
+  return *this;
+}
+
+roaring_bitmap& roaring_bitmap::operator|=(const roaring_bitmap& other) {
+  containers_ = merge<true, true>(containers_, other.containers_, unite);
+  num_bits_ = std::max(num_bits_, other.num_bits_);
+  return *this;
+}
+
+roaring_bitmap& roaring_bitmap::operator^=(const roaring_bitmap& other) {
+  containers_ = merge<true, true>(containers_, other.containers_,
+                                  symmetric_difference);
+  num_bits_ = std::max(num_bits_, other.num_bits_);
+  return *this;
+}
+
+roaring_bitmap& roaring_bitmap::operator-=(const roaring_bitmap& other) {
+  containers_ = merge<true, false>(containers_, other.containers_, subtract);
+  num_bits_ = std::max(num_bits_, other.num_bits_);
+  return *this;
+}
+
+void roaring_bitmap::set_range(size_type first, size_type last) {
+  while (true) {
+    auto key = first / container_bits;
+    auto l = std::min(last, key * container_bits + container_bits - 1);
+    append_range(back(key), static_cast<uint16_t>(first % container_bits),
+                 static_cast<uint16_t>(l % container_bits));
+    if (l == last)
+      return;
+    first = l + 1;
+  }
+}
+
+roaring_bitmap::container& roaring_bitmap::back(size_type key) {
+  VAST_ASSERT(containers_.empty() || containers_.back().key <= key);
+  if (containers_.empty() || containers_.back().key != key) {
+    // The previous container is complete now.
+    if (!containers_.empty())
+      shrink(containers_.back());
+    containers_.emplace_back();
+    containers_.back().key = key;
+  }
+  return containers_.back();
+}
+
+bool operator==(const roaring_bitmap& x, const roaring_bitmap& y) {
+  if (x.num_bits_ != y.num_bits_
+      || x.containers_.size() != y.containers_.size())
+    return false;
+  // Equal bits may have different representations.
+  auto equal = [](const container& lhs, const container& rhs) {
+    if (lhs.key != rhs.key || lhs.cardinality != rhs.cardinality)
+      return false;
+    if (lhs.kind == rhs.kind)
+      return lhs.values == rhs.values && lhs.words == rhs.words;
+    return to_words(lhs) == to_words(rhs);
+  };
+  return std::equal(x.containers_.begin(), x.containers_.end(),
+                    y.containers_.begin(), equal);
+}
+
+roaring_bitmap binary_and(const roaring_bitmap& lhs,
+                          const roaring_bitmap& rhs) {
+  auto result = lhs;
+  result &= rhs;
+  return result;
+}
+
+roaring_bitmap binary_or(const roaring_bitmap& lhs,
+                         const roaring_bitmap& rhs) {
+  auto result = lhs;
+  result |= rhs;
+  return result;
+}
+
+roaring_bitmap binary_xor(const roaring_bitmap& lhs,
+                          const roaring_bitmap& rhs) {
+  auto result = lhs;
+  result ^= rhs;
+  return result;
+}
+
+roaring_bitmap binary_nand(const roaring_bitmap& lhs,
+                           const roaring_bitmap& rhs) {
+  auto result = lhs;
+  result -= rhs;
+  return result;
+}
+
+roaring_bitmap::size_type rank1(const roaring_bitmap& bm,
+                                roaring_bitmap::size_type i) {
+  auto& xs = bm.containers();
+  auto key = i / roaring_bitmap::container_bits;
+  auto pred = [](const container& c, size_type k) { return c.key < k; };
+  auto last = std::lower_bound(xs.begin(), xs.end(), key, pred);
+  size_type result = 0;
+  for (auto c = xs.begin(); c != last; ++c)
+    result += c->cardinality;
+  if (last != xs.end() && last->key == key)
+    result += rank_in(*last, static_cast<uint16_t>(
+                               i % roaring_bitmap::container_bits));
+  return result;
+}
+
+roaring_bitmap::size_type select1(const roaring_bitmap& bm,
+                                  roaring_bitmap::size_type i) {
+  VAST_ASSERT(i > 0);
+  auto& xs = bm.containers();
+  if (i == word_type::npos) {
+    if (xs.empty())
+      return word_type::npos;
+    auto& c = xs.back();
+    return c.key * roaring_bitmap::container_bits
+           + select_in(c, c.cardinality);
+  }
+  for (auto& c : xs) {
+    if (i <= c.cardinality)
+      return c.key * roaring_bitmap::container_bits
+             + select_in(c, static_cast<uint32_t>(i));
+    i -= c.cardinality;
+  }
+  return word_type::npos;
+}
+
+// -- roaring_bitmap_range -----------------------------------------------------
+
+roaring_bitmap_range::roaring_bitmap_range(const roaring_bitmap& bm)
+  : bm_{&bm},
+    done_{bm.empty()} {
+  if (!done_)
+    scan();
+}
+
+void roaring_bitmap_range::next() {
+  position_ += bits_.size();
+  done_ = position_ >= bm_->size();
+  if (!done_)
+    scan();
+}
+
+bool roaring_bitmap_range::done() const {
+  return done_;
+}
+
+void roaring_bitmap_range::scan() {
+  auto& xs = bm_->containers_;
+  auto end = bm_->size();
+  // Skip the container if we reached its end.
+  if (container_ < xs.size()) {
+    auto last = (xs[container_].key + 1) * roaring_bitmap::container_bits;
+    if (position_ >= last) {
+      ++container_;
+      cursor_ = 0;
+    }
+  }
+  // Emit 0-bits up to the next container.
+  if (container_ == xs.size()
+      || position_ < xs[container_].key * roaring_bitmap::container_bits) {
+    auto next = container_ == xs.size()
+                  ? end
+                  : xs[container_].key * roaring_bitmap::container_bits;
+    bits_ = {word_type::none, next - position_};
+    return;
+  }
+  auto& c = xs[container_];
+  auto base = c.key * roaring_bitmap::container_bits;
+  auto last = std::min(base + roaring_bitmap::container_bits, end);
+  auto offset = position_ - base;
+  switch (c.kind) {
+    case roaring_bitmap::container::run: {
+      if (cursor_ == c.values.size()) {
+        bits_ = {word_type::none, last - position_};
+      } else if (offset < c.values[cursor_]) {
+        bits_ = {word_type::none, c.values[cursor_] - offset};
+      } else {
+        auto run_end = std::min(base + c.values[cursor_ + 1] + 1, last);
+        bits_ = {word_type::all, run_end - position_};
+        cursor_ += 2;
+      }
+      break;
+    }
+    case roaring_bitmap::container::dense: {
+      // Coalesce homogeneous words into runs.
+      auto i = offset / word_type::width;
+      auto data = c.words[i];
+      auto n = std::min(word_type::width, last - position_);
+      if (word_type::all_or_none(data))
+        while (++i < words_per_container && c.words[i] == data
+               && position_ + n < last)
+          n = std::min(n + word_type::width, last - position_);
+      bits_ = {data, n};
+      break;
+    }
+    case roaring_bitmap::container::array: {
+      if (cursor_ == c.values.size()) {
+        bits_ = {word_type::none, last - position_};
+        break;
+      }
+      auto next = c.values[cursor_];
+      auto word_begin = offset / word_type::width * word_type::width;
+      if (next >= word_begin + word_type::width) {
+        // Skip words without 1-bits.
+        bits_ = {word_type::none,
+                 next / word_type::width * word_type::width - offset};
+        break;
+      }
+      block_type data = 0;
+      while (cursor_ < c.values.size()
+             && c.values[cursor_] < word_begin + word_type::width)
+        data |= word_type::mask(c.values[cursor_++] - word_begin);
+      bits_ = {data, std::min(word_type::width, last - position_)};
+      break;
+    }
+  }
+}
+
+roaring_bitmap_range bit_range(const roaring_bitmap& bm) {
+  return roaring_bitmap_range{bm};
+}
+
+} // namespace vast
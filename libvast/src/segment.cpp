@@ -14,36 +14,129 @@
 #include "vast/segment.hpp"
 
 #include <caf/binary_deserializer.hpp>
+#include <caf/deserializer.hpp>
+#include <caf/serializer.hpp>
 
 #include "vast/bitmap.hpp"
 #include "vast/bitmap_algorithms.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/detail/byte_swap.hpp"
 #include "vast/detail/narrow.hpp"
+#include "vast/error.hpp"
 #include "vast/ids.hpp"
 #include "vast/logger.hpp"
 #include "vast/si_literals.hpp"
 #include "vast/table_slice.hpp"
+#include "vast/table_slice_factory.hpp"
 
 namespace vast {
 
 using namespace binary_byte_literals;
 
+namespace {
+
+// The per-slice meta data of version 1 segments, which stored all table
+// slices uncompressed.
+struct table_slice_synopsis_v1 {
+  int64_t start;
+  int64_t end;
+  id offset;
+  uint64_t size;
+};
+
+template <class Inspector>
+auto inspect(Inspector& f, table_slice_synopsis_v1& x) {
+  return f(x.start, x.end, x.offset, x.size);
+}
+
+// The per-slice meta data of version 2 segments, which stored the layout with
+// every table slice.
+struct table_slice_synopsis_v2 {
+  int64_t start;
+  int64_t end;
+  id offset;
+  uint64_t size;
+  compression method;
+  uint64_t raw_size;
+};
+
+template <class Inspector>
+auto inspect(Inspector& f, table_slice_synopsis_v2& x) {
+  return f(x.start, x.end, x.offset, x.size, x.method, x.raw_size);
+}
+
+// Reads the meta data in the format of the given segment version.
+caf::error load_meta(caf::deserializer& source, segment_version_type version,
+                     segment::meta_data& x) {
+  if (version >= 3)
+    return source(x);
+  x = {};
+  if (version == 2) {
+    std::vector<table_slice_synopsis_v2> xs;
+    if (auto error = source(xs))
+      return error;
+    x.slices.reserve(xs.size());
+    for (auto& y : xs)
+      x.slices.push_back({y.start, y.end, y.offset, y.size, y.method,
+                          y.raw_size, 0});
+    return caf::none;
+  }
+  std::vector<table_slice_synopsis_v1> xs;
+  if (auto error = source(xs))
+    return error;
+  x.slices.reserve(xs.size());
+  for (auto& y : xs) {
+    auto raw_size = detail::narrow_cast<uint64_t>(y.end - y.start);
+    x.slices.push_back({y.start, y.end, y.offset, y.size, compression::null,
+                        raw_size, 0});
+  }
+  return caf::none;
+}
+
+// Writes the meta data in the format of the given segment version.
+caf::error save_meta(caf::serializer& sink, segment_version_type version,
+                     segment::meta_data& x) {
+  if (version >= 3)
+    return sink(x);
+  if (version == 2) {
+    std::vector<table_slice_synopsis_v2> xs;
+    xs.reserve(x.slices.size());
+    for (auto& y : x.slices)
+      xs.push_back({y.start, y.end, y.offset, y.size, y.method, y.raw_size});
+    return sink(xs);
+  }
+  std::vector<table_slice_synopsis_v1> xs;
+  xs.reserve(x.slices.size());
+  for (auto& y : x.slices) {
+    VAST_ASSERT(y.method == compression::null);
+    xs.push_back({y.start, y.end, y.offset, y.size});
+  }
+  return sink(xs);
+}
+
+} // namespace <anonymous>
+
 segment_ptr segment::make(chunk_ptr chunk) {
   VAST_ASSERT(chunk != nullptr);
   // Setup a CAF deserializer
   caf::binary_deserializer source{nullptr, chunk->data(), chunk->size()};
   auto result = segment_ptr{new segment, false};
-  if (auto error = source(result->header_, result->meta_)) {
-    VAST_ERROR_ANON(__func__, "failed to deserialize segment meta data");
+  if (auto error = source(result->header_)) {
+    VAST_ERROR_ANON(__func__, "failed to deserialize segment header");
     return nullptr;
   }
-  if (result->magic != magic) {
-    VAST_ERROR_ANON(__func__, "got invalid segment magic", result->magic);
+  if (result->header_.magic != magic) {
+    VAST_ERROR_ANON(__func__, "got invalid segment magic",
+                    result->header_.magic);
     return nullptr;
   }
-  if (result->version > version) {
-    VAST_ERROR_ANON(__func__, "got newer segment version", result->version);
+  if (result->header_.version > version) {
+    VAST_ERROR_ANON(__func__, "got newer segment version",
+                    result->header_.version);
+    return nullptr;
+  }
+  if (auto error = load_meta(source, result->header_.version, result->meta_)) {
+    VAST_ERROR_ANON(__func__, "failed to deserialize segment meta data");
     return nullptr;
   }
   // Skip meta data. Since the buffer following the chunk meta data was
@@ -91,23 +184,52 @@ segment::lookup(const ids& xs) const {
 
 caf::expected<table_slice_ptr>
 segment::make_slice(const table_slice_synopsis& slice) const {
-  auto slice_size = detail::narrow_cast<size_t>(slice.end - slice.start);
-  caf::binary_deserializer source{nullptr, chunk_->data() + slice.start,
-                                  slice_size};
-  table_slice_ptr result;
-  if (auto error = source(result))
-    return error;
+  // Hand out a view into the segment chunk to allow table slice
+  // implementations to access their data in place.
+  using detail::narrow_cast;
+  auto start = narrow_cast<size_t>(slice.start);
+  auto slice_size = narrow_cast<size_t>(slice.end - slice.start);
+  auto bytes = chunk_->slice(start, slice_size);
+  // Only uncompress the selected slice; uncompressed slices stay zero-copy.
+  if (slice.method != compression::null) {
+    auto raw = chunk::make(detail::narrow_cast<size_t>(slice.raw_size));
+    auto out = const_cast<char*>(raw->data()); // We own the fresh chunk.
+    if (!uncompress(slice.method, bytes->data(), bytes->size(), out,
+                    raw->size()))
+      return make_error(ec::format_error, "failed to uncompress table slice");
+    bytes = std::move(raw);
+  }
+  // Older versions store the layout with every slice.
+  if (header_.version < 3) {
+    auto result = factory<table_slice>::traits::make(std::move(bytes));
+    if (result == nullptr)
+      return make_error(ec::format_error, "failed to load table slice");
+    return result;
+  }
+  auto layout = meta_.layouts.find(slice.layout);
+  if (layout == nullptr)
+    return make_error(ec::format_error, "unknown table slice layout",
+                      slice.layout);
+  auto result = factory<table_slice>::traits::make(std::move(bytes), *layout);
+  if (result == nullptr)
+    return make_error(ec::format_error, "failed to load table slice");
   return result;
 }
 
 caf::error inspect(caf::serializer& sink, const segment_ptr& x) {
   VAST_ASSERT(x != nullptr);
-  return sink(x->header_, x->meta_, x->chunk_);
+  return caf::error::eval(
+    [&] { return sink(x->header_); },
+    [&] { return save_meta(sink, x->header_.version, x->meta_); },
+    [&] { return sink(x->chunk_); });
 }
 
 caf::error inspect(caf::deserializer& source, segment_ptr& x) {
   x.reset(new segment);
-  return source(x->header_, x->meta_, x->chunk_);
+  return caf::error::eval(
+    [&] { return source(x->header_); },
+    [&] { return load_meta(source, x->header_.version, x->meta_); },
+    [&] { return source(x->chunk_); });
 }
 
 ids flat_slice_ids(const segment::meta_data& x) {
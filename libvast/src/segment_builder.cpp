@@ -27,25 +27,30 @@
 
 namespace vast {
 
-segment_builder::segment_builder() {
+segment_builder::segment_builder(compression method) : method_{method} {
   reset();
 }
 
 caf::error segment_builder::add(table_slice_ptr x) {
   if (x->offset() < min_table_slice_offset_)
     return make_error(ec::unspecified, "slice offsets not increasing");
-  auto before = table_slice_buffer_.size();
-  caf::binary_serializer sink{nullptr, table_slice_buffer_};
-  if (auto error = sink(x)) {
-    table_slice_buffer_.resize(before);
+  // Serialize into a scratch buffer first and then compress the slice on its
+  // own, so that lookups only need to uncompress the slices they select. The
+  // meta data stores the layout once for all slices that share it.
+  auto layout = meta_.layouts.add(x->layout());
+  scratch_.clear();
+  caf::binary_serializer sink{nullptr, scratch_};
+  if (auto error = serialize_without_layout(sink, x))
     return error;
-  }
+  auto before = table_slice_buffer_.size();
+  auto method = compress(method_, scratch_.data(), scratch_.size(),
+                         table_slice_buffer_);
   auto after = table_slice_buffer_.size();
   VAST_ASSERT(before < after);
   meta_.slices.push_back({
     detail::narrow_cast<int64_t>(before),
     detail::narrow_cast<int64_t>(after),
-    x->offset(), x->rows()});
+    x->offset(), x->rows(), method, scratch_.size(), layout});
   min_table_slice_offset_ = x->offset() + x->rows();
   slices_.push_back(x);
   return caf::none;
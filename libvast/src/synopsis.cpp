@@ -20,9 +20,11 @@
 #include <caf/serializer.hpp>
 
 #include "vast/boolean_synopsis.hpp"
+#include "vast/detail/assert.hpp"
 #include "vast/error.hpp"
 #include "vast/logger.hpp"
 #include "vast/synopsis_factory.hpp"
+#include "vast/table_slice.hpp"
 #include "vast/timestamp_synopsis.hpp"
 
 #include "vast/detail/overload.hpp"
@@ -37,6 +39,15 @@ synopsis::~synopsis() {
   // nop
 }
 
+void synopsis::add_column(const table_slice& slice, size_t col) {
+  VAST_ASSERT(col < slice.columns());
+  for (size_t row = 0; row < slice.rows(); ++row) {
+    auto x = slice.at(row, col);
+    if (!caf::holds_alternative<caf::none_t>(x))
+      add(std::move(x));
+  }
+}
+
 const vast::type& synopsis::type() const {
   return type_;
 }
@@ -13,6 +13,8 @@
 
 #include "vast/synopsis_factory.hpp"
 
+#include "vast/arithmetic_synopsis.hpp"
+#include "vast/bloom_filter_synopsis.hpp"
 #include "vast/boolean_synopsis.hpp"
 #include "vast/timestamp_synopsis.hpp"
 
@@ -20,7 +22,15 @@ namespace vast {
 
 void factory_traits<synopsis>::initialize() {
   factory<synopsis>::add<boolean_type, boolean_synopsis>();
+  factory<synopsis>::add<integer_type, arithmetic_synopsis<integer>>();
+  factory<synopsis>::add<count_type, arithmetic_synopsis<count>>();
+  factory<synopsis>::add<real_type, arithmetic_synopsis<real>>();
+  factory<synopsis>::add<timespan_type, arithmetic_synopsis<timespan>>();
   factory<synopsis>::add<timestamp_type, timestamp_synopsis>();
+  factory<synopsis>::add<string_type, bloom_filter_synopsis>();
+  factory<synopsis>::add<address_type, bloom_filter_synopsis>();
+  factory<synopsis>::add<subnet_type, bloom_filter_synopsis>();
+  factory<synopsis>::add<port_type, bloom_filter_synopsis>();
 }
 
 } // namespace vast
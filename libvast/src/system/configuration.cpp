@@ -72,7 +72,11 @@ configuration::configuration() {
 #endif
   opt_group{custom_options_, "system"}
     .add<size_t>("table-slice-size",
-                 "maximum size for sources that generate table slices");
+                 "maximum size for sources that generate table slices")
+    .add<caf::atom_value>("index-routing",
+                          "policy for distributing slices over INDEX actors")
+    .add<caf::atom_value>("index-evaluation",
+                          "strategy for evaluating queries on partitions");
   initialize_factories<synopsis, table_slice, table_slice_builder,
                        value_index>();
 }
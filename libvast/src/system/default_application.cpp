@@ -58,6 +58,8 @@ default_application::default_application() {
                    .add<std::string>("endpoint,e", "node endpoint")
                    .add<std::string>("node-id,i", "the unique ID of this node")
                    .add<bool>("disable-accounting", "don't run the accountant")
+                   .add<size_t>("index-shards",
+                                "number of INDEX actors per node")
                    .finish();
   // Add standalone commands.
   add(version_command, "version", "prints the software version", opts());
@@ -78,7 +80,9 @@ default_application::default_application() {
                   .add<bool>("blocking,b",
                              "block until the IMPORTER forwarded all data")
                   .add<size_t>("max-events,n",
-                               "the maximum number of events to import"));
+                               "the maximum number of events to import")
+                  .add<size_t>("jobs,j",
+                               "the number of inputs to read in parallel"));
   import_->add(READER(zeek), "imports Zeek logs from STDIN or file",
                src_opts("?import.zeek"));
   import_->add(READER(mrt), "imports MRT logs from STDIN or file",
@@ -24,70 +24,13 @@
 
 namespace vast::system {
 
-namespace {
-
-/// Concatenates IDs according to given predicates. In paticular, resolves
-/// conjunctions, disjunctions, and negations.
-class ids_evaluator {
-public:
-  ids_evaluator(const evaluator_state::predicate_hits_map& xs) : hits_(xs) {
-    push();
-  }
-
-  ids operator()(caf::none_t) {
-    return {};
-  }
-
-  template <class Connective>
-  ids operator()(const Connective& xs) {
-    VAST_ASSERT(xs.size() > 0);
-    push();
-    auto result = caf::visit(*this, xs[0]);
-    for (size_t index = 1; index < xs.size(); ++index) {
-      next();
-      if constexpr (std::is_same_v<Connective, conjunction>) {
-        result &= caf::visit(*this, xs[index]);
-      } else {
-        static_assert(std::is_same_v<Connective, disjunction>);
-        result |= caf::visit(*this, xs[index]);
-      }
-    }
-    pop();
-    return result;
-  }
-
-  ids operator()(const negation& n) {
-    push();
-    auto result = caf::visit(*this, n.expr());
-    pop();
-    result.flip();
-    return result;
-  }
-
-  ids operator()(const predicate&) {
-    auto i = hits_.find(position_);
-    return i != hits_.end() ? i->second.second : ids{};
-  }
-
-private:
-  void push() {
-    position_.emplace_back(0);
-  }
-
-  void pop() {
-    position_.pop_back();
-  }
-
-  void next() {
-    VAST_ASSERT(!position_.empty());
-    ++position_.back();
-  }
-
-  const evaluator_state::predicate_hits_map& hits_;
-  offset position_;
-};
-
-} // namespace
+ids evaluate(const expression& expr,
+             const evaluator_state::predicate_hits_map& hits) {
+  ids_expression tree{expr};
+  for (auto& [position, entry] : hits)
+    tree.bind(position, entry.second);
+  return tree.evaluate();
+}
 
 evaluator_state::evaluator_state(caf::event_based_actor* self) : self(self) {
   // nop
@@ -98,6 +41,7 @@ void evaluator_state::init(caf::actor client, expression expr,
   VAST_TRACE(VAST_ARG(client), VAST_ARG(expr), VAST_ARG(promise));
   this->client = std::move(client);
   this->expr = std::move(expr);
+  tree = ids_expression{this->expr};
   this->promise = std::move(promise);
 }
 
@@ -108,6 +52,7 @@ void evaluator_state::handle_result(const offset& position, const ids& result) {
   VAST_ASSERT(ptr != nullptr);
   auto& [missing, accumulated_hits] = *ptr;
   accumulated_hits |= result;
+  tree.bind(position, accumulated_hits);
   if (--missing == 0) {
     VAST_DEBUG(self, "collected all INDEXER results at position", position);
     evaluate();
@@ -130,9 +75,10 @@ void evaluator_state::handle_missing_result(const offset& position,
 }
 
 void evaluator_state::evaluate() {
+  auto& expr_hits = tree.evaluate();
   VAST_DEBUG(self, "got predicate_hits:", predicate_hits,
-             "expr_hits:", caf::visit(ids_evaluator{predicate_hits}, expr));
-  auto delta = caf::visit(ids_evaluator{predicate_hits}, expr) - hits;
+             "expr_hits:", expr_hits);
+  auto delta = expr_hits - hits;
   if (any<1>(delta)) {
     hits |= delta;
     self->send(client, std::move(delta));
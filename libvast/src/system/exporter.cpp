@@ -11,6 +11,9 @@
  * contained in the LICENSE file.                                             *
  ******************************************************************************/
 
+#include <algorithm>
+#include <cmath>
+
 #include <caf/all.hpp>
 
 #include "vast/concept/printable/std/chrono.hpp"
@@ -19,17 +22,18 @@
 #include "vast/concept/printable/vast/event.hpp"
 #include "vast/concept/printable/vast/expression.hpp"
 #include "vast/concept/printable/vast/uuid.hpp"
+#include "vast/defaults.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/detail/fill_status_map.hpp"
 #include "vast/detail/narrow.hpp"
+#include "vast/error.hpp"
 #include "vast/event.hpp"
-#include "vast/expression_visitors.hpp"
 #include "vast/logger.hpp"
 #include "vast/system/archive.hpp"
 #include "vast/system/atoms.hpp"
 #include "vast/system/exporter.hpp"
 #include "vast/table_slice.hpp"
-#include "vast/to_events.hpp"
+#include "vast/table_slice_filter.hpp"
 
 using namespace std::chrono;
 using namespace std::string_literals;
@@ -42,29 +46,30 @@ namespace {
 
 void ship_results(stateful_actor<exporter_state>* self) {
   VAST_TRACE("");
-  if (self->state.results.empty() || self->state.query.requested == 0) {
+  auto& st = self->state;
+  if (st.results.empty() || st.query.requested == 0) {
     return;
   }
-  VAST_DEBUG(self, "relays", self->state.results.size(), "events");
-  message msg;
-  if (self->state.results.size() <= self->state.query.requested) {
-    self->state.query.requested -= self->state.results.size();
-    self->state.query.shipped += self->state.results.size();
-    msg = make_message(std::move(self->state.results));
-    self->state.results = {};
-  } else {
-    std::vector<event> remainder;
-    remainder.reserve(self->state.results.size() - self->state.query.requested);
-    auto begin = self->state.results.begin() + self->state.query.requested;
-    auto end = self->state.results.end();
-    std::move(begin, end, std::back_inserter(remainder));
-    self->state.results.resize(self->state.query.requested);
-    msg = make_message(std::move(self->state.results));
-    self->state.results = std::move(remainder);
-    self->state.query.shipped += self->state.query.requested;
-    self->state.query.requested = 0;
+  VAST_DEBUG(self, "relays", std::min(st.num_results, st.query.requested),
+             "events");
+  while (!st.results.empty() && st.query.requested > 0) {
+    auto& [slice, selection] = st.results.front();
+    auto n = rank(selection);
+    if (n > st.query.requested) {
+      // Ship only the first rows and keep the remainder for later.
+      auto head = selection & ids(select(selection, st.query.requested) + 1,
+                                  true);
+      selection -= head;
+      self->send(st.sink, slice, std::move(head));
+      n = st.query.requested;
+    } else {
+      self->send(st.sink, std::move(slice), std::move(selection));
+      st.results.pop_front();
+    }
+    st.query.requested -= n;
+    st.query.shipped += n;
+    st.num_results -= n;
   }
-  self->send(self->state.sink, msg);
 }
 
 void report_statistics(stateful_actor<exporter_state>* self) {
@@ -79,7 +84,7 @@ void report_statistics(stateful_actor<exporter_state>* self) {
     auto hits = rank(st.hits);
     auto processed = st.query.processed;
     auto shipped = st.query.shipped;
-    auto results = shipped + st.results.size();
+    auto results = shipped + st.num_results;
     auto selectivity = double(results) / processed;
     auto msg = report{{"exporter.hits", hits},
                       {"exporter.processed", processed},
@@ -103,6 +108,30 @@ void shutdown(stateful_actor<exporter_state>* self) {
   self->send_exit(self, exit_reason::normal);
 }
 
+// Sizes the next request to the INDEX by the observed per-partition latency
+// and the number of results the client still demands.
+size_t partitions_per_request(const exporter_state& st, size_t remaining) {
+  namespace defs = defaults::export_;
+  auto limit = std::min(remaining, defs::max_partitions_per_request);
+  // Start small until we measured how long the INDEX takes per partition.
+  if (st.partition_latency == timespan::zero())
+    return std::min(limit, defs::initial_partitions);
+  // Schedule as many partitions as the INDEX processes within the target
+  // latency.
+  auto n = static_cast<size_t>(defs::target_request_latency
+                               / st.partition_latency);
+  // Avoid scheduling far more partitions than necessary for satisfying the
+  // client, based on the number of results per partition so far.
+  auto results = st.query.shipped + st.num_results;
+  if (st.query.requested != max_events && st.query.received > 0
+      && results > 0) {
+    auto per_partition = static_cast<double>(results) / st.query.received;
+    auto needed = std::ceil(st.query.requested / per_partition);
+    n = std::min(n, static_cast<size_t>(needed));
+  }
+  return std::clamp(n, size_t{1}, limit);
+}
+
 void request_more_hits(stateful_actor<exporter_state>* self) {
   auto& st = self->state;
   // Sanity check.
@@ -116,6 +145,12 @@ void request_more_hits(stateful_actor<exporter_state>* self) {
                "results and waits for client to request more");
     return;
   }
+  // Do nothing if INDEX actors still process previously scheduled partitions.
+  if (st.pending_batches > 0) {
+    VAST_DEBUG(self, "currently awaits", st.pending_batches,
+               "more batches from the index");
+    return;
+  }
   // Do nothing if we are still waiting for results from the ARCHIVE.
   if (st.query.lookups_issued > st.query.lookups_complete) {
     VAST_DEBUG(self, "currently awaits",
@@ -136,15 +171,25 @@ void request_more_hits(stateful_actor<exporter_state>* self) {
   // hits by the INDEX.
   VAST_ASSERT(st.query.received < st.query.expected);
   auto remaining = st.query.expected - st.query.received;
-  // TODO: Figure out right number of partitions to ask for. For now, we
-  // bound the number by an arbitrary constant.
-  auto n = std::min(remaining, size_t{2});
+  auto n = partitions_per_request(st, remaining);
   // Store how many partitions we schedule with our request. When receiving
-  // 'done', we add this number to `received`.
+  // 'done' from all INDEX actors, we add this number to `received`.
   st.query.scheduled = n;
-  // Request more hits from the INDEX.
+  // Request more hits from the INDEX actors with remaining partitions.
   VAST_DEBUG(self, "asks index to process", n, "more partitions");
-  self->send(st.index, st.id, detail::narrow<uint32_t>(n));
+  for (auto& lookup : st.lookups) {
+    if (n == 0)
+      break;
+    if (lookup.remaining == 0)
+      continue;
+    auto k = std::min(lookup.remaining, n);
+    lookup.remaining -= k;
+    n -= k;
+    ++st.pending_batches;
+    self->send(lookup.index, lookup.id, detail::narrow<uint32_t>(k));
+  }
+  VAST_ASSERT(n == 0);
+  st.last_request = steady_clock::now();
 }
 
 } // namespace <anonymous>
@@ -173,7 +218,8 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
   self->set_exit_handler(
     [=](const exit_msg& msg) {
       VAST_DEBUG(self, "received exit from", msg.source, "with reason:", msg.reason);
-      self->send<message_priority::high>(self->state.index, self->state.id, 0);
+      for (auto& lookup : self->state.lookups)
+        self->send<message_priority::high>(lookup.index, lookup.id, 0);
       self->send(self->state.sink, sys_atom::value, delete_atom::value);
       self->send_exit(self->state.sink, msg.reason);
       self->quit(msg.reason);
@@ -184,9 +230,11 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
   self->set_down_handler(
     [=](const down_msg& msg) {
       VAST_DEBUG(self, "received DOWN from", msg.source);
+      auto& indexes = self->state.indexes;
+      auto is_index = std::any_of(indexes.begin(), indexes.end(),
+                                  [&](auto& x) { return x == msg.source; });
       if (has_continuous_option(self->state.options)
-          && (msg.source == self->state.archive
-              || msg.source == self->state.index))
+          && (msg.source == self->state.archive || is_index))
         report_statistics(self);
     }
   );
@@ -194,32 +242,42 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
     return qs.received == qs.expected
            && qs.lookups_issued == qs.lookups_complete;
   };
-  auto handle_batch = [=](std::vector<event> candidates) {
+  auto handle_batch = [=](const table_slice_ptr& slice,
+                          const ids& candidates) {
     auto& st = self->state;
-    VAST_DEBUG(self, "got batch of", candidates.size(), "events");
-    auto sender = self->current_sender();
-    for (auto& candidate : candidates) {
-      auto& checker = st.checkers[candidate.type()];
-      // Construct a candidate checker if we don't have one for this type.
-      if (caf::holds_alternative<caf::none_t>(checker)) {
-        auto x = tailor(st.expr, candidate.type());
-        if (!x) {
-          VAST_ERROR(self, "failed to tailor expression:",
-                     self->system().render(x.error()));
-          ship_results(self);
-          self->send_exit(self, exit_reason::normal);
-          return;
-        }
-        checker = std::move(*x);
-        VAST_DEBUG(self, "tailored AST to", candidate.type() << ':', checker);
+    // Restrict the candidates to the rows of the slice.
+    ids rows{slice->offset(), false};
+    rows.append_bits(true, slice->rows());
+    auto xs = candidates & rows;
+    auto n = rank(xs);
+    VAST_DEBUG(self, "got batch of", n, "candidates");
+    if (n == 0)
+      return;
+    // Construct a candidate checker if we don't have one for this layout.
+    auto layout = type{slice->layout()};
+    auto i = st.checkers.find(layout);
+    if (i == st.checkers.end()) {
+      auto x = table_slice_filter::make(st.expr, slice->layout());
+      if (!x) {
+        VAST_ERROR(self, "failed to tailor expression:",
+                   self->system().render(x.error()));
+        ship_results(self);
+        self->send_exit(self, exit_reason::normal);
+        return;
       }
-      // Perform candidate check and keep event as result on success.
-      if (caf::visit(event_evaluator{candidate}, checker))
-        st.results.push_back(std::move(candidate));
-      else
-        VAST_DEBUG(self, "ignores false positive:", candidate);
+      VAST_DEBUG(self, "tailored AST to", layout << ':', x->expr());
+      i = st.checkers.emplace(std::move(layout), std::move(*x)).first;
     }
-    st.query.processed += candidates.size();
+    // Perform the candidate check column by column and keep the slice along
+    // with the rows that fulfill the expression.
+    auto selection = i->second(*slice, xs);
+    auto k = rank(selection);
+    VAST_DEBUG(self, "ignores", n - k, "false positives");
+    if (k > 0) {
+      st.results.emplace_back(slice, std::move(selection));
+      st.num_results += k;
+    }
+    st.query.processed += n;
     ship_results(self);
   };
   return {
@@ -257,7 +315,7 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
       return caf::unit;
     },
     [=](table_slice_ptr slice) {
-      handle_batch(to_events(*slice, self->state.hits));
+      handle_batch(slice, self->state.hits);
     },
     [=](done_atom) -> caf::result<void> {
       auto& st = self->state;
@@ -266,10 +324,28 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
       // Otherwise, we can end up in weirdly interleaved state.
       if (qs.lookups_issued != qs.lookups_complete)
         return caf::skip;
+      // Ignore this message until all INDEX actors responded to our query,
+      // since an INDEX without candidates sends 'done' before its response.
+      if (st.pending_responses > 0)
+        return caf::skip;
+      // Wait until all INDEX actors processed the scheduled partitions.
+      if (st.pending_batches > 0 && --st.pending_batches > 0)
+        return caf::unit;
       // Figure out if we're done by bumping the counter for `received` and
       // check whether it reaches `expected`.
-      timespan runtime = steady_clock::now() - st.start;
+      auto now = steady_clock::now();
+      timespan runtime = now - st.start;
       qs.runtime = runtime;
+      // Update the moving average of the per-partition latency, which
+      // determines the size of subsequent requests.
+      if (qs.scheduled > 0) {
+        auto elapsed = duration_cast<timespan>(now - st.last_request);
+        auto latency = elapsed / static_cast<timespan::rep>(qs.scheduled);
+        st.partition_latency
+          = st.partition_latency == timespan::zero()
+              ? latency
+              : (3 * st.partition_latency + latency) / 4;
+      }
       qs.received += qs.scheduled;
       if (qs.received < qs.expected) {
         VAST_DEBUG(self, "received hits from", qs.received, '/', qs.expected,
@@ -350,7 +426,7 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
     },
     [=](index_atom, const actor& index) {
       VAST_DEBUG(self, "registers index", index);
-      self->state.index = index;
+      self->state.indexes.emplace_back(index);
       if (has_continuous_option(self->state.options))
         self->monitor(index);
     },
@@ -370,22 +446,38 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
       self->state.start = steady_clock::now();
       if (!has_historical_option(self->state.options))
         return;
-      self->request(self->state.index, infinite, self->state.expr).then(
-        [=](const uuid& lookup, uint32_t partitions, uint32_t scheduled) {
-          VAST_DEBUG(self, "got lookup handle", lookup << ", scheduled",
-                     scheduled << '/' << partitions, "partitions");
-          self->state.id = lookup;
-          if (partitions > 0) {
-            self->state.query.expected = partitions;
-            self->state.query.scheduled = scheduled;
-          } else {
-            shutdown(self);
+      auto& st = self->state;
+      if (st.indexes.empty()) {
+        shutdown(self, make_error(ec::unspecified, "no index registered"));
+        return;
+      }
+      // Fan out the query to all INDEX actors and merge their responses into
+      // a single logical query.
+      st.id = uuid::random();
+      st.last_request = st.start;
+      st.pending_responses = st.indexes.size();
+      for (auto& index : st.indexes) {
+        self->request(index, infinite, st.expr).then(
+          [=](const uuid& lookup, uint32_t partitions, uint32_t scheduled) {
+            VAST_DEBUG(self, "got lookup handle", lookup << ", scheduled",
+                       scheduled << '/' << partitions, "partitions");
+            auto& st = self->state;
+            // Each response entails a 'done' once the taste completes.
+            --st.pending_responses;
+            ++st.pending_batches;
+            if (partitions > 0) {
+              st.query.expected += partitions;
+              st.query.scheduled += scheduled;
+              st.lookups.push_back({index, lookup, partitions - scheduled});
+            }
+            if (st.pending_responses == 0 && st.query.expected == 0)
+              shutdown(self);
+          },
+          [=](const error& e) {
+            shutdown(self, e);
           }
-        },
-        [=](const error& e) {
-          shutdown(self, e);
-        }
-      );
+        );
+      }
     },
     [=](caf::stream<table_slice_ptr> in) {
       return self->make_sink(
@@ -394,9 +486,10 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
           // nop
         },
         [=](caf::unit_t&, const table_slice_ptr& slice) {
-          // TODO: port to new table slice API
-          auto candidates = to_events(*slice);
-          handle_batch(std::move(candidates));
+          // Without an INDEX, every row of a continuous query is a candidate.
+          ids candidates{slice->offset(), false};
+          candidates.append_bits(true, slice->rows());
+          handle_batch(slice, candidates);
         },
         [=](caf::unit_t&, const error& err) {
           VAST_IGNORE_UNUSED(err);
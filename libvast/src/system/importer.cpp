@@ -13,7 +13,9 @@
 
 #include "vast/system/importer.hpp"
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
 
 #include <caf/config_value.hpp>
 #include <caf/dictionary.hpp>
@@ -23,6 +25,7 @@
 #include "vast/concept/printable/vast/filesystem.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/fill_status_map.hpp"
+#include "vast/detail/narrow.hpp"
 #include "vast/detail/notifying_stream_manager.hpp"
 #include "vast/logger.hpp"
 #include "vast/system/atoms.hpp"
@@ -34,6 +37,60 @@ using namespace caf;
 
 namespace vast::system {
 
+bool importer_stage_selector::operator()(const importer_stage_filter& f,
+                                         const table_slice_ptr& x) const {
+  if (f.num_shards == 0)
+    return true;
+  size_t n = 0;
+  switch (f.routing) {
+    case index_routing::round_robin:
+      n = x->offset() / f.block_size;
+      break;
+    case index_routing::layout:
+      n = std::hash<std::string>{}(x->layout().name());
+      break;
+  }
+  return n % f.num_shards == f.shard;
+}
+
+namespace {
+
+struct flush_relay_state {
+  std::vector<caf::actor> pending;
+  static inline const char* name = "flush-relay";
+};
+
+// Waits for a 'flush' from every INDEX actor before notifying the listener
+// exactly once. A terminated INDEX counts as flushed.
+behavior flush_relay(stateful_actor<flush_relay_state>* self, actor listener,
+                     std::vector<actor> indexes) {
+  auto done = [=](const actor_addr& x) {
+    auto& pending = self->state.pending;
+    auto i = std::find(pending.begin(), pending.end(), x);
+    if (i == pending.end())
+      return;
+    pending.erase(i);
+    if (pending.empty()) {
+      self->send(listener, flush_atom::value);
+      self->quit();
+    }
+  };
+  self->set_down_handler([=](const down_msg& msg) { done(msg.source); });
+  for (auto& index : indexes) {
+    self->monitor(index);
+    self->send(index, subscribe_atom::value, flush_atom::value,
+               actor_cast<actor>(self));
+  }
+  self->state.pending = std::move(indexes);
+  return {
+    [=](flush_atom) {
+      done(actor_cast<actor_addr>(self->current_sender()));
+    }
+  };
+}
+
+} // namespace <anonymous>
+
 importer_state::importer_state(event_based_actor* self_ptr) : self(self_ptr) {
   // nop
 }
@@ -139,12 +196,40 @@ void importer_state::send_report() {
 void importer_state::notify_flush_listeners() {
   VAST_DEBUG(self, "forwards 'flush' subscribers to", index_actors.size(),
              "INDEX actors");
-  for (auto& listener : flush_listeners)
-    for (auto& next : index_actors)
-      self->send(next, subscribe_atom::value, flush_atom::value, listener);
+  for (auto& listener : flush_listeners) {
+    switch (index_actors.size()) {
+      case 0:
+        self->send(listener, flush_atom::value);
+        break;
+      case 1:
+        self->send(index_actors.front(), subscribe_atom::value,
+                   flush_atom::value, listener);
+        break;
+      default:
+        self->spawn(flush_relay, listener, index_actors);
+    }
+  }
   flush_listeners.clear();
 }
 
+caf::outbound_stream_slot<importer_state::output_type>
+importer_state::add_index(caf::actor index) {
+  auto result = stg->add_outbound_path(index);
+  index_actors.emplace_back(std::move(index));
+  index_slots.emplace_back(result.value());
+  // Assign each INDEX actor its own shard of the stream.
+  auto num_shards = detail::narrow_cast<uint32_t>(index_slots.size());
+  for (uint32_t i = 0; i < num_shards; ++i) {
+    importer_stage_filter f;
+    f.shard = i;
+    f.num_shards = num_shards;
+    f.block_size = detail::narrow_cast<uint32_t>(max_table_slice_size);
+    f.routing = routing;
+    stg->out().set_filter(index_slots[i], f);
+  }
+  return result;
+}
+
 namespace {
 
 // Asks the consensus module for more IDs.
@@ -286,9 +371,10 @@ auto make_importer_stage(importer_actor* self) {
 } // namespace <anonymous>
 
 behavior importer(stateful_actor<importer_state>* self, path dir,
-                  size_t max_table_slice_size) {
+                  size_t max_table_slice_size, index_routing routing) {
   VAST_TRACE(VAST_ARG(dir), VAST_ARG(max_table_slice_size));
   self->state.dir = dir;
+  self->state.routing = routing;
   self->state.last_replenish = steady_clock::time_point::min();
   self->state.max_table_slice_size = static_cast<int32_t>(max_table_slice_size);
   auto err = self->state.read_state();
@@ -323,17 +409,7 @@ behavior importer(stateful_actor<importer_state>* self, path dir,
     },
     [=](index_atom, const actor& index) {
       VAST_DEBUG(self, "registers index", index);
-      self->state.index_actors.emplace_back(index);
-      // TODO: currently, the subscriber expects only a single 'flush' message.
-      //       Adding multiple INDEX actors will cause the subscriber to
-      //       receive more than one 'flush'  message, but the subscriber only
-      //       expects one and will stop waiting after the first one. Once we
-      //       support multiple INDEX actors at the IMPORTER, we also need to
-      //       revise the signaling of these 'flush' messages.
-      if (self->state.index_actors.size() > 1)
-        VAST_WARNING(self, "registered more than one INDEX actor",
-                     "(currently unsupported!)");
-      return self->state.stg->add_outbound_path(index);
+      return self->state.add_index(index);
     },
     [=](exporter_atom, const actor& exporter) {
       VAST_DEBUG(self, "registers exporter", exporter);
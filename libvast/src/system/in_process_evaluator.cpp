@@ -0,0 +1,162 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/in_process_evaluator.hpp"
+
+#include <algorithm>
+#include <optional>
+
+#include <caf/binary_deserializer.hpp>
+#include <caf/event_based_actor.hpp>
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/overload.hpp"
+#include "vast/expression_visitors.hpp"
+#include "vast/logger.hpp"
+#include "vast/system/atoms.hpp"
+#include "vast/system/evaluator.hpp"
+#include "vast/view.hpp"
+
+using namespace caf;
+
+namespace vast::system {
+
+namespace {
+
+// Looks up the hits of a single predicate in a table. Mirrors the selection
+// of INDEXER actors in `partition::eval`: returns `std::nullopt` whenever the
+// actor-based evaluation would not query an INDEXER for the predicate.
+std::optional<ids> lookup(sealed_columns& columns,
+                          const partition_file::table& tbl,
+                          const predicate& pred) {
+  auto& layout = tbl.layout;
+  auto lookup_column = [&](const vast::offset& o, const data& x) -> ids {
+    auto column = layout.flat_index_at(o);
+    if (!column || *column >= tbl.columns.size())
+      return {};
+    auto result = columns.lookup(tbl, *column, pred.op, make_view(x));
+    if (!result) {
+      VAST_WARNING_ANON(__func__, "failed to look up column", *column);
+      return {};
+    }
+    return std::move(*result);
+  };
+  auto on_attribute = [&](const attribute_extractor& ex,
+                          const data& x) -> std::optional<ids> {
+    if (ex.attr == type_atom::value) {
+      auto str = caf::get_if<std::string>(&x);
+      if (str == nullptr || layout.name() != *str)
+        return std::nullopt;
+      return tbl.row_ids;
+    }
+    if (ex.attr == time_atom::value) {
+      if (!caf::holds_alternative<timestamp>(x))
+        return std::nullopt;
+      auto is_time = [](auto& field) {
+        return caf::holds_alternative<timestamp_type>(field.type)
+               && has_attribute(field.type, "time");
+      };
+      auto& fs = layout.fields;
+      auto i = std::find_if(fs.begin(), fs.end(), is_time);
+      if (i == fs.end())
+        return std::nullopt;
+      auto pos = static_cast<size_t>(std::distance(fs.begin(), i));
+      return lookup_column(vast::offset{pos}, x);
+    }
+    return std::nullopt;
+  };
+  auto on_data = [&](const data_extractor& dx,
+                     const data& x) -> std::optional<ids> {
+    if (dx.offset.empty())
+      return std::nullopt;
+    return lookup_column(dx.offset, x);
+  };
+  return caf::visit(detail::overload(on_attribute, on_data,
+                                     [](const auto&, const auto&) {
+                                       return std::optional<ids>{};
+                                     }),
+                    pred.lhs, pred.rhs);
+}
+
+} // namespace <anonymous>
+
+sealed_columns::sealed_columns(std::shared_ptr<const partition_file> file)
+  : file_(std::move(file)) {
+  VAST_ASSERT(file_ != nullptr);
+}
+
+sealed_columns::column& sealed_columns::at(const partition_file::table& x,
+                                           size_t column) {
+  VAST_ASSERT(column < x.columns.size());
+  std::lock_guard<std::mutex> guard{mtx_};
+  auto& cols = columns_[&x];
+  if (cols.empty()) {
+    cols.resize(x.columns.size());
+    for (auto& col : cols)
+      col = std::make_unique<sealed_columns::column>();
+  }
+  return *cols[column];
+}
+
+caf::expected<ids> sealed_columns::lookup(const partition_file::table& x,
+                                          size_t column,
+                                          relational_operator op,
+                                          data_view rhs) {
+  auto& col = at(x, column);
+  std::lock_guard<std::mutex> guard{col.mtx};
+  if (!col.decoded) {
+    col.decoded = true;
+    if (auto state = file_->column(x, column)) {
+      caf::binary_deserializer source{nullptr, state->data(), state->size()};
+      value_index::size_type last_flush;
+      if (auto err = source(last_flush, col.idx)) {
+        VAST_ERROR_ANON(__func__, "failed to deserialize value index of column",
+                        column);
+        col.idx = nullptr;
+      }
+    }
+  }
+  if (col.idx == nullptr)
+    return ids{};
+  return col.idx->lookup(op, rhs);
+}
+
+ids evaluate(const expression& expr, sealed_columns& columns) {
+  evaluator_state::predicate_hits_map hits;
+  for (auto& kvp : columns.file().tables()) {
+    auto& tbl = kvp.second;
+    for (auto& [position, pred] : resolve(expr, tbl.layout))
+      if (auto x = lookup(columns, tbl, pred)) {
+        auto& [count, accumulated] = hits[position];
+        ++count;
+        accumulated |= *x;
+      }
+  }
+  return evaluate(expr, hits);
+}
+
+behavior in_process_evaluator(event_based_actor* self, expression expr,
+                              std::shared_ptr<sealed_columns> columns) {
+  return {[=](const caf::actor& client) {
+    auto result = evaluate(expr, *columns);
+    VAST_DEBUG(self, "evaluated expression with", rank(result), "hits");
+    if (any<1>(result))
+      self->send(client, std::move(result));
+    // We can only deal with exactly one expression/client.
+    self->unbecome();
+    return done_atom::value;
+  }};
+}
+
+} // namespace vast::system
@@ -13,6 +13,7 @@
 
 #include "vast/system/index.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <deque>
 #include <unordered_set>
@@ -21,6 +22,7 @@
 #include <caf/detail/unordered_flat_map.hpp>
 
 #include "vast/concept/parseable/to.hpp"
+#include "vast/concept/printable/std/chrono.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/bitmap.hpp"
 #include "vast/concept/printable/vast/error.hpp"
@@ -29,6 +31,7 @@
 #include "vast/defaults.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/detail/fill_status_map.hpp"
+#include "vast/detail/narrow.hpp"
 #include "vast/detail/notifying_stream_manager.hpp"
 #include "vast/event.hpp"
 #include "vast/expression_visitors.hpp"
@@ -38,12 +41,15 @@
 #include "vast/logger.hpp"
 #include "vast/save.hpp"
 #include "vast/system/evaluator.hpp"
+#include "vast/system/in_process_evaluator.hpp"
+#include "vast/system/meta_indexer.hpp"
 #include "vast/table_slice.hpp"
 
 #include "vast/system/accountant.hpp"
 #include "vast/system/query_supervisor.hpp"
 #include "vast/system/index.hpp"
 #include "vast/system/partition.hpp"
+#include "vast/system/partition_loader.hpp"
 #include "vast/system/spawn_indexer.hpp"
 #include "vast/system/task.hpp"
 
@@ -65,24 +71,10 @@ auto make_index_stage(index_state* st) {
 
 } // namespace
 
-partition_ptr index_state::partition_factory::operator()(const uuid& id) const {
-  // The factory must not get called for the active partition nor for
-  // partitions that are currently unpersisted.
-  VAST_ASSERT(st_->active == nullptr || id != st_->active->id());
-  VAST_ASSERT(std::none_of(st_->unpersisted.begin(), st_->unpersisted.end(),
-                           [&](auto& kvp) { return kvp.first->id() == id; }));
-  // Load partition from disk.
-  VAST_DEBUG(st_->self, "loads partition", id);
-  auto result = std::make_unique<partition>(st_, id, st_->max_partition_size);
-  if (auto err = result->init())
-    VAST_ERROR(st_->self, "unable to load partition state from disk:", id);
-  return result;
-}
-
 index_state::index_state(caf::stateful_actor<index_state>* self)
   : self(self),
     factory(spawn_indexer),
-    lru_partitions(10, partition_lookup{}, partition_factory{this}) {
+    lru_partitions(10) {
   // nop
 }
 
@@ -92,16 +84,17 @@ index_state::~index_state() {
 }
 
 caf::error index_state::init(const path& dir, size_t max_partition_size,
-                             uint32_t in_mem_partitions,
+                             size_t max_resident_size,
                              uint32_t taste_partitions) {
   VAST_TRACE(VAST_ARG(dir), VAST_ARG(max_partition_size),
-             VAST_ARG(in_mem_partitions), VAST_ARG(taste_partitions));
+             VAST_ARG(max_resident_size), VAST_ARG(taste_partitions));
   put(meta_idx.factory_options(), "max-partition-size", max_partition_size);
   // Set members.
   this->dir = dir;
   this->max_partition_size = max_partition_size;
-  this->lru_partitions.size(in_mem_partitions);
+  this->lru_partitions.size(max_resident_size);
   this->taste_partitions = taste_partitions;
+  this->loader = self->spawn(partition_loader);
   if (auto a = self->system().registry().get(accountant_atom::value)) {
     namespace defs = defaults::system;
     this->accountant = actor_cast<accountant_type>(a);
@@ -187,9 +180,25 @@ caf::dictionary<caf::config_value> index_state::status() const {
   auto& cached = put_list(partitions, "cached");
   for (auto& part : lru_partitions.elements())
     cached.emplace_back(to_string(part->id()));
+  partitions.emplace("resident-bytes", lru_partitions.weight());
+  partitions.emplace("max-resident-bytes", lru_partitions.size());
   auto& unpersisted = put_list(partitions, "unpersisted");
   for (auto& kvp : this->unpersisted)
     unpersisted.emplace_back(to_string(kvp.first->id()));
+  // Query scheduling.
+  auto& scheduler = put_dictionary(result, "scheduler");
+  size_t queued = 0;
+  for (auto& queue : task_queues)
+    queued += queue.size();
+  size_t parked = 0;
+  for (auto& kvp : loading)
+    parked += kvp.second.size();
+  scheduler.emplace("queued-tasks", queued);
+  scheduler.emplace("parked-tasks", parked);
+  scheduler.emplace("loading-partitions", loading.size());
+  scheduler.emplace("busy-workers", busy_workers.size());
+  scheduler.emplace("idle-workers", idle_workers.size());
+  scheduler.emplace("pending-batches", batches.size());
   // General state such as open streams.
   detail::fill_status_map(result, self);
   return result;
@@ -235,6 +244,21 @@ void index_state::reset_active_partition() {
   // Persist meta data and the state of all INDEXER actors when the active
   // partition gets replaced becomes full.
   if (active != nullptr) {
+    // Collect the synopses of the partition from its META INDEXER.
+    if (active_meta_indexer != nullptr) {
+      auto id = active->id();
+      self->request(active_meta_indexer, caf::infinite, get_atom::value, id)
+        .then(
+          [this, id](meta_index::partition_synopsis& synopses) {
+            meta_idx.merge(id, std::move(synopses));
+          },
+          [this, id](const caf::error& err) {
+            VAST_ERROR(self, "failed to collect synopses for partition", id,
+                       "(the partition remains a candidate for all queries):",
+                       self->system().render(err));
+          });
+      active_meta_indexer = nullptr;
+    }
     if (auto err = active->flush_to_disk())
       VAST_ERROR(self, "unable to persist active partition");
     // Store this partition as unpersisted to make sure we're not attempting
@@ -247,6 +271,23 @@ void index_state::reset_active_partition() {
   active_partition_indexers = 0;
 }
 
+void index_state::update_meta_index(const table_slice_ptr& slice) {
+  VAST_ASSERT(active != nullptr);
+  if (meta_indexers.empty()) {
+    meta_idx.add(active->id(), *slice);
+    return;
+  }
+  // Assign each partition to a META INDEXER in round-robin fashion. Until
+  // the partition completes, the meta index considers it a candidate for all
+  // queries.
+  if (active_meta_indexer == nullptr) {
+    auto i = meta_indexer_assignments++ % meta_indexers.size();
+    active_meta_indexer = meta_indexers[i];
+    meta_idx.add(active->id());
+  }
+  self->send(active_meta_indexer, active->id(), slice);
+}
+
 partition_ptr index_state::make_partition() {
   return make_partition(uuid::random());
 }
@@ -264,6 +305,14 @@ caf::actor index_state::make_indexer(path dir, type column_type, size_t column,
                  self, partition_id, m);
 }
 
+caf::actor index_state::make_indexer(chunk_ptr state, type column_type,
+                                     size_t column, uuid partition_id,
+                                     atomic_measurement* m) {
+  VAST_TRACE(VAST_ARG(column_type), VAST_ARG(column), VAST_ARG(partition_id));
+  return spawn_sealed_indexer(self, std::move(state), std::move(column_type),
+                              column, self, partition_id, m);
+}
+
 void index_state::decrement_indexer_count(uuid partition_id) {
   if (partition_id == active->id())
     active_partition_indexers--;
@@ -278,6 +327,8 @@ void index_state::decrement_indexer_count(uuid partition_id) {
     if (--i->second == 0) {
       VAST_DEBUG(self, "successfully persisted", partition_id);
       unpersisted.erase(i);
+      // The partition is immutable from now on.
+      self->send(loader, persist_atom::value, dir / to_string(partition_id));
     }
   }
 }
@@ -288,52 +339,167 @@ partition* index_state::find_unpersisted(const uuid& id) {
   return i != unpersisted.end() ? i->first.get() : nullptr;
 }
 
-query_map index_state::launch_evaluators(lookup_state& lookup,
-                                         uint32_t num_partitions) {
-  VAST_TRACE(VAST_ARG(lookup), VAST_ARG(num_partitions));
+bool index_state::in_memory(const uuid& id) {
+  return (active != nullptr && active->id() == id)
+         || find_unpersisted(id) != nullptr || lru_partitions.contains(id);
+}
+
+size_t index_state::enqueue_tasks(lookup_state& lookup,
+                                  uint32_t num_partitions,
+                                  const uuid& query_id, caf::actor client,
+                                  bool interactive) {
+  VAST_TRACE(VAST_ARG(lookup), VAST_ARG(num_partitions), VAST_ARG(query_id),
+             VAST_ARG(client), VAST_ARG(interactive));
   if (num_partitions == 0 || lookup.partitions.empty())
-    return {};
+    return 0;
   // Prefer partitions that are already available in RAM.
   std::partition(lookup.partitions.begin(), lookup.partitions.end(),
-                 [&](const uuid& candidate) {
-                   return (active != nullptr && active->id() == candidate)
-                          || find_unpersisted(candidate) != nullptr
-                          || lru_partitions.contains(candidate);
-                 });
-  // Maps partition IDs to the EVALUATOR actors we are going to spawn.
-  query_map result;
-  // Helper function to spin up EVALUATOR actors for a single partition.
-  auto spin_up = [&](const uuid& partition_id) {
+                 [&](const uuid& candidate) { return in_memory(candidate); });
+  auto n = std::min(lookup.partitions.size(), size_t{num_partitions});
+  auto batch = next_batch++;
+  batches.emplace(batch, query_batch{query_id, lookup.expr, std::move(client),
+                                     n, timespan::zero()});
+  auto now = steady_clock::now();
+  auto first = lookup.partitions.begin();
+  auto last = first + n;
+  for (auto i = first; i != last; ++i) {
+    auto priority = interactive ? interactive_on_disk : bulk_on_disk;
+    if (in_memory(*i))
+      priority = interactive ? interactive_in_memory : bulk_in_memory;
+    task_queues[priority].push_back(query_task{batch, *i, priority, now});
+  }
+  lookup.partitions.erase(first, last);
+  dispatch_tasks();
+  return n;
+}
+
+void index_state::prefetch(const lookup_state& lookup,
+                           size_t num_partitions) {
+  // Never prefetch more than half of the cache to keep the partitions of
+  // queued tasks in memory. We estimate the size of the next partitions from
+  // the average size of the cached partitions.
+  auto n = std::min(num_partitions, lookup.partitions.size());
+  if (auto cached = lru_partitions.elements().size(); cached > 0) {
+    auto avg = std::max(lru_partitions.weight() / cached, size_t{1});
+    n = std::min(n, lru_partitions.size() / 2 / avg);
+  }
+  for (size_t i = 0; i < n; ++i)
+    load_partition(lookup.partitions[i]);
+}
+
+void index_state::load_partition(const uuid& id) {
+  if (in_memory(id) || loading.count(id) > 0)
+    return;
+  VAST_DEBUG(self, "loads partition", id);
+  loading.emplace(id, std::vector<query_task>{});
+  self->request(loader, caf::infinite, load_atom::value, dir / to_string(id))
+    .then(
+      [this, id](partition::meta_data& md) {
+        auto i = loading.find(id);
+        VAST_ASSERT(i != loading.end());
+        auto tasks = std::move(i->second);
+        loading.erase(i);
+        if (!in_memory(id)) {
+          auto part = make_partition(id);
+          part->init(std::move(md));
+          lru_partitions.add(std::move(part));
+        }
+        // Parked tasks waited long enough already and go to the front of
+        // their queues in their original order.
+        for (auto t = tasks.rbegin(); t != tasks.rend(); ++t)
+          task_queues[t->priority].push_front(std::move(*t));
+        dispatch_tasks();
+      },
+      [this, id](const caf::error& err) {
+        VAST_ERROR(self, "unable to load partition state from disk:", id,
+                   self->system().render(err));
+        auto i = loading.find(id);
+        VAST_ASSERT(i != loading.end());
+        auto tasks = std::move(i->second);
+        loading.erase(i);
+        for (auto& task : tasks)
+          complete_task(task.batch);
+      });
+}
+
+void index_state::dispatch_tasks() {
+  auto next_queue = [&]() -> std::deque<query_task>* {
+    for (auto& queue : task_queues)
+      if (!queue.empty())
+        return &queue;
+    return nullptr;
+  };
+  while (worker_available()) {
+    auto queue = next_queue();
+    if (queue == nullptr)
+      return;
+    auto task = std::move(queue->front());
+    queue->pop_front();
+    // Park tasks for partitions on disk instead of blocking the INDEX with
+    // I/O. The task returns to its queue after loading the partition.
+    if (!in_memory(task.partition)) {
+      load_partition(task.partition);
+      loading[task.partition].emplace_back(std::move(task));
+      continue;
+    }
+    auto& b = batches[task.batch];
+    auto delay = steady_clock::now() - task.enqueued;
+    b.queueing_delay = std::max(b.queueing_delay,
+                                duration_cast<timespan>(delay));
     // We need to first check whether the ID is the active partition or one
     // of our unpersistet ones. Only then can we dispatch to our LRU cache.
     partition* part;
-    if (active != nullptr && active->id() == partition_id)
+    if (active != nullptr && active->id() == task.partition)
       part = active.get();
-    else if (auto ptr = find_unpersisted(partition_id); ptr != nullptr)
+    else if (auto ptr = find_unpersisted(task.partition); ptr != nullptr)
       part = ptr;
+    else if (auto cached = lru_partitions.find(task.partition))
+      part = cached->get();
     else
-      part = lru_partitions.get_or_add(partition_id).get();
-    auto eval = part->eval(lookup.expr);
-    if (eval.empty()) {
-      VAST_WARNING(self, "identified partition", partition_id,
-                   "as candidate in the meta index, but it didn't produce an "
-                   "evaluation map");
-      return;
+      part = nullptr;
+    // The in_memory check above parks tasks for all other partitions.
+    VAST_ASSERT(part != nullptr);
+    query_map qm;
+    auto columns = engine == evaluation_engine::in_process ? part->columns()
+                                                           : nullptr;
+    if (columns != nullptr) {
+      // Sealed partitions are read-only, which allows a single actor to
+      // query all column indexes without INDEXER actors.
+      qm.emplace(task.partition,
+                 std::vector<caf::actor>{self->spawn(in_process_evaluator,
+                                                     b.expr,
+                                                     std::move(columns))});
+    } else {
+      auto eval = part->eval(b.expr);
+      if (eval.empty()) {
+        VAST_WARNING(self, "identified partition", task.partition,
+                     "as candidate in the meta index, but it didn't produce "
+                     "an evaluation map");
+        complete_task(task.batch);
+        continue;
+      }
+      qm.emplace(task.partition, std::vector<caf::actor>{
+                                   self->spawn(evaluator, b.expr,
+                                               std::move(eval))});
     }
-    std::vector<caf::actor> xs{
-      self->spawn(evaluator, lookup.expr, std::move(eval))};
-    result.emplace(partition_id, std::move(xs));
-  };
-  // Loop over the candidate set until we either successfully scheduled
-  // num_partitions partitions or run out of candidates.
-  {
-    auto i = lookup.partitions.begin();
-    auto last = lookup.partitions.end();
-    for (; i != last && result.size() < num_partitions; ++i)
-      spin_up(*i);
-    lookup.partitions.erase(lookup.partitions.begin(), i);
+    auto worker = next_worker();
+    busy_workers.emplace_back(worker, task.batch);
+    self->send(worker, b.expr, std::move(qm), b.client);
   }
-  return result;
+}
+
+void index_state::complete_task(uint64_t batch) {
+  auto i = batches.find(batch);
+  VAST_ASSERT(i != batches.end());
+  auto& b = i->second;
+  if (--b.open_tasks > 0)
+    return;
+  VAST_DEBUG(self, "completed a batch of query", b.query,
+             "with a queueing delay of", to_string(b.queueing_delay));
+  if (accountant)
+    self->send(accountant, "index.queueing-delay", b.queueing_delay);
+  self->send(b.client, done_atom::value);
+  batches.erase(i);
 }
 
 void index_state::add_flush_listener(caf::actor listener) {
@@ -351,20 +517,22 @@ void index_state::notify_flush_listeners() {
 }
 
 behavior index(stateful_actor<index_state>* self, const path& dir,
-               size_t max_partition_size, size_t in_mem_partitions,
-               size_t taste_partitions, size_t num_workers) {
+               size_t max_partition_size, size_t max_resident_size,
+               size_t taste_partitions, size_t num_workers,
+               size_t num_meta_indexers, evaluation_engine engine) {
   VAST_TRACE(VAST_ARG(dir), VAST_ARG(max_partition_size),
-             VAST_ARG(in_mem_partitions), VAST_ARG(taste_partitions),
-             VAST_ARG(num_workers));
+             VAST_ARG(max_resident_size), VAST_ARG(taste_partitions),
+             VAST_ARG(num_workers), VAST_ARG(num_meta_indexers));
   VAST_ASSERT(max_partition_size > 0);
-  VAST_ASSERT(in_mem_partitions > 0);
+  VAST_ASSERT(max_resident_size > 0);
   VAST_INFO(self, "spawned:", VAST_ARG(max_partition_size),
-            VAST_ARG(in_mem_partitions), VAST_ARG(taste_partitions));
-  if (auto err = self->state.init(dir, max_partition_size, in_mem_partitions,
+            VAST_ARG(max_resident_size), VAST_ARG(taste_partitions));
+  if (auto err = self->state.init(dir, max_partition_size, max_resident_size,
                                   taste_partitions)) {
     self->quit(std::move(err));
     return {};
   }
+  self->state.engine = engine;
   self->set_exit_handler([=](const exit_msg& msg) {
     VAST_DEBUG(self, "received exit from", msg.source,
                "with reason:", msg.reason);
@@ -374,10 +542,11 @@ behavior index(stateful_actor<index_state>* self, const path& dir,
   // Launch workers for resolving queries.
   for (size_t i = 0; i < num_workers; ++i)
     self->spawn(query_supervisor, self);
-  // We switch between has_worker behavior and the default behavior (which
-  // simply waits for a worker).
-  self->set_default_handler(caf::skip);
-  self->state.has_worker.assign(
+  // Launch workers for computing synopses.
+  for (size_t i = 0; i < num_meta_indexers; ++i)
+    self->state.meta_indexers.emplace_back(
+      self->spawn(meta_indexer, self->state.meta_idx.factory_options()));
+  return {
     [=](expression& expr) -> result<uuid, uint32_t, uint32_t> {
       auto& st = self->state;
       // Sanity check.
@@ -385,21 +554,17 @@ behavior index(stateful_actor<index_state>* self, const path& dir,
         VAST_ERROR(self, "got an anonymous query (ignored)");
         return sec::invalid_argument;
       }
-      // Convenience function for dropping out without producing hits. Makes
-      // sure that clients always receive a 'done' message.
-      auto no_result = [&] {
-        auto client = caf::actor_cast<caf::actor>(self->current_sender());
-        auto rp = self->make_response_promise<uuid, uint32_t, uint32_t>();
-        rp.deliver(uuid::nil(), uint32_t{0}, uint32_t{0});
-        self->send(caf::actor_cast<caf::actor>(client), done_atom::value);
-        return rp;
-      };
+      auto client = actor_cast<actor>(self->current_sender());
       // Get all potentially matching partitions.
       auto candidates = st.meta_idx.lookup(expr);
-      // Report no result if no candidates are found.
+      // Report no result if no candidates are found. Makes sure that clients
+      // always receive a 'done' message.
       if (candidates.empty()) {
         VAST_DEBUG(self, "returns without result: no partitions qualify");
-        return no_result();
+        auto rp = self->make_response_promise<uuid, uint32_t, uint32_t>();
+        rp.deliver(uuid::nil(), uint32_t{0}, uint32_t{0});
+        self->send(client, done_atom::value);
+        return rp;
       }
       // Allows the client to query further results after initial taste.
       auto query_id = uuid::random();
@@ -408,29 +573,22 @@ behavior index(stateful_actor<index_state>* self, const path& dir,
                                               ls{expr, std::move(candidates)});
       VAST_ASSERT(added);
       VAST_IGNORE_UNUSED(added);
-      auto qm = st.launch_evaluators(iter->second, st.taste_partitions);
-      if (qm.empty()) {
-        VAST_ASSERT(iter->second.partitions.empty());
-        st.pending.erase(iter);
-        VAST_DEBUG(self, "returns without result: no partitions qualify");
-        return no_result();
-      }
-      // Delegate to query supervisor (uses up this worker) and report
-      // query ID + some stats to the client.
-      auto scheduled = qm.size();
+      // Queue the initial partitions as interactive tasks and report query
+      // ID + some stats to the client.
+      auto scheduled = st.enqueue_tasks(iter->second, st.taste_partitions,
+                                        query_id, client, true);
+      VAST_ASSERT(scheduled > 0);
       size_t hits = iter->second.partitions.size() + scheduled;
       VAST_DEBUG(self, "schedules", scheduled, "/", hits,
                  "partitions for query", iter->first);
-      self->send(st.next_worker(), std::move(expr), std::move(qm),
-                 actor_cast<actor>(self->current_sender()));
-      if (!st.worker_available())
-        self->unbecome();
+      st.prefetch(iter->second, scheduled);
       // Cleanup early if we could exhaust the query with the taste.
       if (iter->second.partitions.empty()) {
         query_id = uuid::nil();
         st.pending.erase(iter);
       }
-      return {std::move(query_id), hits, scheduled};
+      return {std::move(query_id), detail::narrow_cast<uint32_t>(hits),
+              detail::narrow_cast<uint32_t>(scheduled)};
     },
     [=](const uuid& query_id, uint32_t num_partitions) {
       auto& st = self->state;
@@ -452,26 +610,31 @@ behavior index(stateful_actor<index_state>* self, const path& dir,
         self->send(client, done_atom::value);
         return;
       }
-      auto qm = st.launch_evaluators(iter->second, num_partitions);
-      if (qm.empty()) {
-        VAST_ASSERT(iter->second.partitions.empty());
-        st.pending.erase(iter);
-        VAST_DEBUG(self, "returns without result: no partitions qualify");
-        self->send(client, done_atom::value);
-        return;
-      }
-      // Delegate to query supervisor (uses up this worker) and report
-      // query ID + some stats to the client.
-      VAST_DEBUG(self, "schedules", qm.size(), "more partition(s) for query",
+      // Queue further partitions as bulk tasks, which yield to the initial
+      // partitions of other queries.
+      auto scheduled = st.enqueue_tasks(iter->second, num_partitions, query_id,
+                                        client, false);
+      VAST_ASSERT(scheduled > 0);
+      VAST_DEBUG(self, "schedules", scheduled, "more partition(s) for query",
                  iter->first, "with", iter->second.partitions.size(),
                  "remaining");
-      self->send(st.next_worker(), iter->second.expr, std::move(qm), client);
+      st.prefetch(iter->second, scheduled);
       // Cleanup if we exhausted all candidates.
       if (iter->second.partitions.empty())
         st.pending.erase(iter);
     },
     [=](worker_atom, caf::actor& worker) {
-      self->state.idle_workers.emplace_back(std::move(worker));
+      auto& st = self->state;
+      // A worker that reports back completed its previous task, if any.
+      auto i = std::find_if(st.busy_workers.begin(), st.busy_workers.end(),
+                            [&](auto& kvp) { return kvp.first == worker; });
+      if (i != st.busy_workers.end()) {
+        auto batch = i->second;
+        st.busy_workers.erase(i);
+        st.complete_task(batch);
+      }
+      st.idle_workers.emplace_back(std::move(worker));
+      st.dispatch_tasks();
     },
     [=](done_atom, uuid partition_id) {
       self->state.decrement_indexer_count(partition_id);
@@ -490,31 +653,8 @@ behavior index(stateful_actor<index_state>* self, const path& dir,
     },
     [=](subscribe_atom, flush_atom, actor& listener) {
       self->state.add_flush_listener(std::move(listener));
-    });
-  return {[=](worker_atom, caf::actor& worker) {
-            auto& st = self->state;
-            st.idle_workers.emplace_back(std::move(worker));
-            self->become(keep_behavior, st.has_worker);
-          },
-          [=](done_atom, uuid partition_id) {
-            self->state.decrement_indexer_count(partition_id);
-          },
-          [=](caf::stream<table_slice_ptr> in) {
-            VAST_DEBUG(self, "got a new source");
-            return self->state.stage->add_inbound_path(in);
-          },
-          [=](status_atom) -> caf::config_value::dictionary {
-            return self->state.status();
-          },
-          [=](telemetry_atom) {
-            self->state.send_report();
-            namespace defs = defaults::system;
-            self->delayed_send(self, defs::telemetry_rate,
-                               telemetry_atom::value);
-          },
-          [=](subscribe_atom, flush_atom, actor& listener) {
-            self->state.add_flush_listener(std::move(listener));
-          }};
+    }
+  };
 }
 
 } // namespace vast::system
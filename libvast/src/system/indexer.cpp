@@ -52,19 +52,21 @@ caf::error indexer_state::init(event_based_actor* self, path filename,
   return col.init();
 }
 
-behavior indexer(stateful_actor<indexer_state>* self, path dir,
-                 type column_type, size_t column, caf::actor index,
-                 uuid partition_id, atomic_measurement* m) {
-  VAST_TRACE(VAST_ARG(dir), VAST_ARG(column_type), VAST_ARG(column));
-  VAST_DEBUG(self, "operates for column", column, "of type", column_type);
-  if (auto err = self->state.init(self,
-                                  std::move(dir) / "fields"
-                                      / std::to_string(column),
-                                  std::move(column_type), column,
-                                  std::move(index), partition_id, m)) {
-    self->quit(std::move(err));
-    return {};
-  }
+caf::error indexer_state::init(event_based_actor* self, chunk_ptr state,
+                               type column_type, size_t column,
+                               caf::actor index, uuid partition_id,
+                               atomic_measurement* m) {
+  this->index = std::move(index);
+  this->partition_id = partition_id;
+  this->measurement = m;
+  new (&col) column_index(self->system(), std::move(column_type),
+                          std::move(state), column);
+  return col.init();
+}
+
+namespace {
+
+behavior make_indexer_behavior(stateful_actor<indexer_state>* self) {
   return {
     [=](const curried_predicate& pred) {
       VAST_DEBUG(self, "got predicate:", pred);
@@ -106,4 +108,37 @@ behavior indexer(stateful_actor<indexer_state>* self, path dir,
   };
 }
 
+} // namespace
+
+behavior indexer(stateful_actor<indexer_state>* self, path dir,
+                 type column_type, size_t column, caf::actor index,
+                 uuid partition_id, atomic_measurement* m) {
+  VAST_TRACE(VAST_ARG(dir), VAST_ARG(column_type), VAST_ARG(column));
+  VAST_DEBUG(self, "operates for column", column, "of type", column_type);
+  if (auto err = self->state.init(self,
+                                  std::move(dir) / "fields"
+                                      / std::to_string(column),
+                                  std::move(column_type), column,
+                                  std::move(index), partition_id, m)) {
+    self->quit(std::move(err));
+    return {};
+  }
+  return make_indexer_behavior(self);
+}
+
+behavior sealed_indexer(stateful_actor<indexer_state>* self, chunk_ptr state,
+                        type column_type, size_t column, caf::actor index,
+                        uuid partition_id, atomic_measurement* m) {
+  VAST_TRACE(VAST_ARG(column_type), VAST_ARG(column));
+  VAST_DEBUG(self, "operates for sealed column", column, "of type",
+             column_type);
+  if (auto err = self->state.init(self, std::move(state),
+                                  std::move(column_type), column,
+                                  std::move(index), partition_id, m)) {
+    self->quit(std::move(err));
+    return {};
+  }
+  return make_indexer_behavior(self);
+}
+
 } // namespace vast::system
@@ -50,7 +50,7 @@ void indexer_stage_driver::process(downstream_type& out, batch_type& slices) {
     if (st.active == nullptr)
       st.reset_active_partition();
     // Update meta index.
-    st.meta_idx.add(st.active->id(), *slice);
+    st.update_meta_index(slice);
     // Start new INDEXER actors when needed and add it to the stream.
     auto& layout = slice->layout();
     auto [meta_x, added] = st.active->get_or_add(layout);
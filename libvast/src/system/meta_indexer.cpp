@@ -0,0 +1,59 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/meta_indexer.hpp"
+
+#include <caf/all.hpp>
+
+#include "vast/factory.hpp"
+#include "vast/logger.hpp"
+#include "vast/synopsis_factory.hpp"
+#include "vast/system/atoms.hpp"
+#include "vast/table_slice.hpp"
+
+using namespace caf;
+
+namespace vast::system {
+
+behavior meta_indexer(stateful_actor<meta_indexer_state>* self,
+                      synopsis_options opts) {
+  self->state.options = std::move(opts);
+  return {
+    [=](const uuid& partition, const table_slice_ptr& slice) {
+      auto& st = self->state;
+      auto& layout = slice->layout();
+      auto& table_syn = st.partitions[partition][layout];
+      if (table_syn.empty())
+        for (auto& field : layout.fields)
+          table_syn.emplace_back(
+            has_skip_attribute(field.type)
+              ? nullptr
+              : factory<synopsis>::make(field.type, st.options));
+      for (size_t col = 0; col < slice->columns(); ++col)
+        if (auto& syn = table_syn[col])
+          syn->add_column(*slice, col);
+    },
+    [=](get_atom, const uuid& partition) -> meta_index::partition_synopsis {
+      auto& st = self->state;
+      meta_index::partition_synopsis result;
+      if (auto i = st.partitions.find(partition); i != st.partitions.end()) {
+        result = std::move(i->second);
+        st.partitions.erase(i);
+      }
+      VAST_DEBUG(self, "delivers synopses for partition", partition);
+      return result;
+    },
+  };
+}
+
+} // namespace vast::system
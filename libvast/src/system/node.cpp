@@ -253,7 +253,17 @@ caf::message spawn_command(const command& cmd, caf::actor_system& sys,
   } else {
     label = comp_name;
     const char* multi_instance[] = {"importer", "exporter", "source", "sink"};
-    if (std::count(begin(multi_instance), end(multi_instance), label) != 0) {
+    if (label == "index") {
+      // Additional INDEX shards get a numbered label, but the first one keeps
+      // its plain label to remain compatible with existing state directories.
+      auto n = ++this_node->state.labels[label];
+      if (n > 1) {
+        label += '-';
+        label += std::to_string(n);
+        VAST_DEBUG(this_node, "auto-generated new label:", label);
+      }
+    } else if (std::count(begin(multi_instance), end(multi_instance), label)
+               != 0) {
       // Create a new label and update our counter in the map.
       auto n = ++this_node->state.labels[label];
       label += '-';
@@ -363,16 +373,26 @@ void node_state::init(std::string init_name, path init_dir) {
   sp->add(spawn_command, "importer", "creates a new importer",
           opts()
             .add<size_t>("ids,n",
-                         "number of initial IDs to request (deprecated)"));
+                         "number of initial IDs to request (deprecated)")
+            .add<caf::atom_value>("routing,r",
+                                  "policy for distributing slices over INDEX "
+                                  "actors (roundrobin|layout)"));
   sp->add(spawn_command, "index", "creates a new index",
           opts()
             .add<size_t>("max-events,e", "maximum events per partition")
+            .add<size_t>("max-resident-size,r",
+                         "maximum size of cached partitions in MB")
             .add<size_t>("max-parts,p",
-                         "maximum number of in-memory partitions")
+                         "maximum number of in-memory partitions (deprecated)")
             .add<size_t>("taste-parts,t",
                          "number of immediately scheduled partitions")
             .add<size_t>("max-queries,q",
-                         "maximum number of concurrent queries"));
+                         "maximum number of concurrent queries")
+            .add<size_t>("meta-indexers,m",
+                         "number of actors computing synopses off the index")
+            .add<caf::atom_value>("evaluation,v",
+                                  "strategy for evaluating queries on "
+                                  "partitions (actors|inprocess)"));
   sp->add(spawn_command, "consensus", "creates a new consensus",
           opts().add<raft::server_id>("id,i",
                                       "the server ID of the consensus module"));
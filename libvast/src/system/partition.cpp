@@ -14,22 +14,30 @@
 #include "vast/system/partition.hpp"
 
 #include <caf/event_based_actor.hpp>
+#include <caf/expected.hpp>
 #include <caf/local_actor.hpp>
 #include <caf/make_counted.hpp>
 #include <caf/stateful_actor.hpp>
 
+#include "vast/chunk.hpp"
+#include "vast/column_index.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/expression.hpp"
+#include "vast/concept/printable/vast/filesystem.hpp"
 #include "vast/concept/printable/vast/uuid.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/error.hpp"
 #include "vast/event.hpp"
 #include "vast/expression_visitors.hpp"
+#include "vast/filesystem.hpp"
 #include "vast/ids.hpp"
 #include "vast/load.hpp"
 #include "vast/logger.hpp"
 #include "vast/save.hpp"
 #include "vast/system/atoms.hpp"
+#include "vast/system/in_process_evaluator.hpp"
 #include "vast/system/index.hpp"
+#include "vast/system/partition_file.hpp"
 #include "vast/system/spawn_indexer.hpp"
 #include "vast/system/table_indexer.hpp"
 #include "vast/time.hpp"
@@ -56,13 +64,83 @@ partition::~partition() noexcept {
 
 caf::error partition::init() {
   VAST_TRACE("");
-  auto file_path = meta_file();
-  if (!exists(file_path))
-    return ec::no_such_file;
-  if (auto err = load(nullptr, file_path , meta_data_))
-    return err;
+  auto md = load_meta_data(base_dir());
+  if (!md)
+    return std::move(md.error());
+  init(std::move(*md));
+  return caf::none;
+}
+
+void partition::init(meta_data md) {
+  VAST_TRACE("");
+  meta_data_ = std::move(md);
   VAST_DEBUG(state_->self, "loaded partition", id_, "from disk with",
              meta_data_.types.size(), "layouts");
+}
+
+caf::expected<partition::meta_data> partition::load_meta_data(const path& dir) {
+  VAST_TRACE(VAST_ARG(dir));
+  // Sealed partitions only need to read their table of contents.
+  if (auto filename = partition_file::filename(dir); exists(filename)) {
+    auto chk = chunk::mmap(filename);
+    if (chk == nullptr)
+      return make_error(ec::filesystem_error, "failed to mmap partition",
+                        filename);
+    auto file = partition_file::make(std::move(chk));
+    if (!file)
+      return std::move(file.error());
+    meta_data result;
+    for (auto& kvp : file->tables())
+      result.types.emplace(kvp.first, kvp.second.layout);
+    result.disk_usage = file->size();
+    result.file = std::make_shared<const partition_file>(std::move(*file));
+    return result;
+  }
+  auto file_path = dir / "meta";
+  if (!exists(file_path))
+    return make_error(ec::no_such_file, file_path.str());
+  meta_data result;
+  if (auto err = load(nullptr, file_path, result))
+    return err;
+  result.disk_usage = vast::disk_usage(dir);
+  return result;
+}
+
+caf::error partition::seal(const path& dir) {
+  VAST_TRACE(VAST_ARG(dir));
+  auto filename = partition_file::filename(dir);
+  // A previous attempt may have stopped before removing the directory.
+  if (exists(filename)) {
+    if (exists(dir) && !rm(dir))
+      return make_error(ec::filesystem_error, "failed to remove", dir);
+    return caf::none;
+  }
+  meta_data md;
+  if (auto err = load(nullptr, dir / "meta", md))
+    return err;
+  partition_file::table_map tables;
+  caf::detail::unordered_flat_map<std::string, std::vector<path>> columns;
+  for (auto& [digest, layout] : md.types) {
+    auto& tbl = tables.emplace(digest, partition_file::table{}).first->second;
+    tbl.layout = layout;
+    auto table_dir = dir / digest;
+    if (auto row_ids_file = table_dir / "row_ids"; exists(row_ids_file))
+      if (auto err = load(nullptr, row_ids_file, tbl.row_ids))
+        return err;
+    auto& files = columns.emplace(digest, std::vector<path>{}).first->second;
+    for (size_t column = 0; column < layout.fields.size(); ++column) {
+      auto& file = files.emplace_back(
+        table_indexer::column_file(table_dir, layout, column) / "fields"
+        / std::to_string(column));
+      // Fold the delta segments of incremental flushes into a single file.
+      if (auto err = compact_column_index(file))
+        return err;
+    }
+  }
+  if (auto err = partition_file::write(filename, std::move(tables), columns))
+    return err;
+  if (!rm(dir))
+    return make_error(ec::filesystem_error, "failed to remove", dir);
   return caf::none;
 }
 
@@ -164,6 +242,20 @@ evaluation_map partition::eval(const expression& expr) {
     // Skip any layout that we cannot resolve.
     if (resolved.empty())
       continue;
+    // Materialize the persistent state of tables when a query touches them
+    // for the first time.
+    table_indexer* tbl = nullptr;
+    auto get_table = [&]() -> table_indexer& {
+      if (tbl == nullptr) {
+        auto [x, added] = get_or_add(layout);
+        if (added)
+          if (auto err = x.init())
+            VAST_ERROR(state_->self, "failed to initialize table_indexer in",
+                       "partition", id_);
+        tbl = &x;
+      }
+      return *tbl;
+    };
     // Add triples (offset, curried predicate, and INDEXER) to evaluation map.
     evaluation_map::mapped_type triples;
     for (auto& kvp: resolved) {
@@ -171,12 +263,12 @@ evaluation_map partition::eval(const expression& expr) {
       auto hdl = caf::visit(detail::overload(
                               [&](const attribute_extractor& ex,
                                   const data& x) {
-                                return fetch_indexer(get_or_add(layout).first,
-                                                     ex, pred.op, x);
+                                return fetch_indexer(get_table(), ex,
+                                                     pred.op, x);
                               },
                               [&](const data_extractor& dx, const data& x) {
-                                return fetch_indexer(get_or_add(layout).first,
-                                                     dx, pred.op, x);
+                                return fetch_indexer(get_table(), dx,
+                                                     pred.op, x);
                               },
                               [](const auto&, const auto&) {
                                 return caf::actor{};
@@ -193,6 +285,12 @@ evaluation_map partition::eval(const expression& expr) {
   return result;
 }
 
+std::shared_ptr<sealed_columns> partition::columns() {
+  if (columns_ == nullptr && meta_data_.file != nullptr)
+    columns_ = std::make_shared<sealed_columns>(meta_data_.file);
+  return columns_;
+}
+
 std::vector<record_type> partition::layouts() const {
   std::vector<record_type> result;
   auto& ts = meta_data_.types;
@@ -0,0 +1,136 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/partition_file.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+#include <caf/binary_deserializer.hpp>
+
+#include "vast/concept/printable/vast/filesystem.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/narrow.hpp"
+#include "vast/error.hpp"
+#include "vast/logger.hpp"
+#include "vast/save.hpp"
+
+namespace vast::system {
+
+namespace {
+
+// Returns the size of a file or 0 if the file does not exist.
+uint64_t file_size(const path& filename) {
+  std::ifstream fs{filename.str(), std::ios::binary | std::ios::ate};
+  if (!fs)
+    return 0;
+  auto result = fs.tellg();
+  return result > 0 ? static_cast<uint64_t>(result) : 0;
+}
+
+} // namespace <anonymous>
+
+caf::expected<partition_file> partition_file::make(chunk_ptr chunk) {
+  VAST_ASSERT(chunk != nullptr);
+  caf::binary_deserializer source{nullptr, chunk->data(), chunk->size()};
+  uint32_t file_magic = 0;
+  uint32_t file_version = 0;
+  if (auto err = source(file_magic, file_version))
+    return err;
+  if (file_magic != magic)
+    return make_error(ec::format_error, "got invalid partition file magic",
+                      file_magic);
+  if (file_version > version)
+    return make_error(ec::version_error, "got newer partition file version",
+                      file_version);
+  partition_file result;
+  if (auto err = source(result.tables_))
+    return err;
+  using detail::narrow_cast;
+  result.payload_offset_
+    = narrow_cast<size_t>(source.current() - chunk->data());
+  result.chunk_ = std::move(chunk);
+  // Reject column ranges outside of the file before anyone maps them.
+  auto payload_size = result.chunk_->size() - result.payload_offset_;
+  for (auto& kvp : result.tables_)
+    for (auto& range : kvp.second.columns)
+      if (range.offset + range.size > payload_size)
+        return make_error(ec::format_error,
+                          "got column index beyond the end of the file");
+  return result;
+}
+
+caf::error partition_file::write(
+  const path& filename, table_map tables,
+  const caf::detail::unordered_flat_map<std::string, std::vector<path>>&
+    columns) {
+  VAST_TRACE(VAST_ARG(filename));
+  // Assign consecutive byte ranges to all column index files.
+  uint64_t offset = 0;
+  for (auto& [digest, tbl] : tables) {
+    tbl.columns.clear();
+    if (auto i = columns.find(digest); i != columns.end())
+      for (auto& file : i->second) {
+        auto size = file_size(file);
+        tbl.columns.push_back({offset, size});
+        offset += size;
+      }
+  }
+  // Write the table of contents followed by the column indexes into a
+  // temporary file, which replaces the target file only on success.
+  auto tmp = filename + ".tmp";
+  {
+    std::ofstream fs{tmp.str(), std::ios::binary};
+    if (!fs)
+      return make_error(ec::filesystem_error, "failed to create filestream",
+                        tmp);
+    if (auto err = save(nullptr, *fs.rdbuf(), magic, version, tables))
+      return err;
+    for (auto& [digest, tbl] : tables) {
+      auto i = columns.find(digest);
+      for (size_t column = 0; column < tbl.columns.size(); ++column) {
+        if (tbl.columns[column].size == 0)
+          continue;
+        std::ifstream in{i->second[column].str(), std::ios::binary};
+        if (!(fs << in.rdbuf()))
+          return make_error(ec::filesystem_error, "failed to copy",
+                            i->second[column]);
+      }
+    }
+    if (!fs.flush())
+      return make_error(ec::filesystem_error, "failed to write", tmp);
+  }
+  if (std::rename(tmp.str().c_str(), filename.str().c_str()) != 0)
+    return make_error(ec::filesystem_error, "failed to rename to", filename);
+  return caf::none;
+}
+
+path partition_file::filename(const path& dir) {
+  return dir + ".part";
+}
+
+const partition_file::table*
+partition_file::find(const std::string& digest) const {
+  auto i = tables_.find(digest);
+  return i != tables_.end() ? &i->second : nullptr;
+}
+
+chunk_ptr partition_file::column(const table& x, size_t column) const {
+  VAST_ASSERT(column < x.columns.size());
+  auto& range = x.columns[column];
+  if (range.size == 0)
+    return nullptr;
+  return chunk_->slice(payload_offset_ + range.offset, range.size);
+}
+
+} // namespace vast::system
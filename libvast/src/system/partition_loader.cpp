@@ -0,0 +1,51 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/partition_loader.hpp"
+
+#include <caf/event_based_actor.hpp>
+#include <caf/result.hpp>
+
+#include "vast/concept/printable/vast/filesystem.hpp"
+#include "vast/logger.hpp"
+#include "vast/system/atoms.hpp"
+
+using namespace caf;
+
+namespace vast::system {
+
+behavior partition_loader(event_based_actor* self) {
+  return {
+    [=](load_atom, const path& dir) -> result<partition::meta_data> {
+      VAST_DEBUG(self, "loads partition meta data from", dir);
+      // Partitions on disk are immutable, which allows us to migrate
+      // partitions from previous runs to the consolidated format.
+      if (exists(dir))
+        if (auto err = partition::seal(dir))
+          VAST_WARNING(self, "failed to seal partition", dir, ":",
+                       self->system().render(err));
+      auto md = partition::load_meta_data(dir);
+      if (!md)
+        return std::move(md.error());
+      return std::move(*md);
+    },
+    [=](persist_atom, const path& dir) {
+      VAST_DEBUG(self, "seals partition", dir);
+      if (auto err = partition::seal(dir))
+        VAST_WARNING(self, "failed to seal partition", dir, ":",
+                     self->system().render(err));
+    },
+  };
+}
+
+} // namespace vast::system
@@ -66,10 +66,10 @@ query_supervisor(caf::stateful_actor<query_supervisor_state>* self,
               VAST_DEBUG(self, "collected all results for partition", id);
               self->state.open_requests.erase(id);
               // Ask master for more work after receiving the last sub
-              // result.
+              // result. The master tracks the progress of the query and
+              // notifies the client when done.
               if (self->state.open_requests.empty()) {
                 VAST_DEBUG(self, "collected all results for all partitions");
-                self->send(client, done_atom::value);
                 self->send(master, worker_atom::value, self);
               }
             }
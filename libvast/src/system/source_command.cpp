@@ -13,7 +13,10 @@
 
 #include "vast/system/source_command.hpp"
 
+#include <algorithm>
 #include <csignal>
+#include <string>
+#include <vector>
 
 #include <caf/config_value.hpp>
 #include <caf/scoped_actor.hpp>
@@ -25,6 +28,7 @@
 #include "vast/expression.hpp"
 #include "vast/filesystem.hpp"
 #include "vast/logger.hpp"
+#include "vast/pattern.hpp"
 #include "vast/schema.hpp"
 #include "vast/scope_linked.hpp"
 
@@ -34,6 +38,7 @@
 
 #include "vast/system/accountant.hpp"
 #include "vast/system/signal_monitor.hpp"
+#include "vast/system/source_supervisor.hpp"
 #include "vast/system/spawn_or_connect_to_node.hpp"
 #include "vast/system/tracker.hpp"
 
@@ -65,12 +70,26 @@ caf::message source_command(const command& cmd, caf::actor_system& sys,
                             caf::actor src, caf::settings& options,
                             command::argument_iterator begin,
                             command::argument_iterator end) {
+  auto make_source = [src = std::move(src)](const std::string&) {
+    return caf::expected<caf::actor>{src};
+  };
+  return source_command(cmd, sys, {std::string{}}, std::move(make_source), 1,
+                        options, begin, end);
+}
+
+caf::message source_command(const command& cmd, caf::actor_system& sys,
+                            std::vector<std::string> inputs,
+                            source_factory make_source, size_t jobs,
+                            caf::settings& options,
+                            command::argument_iterator begin,
+                            command::argument_iterator end) {
   using namespace caf;
   using namespace std::chrono_literals;
   VAST_UNUSED(cmd);
+  VAST_ASSERT(!inputs.empty());
   // Helper for blocking actor communication.
   scoped_actor self{sys};
-  // Supply an alternate schema, if requested.
+  // Load an alternate schema, if requested.
   expected<vast::schema> schema{caf::none};
   if (auto sf = caf::get_if<std::string>(&options, "schema-file")) {
     if (caf::get_if<std::string>(&options, "schema"))
@@ -80,16 +99,15 @@ caf::message source_command(const command& cmd, caf::actor_system& sys,
   } else if (auto sc = caf::get_if<std::string>(&options, "schema")) {
     schema = to<vast::schema>(*sc);
   }
-  if (schema)
-    self->send(src, put_atom::value, std::move(*schema));
-  else if (schema.error())
+  if (!schema && schema.error())
     return make_message(std::move(schema.error()));
   // Attempt to parse the remainder as an expression.
+  caf::optional<expression> expr;
   if (begin != end) {
-    auto expr = parse_expression(begin, end);
-    if (!expr)
-      return make_message(std::move(expr.error()));
-    self->send(src, std::move(*expr));
+    auto x = parse_expression(begin, end);
+    if (!x)
+      return make_message(std::move(x.error()));
+    expr = std::move(*x);
   }
   // Get VAST node.
   auto node_opt = spawn_or_connect_to_node(self, "import.node", options,
@@ -105,18 +123,14 @@ caf::message source_command(const command& cmd, caf::actor_system& sys,
   auto guard = signal_monitor::run_guarded(sig_mon_thread, sys, 750ms, self);
   // Set defaults.
   caf::error err;
-  // Connect source to importers.
+  // Look up the accountant and the importer.
+  accountant_type accountant;
   caf::actor importer;
   self->request(node, infinite, get_atom::value).receive(
     [&](const std::string& id, system::registry& reg) {
-      // Assign accountant to source.
-      VAST_DEBUG(&cmd, "assigns accountant from node", id, "to new source");
       auto er = reg.components[id].equal_range("accountant");
-      if (er.first != er.second) {
-        auto accountant = er.first->second.actor;
-        self->send(src, actor_cast<accountant_type>(accountant));
-      }
-      // Assign IMPORTER to SOURCE and start streaming.
+      if (er.first != er.second)
+        accountant = actor_cast<accountant_type>(er.first->second.actor);
       er = reg.components[id].equal_range("importer");
       if (er.first == er.second) {
         err = make_error(ec::no_importer);
@@ -124,9 +138,7 @@ caf::message source_command(const command& cmd, caf::actor_system& sys,
         err = make_error(ec::unimplemented,
                          "multiple IMPORTER actors currently not supported");
       } else {
-        VAST_DEBUG(&cmd, "connects to importer");
         importer = er.first->second.actor;
-        self->send(src, system::sink_atom::value, importer);
       }
     },
     [&](error& e) {
@@ -135,37 +147,43 @@ caf::message source_command(const command& cmd, caf::actor_system& sys,
   );
   if (err)
     return make_message(std::move(err));
-  // Start the source.
-  bool stop = false;
-  self->monitor(src);
   self->monitor(importer);
+  // Spawn the supervisor that schedules a source per input.
+  caf::optional<vast::schema> sch;
+  if (schema)
+    sch = std::move(*schema);
+  auto blocking = caf::get_or(options, "import.blocking", false);
+  auto supervisor = sys.spawn(source_supervisor, std::move(inputs),
+                              std::move(make_source), jobs, importer,
+                              std::move(sch), std::move(expr),
+                              std::move(accountant), blocking);
+  self->monitor(supervisor);
+  bool stop = false;
   // clang-format off
   self->do_receive(
     [&](const down_msg& msg) {
       if (msg.source == importer)  {
+        // Wait for the DOWN of the supervisor so that no source outlives
+        // this command.
         VAST_DEBUG(&cmd, "received DOWN from node importer");
-        self->send_exit(src, exit_reason::user_shutdown);
+        self->send_exit(supervisor, exit_reason::user_shutdown);
         err = ec::remote_node_down;
-        stop = true;
-      } else if (msg.source == src) {
-        VAST_DEBUG(&cmd, "received DOWN from source");
-        if (caf::get_or(options, "import.blocking", false))
-          self->send(importer, subscribe_atom::value, flush_atom::value, self);
-        else
-          stop = true;
-      } else {
+        return;
+      }
+      if (msg.source != supervisor) {
         VAST_DEBUG(&cmd, "received unexpected DOWN from", msg.source);
         VAST_ASSERT(!"unexpected DOWN message");
+        return;
       }
-    },
-    [&](flush_atom) {
-      VAST_DEBUG(&cmd, "received flush from IMPORTER");
+      VAST_DEBUG(&cmd, "received DOWN from source supervisor");
+      if (!err && msg.reason && msg.reason != exit_reason::user_shutdown)
+        err = msg.reason;
       stop = true;
     },
     [&](system::signal_atom, int signal) {
       VAST_DEBUG(&cmd, "got " << ::strsignal(signal));
       if (signal == SIGINT || signal == SIGTERM)
-        self->send_exit(src, exit_reason::user_shutdown);
+        self->send_exit(supervisor, exit_reason::user_shutdown);
     }
   ).until(stop);
   // clang-format on
@@ -174,4 +192,32 @@ caf::message source_command(const command& cmd, caf::actor_system& sys,
   return caf::none;
 }
 
+caf::expected<std::vector<std::string>>
+expand_inputs(const std::string& input) {
+  auto p = path{input};
+  std::vector<std::string> result;
+  if (p.is_directory()) {
+    for (auto& entry : directory{p})
+      if (entry.is_regular_file())
+        result.push_back(entry.str());
+  } else {
+    auto name = p.basename().str();
+    if (name.find_first_of("*?") == std::string::npos)
+      return std::vector<std::string>{input};
+    auto dir = p.parent();
+    if (dir.empty())
+      dir = ".";
+    if (!dir.is_directory())
+      return make_error(ec::filesystem_error, "no such directory:", dir.str());
+    auto glob = pattern::glob(name);
+    for (auto& entry : directory{dir})
+      if (entry.is_regular_file() && glob.match(entry.basename().str()))
+        result.push_back(entry.str());
+  }
+  if (result.empty())
+    return make_error(ec::filesystem_error, "no files to read in", input);
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
 } // namespace vast::system
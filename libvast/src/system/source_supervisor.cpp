@@ -0,0 +1,125 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/source_supervisor.hpp"
+
+#include <algorithm>
+
+#include <caf/all.hpp>
+
+#include "vast/detail/assert.hpp"
+#include "vast/logger.hpp"
+
+#include "vast/system/atoms.hpp"
+
+using namespace caf;
+
+namespace vast::system {
+
+namespace {
+
+using supervisor_ptr = stateful_actor<source_supervisor_state>*;
+
+// Terminates all running sources and then the supervisor itself.
+void shutdown(supervisor_ptr self, const error& reason) {
+  for (auto& src : self->state.sources)
+    self->send_exit(src, exit_reason::user_shutdown);
+  self->state.sources.clear();
+  self->quit(reason);
+}
+
+// Spawns sources for the remaining inputs until reaching the number of
+// parallel jobs.
+error spawn_sources(supervisor_ptr self) {
+  auto& st = self->state;
+  while (st.sources.size() < st.jobs && st.next < st.inputs.size()) {
+    auto& input = st.inputs[st.next++];
+    auto src = st.make_source(input);
+    if (!src)
+      return std::move(src.error());
+    if (st.schema)
+      self->send(*src, put_atom::value, *st.schema);
+    if (st.expr)
+      self->send(*src, *st.expr);
+    if (st.accountant) {
+      VAST_DEBUG(self, "assigns accountant to new source");
+      self->send(*src, st.accountant);
+    }
+    // Assign IMPORTER to SOURCE and start streaming.
+    VAST_DEBUG(self, "connects source for", input, "to importer");
+    self->send(*src, sink_atom::value, st.importer);
+    self->monitor(*src);
+    st.sources.push_back(std::move(*src));
+  }
+  return caf::none;
+}
+
+} // namespace <anonymous>
+
+behavior source_supervisor(stateful_actor<source_supervisor_state>* self,
+                           std::vector<std::string> inputs,
+                           source_factory make_source, size_t jobs,
+                           actor importer, caf::optional<vast::schema> schema,
+                           caf::optional<expression> expr,
+                           accountant_type accountant, bool blocking) {
+  VAST_ASSERT(!inputs.empty());
+  auto& st = self->state;
+  st.inputs = std::move(inputs);
+  st.make_source = std::move(make_source);
+  st.jobs = std::max(jobs, size_t{1});
+  st.importer = std::move(importer);
+  st.schema = std::move(schema);
+  st.expr = std::move(expr);
+  st.accountant = std::move(accountant);
+  st.blocking = blocking;
+  self->set_exit_handler([=](const exit_msg& msg) {
+    shutdown(self, msg.reason);
+  });
+  self->set_down_handler([=](const down_msg& msg) {
+    auto& st = self->state;
+    auto is_source = [&](const actor& src) { return msg.source == src; };
+    auto i = std::find_if(st.sources.begin(), st.sources.end(), is_source);
+    if (i == st.sources.end()) {
+      VAST_DEBUG(self, "received unexpected DOWN from", msg.source);
+      return;
+    }
+    VAST_DEBUG(self, "received DOWN from source");
+    st.sources.erase(i);
+    if (st.inputs.size() > 1)
+      VAST_INFO(self, "finished", st.next - st.sources.size(), "of",
+                st.inputs.size(), "inputs");
+    if (auto err = spawn_sources(self)) {
+      shutdown(self, err);
+      return;
+    }
+    if (!st.sources.empty())
+      return;
+    if (st.blocking)
+      self->send(st.importer, subscribe_atom::value, flush_atom::value,
+                 actor_cast<actor>(self));
+    else
+      self->quit();
+  });
+  if (auto err = spawn_sources(self)) {
+    shutdown(self, err);
+    return {};
+  }
+  return {
+    [=](flush_atom) {
+      VAST_DEBUG(self, "received flush from IMPORTER");
+      self->quit();
+    },
+  };
+}
+
+} // namespace vast::system
@@ -20,6 +20,7 @@
 
 #include "vast/defaults.hpp"
 #include "vast/detail/unbox_var.hpp"
+#include "vast/error.hpp"
 #include "vast/system/importer.hpp"
 #include "vast/system/node.hpp"
 #include "vast/system/spawn_arguments.hpp"
@@ -29,11 +30,29 @@ namespace vast::system {
 maybe_actor spawn_importer(node_actor* self, spawn_arguments& args) {
   if (!args.empty())
     return unexpected_arguments(args);
+  auto& cfg = self->system().config();
+  // The spawn option takes precedence over the system-wide configuration.
+  auto policy = caf::get_or(args.options, "routing",
+                            caf::get_or(cfg, "system.index-routing",
+                                        defaults::system::index_routing));
+  index_routing routing;
+  switch (caf::atom_uint(policy)) {
+    case caf::atom_uint("roundrobin"):
+      routing = index_routing::round_robin;
+      break;
+    case caf::atom_uint("layout"):
+      routing = index_routing::layout;
+      break;
+    default:
+      return make_error(ec::invalid_configuration,
+                        "invalid index routing policy",
+                        caf::to_string(policy));
+  }
   // FIXME: Notify exporters with a continuous query.
   return self->spawn(importer, args.dir / args.label,
-                     caf::get_or(self->system().config(),
-                                 "system.table-slice-size",
-                                 defaults::system::table_slice_size));
+                     caf::get_or(cfg, "system.table-slice-size",
+                                 defaults::system::table_slice_size),
+                     routing);
 }
 
 } // namespace vast::system
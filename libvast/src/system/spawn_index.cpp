@@ -14,15 +14,21 @@
 #include "vast/system/spawn_index.hpp"
 
 #include <caf/actor.hpp>
+#include <caf/actor_system_config.hpp>
 #include <caf/expected.hpp>
 #include <caf/settings.hpp>
 
 #include "vast/defaults.hpp"
 #include "vast/detail/unbox_var.hpp"
+#include "vast/error.hpp"
+#include "vast/logger.hpp"
+#include "vast/si_literals.hpp"
 #include "vast/system/index.hpp"
 #include "vast/system/node.hpp"
 #include "vast/system/spawn_arguments.hpp"
 
+using namespace vast::binary_byte_literals;
+
 namespace vast::system {
 
 maybe_actor spawn_index(caf::local_actor* self, spawn_arguments& args) {
@@ -32,11 +38,36 @@ maybe_actor spawn_index(caf::local_actor* self, spawn_arguments& args) {
     return get_or(args.options, key, default_value);
   };
   namespace sd = vast::defaults::system;
+  // The spawn option takes precedence over the system-wide configuration.
+  auto strategy = opt("evaluation",
+                      caf::get_or(self->system().config(),
+                                  "system.index-evaluation",
+                                  sd::index_evaluation));
+  evaluation_engine engine;
+  switch (caf::atom_uint(strategy)) {
+    case caf::atom_uint("actors"):
+      engine = evaluation_engine::actors;
+      break;
+    case caf::atom_uint("inprocess"):
+      engine = evaluation_engine::in_process;
+      break;
+    default:
+      return make_error(ec::invalid_configuration,
+                        "invalid index evaluation strategy",
+                        caf::to_string(strategy));
+  }
+  // The partition cache used to hold a fixed number of partitions, which
+  // does not translate into a size limit.
+  if (caf::get_if<size_t>(&args.options, "max-parts"))
+    VAST_WARNING(self, "ignores the deprecated option max-parts, use "
+                       "max-resident-size instead");
   return self->spawn(index, args.dir / args.label,
                      opt("max-events", sd::max_partition_size),
-                     opt("max-parts", sd::max_in_mem_partitions),
+                     1_MiB * opt("max-resident-size",
+                                 sd::max_resident_size),
                      opt("taste-parts", sd::taste_partitions),
-                     opt("max_queries", sd::num_query_supervisors));
+                     opt("max-queries", sd::num_query_supervisors),
+                     opt("meta-indexers", sd::num_meta_indexers), engine);
 }
 
 } // namespace vast::system
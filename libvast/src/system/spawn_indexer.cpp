@@ -16,6 +16,7 @@
 #include <caf/actor.hpp>
 #include <caf/local_actor.hpp>
 
+#include "vast/chunk.hpp"
 #include "vast/filesystem.hpp"
 #include "vast/logger.hpp"
 #include "vast/system/indexer.hpp"
@@ -33,4 +34,15 @@ caf::actor spawn_indexer(caf::local_actor* parent, path dir, type column_type,
                                        std::move(index), partition_id, m);
 }
 
+caf::actor spawn_sealed_indexer(caf::local_actor* parent, chunk_ptr state,
+                                type column_type, size_t column,
+                                caf::actor index, uuid partition_id,
+                                atomic_measurement* m) {
+  VAST_TRACE(VAST_ARG(column_type), VAST_ARG(column), VAST_ARG(index),
+             VAST_ARG(partition_id), VAST_ARG(*m));
+  return parent->spawn<caf::lazy_init>(sealed_indexer, std::move(state),
+                                       std::move(column_type), column,
+                                       std::move(index), partition_id, m);
+}
+
 } // namespace vast::system
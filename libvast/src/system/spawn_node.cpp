@@ -13,6 +13,8 @@
 
 #include "vast/system/spawn_node.hpp"
 
+#include <algorithm>
+#include <list>
 #include <string>
 #include <vector>
 
@@ -34,6 +36,8 @@ expected<scope_linked_actor> spawn_node(caf::scoped_actor& self,
   auto id = get_or(opts, "system.node-id", defaults::system::node_id);
   auto dir = get_or(opts, "system.directory", defaults::system::directory);
   auto abs_dir = path{dir}.complete();
+  auto index_shards = get_or(opts, "system.index-shards",
+                             defaults::system::index_shards);
   VAST_DEBUG_ANON(__func__, "spawns local node:", id);
   // Pointer to the root command to system::node.
   scope_linked_actor node{self->spawn(system::node, id, abs_dir)};
@@ -45,9 +49,13 @@ expected<scope_linked_actor> spawn_node(caf::scoped_actor& self,
                [&](caf::error& e) { result = std::move(e); });
     return result;
   };
-  std::list components = {"consensus", "archive", "index", "importer"};
+  std::list<std::string> components = {"consensus", "archive"};
   if (accounting)
     components.push_front("accountant");
+  // Spawn all INDEX shards before the IMPORTER so that it routes to each.
+  for (size_t i = 0; i < std::max(index_shards, size_t{1}); ++i)
+    components.emplace_back("index");
+  components.emplace_back("importer");
   for (auto& c : components) {
     if (auto err = spawn_component(c)) {
       VAST_ERROR(self, self->system().render(err));
@@ -13,8 +13,10 @@
 
 #include "vast/system/table_indexer.hpp"
 
+#include "vast/chunk.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/detail/string.hpp"
+#include "vast/error.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/load.hpp"
 #include "vast/logger.hpp"
@@ -37,7 +39,8 @@ table_indexer::table_indexer(partition* parent, const record_type& layout)
     indexers_(layout.fields.size()),
     measurements_(layout.fields.size()),
     last_flush_size_(0),
-    skip_mask_(0) {
+    skip_mask_(0),
+    sealed_(nullptr) {
   VAST_ASSERT(partition_ != nullptr);
   VAST_ASSERT(layout.fields.size() > 0);
   VAST_TRACE(VAST_ARG(type_erased_layout_));
@@ -58,6 +61,15 @@ table_indexer::~table_indexer() noexcept {
 
 caf::error table_indexer::init() {
   VAST_TRACE("");
+  if (auto file = partition_->file(); file != nullptr) {
+    sealed_ = file->find(to_digest(layout()));
+    if (sealed_ == nullptr)
+      return make_error(ec::format_error,
+                        "sealed partition lacks table of layout");
+    row_ids_ = sealed_->row_ids;
+    set_clean();
+    return caf::none;
+  }
   auto filename = row_ids_file();
   if (exists(filename))
     if (auto err = load(nullptr, filename, row_ids_))
@@ -91,9 +103,15 @@ caf::actor& table_indexer::indexer_at(size_t column) {
   VAST_ASSERT(column < indexers_.size());
   auto& result = indexers_[column];
   if (!result) {
-    result = state().make_indexer(column_file(column),
-                                  layout().fields[column].type, column,
-                                  partition_->id(), &measurements_[column]);
+    if (sealed_ != nullptr)
+      result = state().make_indexer(partition_->file()->column(*sealed_,
+                                                               column),
+                                    layout().fields[column].type, column,
+                                    partition_->id(), &measurements_[column]);
+    else
+      result = state().make_indexer(column_file(column),
+                                    layout().fields[column].type, column,
+                                    partition_->id(), &measurements_[column]);
     VAST_ASSERT(result != nullptr);
   }
   return result;
@@ -131,8 +149,13 @@ path table_indexer::data_dir() const {
 }
 
 path table_indexer::column_file(size_t column) const {
-  return data_dir()
-         / detail::replace_all(layout().fields[column].name, ".",
+  return column_file(base_dir(), layout(), column);
+}
+
+path table_indexer::column_file(const path& base_dir,
+                                const record_type& layout, size_t column) {
+  return base_dir / "data"
+         / detail::replace_all(layout.fields[column].name, ".",
                                path::separator);
 }
 
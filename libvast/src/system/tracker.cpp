@@ -147,6 +147,10 @@ void register_component(scheduled_actor* self, tracker_state& st,
       anon_send(component, index_atom::value, a);
     for (auto& a : actors("source"))
       anon_send(a, sink_atom::value, component);
+  } else if (type == "index") {
+    // Additional INDEX actors become new shards at running IMPORTERs.
+    for (auto& a : actors("importer"))
+      anon_send(a, index_atom::value, component);
   } else if (type == "source") {
     for (auto& a : actors("importer"))
       anon_send(component, sink_atom::value, a);
@@ -165,7 +169,7 @@ void register_component(scheduled_actor* self, tracker_state& st,
 
 // Checks whether a component can be spawned at most once.
 bool is_singleton(const std::string& component) {
-  const char* singletons[] = {"archive", "index", "consensus"};
+  const char* singletons[] = {"archive", "consensus"};
   auto pred = [&](const char* lhs) { return lhs == component; };
   return std::any_of(std::begin(singletons), std::end(singletons), pred);
 }
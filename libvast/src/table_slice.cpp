@@ -84,8 +84,13 @@ caf::error table_slice::load(chunk_ptr chunk) {
 
 void table_slice::append_column_to_index(size_type col,
                                          value_index& idx) const {
+  append_column_to_index(col, idx, offset());
+}
+
+void table_slice::append_column_to_index(size_type col, value_index& idx,
+                                         id first) const {
   for (size_type row = 0; row < rows(); ++row)
-    idx.append(at(row, col), offset() + row);
+    idx.append(at(row, col), first + row);
 }
 
 expected<std::vector<table_slice_ptr>>
@@ -228,4 +233,14 @@ caf::error inspect(caf::deserializer& source, table_slice_ptr& ptr) {
   return ptr.unshared().deserialize(source);
 }
 
+caf::error serialize_without_layout(caf::serializer& sink,
+                                    const table_slice_ptr& ptr) {
+  VAST_ASSERT(ptr != nullptr);
+  auto& header = ptr->header();
+  return caf::error::eval(
+    [&] { return sink(ptr->implementation_id()); },
+    [&] { return sink(header.rows, header.offset); },
+    [&] { return ptr->serialize(sink); });
+}
+
 } // namespace vast
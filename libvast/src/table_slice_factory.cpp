@@ -16,6 +16,7 @@
 #include <caf/binary_deserializer.hpp>
 
 #include "vast/chunk.hpp"
+#include "vast/columnar_table_slice.hpp"
 #include "vast/default_table_slice.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/detail/narrow.hpp"
@@ -25,8 +26,33 @@ namespace vast {
 
 void factory_traits<table_slice>::initialize() {
   factory<table_slice>::add<default_table_slice>();
+  factory<table_slice>::add<columnar_table_slice>();
 }
 
+namespace {
+
+// Constructs a table slice from a header and loads its contents from the
+// remainder of a chunk.
+table_slice_ptr make_and_load(caf::atom_value id, table_slice_header header,
+                              const chunk_ptr& chunk,
+                              caf::binary_deserializer& source) {
+  auto result = factory<table_slice>::make(id, std::move(header));
+  if (!result) {
+    VAST_ERROR_ANON(__func__, "failed to make table slice for:", to_string(id));
+    return nullptr;
+  }
+  // Skip table slice data already processed.
+  using detail::narrow_cast;
+  auto bytes_read = narrow_cast<size_t>(source.current() - chunk->data());
+  if (auto err = result.unshared().load(chunk->slice(bytes_read))) {
+    VAST_ERROR_ANON(__func__, "failed to load table slice from chunk");
+    return nullptr;
+  }
+  return result;
+}
+
+} // namespace <anonymous>
+
 table_slice_ptr factory_traits<table_slice>::make(chunk_ptr chunk) {
   if (chunk == nullptr)
     return nullptr;
@@ -39,19 +65,23 @@ table_slice_ptr factory_traits<table_slice>::make(chunk_ptr chunk) {
     VAST_ERROR_ANON(__func__, "failed to deserialize table slice meta data");
     return nullptr;
   }
-  auto result = factory<table_slice>::make(id, std::move(header));
-  if (!result) {
-    VAST_ERROR_ANON(__func__, "failed to make table slice for:", to_string(id));
+  return make_and_load(id, std::move(header), chunk, source);
+}
+
+table_slice_ptr factory_traits<table_slice>::make(chunk_ptr chunk,
+                                                  record_type layout) {
+  if (chunk == nullptr)
     return nullptr;
-  }
-  // Skip table slice data already processed.
-  using detail::narrow_cast;
-  auto bytes_read = narrow_cast<size_t>(source.current() - chunk->data());
-  if (auto err = result.unshared().load(chunk->slice(bytes_read))) {
-    VAST_ERROR_ANON(__func__, "failed to load table slice from chunk");
+  caf::binary_deserializer source{nullptr, chunk->data(), chunk->size()};
+  // The chunk holds everything but the layout.
+  caf::atom_value id;
+  table_slice_header header;
+  if (auto err = source(id, header.rows, header.offset)) {
+    VAST_ERROR_ANON(__func__, "failed to deserialize table slice meta data");
     return nullptr;
   }
-  return result;
+  header.layout = std::move(layout);
+  return make_and_load(id, std::move(header), chunk, source);
 }
 
 } // namespace vast
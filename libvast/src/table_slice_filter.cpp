@@ -0,0 +1,391 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/table_slice_filter.hpp"
+
+#include <functional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <caf/optional.hpp>
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/columnar_table_slice.hpp"
+#include "vast/data.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/type_traits.hpp"
+#include "vast/expression_visitors.hpp"
+#include "vast/system/atoms.hpp"
+#include "vast/table_slice.hpp"
+
+namespace vast {
+
+namespace {
+
+bool is_relational(relational_operator op) {
+  switch (op) {
+    default:
+      return false;
+    case equal:
+    case not_equal:
+    case less:
+    case less_equal:
+    case greater:
+    case greater_equal:
+      return true;
+  }
+}
+
+template <class T, class U>
+bool compare(const T& x, relational_operator op, const U& y) {
+  switch (op) {
+    default:
+      VAST_ASSERT(!"not a relational operator");
+      return false;
+    case equal:
+      return x == y;
+    case not_equal:
+      return x != y;
+    case less:
+      return x < y;
+    case less_equal:
+      return x <= y;
+    case greater:
+      return x > y;
+    case greater_equal:
+      return x >= y;
+  }
+}
+
+/// Creates a function that checks a single value against the right-hand side
+/// of a predicate. The common cases operate directly on the view; everything
+/// else materializes the value and falls back to `evaluate`.
+std::function<bool(data_view)> make_check(relational_operator op, data rhs) {
+  auto fallback = [=](data_view x) {
+    return evaluate(materialize(x), op, rhs);
+  };
+  auto f = [&](const auto& y) -> std::function<bool(data_view)> {
+    using rhs_type = std::decay_t<decltype(y)>;
+    if constexpr (detail::is_any_v<rhs_type, boolean, integer, count, real,
+                                   timespan, timestamp, port, address,
+                                   subnet>) {
+      if (is_relational(op))
+        return [=](data_view x) {
+          if (auto z = caf::get_if<rhs_type>(&x))
+            return compare(*z, op, y);
+          return fallback(x);
+        };
+      if constexpr (std::is_same_v<rhs_type, subnet>)
+        if (op == in || op == not_in)
+          return [=](data_view x) {
+            if (auto z = caf::get_if<address>(&x))
+              return y.contains(*z) == (op == in);
+            return fallback(x);
+          };
+    } else if constexpr (std::is_same_v<rhs_type, std::string>) {
+      if (is_relational(op))
+        return [=](data_view x) {
+          if (auto z = caf::get_if<std::string_view>(&x))
+            return compare(*z, op, std::string_view{y});
+          return fallback(x);
+        };
+      if (op == ni || op == not_ni)
+        return [=](data_view x) {
+          if (auto z = caf::get_if<std::string_view>(&x))
+            return (z->find(y) != std::string_view::npos) == (op == ni);
+          return fallback(x);
+        };
+    } else if constexpr (std::is_same_v<rhs_type, pattern>) {
+      if (op == match || op == not_match)
+        return [=](data_view x) {
+          if (auto z = caf::get_if<std::string_view>(&x))
+            return y.match(*z) == (op == match);
+          return fallback(x);
+        };
+    }
+    return fallback;
+  };
+  return caf::visit(f, rhs);
+}
+
+using scan_function
+  = std::function<caf::optional<ids>(const table_slice&, size_t)>;
+
+/// Creates a function that selects the rows of an entire fixed-width column
+/// of a columnar table slice that fulfill a relational predicate. The
+/// function yields `caf::none` for other slices and columns, for which the
+/// filter falls back to checking one value at a time.
+/// @param nil_hit The outcome of the predicate for nil cells.
+template <class T>
+scan_function make_scan(relational_operator op, T y, bool nil_hit) {
+  auto scan = [=](auto cmp) -> scan_function {
+    return [=](const table_slice& slice, size_t column) -> caf::optional<ids> {
+      if (slice.implementation_id() != columnar_table_slice::class_id)
+        return caf::none;
+      auto& xs = static_cast<const columnar_table_slice&>(slice);
+      auto first = slice.offset();
+      ids hits{first, false};
+      ids valid{first, false};
+      auto f = [&](size_t row, T x) {
+        if (nil_hit) {
+          valid.append_bits(false, first + row - valid.size());
+          valid.append_bit(true);
+        }
+        if (cmp(x, y)) {
+          hits.append_bits(false, first + row - hits.size());
+          hits.append_bit(true);
+        }
+      };
+      if (!xs.for_each_value<T>(column, f))
+        return caf::none;
+      if (nil_hit) {
+        ids rows{first, false};
+        rows.append_bits(true, slice.rows());
+        hits |= rows - valid;
+      }
+      return hits;
+    };
+  };
+  switch (op) {
+    default:
+      return {};
+    case equal:
+      return scan(std::equal_to<>{});
+    case not_equal:
+      return scan(std::not_equal_to<>{});
+    case less:
+      return scan(std::less<>{});
+    case less_equal:
+      return scan(std::less_equal<>{});
+    case greater:
+      return scan(std::greater<>{});
+    case greater_equal:
+      return scan(std::greater_equal<>{});
+  }
+}
+
+/// Creates a column scan for the right-hand side of a predicate if it has an
+/// arithmetic or time type.
+scan_function make_scan(relational_operator op, const data& rhs,
+                        bool nil_hit) {
+  auto f = [&](const auto& y) -> scan_function {
+    using rhs_type = std::decay_t<decltype(y)>;
+    if constexpr (detail::is_any_v<rhs_type, integer, count, real, timespan,
+                                   timestamp>)
+      return make_scan(op, y, nil_hit);
+    else
+      return {};
+  };
+  return caf::visit(f, rhs);
+}
+
+} // namespace <anonymous>
+
+/// Translates a tailored expression into the nodes of a filter. Mirrors the
+/// semantics of the ::event_evaluator.
+struct table_slice_filter::compiler {
+  size_t operator()(caf::none_t) {
+    return constant(false);
+  }
+
+  size_t operator()(const conjunction& xs) {
+    return connective(node_kind::conjunction, xs);
+  }
+
+  size_t operator()(const disjunction& xs) {
+    return connective(node_kind::disjunction, xs);
+  }
+
+  size_t operator()(const negation& n) {
+    auto i = add(node_kind::negation);
+    auto child = caf::visit(*this, n.expr());
+    self.nodes_[i].children.push_back(child);
+    return i;
+  }
+
+  size_t operator()(const predicate& p) {
+    op = p.op;
+    return caf::visit(*this, p.lhs, p.rhs);
+  }
+
+  size_t operator()(const attribute_extractor& e, const data& d) {
+    if (e.attr == system::type_atom::value)
+      return constant(vast::evaluate(data{self.layout_.name()}, op, d));
+    if (e.attr == system::time_atom::value) {
+      auto check = make_check(op, d);
+      if (auto column = find_time_column(self.layout_))
+        return predicate(
+          *column,
+          [=](data_view x) {
+            if (caf::holds_alternative<caf::none_t>(x))
+              return check(timestamp{});
+            return check(x);
+          },
+          make_scan(op, d, check(timestamp{})));
+      return constant(check(timestamp{}));
+    }
+    return constant(false);
+  }
+
+  size_t operator()(const data_extractor& e, const data& d) {
+    if (e.type != type{self.layout_})
+      return constant(false);
+    if (e.offset.empty())
+      return predicate(npos, make_check(op, d));
+    if (auto column = self.layout_.flat_index_at(e.offset))
+      return predicate(*column, make_check(op, d),
+                       make_scan(op, d, vast::evaluate(data{}, op, d)));
+    return constant(false);
+  }
+
+  template <class T>
+  size_t operator()(const data& d, const T& x) {
+    return (*this)(x, d);
+  }
+
+  template <class T, class U>
+  size_t operator()(const T&, const U&) {
+    return constant(false);
+  }
+
+  template <class Connective>
+  size_t connective(node_kind kind, const Connective& xs) {
+    auto i = add(kind);
+    for (auto& x : xs) {
+      auto child = caf::visit(*this, x);
+      self.nodes_[i].children.push_back(child);
+    }
+    return i;
+  }
+
+  size_t constant(bool value) {
+    auto i = add(node_kind::constant);
+    self.nodes_[i].value = value;
+    return i;
+  }
+
+  size_t predicate(size_t column, std::function<bool(data_view)> check,
+                   scan_function scan = {}) {
+    auto i = add(node_kind::predicate);
+    self.nodes_[i].column = column;
+    self.nodes_[i].check = std::move(check);
+    self.nodes_[i].scan = std::move(scan);
+    return i;
+  }
+
+  size_t add(node_kind kind) {
+    self.nodes_.emplace_back();
+    self.nodes_.back().kind = kind;
+    return self.nodes_.size() - 1;
+  }
+
+  table_slice_filter& self;
+  relational_operator op;
+};
+
+caf::expected<table_slice_filter>
+table_slice_filter::make(const expression& expr, record_type layout) {
+  auto tailored = tailor(expr, type{layout});
+  if (!tailored)
+    return tailored.error();
+  table_slice_filter result;
+  result.expr_ = std::move(*tailored);
+  result.layout_ = std::move(layout);
+  compiler c{result, equal};
+  auto root = caf::visit(c, result.expr_);
+  VAST_ASSERT(root == 0);
+  static_cast<void>(root);
+  return result;
+}
+
+ids table_slice_filter::operator()(const table_slice& slice,
+                                   const ids& candidates) const {
+  VAST_ASSERT(slice.layout() == layout_);
+  // Restrict the candidates to the rows of the slice.
+  ids rows{slice.offset(), false};
+  rows.append_bits(true, slice.rows());
+  auto xs = candidates & rows;
+  if (all<0>(xs))
+    return {};
+  return evaluate(0, slice, xs);
+}
+
+const expression& table_slice_filter::expr() const {
+  return expr_;
+}
+
+const record_type& table_slice_filter::layout() const {
+  return layout_;
+}
+
+ids table_slice_filter::evaluate(size_t i, const table_slice& slice,
+                                 const ids& xs) const {
+  auto& x = nodes_[i];
+  switch (x.kind) {
+    case node_kind::constant:
+      return x.value ? xs : ids{};
+    case node_kind::conjunction: {
+      auto result = xs;
+      for (auto child : x.children) {
+        if (all<0>(result))
+          break;
+        result = evaluate(child, slice, result);
+      }
+      return result;
+    }
+    case node_kind::disjunction: {
+      ids result;
+      auto remaining = xs;
+      for (auto child : x.children) {
+        if (all<0>(remaining))
+          break;
+        auto hits = evaluate(child, slice, remaining);
+        remaining -= hits;
+        result |= hits;
+      }
+      return result;
+    }
+    case node_kind::negation:
+      VAST_ASSERT(x.children.size() == 1);
+      return xs - evaluate(x.children[0], slice, xs);
+    case node_kind::predicate: {
+      if (x.scan)
+        if (auto hits = x.scan(slice, x.column))
+          return *hits & xs;
+      ids result;
+      auto first = slice.offset();
+      for (auto rng = select(xs); rng; rng.next()) {
+        auto row = rng.get() - first;
+        bool hit;
+        if (x.column == npos) {
+          vector values(slice.columns());
+          for (size_t col = 0; col < slice.columns(); ++col)
+            values[col] = materialize(slice.at(row, col));
+          hit = x.check(make_view(values));
+        } else {
+          hit = x.check(slice.at(row, x.column));
+        }
+        if (hit) {
+          result.append_bits(false, rng.get() - result.size());
+          result.append_bit(true);
+        }
+      }
+      return result;
+    }
+  }
+  VAST_ASSERT(!"unhandled node kind");
+  return {};
+}
+
+} // namespace vast
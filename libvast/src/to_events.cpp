@@ -26,13 +26,6 @@ namespace vast {
 
 namespace {
 
-optional<size_t> find_time_column(record_type layout) {
-  for (size_t i = 0; i < layout.fields.size(); ++i)
-    if (has_attribute(layout.fields[i].type, "time"))
-      return i;
-  return caf::none;
-}
-
 event to_event(const table_slice& slice, id eid, type event_layout,
                caf::optional<size_t> timestamp_column) {
   VAST_ASSERT(slice.columns() > 0);
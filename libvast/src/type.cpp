@@ -882,6 +882,13 @@ json jsonize(const type& x) {
 
 } // namespace <anonymous>
 
+caf::optional<size_t> find_time_column(const record_type& layout) {
+  for (size_t i = 0; i < layout.fields.size(); ++i)
+    if (has_attribute(layout.fields[i].type, "time"))
+      return i;
+  return caf::none;
+}
+
 bool convert(const type& t, json& j) {
   json::object o;
   o["name"] = t.name();
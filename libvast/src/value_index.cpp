@@ -11,12 +11,67 @@
  * contained in the LICENSE file.                                             *
  ******************************************************************************/
 
+#include <algorithm>
 #include <cmath>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "vast/base.hpp"
+#include "vast/concept/hashable/xxhash.hpp"
+#include "vast/detail/regex.hpp"
 #include "vast/value_index.hpp"
 
 namespace vast {
+namespace {
+
+// Pads a bitmap that only grows on append to the full size of an index.
+ids pad(const ids& bm, size_t n) {
+  auto result = bm;
+  result.append_bits(false, n - result.size());
+  return result;
+}
+
+// -- trigram utilities --------------------------------------------------------
+
+constexpr char trigram_begin = '\x02';
+
+constexpr char trigram_end = '\x03';
+
+uint32_t pack_trigram(const char* x) {
+  return static_cast<uint32_t>(static_cast<uint8_t>(x[0])) << 16
+         | static_cast<uint32_t>(static_cast<uint8_t>(x[1])) << 8
+         | static_cast<uint32_t>(static_cast<uint8_t>(x[2]));
+}
+
+// Computes the distinct trigrams of a string.
+std::vector<uint32_t> trigrams(std::string_view x) {
+  std::vector<uint32_t> result;
+  if (x.size() < 3)
+    return result;
+  result.reserve(x.size() - 2);
+  for (size_t i = 0; i + 2 < x.size(); ++i)
+    result.push_back(pack_trigram(x.data() + i));
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+// Delimits a string with markers such that even the empty string consists of
+// at least one trigram.
+std::string delimit(std::string_view x, bool terminate) {
+  std::string result;
+  result.reserve(x.size() + 3);
+  result += trigram_begin;
+  result.append(x.data(), x.size());
+  if (terminate)
+    do
+      result += trigram_end;
+    while (result.size() < 3);
+  return result;
+}
+
+} // namespace <anonymous>
 
 // -- value_index --------------------------------------------------------------
 
@@ -48,12 +103,58 @@ expected<void> value_index::append(data_view x, id pos) {
   return {};
 }
 
+expected<void> value_index::append(value_span xs,
+                                   span<const uint64_t> validity, id first) {
+  auto n = caf::visit([](auto ys) { return static_cast<size_t>(ys.size()); },
+                      xs);
+  VAST_ASSERT(static_cast<size_t>(validity.size()) * 64 >= n);
+  auto off = mask_.size();
+  if (first < off)
+    // Can only append at the end
+    return make_error(ec::unspecified, first, '<', off);
+  if (n == 0)
+    return {};
+  // Reject values of the wrong type before touching any state, so that a
+  // failed append leaves the index unchanged.
+  auto well_typed = caf::visit(
+    [&](auto ys) {
+      using value_type = std::decay_t<decltype(ys[0])>;
+      return type_check(type(), data{value_type{}});
+    },
+    xs);
+  if (!well_typed)
+    return make_error(ec::type_clash, "cannot append values in bulk to",
+                      type());
+  if (!bulk_append_impl(xs, validity.data(), first)) {
+    auto value_type = caf::visit(
+      [](auto ys) -> vast::type {
+        return data_to_type<std::decay_t<decltype(ys[0])>>{};
+      },
+      xs);
+    return make_error(ec::type_clash, "failed to append values of type",
+                      value_type, "in bulk to", type());
+  }
+  for (size_t i = 0; i < n; i += 64) {
+    auto m = std::min(n - i, size_t{64});
+    auto nils = ~validity[i / 64];
+    if (m < 64)
+      nils &= (uint64_t{1} << m) - 1;
+    if (nils != 0) {
+      none_.append_bits(false, first + i - none_.size());
+      none_.append_block(nils, m);
+    }
+  }
+  mask_.append_bits(false, first - off);
+  mask_.append_bits(true, n);
+  return {};
+}
+
 expected<ids> value_index::lookup(relational_operator op, data_view x) const {
   if (caf::holds_alternative<caf::none_t>(x)) {
     if (op == equal)
       return none_ & mask_;
     if (op == not_equal)
-      return ~none_ & mask_;
+      return mask_ - none_;
     return make_error(ec::unsupported_operator, op);
   }
   auto result = lookup_impl(op, x);
@@ -62,6 +163,45 @@ expected<ids> value_index::lookup(relational_operator op, data_view x) const {
   return (*result - none_) & mask_;
 }
 
+expected<void> value_index::merge(const value_index& other, id first) {
+  auto off = mask_.size();
+  if (first < off)
+    // Can only append at the end
+    return make_error(ec::unspecified, first, '<', off);
+  if (type() != other.type())
+    return make_error(ec::type_clash, "cannot merge value indexes of "
+                                      "different types");
+  if (!merge_impl(other, first))
+    return make_error(ec::unspecified, "merge_impl");
+  if (!other.none_.empty()) {
+    none_.append_bits(false, first - none_.size());
+    none_.append(other.none_);
+  }
+  mask_.append_bits(false, first - off);
+  mask_.append(other.mask_);
+  return {};
+}
+
+bool value_index::mergeable() const {
+  return false;
+}
+
+bool value_index::bulk_append_impl(const value_span& xs,
+                                   const uint64_t* validity, id first) {
+  auto append = [&](auto ys) {
+    for (size_t i = 0; i < static_cast<size_t>(ys.size()); ++i)
+      if ((validity[i / 64] >> (i % 64)) & 1)
+        if (!append_impl(make_view(ys[i]), first + i))
+          return false;
+    return true;
+  };
+  return caf::visit(append, xs);
+}
+
+bool value_index::merge_impl(const value_index&, id) {
+  return false;
+}
+
 value_index::size_type value_index::offset() const {
   return mask_.size();
 }
@@ -125,6 +265,10 @@ caf::error string_index::deserialize(caf::deserializer& source) {
                           [&] { return source(max_length_, length_, chars_); });
 }
 
+bool string_index::mergeable() const {
+  return true;
+}
+
 void string_index::init() {
   if (length_.coder().storage().empty()) {
     size_t components = std::log10(max_length_);
@@ -153,6 +297,25 @@ bool string_index::append_impl(data_view x, id pos) {
   return true;
 }
 
+bool string_index::merge_impl(const value_index& other, id first) {
+  auto x = dynamic_cast<const string_index*>(&other);
+  if (x == nullptr || x->max_length_ != max_length_)
+    return false;
+  // The other index has not seen a string yet.
+  if (x->length_.coder().storage().empty())
+    return true;
+  init();
+  if (x->chars_.size() > chars_.size())
+    chars_.resize(x->chars_.size(), char_bitmap_index{8});
+  for (auto i = 0u; i < x->chars_.size(); ++i) {
+    chars_[i].skip(first - chars_[i].size());
+    chars_[i].append(x->chars_[i]);
+  }
+  length_.skip(first - length_.size());
+  length_.append(x->length_);
+  return true;
+}
+
 expected<ids>
 string_index::lookup_impl(relational_operator op, data_view x) const {
   return caf::visit(detail::overload(
@@ -222,6 +385,274 @@ string_index::lookup_impl(relational_operator op, data_view x) const {
   ), x);
 }
 
+// -- hash_index ---------------------------------------------------------------
+
+hash_index::hash_index(vast::type t, size_t max_cardinality,
+                       size_t num_buckets)
+  : value_index{std::move(t)},
+    max_cardinality_{max_cardinality},
+    num_buckets_{std::max(num_buckets, size_t{1})} {
+  // nop
+}
+
+size_t hash_index::cardinality() const {
+  return dictionary_.size();
+}
+
+caf::error hash_index::serialize(caf::serializer& sink) const {
+  return caf::error::eval(
+    [&] { return value_index::serialize(sink); },
+    [&] {
+      return sink(max_cardinality_, num_buckets_, dictionary_, bitmaps_,
+                  buckets_);
+    });
+}
+
+caf::error hash_index::deserialize(caf::deserializer& source) {
+  return caf::error::eval(
+    [&] { return value_index::deserialize(source); },
+    [&] {
+      return source(max_cardinality_, num_buckets_, dictionary_, bitmaps_,
+                    buckets_);
+    });
+}
+
+const ids* hash_index::find(std::string_view x, bool& exact) const {
+  exact = true;
+  auto i = dictionary_.find(std::string{x});
+  if (i != dictionary_.end())
+    return &bitmaps_[i->second];
+  // Values in the dictionary never go to a bucket, so a miss is only exact
+  // as long as no value overflowed the dictionary.
+  if (buckets_.empty())
+    return nullptr;
+  exact = false;
+  return &buckets_[bucket(x)];
+}
+
+size_t hash_index::bucket(std::string_view x) const {
+  xxhash64 h;
+  h(x.data(), x.size());
+  return static_cast<xxhash64::result_type>(h) % num_buckets_;
+}
+
+bool hash_index::append_impl(data_view x, id pos) {
+  auto str = caf::get_if<view<std::string>>(&x);
+  if (!str)
+    return false;
+  ids* bm;
+  std::string key{*str};
+  if (auto i = dictionary_.find(key); i != dictionary_.end()) {
+    bm = &bitmaps_[i->second];
+  } else if (dictionary_.size() < max_cardinality_) {
+    dictionary_.emplace(std::move(key),
+                        static_cast<uint32_t>(bitmaps_.size()));
+    bm = &bitmaps_.emplace_back();
+  } else {
+    if (buckets_.empty())
+      buckets_.resize(num_buckets_);
+    bm = &buckets_[bucket(*str)];
+  }
+  bm->append_bits(false, pos - bm->size());
+  bm->append_bit(true);
+  return true;
+}
+
+expected<ids>
+hash_index::lookup_impl(relational_operator op, data_view x) const {
+  auto container_lookup = [&](const auto& xs) -> expected<ids> {
+    if (!(op == in || op == not_in))
+      return make_error(ec::unsupported_operator, op);
+    ids result{offset(), op == not_in};
+    for (auto x : xs) {
+      auto str = caf::get_if<view<std::string>>(&x);
+      if (!str)
+        return make_error(ec::type_clash, materialize(x));
+      auto exact = true;
+      auto bm = find(*str, exact);
+      if (bm == nullptr)
+        continue;
+      // Removing a bucket would drop rows with other values in the bucket.
+      if (op == in)
+        result |= pad(*bm, offset());
+      else if (exact)
+        result -= pad(*bm, offset());
+    }
+    return result;
+  };
+  return caf::visit(detail::overload(
+    [&](auto x) -> expected<ids> {
+      return make_error(ec::type_clash, materialize(x));
+    },
+    [&](view<std::string> str) -> expected<ids> {
+      switch (op) {
+        default:
+          return make_error(ec::unsupported_operator, op);
+        case equal:
+        case not_equal: {
+          auto exact = true;
+          auto bm = find(str, exact);
+          if (bm == nullptr)
+            return ids{offset(), op == not_equal};
+          if (op == equal)
+            return pad(*bm, offset());
+          if (!exact)
+            return ids{offset(), true};
+          auto result = pad(*bm, offset());
+          result.flip();
+          return result;
+        }
+        case ni:
+        case not_ni:
+          // The dictionary does not support substring search, so every row
+          // is a candidate.
+          return ids{offset(), true};
+      }
+    },
+    [&](view<vector> xs) { return container_lookup(*xs); },
+    [&](view<set> xs) { return container_lookup(*xs); }
+  ), x);
+}
+
+// -- trigram_index -------------------------------------------------------------
+
+trigram_index::trigram_index(vast::type t, size_t max_length)
+  : value_index{std::move(t)},
+    max_length_{max_length} {
+  // nop
+}
+
+caf::error trigram_index::serialize(caf::serializer& sink) const {
+  return caf::error::eval(
+    [&] { return value_index::serialize(sink); },
+    [&] { return sink(max_length_, postings_, truncated_); });
+}
+
+caf::error trigram_index::deserialize(caf::deserializer& source) {
+  return caf::error::eval(
+    [&] { return value_index::deserialize(source); },
+    [&] { return source(max_length_, postings_, truncated_); });
+}
+
+bool trigram_index::mergeable() const {
+  return true;
+}
+
+ids trigram_index::intersect(const std::vector<uint32_t>& grams) const {
+  ids result{offset(), true};
+  for (auto gram : grams) {
+    auto i = postings_.find(gram);
+    if (i == postings_.end())
+      return ids{offset(), false};
+    result &= pad(i->second, offset());
+    if (all<0>(result))
+      break;
+  }
+  return result;
+}
+
+bool trigram_index::append_impl(data_view x, id pos) {
+  auto str = caf::get_if<view<std::string>>(&x);
+  if (!str)
+    return false;
+  auto truncated = str->size() > max_length_;
+  for (auto gram : trigrams(delimit(str->substr(0, max_length_), !truncated))) {
+    auto& bm = postings_[gram];
+    bm.append_bits(false, pos - bm.size());
+    bm.append_bit(true);
+  }
+  if (truncated) {
+    truncated_.append_bits(false, pos - truncated_.size());
+    truncated_.append_bit(true);
+  }
+  return true;
+}
+
+bool trigram_index::merge_impl(const value_index& other, id first) {
+  auto x = dynamic_cast<const trigram_index*>(&other);
+  if (x == nullptr || x->max_length_ != max_length_)
+    return false;
+  auto append = [&](ids& bm, const ids& xs) {
+    bm.append_bits(false, first - bm.size());
+    bm.append(xs);
+  };
+  for (auto& [gram, bm] : x->postings_)
+    append(postings_[gram], bm);
+  if (!x->truncated_.empty())
+    append(truncated_, x->truncated_);
+  return true;
+}
+
+expected<ids>
+trigram_index::lookup_impl(relational_operator op, data_view x) const {
+  // Rows with truncated strings may contain any substring beyond the indexed
+  // prefix, so they remain candidates.
+  auto with_truncated = [&](ids result) {
+    return result | pad(truncated_, offset());
+  };
+  auto equal_lookup = [&](std::string_view str) {
+    if (str.size() <= max_length_)
+      return intersect(trigrams(delimit(str, true)));
+    auto prefix = str.substr(0, max_length_);
+    return intersect(trigrams(delimit(prefix, false)))
+           & pad(truncated_, offset());
+  };
+  auto container_lookup = [&](const auto& xs) -> expected<ids> {
+    if (!(op == in || op == not_in))
+      return make_error(ec::unsupported_operator, op);
+    // Trigram lookups are not exact, so we cannot exclude any row.
+    if (op == not_in)
+      return ids{offset(), true};
+    ids result{offset(), false};
+    for (auto x : xs) {
+      auto str = caf::get_if<view<std::string>>(&x);
+      if (!str)
+        return make_error(ec::type_clash, materialize(x));
+      result |= equal_lookup(*str);
+    }
+    return result;
+  };
+  return caf::visit(detail::overload(
+    [&](auto x) -> expected<ids> {
+      return make_error(ec::type_clash, materialize(x));
+    },
+    [&](view<std::string> str) -> expected<ids> {
+      switch (op) {
+        default:
+          return make_error(ec::unsupported_operator, op);
+        case equal:
+          return equal_lookup(str);
+        case ni:
+          if (str.size() > max_length_)
+            return pad(truncated_, offset());
+          return with_truncated(intersect(trigrams(str)));
+        case not_equal:
+        case not_ni:
+          return ids{offset(), true};
+      }
+    },
+    [&](view<pattern> pat) -> expected<ids> {
+      switch (op) {
+        default:
+          return make_error(ec::unsupported_operator, op);
+        case match: {
+          ids result{offset(), true};
+          for (auto& literal : detail::required_literals(pat.string())) {
+            result &= intersect(trigrams(literal));
+            if (all<0>(result))
+              break;
+          }
+          return with_truncated(std::move(result));
+        }
+        case not_match:
+          return ids{offset(), true};
+      }
+    },
+    [&](view<vector> xs) { return container_lookup(*xs); },
+    [&](view<set> xs) { return container_lookup(*xs); }
+  ), x);
+}
+
 // -- address_index ------------------------------------------------------------
 
 caf::error address_index::serialize(caf::serializer& sink) const {
@@ -234,6 +665,10 @@ caf::error address_index::deserialize(caf::deserializer& source) {
                           [&] { return source(bytes_, v4_); });
 }
 
+bool address_index::mergeable() const {
+  return true;
+}
+
 void address_index::init() {
   if (bytes_[0].coder().storage().empty())
     // Initialize on first to make deserialization feasible.
@@ -255,6 +690,23 @@ bool address_index::append_impl(data_view x, id pos) {
   return true;
 }
 
+bool address_index::merge_impl(const value_index& other, id first) {
+  auto x = dynamic_cast<const address_index*>(&other);
+  if (x == nullptr)
+    return false;
+  // The other index has not seen an address yet.
+  if (x->bytes_[0].coder().storage().empty())
+    return true;
+  init();
+  for (auto i = 0u; i < 16; ++i) {
+    bytes_[i].skip(first - bytes_[i].size());
+    bytes_[i].append(x->bytes_[i]);
+  }
+  v4_.skip(first - v4_.size());
+  v4_.append(x->v4_);
+  return true;
+}
+
 expected<ids>
 address_index::lookup_impl(relational_operator op, data_view d) const {
   return caf::visit(detail::overload(
@@ -322,6 +774,10 @@ caf::error subnet_index::deserialize(caf::deserializer& source) {
                           [&] { return source(network_, length_); });
 }
 
+bool subnet_index::mergeable() const {
+  return true;
+}
+
 void subnet_index::init() {
   if (length_.coder().storage().empty())
     length_ = prefix_index{128 + 1}; // Valid prefixes range from /0 to /128.
@@ -337,6 +793,19 @@ bool subnet_index::append_impl(data_view x, id pos) {
   return false;
 }
 
+bool subnet_index::merge_impl(const value_index& other, id first) {
+  auto x = dynamic_cast<const subnet_index*>(&other);
+  if (x == nullptr)
+    return false;
+  // The other index has not seen a subnet yet.
+  if (x->length_.coder().storage().empty())
+    return true;
+  init();
+  length_.skip(first - length_.size());
+  length_.append(x->length_);
+  return static_cast<bool>(network_.merge(x->network_, first));
+}
+
 expected<ids>
 subnet_index::lookup_impl(relational_operator op, data_view d) const {
   return caf::visit(detail::overload(
@@ -426,6 +895,10 @@ caf::error port_index::deserialize(caf::deserializer& source) {
                           [&] { return source(num_, proto_); });
 }
 
+bool port_index::mergeable() const {
+  return true;
+}
+
 void port_index::init() {
   if (num_.coder().storage().empty()) {
     num_ = number_index{base::uniform(10, 5)}; // [0, 2^16)
@@ -445,6 +918,21 @@ bool port_index::append_impl(data_view x, id pos) {
   return false;
 }
 
+bool port_index::merge_impl(const value_index& other, id first) {
+  auto x = dynamic_cast<const port_index*>(&other);
+  if (x == nullptr)
+    return false;
+  // The other index has not seen a port yet.
+  if (x->num_.coder().storage().empty())
+    return true;
+  init();
+  num_.skip(first - num_.size());
+  num_.append(x->num_);
+  proto_.skip(first - proto_.size());
+  proto_.append(x->proto_);
+  return true;
+}
+
 expected<ids>
 port_index::lookup_impl(relational_operator op, data_view d) const {
   if (offset() == 0) // FIXME: why do we need this check again?
@@ -498,6 +986,13 @@ caf::error sequence_index::deserialize(caf::deserializer& source) {
   );
 }
 
+bool sequence_index::mergeable() const {
+  // All elements share the same index type, so a fresh index tells us
+  // whether we can merge them.
+  auto x = factory<value_index>::make(value_type_);
+  return x != nullptr && x->mergeable();
+}
+
 void sequence_index::init() {
   if (size_.coder().storage().empty()) {
     size_t components = std::log10(max_size_);
@@ -533,6 +1028,27 @@ bool sequence_index::append_impl(data_view x, id pos) {
   return caf::visit(f, x);
 }
 
+bool sequence_index::merge_impl(const value_index& other, id first) {
+  auto x = dynamic_cast<const sequence_index*>(&other);
+  if (x == nullptr || x->max_size_ != max_size_)
+    return false;
+  // The other index has not seen a sequence yet.
+  if (x->size_.coder().storage().empty())
+    return true;
+  init();
+  for (auto i = 0u; i < x->elements_.size(); ++i) {
+    if (i == elements_.size()) {
+      elements_.push_back(factory<value_index>::make(value_type_));
+      VAST_ASSERT(elements_.back());
+    }
+    if (!elements_[i]->merge(*x->elements_[i], first))
+      return false;
+  }
+  size_.skip(first - size_.size());
+  size_.append(x->size_);
+  return true;
+}
+
 expected<ids>
 sequence_index::lookup_impl(relational_operator op, data_view x) const {
   if (!(op == ni || op == not_ni))
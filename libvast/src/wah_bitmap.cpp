@@ -16,6 +16,9 @@
 
 #include "vast/wah_bitmap.hpp"
 
+#include "vast/detail/bitwise.hpp"
+#include "vast/detail/word_eval.hpp"
+
 namespace vast {
 
 wah_bitmap::wah_bitmap(size_type n, bool bit) {
@@ -208,4 +211,137 @@ wah_bitmap_range bit_range(const wah_bitmap& bm) {
   return wah_bitmap_range{bm};
 }
 
+namespace {
+
+using word_type = wah_bitmap::word_type;
+
+// A literal word with all bits set.
+constexpr auto full_literal = word_type::lsb_mask(word_type::literal_word_size);
+
+// Exposes the blocks of a WAH bitmap as segments of fill and literal words
+// for detail::word_eval.
+class wah_cursor {
+public:
+  explicit wah_cursor(const wah_bitmap& bm)
+    : blocks_{bm.blocks().data()},
+      end_{bm.blocks().size()} {
+    normalize();
+  }
+
+  bool clean() const {
+    return fill_ > 0 || next_ >= end_;
+  }
+
+  uint64_t value() const {
+    return fill_ > 0 ? value_ : word_type::none;
+  }
+
+  const uint64_t* data() const {
+    return blocks_ + next_;
+  }
+
+  size_t size() const {
+    if (fill_ > 0)
+      return fill_;
+    return next_ < end_ ? literals_end_ - next_ : detail::word_eval_infinite;
+  }
+
+  void advance(size_t n) {
+    if (fill_ > 0)
+      fill_ -= n;
+    else if (next_ < end_)
+      next_ += n;
+    normalize();
+  }
+
+private:
+  // Reads fill words until reaching a non-empty segment and determines the
+  // extent of literal segments. The last block is always a literal.
+  void normalize() {
+    while (fill_ == 0 && next_ < end_ && word_type::is_fill(blocks_[next_])) {
+      auto block = blocks_[next_++];
+      fill_ = word_type::fill_words(block);
+      value_ = word_type::fill_type(block) ? full_literal : word_type::none;
+    }
+    if (fill_ == 0 && next_ >= literals_end_) {
+      literals_end_ = next_;
+      while (literals_end_ < end_ && !word_type::is_fill(blocks_[literals_end_]))
+        ++literals_end_;
+    }
+  }
+
+  const uint64_t* blocks_;
+  size_t end_;
+  size_t next_ = 0;
+  size_t literals_end_ = 0;
+  size_t fill_ = 0;
+  uint64_t value_ = 0;
+};
+
+using wah_builder
+  = detail::word_eval_builder<wah_bitmap, word_type::literal_word_size>;
+
+template <class Operation, class Kernel>
+wah_bitmap eval(const wah_bitmap& lhs, const wah_bitmap& rhs, Operation op,
+                Kernel kernel) {
+  wah_builder result{std::max(lhs.size(), rhs.size())};
+  detail::word_eval(result, wah_cursor{lhs}, wah_cursor{rhs}, full_literal,
+                    op, kernel);
+  return result.finish();
+}
+
+template <class Operation, class Kernel>
+wah_bitmap eval(const std::vector<const wah_bitmap*>& xs, Operation op,
+                Kernel kernel) {
+  std::vector<wah_cursor> cursors;
+  cursors.reserve(xs.size());
+  wah_bitmap::size_type size = 0;
+  for (auto x : xs) {
+    cursors.emplace_back(*x);
+    size = std::max(size, x->size());
+  }
+  wah_builder result{size};
+  detail::word_eval(result, std::move(cursors), full_literal, op, kernel);
+  return result.finish();
+}
+
+} // namespace <anonymous>
+
+// Literal words have a 0 in their MSB, which the operations below preserve.
+
+wah_bitmap binary_and(const wah_bitmap& lhs, const wah_bitmap& rhs) {
+  auto op = [](uint64_t x, uint64_t y) { return x & y; };
+  return eval(lhs, rhs, op, detail::bitwise_and);
+}
+
+wah_bitmap binary_or(const wah_bitmap& lhs, const wah_bitmap& rhs) {
+  auto op = [](uint64_t x, uint64_t y) { return x | y; };
+  return eval(lhs, rhs, op, detail::bitwise_or);
+}
+
+wah_bitmap binary_xor(const wah_bitmap& lhs, const wah_bitmap& rhs) {
+  auto op = [](uint64_t x, uint64_t y) { return x ^ y; };
+  return eval(lhs, rhs, op, detail::bitwise_xor);
+}
+
+wah_bitmap binary_nand(const wah_bitmap& lhs, const wah_bitmap& rhs) {
+  auto op = [](uint64_t x, uint64_t y) { return x & ~y; };
+  return eval(lhs, rhs, op, detail::bitwise_nand);
+}
+
+wah_bitmap nary_and(const std::vector<const wah_bitmap*>& xs) {
+  auto op = [](uint64_t x, uint64_t y) { return x & y; };
+  return eval(xs, op, detail::bitwise_and);
+}
+
+wah_bitmap nary_or(const std::vector<const wah_bitmap*>& xs) {
+  auto op = [](uint64_t x, uint64_t y) { return x | y; };
+  return eval(xs, op, detail::bitwise_or);
+}
+
+wah_bitmap nary_xor(const std::vector<const wah_bitmap*>& xs) {
+  auto op = [](uint64_t x, uint64_t y) { return x ^ y; };
+  return eval(xs, op, detail::bitwise_xor);
+}
+
 } // namespace vast
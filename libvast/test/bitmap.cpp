@@ -15,6 +15,7 @@
 #include "vast/ewah_bitmap.hpp"
 #include "vast/ids.hpp"
 #include "vast/null_bitmap.hpp"
+#include "vast/roaring_bitmap.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/bitmap.hpp"
 
@@ -476,6 +477,14 @@ TEST(wah_bitmap) {
 
 FIXTURE_SCOPE_END()
 
+FIXTURE_SCOPE(roaring_bitmap_tests, bitmap_test_harness<roaring_bitmap>)
+
+TEST(roaring_bitmap) {
+  execute();
+}
+
+FIXTURE_SCOPE_END()
+
 FIXTURE_SCOPE(bitmap_tests, bitmap_test_harness<bitmap>)
 
 TEST(bitmap) {
@@ -912,3 +921,84 @@ TEST(EWAH RLE print 2) {
   //CHECK_EQUAL(str, "1F1T421F2T");
   CHECK_EQUAL(str, "1F1T62F320F39F2T");
 }
+
+namespace {
+
+// Appends the same pattern to a roaring and an EWAH bitmap. The pattern
+// spans several containers and exercises all container types.
+template <class Bitmap>
+Bitmap make_mixed(size_t seed) {
+  Bitmap bm;
+  bm.append_bits(false, 1000 + seed);
+  for (auto i = 0u; i < 3000; ++i)
+    bm.append_bit((i * (seed + 7)) % 13 == 0);
+  bm.append_bits(true, 100000);
+  for (auto i = 0u; i < 70000; ++i)
+    bm.append_bit((i + seed) % 3 != 0);
+  bm.append_bits(false, (1u << 17) + seed);
+  bm.append_block(0xcccccccccccccccc);
+  bm.append_bits(true, seed);
+  return bm;
+}
+
+} // namespace <anonymous>
+
+TEST(roaring containers) {
+  using container = roaring_bitmap::container;
+  roaring_bitmap bm;
+  bm.append_bits(false, 10);
+  for (auto i = 0u; i < 100; ++i)
+    bm.append_bit(i % 2 == 0);
+  bm.append_bits(false, roaring_bitmap::container_bits);
+  bm.append_bits(true, roaring_bitmap::container_bits);
+  for (auto i = 0u; i < roaring_bitmap::container_bits; ++i)
+    bm.append_bit(i % 3 == 0);
+  bm.optimize();
+  auto& xs = bm.containers();
+  REQUIRE_EQUAL(xs.size(), 4u);
+  CHECK_EQUAL(xs[0].kind, container::array);
+  CHECK_EQUAL(xs[0].cardinality, 50u);
+  CHECK_EQUAL(xs[1].kind, container::run);
+  CHECK_EQUAL(xs[2].kind, container::dense);
+  CHECK_EQUAL(xs[3].kind, container::array);
+  CHECK_EQUAL(rank(bm), 50u + roaring_bitmap::container_bits + 21846);
+  CHECK_EQUAL(select(bm, 1), 10u);
+  CHECK_EQUAL(select(bm, 50), 108u);
+  CHECK_EQUAL(select(bm, 51), 110u + roaring_bitmap::container_bits);
+  CHECK_EQUAL(select(bm, word<uint64_t>::npos), bm.size() - 1);
+  CHECK_EQUAL(select<0>(bm, 1), 0u);
+  MESSAGE("flipping preserves the size");
+  auto flipped = ~bm;
+  CHECK_EQUAL(flipped.size(), bm.size());
+  CHECK_EQUAL(rank(flipped), bm.size() - rank(bm));
+  CHECK_EQUAL(~flipped, bm);
+  MESSAGE("runs print compactly");
+  std::string str;
+  printers::bitmap<roaring_bitmap, policy::rle>(str, roaring_bitmap{70000, true});
+  CHECK_EQUAL(str, "65536T4464T");
+}
+
+TEST(roaring bitwise operations) {
+  auto r1 = make_mixed<roaring_bitmap>(3);
+  auto r2 = make_mixed<roaring_bitmap>(42);
+  auto e1 = make_mixed<ewah_bitmap>(3);
+  auto e2 = make_mixed<ewah_bitmap>(42);
+  REQUIRE_EQUAL(to_string(r1), to_string(e1));
+  REQUIRE_EQUAL(to_string(r2), to_string(e2));
+  CHECK_EQUAL(to_string(r1 & r2), to_string(e1 & e2));
+  CHECK_EQUAL(to_string(r1 | r2), to_string(e1 | e2));
+  CHECK_EQUAL(to_string(r1 ^ r2), to_string(e1 ^ e2));
+  CHECK_EQUAL(to_string(r1 - r2), to_string(e1 - e2));
+  CHECK_EQUAL(to_string(r2 - r1), to_string(e2 - e1));
+  CHECK_EQUAL(to_string(~r1), to_string(~e1));
+  CHECK_EQUAL(rank(r1), rank(e1));
+  CHECK_EQUAL(rank<0>(r2, 200000), rank<0>(e2, 200000));
+  CHECK_EQUAL(select(r1, 12345), select(e1, 12345));
+  MESSAGE("type-erased bitmaps use the roaring algorithms");
+  bitmap b1{r1};
+  bitmap b2{r2};
+  auto b = b1 & b2;
+  CHECK(caf::holds_alternative<roaring_bitmap>(b));
+  CHECK_EQUAL(to_string(b), to_string(e1 & e2));
+  CHECK_EQUAL(to_string(b1 | bitmap{e2}), to_string(e1 | e2));
+}
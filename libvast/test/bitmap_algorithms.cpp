@@ -17,10 +17,75 @@
 
 #include "vast/test/test.hpp"
 
+#include <random>
+#include <vector>
+
+#include "vast/concept/printable/vast/bitmap.hpp"
+#include "vast/ewah_bitmap.hpp"
 #include "vast/ids.hpp"
+#include "vast/wah_bitmap.hpp"
+
+#include "vast/detail/bitwise.hpp"
 
 using namespace vast;
 
+namespace {
+
+// Generates a bitmap with a mix of runs and literal blocks.
+template <class Bitmap>
+Bitmap make_random_bitmap(std::mt19937_64& gen, size_t size) {
+  Bitmap result;
+  while (result.size() < size) {
+    switch (gen() % 4) {
+      case 0:
+        result.append_bits(gen() % 2 == 0, gen() % 3000);
+        break;
+      case 1:
+        result.append_block(gen(), gen() % 64 + 1);
+        break;
+      case 2:
+        for (auto i = gen() % 200; i > 0; --i)
+          result.append_block(gen());
+        break;
+      default:
+        result.append_bit(gen() % 2 == 0);
+    }
+  }
+  return result;
+}
+
+// Compares the specialized binary and n-ary operations with the generic
+// algorithms.
+template <class Bitmap>
+void check_kernels() {
+  std::mt19937_64 gen{42};
+  for (auto i = 0; i < 50; ++i) {
+    auto x = make_random_bitmap<Bitmap>(gen, gen() % 20000);
+    auto y = make_random_bitmap<Bitmap>(gen, gen() % 20000);
+    CHECK_EQUAL(binary_and(x, y), (binary_and<Bitmap, Bitmap>(x, y)));
+    CHECK_EQUAL(binary_or(x, y), (binary_or<Bitmap, Bitmap>(x, y)));
+    CHECK_EQUAL(binary_xor(x, y), (binary_xor<Bitmap, Bitmap>(x, y)));
+    CHECK_EQUAL(binary_nand(x, y), (binary_nand<Bitmap, Bitmap>(x, y)));
+    std::vector<Bitmap> xs;
+    for (auto n = gen() % 6; n > 0; --n)
+      xs.push_back(make_random_bitmap<Bitmap>(gen, gen() % 20000));
+    auto pairwise = [&](auto op) {
+      return nary_eval(xs.begin(), xs.end(), op);
+    };
+    CHECK_EQUAL(nary_and(xs.begin(), xs.end()), pairwise([](auto& l, auto& r) {
+                  return binary_and<Bitmap, Bitmap>(l, r);
+                }));
+    CHECK_EQUAL(nary_or(xs.begin(), xs.end()), pairwise([](auto& l, auto& r) {
+                  return binary_or<Bitmap, Bitmap>(l, r);
+                }));
+    CHECK_EQUAL(nary_xor(xs.begin(), xs.end()), pairwise([](auto& l, auto& r) {
+                  return binary_xor<Bitmap, Bitmap>(l, r);
+                }));
+  }
+}
+
+} // namespace <anonymous>
+
 TEST(is subset) {
   CHECK(is_subset(make_ids({{10, 20}}), make_ids({{10, 20}})));
   CHECK(is_subset(make_ids({{11, 20}}), make_ids({{10, 20}})));
@@ -33,3 +98,36 @@ TEST(is not subset) {
   CHECK(!is_subset(make_ids({{11, 21}}), make_ids({{10, 20}})));
   CHECK(!is_subset(make_ids({5, 15, 25}), make_ids({{10, 20}})));
 }
+
+TEST(bitwise kernels) {
+  std::mt19937_64 gen{42};
+  for (size_t n = 0; n < 40; ++n) {
+    std::vector<uint64_t> x(n);
+    std::vector<uint64_t> y(n);
+    std::vector<uint64_t> z(n);
+    for (size_t i = 0; i < n; ++i) {
+      x[i] = gen();
+      y[i] = gen();
+    }
+    detail::bitwise_and(x.data(), y.data(), z.data(), n);
+    for (size_t i = 0; i < n; ++i)
+      CHECK_EQUAL(z[i], x[i] & y[i]);
+    detail::bitwise_or(x.data(), y.data(), z.data(), n);
+    for (size_t i = 0; i < n; ++i)
+      CHECK_EQUAL(z[i], x[i] | y[i]);
+    detail::bitwise_xor(x.data(), y.data(), z.data(), n);
+    for (size_t i = 0; i < n; ++i)
+      CHECK_EQUAL(z[i], x[i] ^ y[i]);
+    detail::bitwise_nand(x.data(), y.data(), z.data(), n);
+    for (size_t i = 0; i < n; ++i)
+      CHECK_EQUAL(z[i], x[i] & ~y[i]);
+  }
+}
+
+TEST(EWAH kernels) {
+  check_kernels<ewah_bitmap>();
+}
+
+TEST(WAH kernels) {
+  check_kernels<wah_bitmap>();
+}
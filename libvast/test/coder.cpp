@@ -24,6 +24,7 @@
 #include "vast/detail/order.hpp"
 #include "vast/load.hpp"
 #include "vast/null_bitmap.hpp"
+#include "vast/roaring_bitmap.hpp"
 #include "vast/save.hpp"
 
 using namespace vast;
@@ -529,3 +530,43 @@ TEST(printable) {
                   "4\t00001";
   CHECK_EQUAL(to_string(c), expected);
 }
+
+TEST(roaring bitmaps) {
+  MESSAGE("equality coder");
+  {
+    equality_coder<roaring_bitmap> c{10};
+    fill(c, 8, 9, 0, 1, 4);
+    CHECK_DECODE(less, 5, "00111");
+    CHECK_DECODE(equal, 8, "10000");
+    CHECK_DECODE(not_equal, 4, "11110");
+    CHECK_DECODE(greater_equal, 4, "11001");
+  }
+  MESSAGE("range coder");
+  {
+    range_coder<roaring_bitmap> c{8};
+    fill(c, 4, 7, 4, 3, 3, 3, 3, 3, 3, 0, 1);
+    CHECK_DECODE(less, 4, "00011111111");
+    CHECK_DECODE(equal, 3, "00011111100");
+    CHECK_DECODE(not_equal, 4, "01011111111");
+    CHECK_DECODE(greater, 3, "11100000000");
+  }
+  MESSAGE("bitslice coder");
+  {
+    bitslice_coder<roaring_bitmap> c{6};
+    fill(c, 4, 5, 2, 3, 0, 1);
+    CHECK_DECODE(equal, 2, "001000");
+    CHECK_DECODE(in, 1, "010101");
+  }
+  MESSAGE("serialization");
+  {
+    using coder_type = multi_level_coder<equality_coder<roaring_bitmap>>;
+    auto x = coder_type{base{10, 10}};
+    fill(x, 42, 84, 42, 21, 30);
+    std::string buf;
+    CHECK_EQUAL(save(nullptr, buf, x), caf::none);
+    auto c = coder_type{};
+    CHECK_EQUAL(load(nullptr, buf, c), caf::none);
+    CHECK_EQUAL(x, c);
+    CHECK_DECODE(equal, 42, "10100");
+  }
+}
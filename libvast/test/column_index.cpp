@@ -16,6 +16,7 @@
 #include "vast/test/test.hpp"
 #include "vast/test/fixtures/actor_system_and_events.hpp"
 
+#include "vast/bitmap_algorithms.hpp"
 #include "vast/column_index.hpp"
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/expression.hpp"
@@ -51,6 +52,16 @@ TEST(skip attribute) {
   CHECK_EQUAL(bar->has_skip_attribute(), true);
 }
 
+TEST(empty read-only column) {
+  column_index col{sys, integer_type{}, chunk_ptr{}, 0};
+  REQUIRE_EQUAL(col.init(), caf::none);
+  CHECK(!col.dirty());
+  auto result = unbox(col.lookup(equal, make_view(integer{42})));
+  CHECK_EQUAL(rank(result), 0u);
+  CHECK_EQUAL(col.flush_to_disk(), caf::none);
+  CHECK(!exists(path{".delta"}));
+}
+
 TEST(integer values) {
   MESSAGE("ingest integer values");
   integer_type column_type;
@@ -82,6 +93,41 @@ TEST(integer values) {
   CHECK_EQUAL(lookup(col, is4), make_ids({}, slice_size));
 }
 
+TEST(incremental flush) {
+  integer_type column_type;
+  record_type layout{{"value", column_type}};
+  auto col = unbox(make_column_index(sys, directory, column_type, 0));
+  auto first = default_table_slice::make(layout, make_rows(1, 2, 3));
+  auto second = default_table_slice::make(layout, make_rows(3, 2, 1));
+  second.unshared().offset(5);
+  auto is1 = curried(unbox(to<predicate>(":int == +1")));
+  auto is3 = curried(unbox(to<predicate>(":int == +3")));
+  MESSAGE("flush rows in two delta segments");
+  col->add(first);
+  CHECK(col->dirty());
+  CHECK_EQUAL(col->flush_to_disk(), caf::none);
+  CHECK(!col->dirty());
+  col->add(second);
+  CHECK_EQUAL(lookup(col, is1), make_ids({0, 7}, 8));
+  CHECK_EQUAL(lookup(col, is3), make_ids({2, 5}, 8));
+  CHECK_EQUAL(col->flush_to_disk(), caf::none);
+  CHECK(!exists(col->filename()));
+  CHECK(exists(col->filename() + ".delta"));
+  MESSAGE("reload from the delta segments");
+  col.reset();
+  col = unbox(make_column_index(sys, directory, column_type, 0));
+  CHECK_EQUAL(lookup(col, is1), make_ids({0, 7}, 8));
+  CHECK_EQUAL(lookup(col, is3), make_ids({2, 5}, 8));
+  MESSAGE("compact the delta segments into a single file");
+  col.reset();
+  CHECK_EQUAL(compact_column_index(directory), caf::none);
+  CHECK(exists(directory));
+  CHECK(!exists(directory + ".delta"));
+  col = unbox(make_column_index(sys, directory, column_type, 0));
+  CHECK_EQUAL(lookup(col, is1), make_ids({0, 7}, 8));
+  CHECK_EQUAL(lookup(col, is3), make_ids({2, 5}, 8));
+}
+
 TEST(zeek conn log) {
   MESSAGE("ingest originators from zeek conn log");
   auto row_type = zeek_conn_log_layout();
@@ -54,6 +54,12 @@ struct make_kvp {
   }
 };
 
+struct value_weight {
+  size_t operator()(const kvp& x) const {
+    return static_cast<size_t>(x.value);
+  }
+};
+
 struct fixture {
   fixture() : cache(5) {
     // nop
@@ -91,4 +97,36 @@ TEST(reordering) {
   CHECK_EQUAL(cache.elements(), expected);
 }
 
+TEST(finding) {
+  for (auto key : {"one", "two", "three"})
+    cache.add(kvp{key});
+  CHECK(cache.find("four") == nullptr);
+  auto ptr = cache.find("one");
+  REQUIRE(ptr != nullptr);
+  CHECK_EQUAL(*ptr, kvp{"one"});
+  std::vector<kvp> expected{kvp{"two"}, kvp{"three"}, kvp{"one"}};
+  CHECK_EQUAL(cache.elements(), expected);
+}
+
+TEST(weighted eviction) {
+  vast::detail::flat_lru_cache<kvp, has_key, make_kvp, value_weight> weighted{
+    10};
+  weighted.add(kvp{"one", 4});
+  weighted.add(kvp{"two", 4});
+  CHECK_EQUAL(weighted.weight(), 8u);
+  weighted.add(kvp{"three", 3});
+  std::vector<kvp> expected{kvp{"two", 4}, kvp{"three", 3}};
+  CHECK_EQUAL(weighted.elements(), expected);
+  CHECK_EQUAL(weighted.weight(), 7u);
+  MESSAGE("the cache keeps a single element that exceeds its capacity");
+  weighted.add(kvp{"four", 20});
+  expected = {kvp{"four", 20}};
+  CHECK_EQUAL(weighted.elements(), expected);
+  CHECK_EQUAL(weighted.weight(), 20u);
+  MESSAGE("shrinking evicts elements");
+  weighted.size(5);
+  CHECK(weighted.elements().empty());
+  CHECK_EQUAL(weighted.weight(), 0u);
+}
+
 FIXTURE_SCOPE_END()
@@ -0,0 +1,93 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE interval_index
+#include "vast/test/test.hpp"
+
+#include "vast/detail/interval_index.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace vast::detail;
+
+namespace {
+
+struct fixture {
+  fixture() {
+    // Overlapping intervals, deliberately out of order.
+    idx = interval_index<int>{{
+      {10, 20, 0},
+      {0, 5, 1},
+      {15, 30, 2},
+      {3, 4, 3},
+      {25, 25, 4},
+    }};
+  }
+
+  template <class F>
+  std::vector<size_t> query(F f) {
+    std::vector<size_t> result;
+    f([&](size_t id) { result.push_back(id); });
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  interval_index<int> idx;
+};
+
+using ids = std::vector<size_t>;
+
+} // namespace <anonymous>
+
+FIXTURE_SCOPE(interval_index_tests, fixture)
+
+TEST(stabbing) {
+  CHECK_EQUAL(idx.size(), 5u);
+  CHECK_EQUAL(query([&](auto f) { idx.stab(-1, f); }), ids{});
+  CHECK_EQUAL(query([&](auto f) { idx.stab(3, f); }), (ids{1, 3}));
+  CHECK_EQUAL(query([&](auto f) { idx.stab(5, f); }), ids{1});
+  CHECK_EQUAL(query([&](auto f) { idx.stab(7, f); }), ids{});
+  CHECK_EQUAL(query([&](auto f) { idx.stab(15, f); }), (ids{0, 2}));
+  CHECK_EQUAL(query([&](auto f) { idx.stab(25, f); }), (ids{2, 4}));
+  CHECK_EQUAL(query([&](auto f) { idx.stab(31, f); }), ids{});
+}
+
+TEST(lower bounds) {
+  CHECK_EQUAL(query([&](auto f) { idx.min_below(0, false, f); }), ids{});
+  CHECK_EQUAL(query([&](auto f) { idx.min_below(0, true, f); }), ids{1});
+  CHECK_EQUAL(query([&](auto f) { idx.min_below(10, false, f); }),
+              (ids{1, 3}));
+  CHECK_EQUAL(query([&](auto f) { idx.min_below(10, true, f); }),
+              (ids{0, 1, 3}));
+  CHECK_EQUAL(query([&](auto f) { idx.min_below(100, false, f); }),
+              (ids{0, 1, 2, 3, 4}));
+}
+
+TEST(upper bounds) {
+  CHECK_EQUAL(query([&](auto f) { idx.max_above(30, false, f); }), ids{});
+  CHECK_EQUAL(query([&](auto f) { idx.max_above(30, true, f); }), ids{2});
+  CHECK_EQUAL(query([&](auto f) { idx.max_above(20, false, f); }),
+              (ids{2, 4}));
+  CHECK_EQUAL(query([&](auto f) { idx.max_above(4, true, f); }),
+              (ids{0, 1, 2, 3, 4}));
+}
+
+TEST(empty index) {
+  interval_index<int> empty;
+  CHECK(empty.empty());
+  CHECK_EQUAL(query([&](auto f) { empty.stab(0, f); }), ids{});
+  CHECK_EQUAL(query([&](auto f) { empty.max_above(0, true, f); }), ids{});
+}
+
+FIXTURE_SCOPE_END()
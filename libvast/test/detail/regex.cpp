@@ -0,0 +1,122 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE regex
+#include "vast/test/test.hpp"
+
+#include "vast/detail/regex.hpp"
+
+#include <memory>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::string_literals;
+using namespace vast::detail;
+
+TEST(native subset) {
+  CHECK(regex{"[a-z]+\\.(com|org)"}.native());
+  CHECK(regex{"^\\w{3}\\d{1,2}$"}.native());
+  CHECK(regex{"(?:ab|ba)*x?"}.native());
+  MESSAGE("unsupported syntax falls back to std::regex");
+  CHECK(!regex{"(a)\\1"}.native());
+  CHECK(!regex{"\\bfoo"}.native());
+  CHECK(!regex{"a(?=b)"}.native());
+  CHECK(!regex{"[[:alpha:]]+"}.native());
+  CHECK(!regex{"a|^b"}.native());
+}
+
+TEST(equivalence with std::regex) {
+  auto patterns = std::vector<std::string>{
+    "foo", "fo*", "^foo", "foo$", "^f.o$", "a|b", "(ab)+c", "[a-c]+x?",
+    "[^a]b", "\\d{2,3}", "x{0,2}y", "(?:ab|ba)*", ".*\\.com", "(a|b)*abb",
+    "[\\w.-]+\\.(com|org)", "a{3}", "\\x61b", "(a*)*b", "a+?b", "^$", "",
+    "[a-]", "ab\\$", "ex.mple\\.org", "[^\\d]+", "\\s\\S", "(abc|abd)e",
+    "(a)\\1", "[[:alpha:]]+", "(x[)]yzw)"};
+  auto inputs = std::vector<std::string>{
+    "", "a", "b", "ab", "abb", "aabb", "foo", "xfoo", "foox", "fao", "f\no",
+    "ababc", "cx", "bb", "12", "1234", "y", "xxy", "xxxy", "abba", "baab",
+    "www.example.com", "example.org", "ex-ample.org", "a.b", "aaa", "aab",
+    "ab$", "abde", "abce", "abe", "a b", "- x", "aa", "abcabd", "x)yzw"};
+  for (auto& pattern : patterns) {
+    regex rx{pattern};
+    std::regex reference{pattern};
+    for (auto& input : inputs) {
+      auto match = std::regex_match(input, reference);
+      auto search = std::regex_search(input, reference);
+      if (rx.match(input) != match || rx.search(input) != search)
+        FAIL("mismatch for /" << pattern << "/ on \"" << input << '"');
+    }
+  }
+}
+
+TEST(many regexes) {
+  MESSAGE("regexes that replace destroyed ones do not see their states");
+  for (auto i = 0; i < 100; ++i) {
+    regex rx{"x" + std::to_string(i) + "y"};
+    CHECK(rx.match("x" + std::to_string(i) + "y"));
+    CHECK(!rx.match("x" + std::to_string(i + 1) + "y"));
+  }
+  MESSAGE("interleaved matching with more regexes than cached per thread");
+  std::vector<std::unique_ptr<regex>> xs;
+  for (auto i = 0; i < 100; ++i)
+    xs.push_back(
+      std::make_unique<regex>("a{" + std::to_string(i % 7 + 1) + "}b"));
+  for (auto round = 0; round < 3; ++round)
+    for (auto i = 0; i < 100; ++i) {
+      auto n = static_cast<size_t>(i % 7 + 1);
+      CHECK(xs[i]->match(std::string(n, 'a') + 'b'));
+      CHECK(!xs[i]->match(std::string(n + 1, 'a') + 'b'));
+    }
+}
+
+TEST(concurrent matching) {
+  regex rx{"(ab|cd)*e+"};
+  auto inputs = std::vector<std::string>{"e", "abcde", "abce", "abcdabee",
+                                         "ee", "abcdx", "cdcdcdcde"};
+  std::vector<bool> expected;
+  for (auto& input : inputs)
+    expected.push_back(std::regex_match(input, std::regex{"(ab|cd)*e+"}));
+  std::vector<std::vector<bool>> results(4);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < results.size(); ++i)
+    threads.emplace_back([&, i] {
+      for (auto round = 0; round < 1000; ++round)
+        for (auto& input : inputs)
+          results[i].push_back(rx.match(input));
+    });
+  for (auto& t : threads)
+    t.join();
+  for (auto& result : results)
+    for (size_t i = 0; i < result.size(); ++i)
+      REQUIRE_EQUAL(result[i], expected[i % inputs.size()]);
+}
+
+TEST(required literals) {
+  using literals = std::vector<std::string>;
+  CHECK_EQUAL(required_literals("foobar"), literals{"foobar"});
+  CHECK_EQUAL(required_literals("^www\\.[a-z]+\\.com$"),
+              (literals{"www.", ".com"}));
+  CHECK_EQUAL(required_literals("fooo?bar"), (literals{"foo", "bar"}));
+  CHECK_EQUAL(required_literals("(abc)def"), literals{"def"});
+  CHECK_EQUAL(required_literals("a[[:alpha:]]bcd"), literals{"bcd"});
+  CHECK_EQUAL(required_literals("ab\\x41cdef"), literals{"cdef"});
+  MESSAGE("brackets inside groups do not close the group");
+  CHECK(required_literals("(x[)]yzw)").empty());
+  CHECK_EQUAL(required_literals("(a[)(]b)cdef"), literals{"cdef"});
+  CHECK(regex{"(x[)]yzw)"}.match("x)yzw"));
+  CHECK(regex{"(x[)]yzw)"}.search("ax)yzw"));
+  CHECK(required_literals("foo|bar").empty());
+  CHECK(required_literals("ab.cd").empty());
+}
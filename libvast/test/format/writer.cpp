@@ -16,6 +16,8 @@
 #include "vast/format/ascii.hpp"
 #include "vast/format/csv.hpp"
 #include "vast/format/json.hpp"
+#include "vast/ids.hpp"
+#include "vast/to_events.hpp"
 
 #define SUITE format
 #include "vast/test/test.hpp"
@@ -56,6 +58,40 @@ std::vector<std::string> generate(const std::vector<event>& xs) {
   return lines;
 }
 
+template <class Writer>
+std::vector<std::string> generate(const std::vector<table_slice_ptr>& xs,
+                                  const ids& selection) {
+  std::string str;
+  auto sb = new caf::containerbuf<std::string>{str};
+  auto out = std::make_unique<std::ostream>(sb);
+  Writer writer{std::move(out)};
+  for (auto& x : xs)
+    if (!writer.write(*x, selection))
+      FAIL("failed to write table slice");
+  writer.flush();
+  REQUIRE(!str.empty());
+  auto lines = detail::to_strings(detail::split(str, "\n"));
+  REQUIRE(!lines.empty());
+  return lines;
+}
+
+// Checks that writing table slices produces the same output as writing the
+// corresponding events.
+template <class Writer>
+void check_table_slices(const std::vector<table_slice_ptr>& xs) {
+  auto last = xs.back()->offset() + xs.back()->rows();
+  auto all = ids(last, true);
+  auto every_other = ids{};
+  for (id i = 0; i < last; ++i)
+    every_other.append_bit(i % 2 == 0);
+  for (auto& selection : {all, every_other}) {
+    std::vector<event> events;
+    for (auto& x : xs)
+      to_events(events, *x, selection);
+    CHECK_EQUAL(generate<Writer>(xs, selection), generate<Writer>(events));
+  }
+}
+
 } // namespace <anonymous>
 
 TEST(Zeek writer) {
@@ -82,4 +118,15 @@ TEST(JSON writer) {
   CHECK_EQUAL(lines.front(), first_zeek_conn_log_line);
 }
 
+TEST(table slices) {
+  check_table_slices<format::ascii::writer>(zeek_conn_log_slices);
+  check_table_slices<format::ascii::writer>(zeek_http_log_slices);
+  check_table_slices<format::ascii::writer>(bgpdump_txt_slices);
+  check_table_slices<format::csv::writer>(zeek_conn_log_slices);
+  check_table_slices<format::csv::writer>(zeek_http_log_slices);
+  check_table_slices<format::json::writer>(zeek_conn_log_slices);
+  check_table_slices<format::json::writer>(zeek_http_log_slices);
+  check_table_slices<format::json::writer>(bgpdump_txt_slices);
+}
+
 FIXTURE_SCOPE_END()
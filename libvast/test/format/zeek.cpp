@@ -21,7 +21,10 @@
 #include "vast/test/fixtures/events.hpp"
 
 #include "vast/concept/parseable/to.hpp"
+#include "vast/detail/string.hpp"
 #include "vast/event.hpp"
+#include "vast/ids.hpp"
+#include "vast/to_events.hpp"
 
 using namespace vast;
 using namespace std::string_literals;
@@ -190,6 +193,58 @@ TEST(zeek reader) {
   CHECK_EQUAL(num, 100);
 }
 
+TEST(zeek reader field values) {
+  using namespace std::chrono;
+  using reader_type = format::zeek::reader;
+  reader_type reader{defaults::system::table_slice_type,
+                     std::make_unique<std::istringstream>(
+                       std::string{conn_log_100_events})};
+  std::vector<table_slice_ptr> slices;
+  auto add_slice = [&](table_slice_ptr ptr) {
+    slices.emplace_back(std::move(ptr));
+  };
+  auto [err, num] = reader.read(2, 2, add_slice);
+  REQUIRE_EQUAL(err, caf::none);
+  REQUIRE_EQUAL(num, 2u);
+  REQUIRE_EQUAL(slices.size(), 1u);
+  auto& x = *slices[0];
+  auto ts = duration_cast<timespan>(double_seconds{1258531221.486539});
+  CHECK_EQUAL(materialize(x.at(0, 0)), data{timestamp{ts}});
+  CHECK_EQUAL(materialize(x.at(0, 1)), data{"Pii6cUUq1v4"});
+  CHECK_EQUAL(materialize(x.at(0, 2)),
+              data{unbox(to<address>("192.168.1.102"))});
+  CHECK_EQUAL(materialize(x.at(0, 3)), data{port{68, port::udp}});
+  CHECK_EQUAL(materialize(x.at(0, 7)), data{caf::none});
+  CHECK_EQUAL(materialize(x.at(0, 9)), data{count{301}});
+  CHECK_EQUAL(materialize(x.at(0, 19)), data{set{}});
+  CHECK_EQUAL(materialize(x.at(1, 7)), data{"dns"});
+}
+
+TEST(zeek reader unescapes strings) {
+  auto log = R"__(#separator \x09
+#set_separator	,
+#empty_field	(empty)
+#unset_field	-
+#path	foo
+#open	2014-05-23-18-02-04
+#fields	s	p
+#types	string	port
+\x2afoo*	80
+)__"s;
+  format::zeek::reader reader{defaults::system::table_slice_type,
+                              std::make_unique<std::istringstream>(log)};
+  std::vector<table_slice_ptr> slices;
+  auto add_slice = [&](table_slice_ptr ptr) {
+    slices.emplace_back(std::move(ptr));
+  };
+  auto [err, num] = reader.read(1, 1, add_slice);
+  REQUIRE_EQUAL(err, caf::none);
+  REQUIRE_EQUAL(num, 1u);
+  REQUIRE_EQUAL(slices.size(), 1u);
+  CHECK_EQUAL(materialize(slices[0]->at(0, 0)), data{"*foo*"});
+  CHECK_EQUAL(materialize(slices[0]->at(0, 1)), data{port{80, port::unknown}});
+}
+
 FIXTURE_SCOPE_END()
 
 FIXTURE_SCOPE(zeek_writer_tests, fixtures::events)
@@ -217,4 +272,43 @@ TEST(zeek writer) {
   CHECK(exists(dir / zeek_http_log[0].type().name() + ".log"));
 }
 
+TEST(zeek writer with table slices) {
+  auto dir = path{"vast-unit-test-zeek-slices"};
+  auto guard = caf::detail::make_scope_guard([&] { rm(dir); });
+  // Writes every other row of the conn log, once as table slices and once as
+  // events.
+  auto selection = ids{};
+  for (size_t i = 0; i < zeek_conn_log.size(); ++i)
+    selection.append_bit(i % 2 == 0);
+  {
+    format::zeek::writer writer{dir / "slices"};
+    for (auto& slice : zeek_conn_log_slices)
+      if (!writer.write(*slice, selection))
+        FAIL("failed to write table slice");
+    writer.flush();
+  }
+  {
+    format::zeek::writer writer{dir / "events"};
+    for (auto& slice : zeek_conn_log_slices)
+      for (auto& e : to_events(*slice, selection))
+        if (!writer.write(e))
+          FAIL("failed to write event");
+    writer.flush();
+  }
+  // The logs differ only in the time of opening and closing.
+  auto load = [&](const path& p) {
+    auto contents = load_contents(p / "zeek.conn.log");
+    REQUIRE(contents);
+    std::vector<std::string> result;
+    for (auto& line : detail::to_strings(detail::split(*contents, "\n")))
+      if (!detail::starts_with(line, "#open")
+          && !detail::starts_with(line, "#close"))
+        result.push_back(line);
+    return result;
+  };
+  auto lines = load(dir / "slices");
+  CHECK_EQUAL(lines.size(), 7u + zeek_conn_log.size() / 2 + 1);
+  CHECK_EQUAL(lines, load(dir / "events"));
+}
+
 FIXTURE_SCOPE_END()
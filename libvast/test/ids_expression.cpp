@@ -0,0 +1,157 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE ids_expression
+
+#include "vast/ids_expression.hpp"
+
+#include "vast/test/test.hpp"
+
+#include <random>
+#include <vector>
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/concept/printable/vast/bitmap.hpp"
+#include "vast/type.hpp"
+
+using namespace vast;
+
+namespace {
+
+// Evaluates an expression eagerly by materializing every subexpression.
+struct reference_evaluator {
+  ids operator()(caf::none_t) {
+    return {};
+  }
+
+  template <class Connective>
+  ids operator()(const Connective& xs) {
+    position.emplace_back(0);
+    auto result = caf::visit(*this, xs[0]);
+    for (size_t i = 1; i < xs.size(); ++i) {
+      position.back() = i;
+      if constexpr (std::is_same_v<Connective, conjunction>)
+        result &= caf::visit(*this, xs[i]);
+      else
+        result |= caf::visit(*this, xs[i]);
+    }
+    position.pop_back();
+    return result;
+  }
+
+  ids operator()(const negation& x) {
+    position.emplace_back(0);
+    auto result = caf::visit(*this, x.expr());
+    position.pop_back();
+    result.flip();
+    return result;
+  }
+
+  ids operator()(const predicate&) {
+    auto i = hits.find(position);
+    return i != hits.end() ? i->second : ids{};
+  }
+
+  const std::map<offset, ids>& hits;
+  offset position;
+};
+
+// Compares IDs independent of their encoding.
+bool same_ids(const ids& x, const ids& y) {
+  return x.size() == y.size() && !any<1>(x ^ y);
+}
+
+struct fixture {
+  fixture() {
+    layout.fields.emplace_back("x", count_type{});
+    layout.fields.emplace_back("y", count_type{});
+    layout.fields.emplace_back("z", count_type{});
+  }
+
+  ids make_random_ids() {
+    ids result;
+    auto n = std::uniform_int_distribution<size_t>{0, 500}(gen);
+    auto p = std::uniform_real_distribution<>{0.0, 1.0}(gen);
+    std::bernoulli_distribution bit{p};
+    for (size_t i = 0; i < n; ++i)
+      result.append_bit(bit(gen));
+    return result;
+  }
+
+  // Binds random hits to all predicates, evaluates the tree, and then keeps
+  // modifying the hits of single predicates.
+  void check(std::string_view str) {
+    MESSAGE(str);
+    auto expr = unbox(to<expression>(str));
+    std::map<offset, ids> hits;
+    for (auto& [position, pred] : resolve(expr, layout))
+      hits[position] = make_random_ids();
+    ids_expression tree{expr};
+    for (auto& [position, x] : hits)
+      REQUIRE(tree.bind(position, x));
+    for (auto round = 0; round < 20; ++round) {
+      auto expected = caf::visit(reference_evaluator{hits, offset{0}}, expr);
+      CHECK(same_ids(tree.evaluate(), expected));
+      auto i = hits.begin();
+      std::advance(i, std::uniform_int_distribution<size_t>{
+                        0, hits.size() - 1}(gen));
+      i->second = make_random_ids();
+      tree.bind(i->first, i->second);
+    }
+  }
+
+  record_type layout;
+  std::mt19937 gen{42};
+};
+
+} // namespace
+
+FIXTURE_SCOPE(ids_expression_tests, fixture)
+
+TEST(empty expression) {
+  ids_expression tree;
+  CHECK(tree.evaluate().empty());
+}
+
+TEST(unbound predicates) {
+  ids_expression tree{unbox(to<expression>("x == 1 || y == 2"))};
+  CHECK(!any<1>(tree.evaluate()));
+  auto hits = make_ids({1, 3});
+  CHECK(tree.bind(offset{0, 1}, hits));
+  CHECK(!tree.bind(offset{0, 2}, hits));
+  CHECK_EQUAL(tree.evaluate(), hits);
+}
+
+TEST(connectives) {
+  check("x == 1");
+  check("x == 1 && y == 2");
+  check("x == 1 || y == 2");
+  check("x == 1 && y == 2 && z == 3");
+  check("x == 1 || y == 2 || z == 3");
+  check("x == 1 && y == 2 || z == 3");
+  check("x == 1 || y == 2 && z == 3");
+}
+
+TEST(negations) {
+  check("! x == 1");
+  check("x == 1 && ! y == 2");
+  check("! x == 1 && ! y == 2");
+  check("! x == 1 && y == 2 && ! z == 3");
+  check("x == 1 || ! y == 2");
+  check("! (x == 1 && y == 2) && z == 3");
+  check("! (x == 1 || ! y == 2) || z == 3");
+}
+
+FIXTURE_SCOPE_END()
@@ -0,0 +1,73 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE layout_registry
+
+#include "vast/layout_registry.hpp"
+
+#include "vast/test/test.hpp"
+
+#include "vast/load.hpp"
+#include "vast/save.hpp"
+
+using namespace vast;
+
+namespace {
+
+struct fixture {
+  record_type foo = record_type{
+    {"x", count_type{}},
+    {"y", string_type{}}
+  }.name("foo");
+
+  record_type bar = record_type{
+    {"x", count_type{}},
+    {"y", string_type{}}
+  }.name("bar");
+};
+
+} // namespace <anonymous>
+
+FIXTURE_SCOPE(layout_registry_tests, fixture)
+
+TEST(deduplication) {
+  layout_registry xs;
+  auto foo_id = xs.add(foo);
+  auto bar_id = xs.add(bar);
+  CHECK_NOT_EQUAL(foo_id, bar_id);
+  CHECK_EQUAL(xs.add(foo), foo_id);
+  CHECK_EQUAL(xs.add(bar), bar_id);
+  CHECK_EQUAL(xs.size(), 2u);
+  REQUIRE_NOT_EQUAL(xs.find(foo_id), nullptr);
+  CHECK_EQUAL(*xs.find(foo_id), foo);
+  REQUIRE_NOT_EQUAL(xs.find(bar_id), nullptr);
+  CHECK_EQUAL(*xs.find(bar_id), bar);
+  CHECK_EQUAL(xs.find(42), nullptr);
+}
+
+TEST(serialization) {
+  layout_registry xs;
+  auto foo_id = xs.add(foo);
+  auto bar_id = xs.add(bar);
+  std::vector<char> buf;
+  REQUIRE_EQUAL(save(nullptr, buf, xs), caf::none);
+  layout_registry ys;
+  REQUIRE_EQUAL(load(nullptr, buf, ys), caf::none);
+  CHECK_EQUAL(xs, ys);
+  MESSAGE("deserialized registries keep deduplicating");
+  CHECK_EQUAL(ys.add(foo), foo_id);
+  CHECK_EQUAL(ys.add(bar), bar_id);
+  CHECK_EQUAL(ys.size(), 2u);
+}
+
+FIXTURE_SCOPE_END()
@@ -265,10 +265,108 @@ TEST(meta index with boolean synopsis) {
   CHECK_EQUAL(lookup("y != F"), all);
   CHECK_EQUAL(lookup("y == F"), all);
   CHECK_EQUAL(lookup("y != T"), all);
+  MESSAGE("lookups remain exact for partitions added later");
+  CHECK(builder->add(make_data_view(true)));
+  slice = builder->finish();
+  REQUIRE(slice != nullptr);
+  auto id4 = uuid::random();
+  meta_idx.add(id4, *slice);
+  auto expected3 = std::vector<uuid>{id1, id4};
+  std::sort(expected3.begin(), expected3.end());
+  CHECK_EQUAL(lookup("x == T"), expected3);
+  CHECK_EQUAL(lookup("x == F"), expected2);
   MESSAGE("perform serialization");
   CHECK_ROUNDTRIP(meta_idx);
 }
 
+TEST(meta index with min-max synopsis) {
+  factory<synopsis>::initialize();
+  meta_index meta_idx;
+  auto layout = record_type{{"x", count_type{}}};
+  auto builder = default_table_slice_builder::make(layout);
+  // Partition i holds the values [10i, 10i + 5].
+  std::vector<uuid> ids;
+  for (count i = 0; i < 100; ++i) {
+    CHECK(builder->add(make_data_view(10 * i)));
+    CHECK(builder->add(make_data_view(10 * i + 5)));
+    auto slice = builder->finish();
+    REQUIRE(slice != nullptr);
+    ids.push_back(uuid::random());
+    meta_idx.add(ids.back(), *slice);
+  }
+  auto lookup = [&](std::string_view expr) {
+    return meta_idx.lookup(unbox(to<expression>(expr)));
+  };
+  auto select = [&](std::vector<size_t> xs) {
+    std::vector<uuid> result;
+    for (auto x : xs)
+      result.push_back(ids[x]);
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+  MESSAGE("point and range queries");
+  CHECK_EQUAL(lookup("x == 42"), select({4}));
+  CHECK_EQUAL(lookup("x == 47"), select({}));
+  CHECK_EQUAL(lookup("x < 15"), select({0, 1}));
+  CHECK_EQUAL(lookup("x <= 10"), select({0, 1}));
+  CHECK_EQUAL(lookup("x > 984"), select({98, 99}));
+  CHECK_EQUAL(lookup("x >= 995"), select({99}));
+  CHECK_EQUAL(lookup("x > 995"), select({}));
+  CHECK_EQUAL(lookup("x > 42 && x < 65"), select({4, 5, 6}));
+  CHECK_EQUAL(lookup(":count == 42"), select({4}));
+  MESSAGE("updates of indexed partitions");
+  CHECK(builder->add(make_data_view(count{42})));
+  auto slice = builder->finish();
+  REQUIRE(slice != nullptr);
+  meta_idx.add(ids[0], *slice);
+  CHECK_EQUAL(lookup("x == 42"), select({0, 4}));
+  CHECK_EQUAL(lookup("x == 47"), select({0}));
+  MESSAGE("new partitions after indexing");
+  CHECK(builder->add(make_data_view(count{47})));
+  slice = builder->finish();
+  REQUIRE(slice != nullptr);
+  ids.push_back(uuid::random());
+  meta_idx.add(ids.back(), *slice);
+  CHECK_EQUAL(lookup("x == 47"), select({0, 100}));
+  MESSAGE("values of a different type");
+  auto all = ids;
+  std::sort(all.begin(), all.end());
+  CHECK_EQUAL(lookup("x == -42"), all);
+}
+
+TEST(meta index with partitions without synopses) {
+  factory<synopsis>::initialize();
+  meta_index meta_idx;
+  auto layout = record_type{{"x", count_type{}}};
+  auto builder = default_table_slice_builder::make(layout);
+  CHECK(builder->add(make_data_view(count{1})));
+  auto slice = builder->finish();
+  REQUIRE(slice != nullptr);
+  auto id1 = uuid::random();
+  meta_idx.add(id1, *slice);
+  auto id2 = uuid::random();
+  meta_idx.add(id2);
+  auto lookup = [&](std::string_view expr) {
+    return meta_idx.lookup(unbox(to<expression>(expr)));
+  };
+  auto both = std::vector<uuid>{id1, id2};
+  std::sort(both.begin(), both.end());
+  MESSAGE("partitions without synopses qualify for all queries");
+  CHECK_EQUAL(lookup("x == 1"), both);
+  CHECK_EQUAL(lookup("x == 2"), std::vector<uuid>{id2});
+  CHECK_EQUAL(lookup("#type == \"foo\""), std::vector<uuid>{id2});
+  MESSAGE("merge synopses computed elsewhere");
+  auto syn = factory<synopsis>::make(count_type{}, synopsis_options{});
+  REQUIRE_NOT_EQUAL(syn, nullptr);
+  syn->add(count{2});
+  meta_index::partition_synopsis synopses;
+  synopses.emplace(layout, meta_index::table_synopsis{syn});
+  meta_idx.merge(id2, std::move(synopses));
+  CHECK_EQUAL(lookup("x == 1"), std::vector<uuid>{id1});
+  CHECK_EQUAL(lookup("x == 2"), std::vector<uuid>{id2});
+  CHECK_EQUAL(lookup("x == 3"), std::vector<uuid>{});
+}
+
 TEST(option setting and retrieval) {
   meta_index meta_idx;
   auto& opts = meta_idx.factory_options();
@@ -62,6 +62,18 @@ TEST(composition) {
   CHECK(!foo_and_bar.match("bar"));
 }
 
+TEST(modification) {
+  auto p = pattern{"foo"};
+  CHECK(p.match("foo"));
+  auto copy = p;
+  p += "bar";
+  CHECK(!p.match("foo"));
+  CHECK(p.match("foobar"));
+  CHECK(copy.match("foo"));
+  p |= "baz";
+  CHECK(p.match("baz"));
+}
+
 TEST(printable) {
   auto p = pattern("(\\w+ )");
   CHECK_EQUAL(to_string(p), "/(\\w+ )/");
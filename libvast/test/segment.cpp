@@ -19,9 +19,13 @@
 #include "vast/test/test.hpp"
 #include "vast/test/fixtures/events.hpp"
 
+#include <tuple>
+
 #include <caf/binary_deserializer.hpp>
 #include <caf/binary_serializer.hpp>
 
+#include "vast/columnar_table_slice.hpp"
+#include "vast/columnar_table_slice_builder.hpp"
 #include "vast/ids.hpp"
 #include "vast/load.hpp"
 #include "vast/table_slice.hpp"
@@ -29,7 +33,42 @@
 
 using namespace vast;
 
-FIXTURE_SCOPE(segment_tests, fixtures::events)
+namespace {
+
+struct fixture : fixtures::events {
+  void check_compression(compression method) {
+    segment_builder builder{method};
+    for (auto& slice : zeek_conn_log_slices)
+      REQUIRE(!builder.add(slice));
+    auto x = builder.finish();
+    REQUIRE_NOT_EQUAL(x, nullptr);
+    for (auto& synopsis : x->meta().slices) {
+      auto bytes = static_cast<uint64_t>(synopsis.end - synopsis.start);
+      if (synopsis.method == method)
+        CHECK_LESS(bytes, synopsis.raw_size);
+      else
+        CHECK_EQUAL(bytes, synopsis.raw_size);
+    }
+    MESSAGE("lookup uncompresses the selected slices");
+    auto xs = unbox(x->lookup(make_ids({0, 6, 19, 21})));
+    REQUIRE_EQUAL(xs.size(), 2u);
+    CHECK_EQUAL(*xs[0], *zeek_conn_log_slices[0]);
+    CHECK_EQUAL(*xs[1], *zeek_conn_log_slices[2]);
+    MESSAGE("segments survive a serialization roundtrip");
+    std::vector<char> buf;
+    REQUIRE_EQUAL(save(nullptr, buf, x), caf::none);
+    auto y = segment::make(chunk::make(std::move(buf)));
+    REQUIRE_NOT_EQUAL(y, nullptr);
+    auto ys = unbox(y->lookup(make_ids({0, 6, 19, 21})));
+    REQUIRE_EQUAL(ys.size(), 2u);
+    CHECK_EQUAL(*ys[0], *zeek_conn_log_slices[0]);
+    CHECK_EQUAL(*ys[1], *zeek_conn_log_slices[2]);
+  }
+};
+
+} // namespace
+
+FIXTURE_SCOPE(segment_tests, fixture)
 
 TEST(construction and querying) {
   segment_builder builder;
@@ -68,4 +107,106 @@ TEST(serialization) {
                    z->chunk()->begin(), z->chunk()->end()));
 }
 
+TEST(lz4 compression) {
+  check_compression(compression::lz4);
+}
+
+#ifdef VAST_HAVE_SNAPPY
+TEST(snappy compression) {
+  check_compression(compression::snappy);
+}
+#endif // VAST_HAVE_SNAPPY
+
+TEST(version 1 compatibility) {
+  auto slice = zeek_conn_log_slices[0];
+  std::vector<char> payload;
+  caf::binary_serializer payload_sink{nullptr, payload};
+  REQUIRE_EQUAL(payload_sink(slice), caf::none);
+  // Version 1 stored uncompressed slices and no compression meta data.
+  using table_slice_synopsis_v1 = std::tuple<int64_t, int64_t, id, uint64_t>;
+  std::vector<table_slice_synopsis_v1> meta{
+    {int64_t{0}, static_cast<int64_t>(payload.size()), slice->offset(),
+     slice->rows()}};
+  segment_header header{segment::magic, 1, uuid::random(), 0};
+  auto payload_chunk = chunk::make(std::move(payload));
+  std::vector<char> buf;
+  caf::binary_serializer sink{nullptr, buf};
+  REQUIRE_EQUAL(sink(header, meta, payload_chunk), caf::none);
+  auto x = segment::make(chunk::make(std::move(buf)));
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  CHECK_EQUAL(x->num_slices(), 1u);
+  auto xs = unbox(x->lookup(make_ids({slice->offset()})));
+  REQUIRE_EQUAL(xs.size(), 1u);
+  CHECK_EQUAL(*xs[0], *slice);
+}
+
+TEST(version 2 compatibility) {
+  auto slice = zeek_conn_log_slices[0];
+  std::vector<char> payload;
+  caf::binary_serializer payload_sink{nullptr, payload};
+  REQUIRE_EQUAL(payload_sink(slice), caf::none);
+  // Version 2 stored the layout with every slice.
+  using table_slice_synopsis_v2
+    = std::tuple<int64_t, int64_t, id, uint64_t, compression, uint64_t>;
+  std::vector<table_slice_synopsis_v2> meta{
+    {int64_t{0}, static_cast<int64_t>(payload.size()), slice->offset(),
+     slice->rows(), compression::null, payload.size()}};
+  segment_header header{segment::magic, 2, uuid::random(), 0};
+  auto payload_chunk = chunk::make(std::move(payload));
+  std::vector<char> buf;
+  caf::binary_serializer sink{nullptr, buf};
+  REQUIRE_EQUAL(sink(header, meta, payload_chunk), caf::none);
+  auto x = segment::make(chunk::make(std::move(buf)));
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  CHECK_EQUAL(x->num_slices(), 1u);
+  auto xs = unbox(x->lookup(make_ids({slice->offset()})));
+  REQUIRE_EQUAL(xs.size(), 1u);
+  CHECK_EQUAL(*xs[0], *slice);
+}
+
+TEST(layout deduplication) {
+  segment_builder builder{compression::null};
+  for (auto& slice : zeek_conn_log_slices)
+    REQUIRE(!builder.add(slice));
+  auto x = builder.finish();
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  MESSAGE("all slices share a single layout");
+  CHECK_EQUAL(x->meta().layouts.size(), 1u);
+  for (auto& synopsis : x->meta().slices)
+    CHECK_EQUAL(synopsis.layout, x->meta().slices[0].layout);
+  MESSAGE("slices do not carry their layout");
+  std::vector<char> buf;
+  caf::binary_serializer sink{nullptr, buf};
+  for (auto& slice : zeek_conn_log_slices)
+    REQUIRE_EQUAL(sink(slice), caf::none);
+  CHECK_LESS(x->chunk()->size(), buf.size());
+  MESSAGE("lookup restores the layout");
+  auto xs = unbox(x->lookup(make_ids({0, 6, 19, 21})));
+  REQUIRE_EQUAL(xs.size(), 2u);
+  CHECK_EQUAL(*xs[0], *zeek_conn_log_slices[0]);
+  CHECK_EQUAL(*xs[1], *zeek_conn_log_slices[2]);
+}
+
+TEST(zero-copy lookup) {
+  auto& orig = zeek_conn_log_slices[0];
+  columnar_table_slice_builder slice_builder{orig->layout()};
+  for (size_t row = 0; row < orig->rows(); ++row)
+    for (size_t col = 0; col < orig->columns(); ++col)
+      REQUIRE(slice_builder.add(orig->at(row, col)));
+  auto slice = slice_builder.finish();
+  slice.unshared().offset(orig->offset());
+  segment_builder builder{compression::null};
+  REQUIRE(!builder.add(slice));
+  auto x = builder.finish();
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  auto xs = unbox(x->lookup(make_ids({orig->offset()})));
+  REQUIRE_EQUAL(xs.size(), 1u);
+  CHECK_EQUAL(*xs[0], *orig);
+  MESSAGE("the loaded slice points into the segment chunk");
+  REQUIRE_EQUAL(xs[0]->implementation_id(), columnar_table_slice::class_id);
+  auto& payload = static_cast<const columnar_table_slice&>(*xs[0]).payload();
+  CHECK_GREATER_EQUAL(payload->begin(), x->chunk()->begin());
+  CHECK_LESS_EQUAL(payload->end(), x->chunk()->end());
+}
+
 FIXTURE_SCOPE_END()
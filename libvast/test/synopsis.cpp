@@ -21,9 +21,17 @@
 
 #include <caf/binary_deserializer.hpp>
 #include <caf/binary_serializer.hpp>
+#include <caf/settings.hpp>
 
+#include "vast/arithmetic_synopsis.hpp"
+#include "vast/bloom_filter_synopsis.hpp"
 #include "vast/boolean_synopsis.hpp"
+#include "vast/columnar_table_slice_builder.hpp"
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/address.hpp"
+#include "vast/default_table_slice_builder.hpp"
 #include "vast/synopsis_factory.hpp"
+#include "vast/table_slice.hpp"
 #include "vast/timestamp_synopsis.hpp"
 
 using namespace std::chrono_literals;
@@ -49,28 +57,28 @@ TEST(min-max synopsis) {
   verify(zero, {N, N, N, N, N, N, F, T, F, F, T, T});
   MESSAGE("[4,7] op 4");
   timestamp four = epoch + 4s;
-  verify(four, {N, N, N, N, N, N, T, F, F, T, T, T});
+  verify(four, {N, N, N, N, N, N, T, T, F, T, T, T});
   MESSAGE("[4,7] op 6");
   timestamp six = epoch + 6s;
-  verify(six, {N, N, N, N, N, N, T, F, T, T, T, T});
+  verify(six, {N, N, N, N, N, N, T, T, T, T, T, T});
   MESSAGE("[4,7] op 7");
   timestamp seven = epoch + 7s;
-  verify(seven, {N, N, N, N, N, N, T, F, T, T, F, T});
+  verify(seven, {N, N, N, N, N, N, T, T, T, T, F, T});
   MESSAGE("[4,7] op 9");
   timestamp nine = epoch + 9s;
   verify(nine, {N, N, N, N, N, N, F, T, T, T, F, F});
   MESSAGE("[4,7] op {0, 4}");
   auto zero_four = data{set{zero, four}};
   auto zero_four_view = make_view(zero_four);
-  verify(zero_four_view, {N, N, T, F, N, N, N, N, N, N, N, N});
+  verify(zero_four_view, {N, N, T, N, N, N, N, N, N, N, N, N});
   MESSAGE("[4,7] op {7, 9}");
   auto seven_nine = data{set{seven, nine}};
   auto seven_nine_view = make_view(seven_nine);
-  verify(seven_nine_view, {N, N, T, F, N, N, N, N, N, N, N, N});
+  verify(seven_nine_view, {N, N, T, N, N, N, N, N, N, N, N, N});
   MESSAGE("[4,7] op {0, 9}");
   auto zero_nine = data{set{zero, nine}};
   auto zero_nine_view = make_view(zero_nine);
-  verify(zero_nine_view, {N, N, F, T, N, N, N, N, N, N, N, N});
+  verify(zero_nine_view, {N, N, F, N, N, N, N, N, N, N, N, N});
   // Check that we don't do any implicit conversions.
   MESSAGE("[4,7] op count{5}");
   count c = 5;
@@ -78,7 +86,155 @@ TEST(min-max synopsis) {
   MESSAGE("[4,7] op {count{5}, 7}");
   auto heterogeneous = data{set{c, seven}};
   auto heterogeneous_view = make_view(heterogeneous);
-  verify(heterogeneous_view, {N, N, T, F, N, N, N, N, N, N, N, N});
+  verify(heterogeneous_view, {N, N, T, N, N, N, N, N, N, N, N, N});
+}
+
+TEST(min-max synopsis - arithmetic) {
+  using namespace nft;
+  factory<synopsis>::initialize();
+  auto x = factory<synopsis>::make(real_type{}, synopsis_options{});
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  MESSAGE("empty synopsis");
+  auto verify = verifier{x};
+  verify(real{4.2}, {N, N, N, N, N, N, F, T, F, F, F, F});
+  x->add(real{-1.5});
+  x->add(real{4.2});
+  MESSAGE("[-1.5,4.2] op -2");
+  verify(real{-2}, {N, N, N, N, N, N, F, T, F, F, T, T});
+  MESSAGE("[-1.5,4.2] op 0");
+  verify(real{0}, {N, N, N, N, N, N, T, T, T, T, T, T});
+  MESSAGE("[-1.5,4.2] op 5");
+  verify(real{5}, {N, N, N, N, N, N, F, T, T, T, F, F});
+  auto y = factory<synopsis>::make(count_type{}, synopsis_options{});
+  REQUIRE_NOT_EQUAL(y, nullptr);
+  y->add(count{42});
+  verify = verifier{y};
+  MESSAGE("[42,42] op 42");
+  verify(count{42}, {N, N, N, N, N, N, T, F, F, T, F, T});
+  MESSAGE("[42,42] op integer{42}");
+  verify(integer{42}, {N, N, N, N, N, N, N, N, N, N, N, N});
+}
+
+TEST(min-max synopsis - negations) {
+  using namespace nft;
+  factory<synopsis>::initialize();
+  auto x = factory<synopsis>::make(count_type{}, synopsis_options{});
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  x->add(count{0});
+  x->add(count{100});
+  auto verify = verifier{x};
+  MESSAGE("[0,100] != 5 may hold for other values in the range");
+  verify(count{5}, {N, N, N, N, N, N, T, T, T, T, T, T});
+  MESSAGE("[0,100] !in {5} may hold for other values in the range");
+  auto five = data{set{count{5}}};
+  verify(make_view(five), {N, N, T, N, N, N, N, N, N, N, N, N});
+  MESSAGE("a degenerate range excludes its only value");
+  auto y = factory<synopsis>::make(count_type{}, synopsis_options{});
+  REQUIRE_NOT_EQUAL(y, nullptr);
+  y->add(count{5});
+  verify = verifier{y};
+  verify(count{5}, {N, N, N, N, N, N, T, F, F, T, F, T});
+  verify(count{6}, {N, N, N, N, N, N, F, T, T, T, F, F});
+}
+
+TEST(bloom filter synopsis) {
+  using namespace nft;
+  factory<synopsis>::initialize();
+  synopsis_options opts;
+  put(opts, "bloom-filter-capacity", size_t{100});
+  put(opts, "bloom-filter-fp-rate", 0.01);
+  auto x = factory<synopsis>::make(address_type{}, opts);
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  auto& bf = dynamic_cast<bloom_filter_synopsis&>(*x);
+  CHECK_EQUAL(bf.num_bits() % 64, 0u);
+  CHECK_GREATER_EQUAL(bf.num_bits(), 959u);
+  CHECK_EQUAL(bf.num_hashes(), 7u);
+  auto addr = [](auto str) { return unbox(to<address>(str)); };
+  auto a = addr("192.168.0.1");
+  auto b = addr("10.0.0.1");
+  auto c = addr("172.16.0.1");
+  auto verify = verifier{x};
+  MESSAGE("empty filter");
+  verify(a, {N, N, N, N, N, N, F, N, N, N, N, N});
+  x->add(a);
+  x->add(b);
+  MESSAGE("equality");
+  verify(a, {N, N, N, N, N, N, T, N, N, N, N, N});
+  verify(b, {N, N, N, N, N, N, T, N, N, N, N, N});
+  verify(c, {N, N, N, N, N, N, F, N, N, N, N, N});
+  MESSAGE("subnet containment at prefix boundaries");
+  verify(subnet{a, 24}, {N, N, T, N, N, N, N, N, N, N, N, N});
+  verify(subnet{a, 16}, {N, N, T, N, N, N, N, N, N, N, N, N});
+  verify(subnet{b, 8}, {N, N, T, N, N, N, N, N, N, N, N, N});
+  verify(subnet{a, 32}, {N, N, T, N, N, N, N, N, N, N, N, N});
+  verify(subnet{c, 16}, {N, N, F, N, N, N, N, N, N, N, N, N});
+  MESSAGE("subnet containment between prefix boundaries");
+  verify(subnet{a, 20}, {N, N, N, N, N, N, N, N, N, N, N, N});
+  MESSAGE("membership");
+  auto xs = data{set{a, c}};
+  verify(make_view(xs), {N, N, T, N, N, N, N, N, N, N, N, N});
+  auto ys = data{set{c}};
+  verify(make_view(ys), {N, N, F, N, N, N, N, N, N, N, N, N});
+  MESSAGE("strings");
+  auto y = factory<synopsis>::make(string_type{}, opts);
+  REQUIRE_NOT_EQUAL(y, nullptr);
+  y->add(make_view("foo"));
+  verify = verifier{y};
+  verify(make_view("foo"), {N, N, N, N, N, N, T, N, N, N, N, N});
+  verify(make_view("bar"), {N, N, N, N, N, N, F, N, N, N, N, N});
+  verify(subnet{a, 24}, {N, N, N, N, N, N, N, N, N, N, N, N});
+  MESSAGE("ports of unknown protocol match any protocol");
+  auto z = factory<synopsis>::make(port_type{}, opts);
+  REQUIRE_NOT_EQUAL(z, nullptr);
+  z->add(port{80, port::tcp});
+  z->add(port{53, port::unknown});
+  verify = verifier{z};
+  verify(port{80, port::tcp}, {N, N, N, N, N, N, T, N, N, N, N, N});
+  verify(port{80, port::unknown}, {N, N, N, N, N, N, T, N, N, N, N, N});
+  verify(port{53, port::udp}, {N, N, N, N, N, N, T, N, N, N, N, N});
+  verify(port{443, port::tcp}, {N, N, N, N, N, N, F, N, N, N, N, N});
+}
+
+TEST(column-wise addition) {
+  using namespace nft;
+  factory<synopsis>::initialize();
+  auto layout = record_type{{"x", count_type{}}, {"y", real_type{}}};
+  auto verify = [&](table_slice_builder_ptr builder) {
+    // Spans two blocks of 64 rows, one of which has nil values.
+    for (count i = 0; i < 100; ++i) {
+      if (i % 7 == 0)
+        CHECK(builder->add(make_data_view(caf::none)));
+      else
+        CHECK(builder->add(make_data_view(i)));
+      CHECK(builder->add(make_data_view(real{i * -0.5})));
+    }
+    auto slice = builder->finish();
+    REQUIRE(slice != nullptr);
+    for (size_t col = 0; col < layout.fields.size(); ++col) {
+      auto& t = layout.fields[col].type;
+      auto x = factory<synopsis>::make(t, synopsis_options{});
+      auto y = factory<synopsis>::make(t, synopsis_options{});
+      REQUIRE_NOT_EQUAL(x, nullptr);
+      REQUIRE_NOT_EQUAL(y, nullptr);
+      x->add_column(*slice, col);
+      for (size_t row = 0; row < slice->rows(); ++row) {
+        auto v = slice->at(row, col);
+        if (!caf::holds_alternative<caf::none_t>(v))
+          y->add(v);
+      }
+      CHECK_EQUAL(*x, *y);
+    }
+    auto x = factory<synopsis>::make(count_type{}, synopsis_options{});
+    x->add_column(*slice, 0);
+    CHECK_EQUAL(x->lookup(less, make_view(count{1})), F);
+    CHECK_EQUAL(x->lookup(less_equal, make_view(count{1})), T);
+    CHECK_EQUAL(x->lookup(greater, make_view(count{99})), F);
+    CHECK_EQUAL(x->lookup(greater_equal, make_view(count{99})), T);
+  };
+  MESSAGE("default table slice");
+  verify(default_table_slice_builder::make(layout));
+  MESSAGE("columnar table slice");
+  verify(columnar_table_slice_builder::make(layout));
 }
 
 FIXTURE_SCOPE(synopsis_tests, fixtures::deterministic_actor_system)
@@ -89,6 +245,13 @@ TEST(serialization) {
   CHECK_ROUNDTRIP(synopsis_ptr{});
   CHECK_ROUNDTRIP_DEREF(factory<synopsis>::make(boolean_type{}, empty));
   CHECK_ROUNDTRIP_DEREF(factory<synopsis>::make(timestamp_type{}, empty));
+  CHECK_ROUNDTRIP_DEREF(factory<synopsis>::make(count_type{}, empty));
+  CHECK_ROUNDTRIP_DEREF(factory<synopsis>::make(address_type{}, empty));
+  synopsis_options opts;
+  put(opts, "bloom-filter-capacity", size_t{100});
+  auto bf = factory<synopsis>::make(string_type{}, opts);
+  bf->add(make_view("foo"));
+  CHECK_ROUNDTRIP_DEREF(bf);
 }
 
 FIXTURE_SCOPE_END()
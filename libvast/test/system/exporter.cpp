@@ -26,11 +26,14 @@
 #include "vast/system/archive.hpp"
 #include "vast/system/importer.hpp"
 #include "vast/system/index.hpp"
+#include "vast/si_literals.hpp"
 #include "vast/system/replicated_store.hpp"
 #include "vast/table_slice.hpp"
+#include "vast/to_events.hpp"
 
 using namespace caf;
 using namespace vast;
+using namespace vast::binary_byte_literals;
 
 using std::string;
 using std::chrono_literals::operator""ms;
@@ -46,7 +49,7 @@ struct fixture : fixture_base {
   }
 
   ~fixture() {
-    for (auto& hdl : {index, importer, exporter, raft_consensus})
+    for (auto& hdl : {index, second_index, importer, exporter, raft_consensus})
       self->send_exit(hdl, exit_reason::user_shutdown);
     self->send_exit(archive, exit_reason::user_shutdown);
     self->send_exit(consensus, exit_reason::user_shutdown);
@@ -54,7 +57,14 @@ struct fixture : fixture_base {
   }
 
   void spawn_index() {
-    index = self->spawn(system::index, directory / "index", 10000, 5, 5, 1);
+    index = self->spawn(system::index, directory / "index", 10000, 5_MiB, 5, 1,
+                        0, system::evaluation_engine::in_process);
+  }
+
+  void spawn_second_index() {
+    second_index = self->spawn(system::index, directory / "index-2", 10000,
+                               5_MiB, 5, 1, 0,
+                               system::evaluation_engine::in_process);
   }
 
   void spawn_archive() {
@@ -63,7 +73,7 @@ struct fixture : fixture_base {
 
   void spawn_importer() {
     importer = self->spawn(system::importer, directory / "importer",
-                           slice_size);
+                           slice_size, system::index_routing::round_robin);
   }
 
   void spawn_raft_consensus() {
@@ -93,6 +103,8 @@ struct fixture : fixture_base {
     run();
     send(importer, archive);
     send(importer, system::index_atom::value, index);
+    if (second_index)
+      send(importer, system::index_atom::value, second_index);
     send(importer, consensus);
     run();
   }
@@ -101,6 +113,8 @@ struct fixture : fixture_base {
     spawn_exporter(opts);
     send(exporter, archive);
     send(exporter, system::index_atom::value, index);
+    if (second_index)
+      send(exporter, system::index_atom::value, second_index);
     send(exporter, system::sink_atom::value, self);
     send(exporter, system::run_atom::value);
     send(exporter, system::extract_atom::value);
@@ -116,7 +130,8 @@ struct fixture : fixture_base {
     std::vector<event> result;
     bool done = false;
     self->do_receive(
-      [&](std::vector<event>& xs) {
+      [&](const table_slice_ptr& slice, const ids& selection) {
+        auto xs = to_events(*slice, selection);
         MESSAGE("... got " << xs.size() << " events");
         std::move(xs.begin(), xs.end(), std::back_inserter(result));
       },
@@ -130,6 +145,7 @@ struct fixture : fixture_base {
   }
 
   actor index;
+  actor second_index;
   system::archive_type archive;
   actor importer;
   actor exporter;
@@ -182,6 +198,25 @@ TEST(historical query with importer) {
   CHECK_EQUAL(results.back().id(), 19u);
 }
 
+TEST(historical query with multiple indexes) {
+  MESSAGE("prepare importer with two INDEX actors");
+  spawn_second_index();
+  importer_setup();
+  MESSAGE("ingest conn.log via importer");
+  vast::detail::spawn_container_source(sys, copy(zeek_conn_log_slices),
+                                       importer);
+  run();
+  MESSAGE("spawn exporter for historical query");
+  exporter_setup(historical);
+  MESSAGE("fetch results");
+  auto results = fetch_results();
+  REQUIRE_EQUAL(results.size(), 5u);
+  std::sort(results.begin(), results.end());
+  CHECK_EQUAL(results.front().id(), 10u);
+  CHECK_EQUAL(results.front().type().name(), "zeek.conn");
+  CHECK_EQUAL(results.back().id(), 19u);
+}
+
 TEST(continuous query with exporter only) {
   MESSAGE("prepare exporter for continuous query");
   spawn_exporter(continuous);
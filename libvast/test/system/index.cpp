@@ -27,6 +27,7 @@
 #include "vast/event.hpp"
 #include "vast/ids.hpp"
 #include "vast/query_options.hpp"
+#include "vast/si_literals.hpp"
 #include "vast/system/atoms.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/table_slice_builder.hpp"
@@ -38,21 +39,29 @@ using caf::after;
 using std::chrono_literals::operator""s;
 
 using namespace vast;
+using namespace vast::binary_byte_literals;
 using namespace std::chrono;
 
 namespace {
 
-static constexpr uint32_t in_mem_partitions = 8;
+static constexpr size_t max_resident_size = 8_MiB;
 
 static constexpr uint32_t taste_count = 4;
 
 static constexpr size_t num_query_supervisors = 1;
 
+static constexpr size_t num_meta_indexers = 0;
+
 struct fixture : fixtures::deterministic_actor_system_and_events {
   fixture() {
     directory /= "index";
+    spawn_index(system::evaluation_engine::in_process);
+  }
+
+  void spawn_index(system::evaluation_engine engine) {
     index = self->spawn(system::index, directory / "index", slice_size,
-                        in_mem_partitions, taste_count, num_query_supervisors);
+                        max_resident_size, taste_count, num_query_supervisors,
+                        num_meta_indexers, engine);
   }
 
   ~fixture() {
@@ -175,6 +184,89 @@ TEST(iterable integer query result) {
   CHECK_EQUAL(result, expected_result);
 }
 
+TEST(actor-based evaluation) {
+  MESSAGE("respawn the INDEX with INDEXER actors per column");
+  anon_send_exit(index, caf::exit_reason::user_shutdown);
+  run();
+  directory /= "actors";
+  spawn_index(system::evaluation_engine::actors);
+  run();
+  MESSAGE("fill first " << (taste_count * 3) << " partitions");
+  auto slices = first_n(alternating_integers_slices, taste_count * 3);
+  auto src = detail::spawn_container_source(sys, slices, index);
+  run();
+  MESSAGE("query half of the values");
+  auto [query_id, hits, scheduled] = query(":int == 1");
+  CHECK_NOT_EQUAL(query_id, uuid::nil());
+  CHECK_EQUAL(hits, taste_count * 3);
+  CHECK_EQUAL(scheduled, taste_count);
+  ids expected_result;
+  expected_result.append_bits(false, alternating_integers[0].id());
+  for (size_t i = 0; i < (slice_size * taste_count * 3) / 2; ++i) {
+    expected_result.append_bit(false);
+    expected_result.append_bit(true);
+  }
+  MESSAGE("collect results");
+  auto result = receive_result(query_id, hits, scheduled);
+  CHECK_EQUAL(result, expected_result);
+}
+
+TEST(interactive tasks precede bulk tasks) {
+  MESSAGE("fill first " << (taste_count * 2) << " partitions");
+  auto slices = first_n(alternating_integers_slices, taste_count * 2);
+  auto src = detail::spawn_container_source(sys, slices, index);
+  run();
+  MESSAGE("keep all workers busy");
+  auto& st = state();
+  auto workers = std::move(st.idle_workers);
+  st.idle_workers.clear();
+  MESSAGE("enqueue bulk tasks before interactive tasks");
+  auto expr = unbox(to<expression>(":int == 1"));
+  auto candidates = st.meta_idx.lookup(expr);
+  REQUIRE_EQUAL(candidates.size(), taste_count * 2u);
+  using lookup_state = system::index_state::lookup_state;
+  lookup_state bulk{expr, first_n(candidates, taste_count)};
+  lookup_state interactive{expr, std::vector<uuid>(candidates.begin()
+                                                     + taste_count,
+                                                   candidates.end())};
+  CHECK_EQUAL(st.enqueue_tasks(bulk, taste_count, uuid::random(), self,
+                               false),
+              taste_count);
+  auto interactive_batch = st.next_batch;
+  CHECK_EQUAL(st.enqueue_tasks(interactive, taste_count, uuid::random(), self,
+                               true),
+              taste_count);
+  CHECK(bulk.partitions.empty());
+  CHECK(interactive.partitions.empty());
+  using index_state = system::index_state;
+  CHECK_EQUAL(st.task_queues[index_state::interactive_in_memory].size()
+                + st.task_queues[index_state::interactive_on_disk].size(),
+              taste_count);
+  CHECK_EQUAL(st.task_queues[index_state::bulk_in_memory].size()
+                + st.task_queues[index_state::bulk_on_disk].size(),
+              taste_count);
+  MESSAGE("idle workers pick interactive tasks first");
+  // Tasks for partitions on disk wait for the PARTITION LOADER instead.
+  auto resident
+    = !st.task_queues[index_state::interactive_in_memory].empty();
+  st.idle_workers = std::move(workers);
+  st.dispatch_tasks();
+  if (resident) {
+    REQUIRE_EQUAL(st.busy_workers.size(), num_query_supervisors);
+    CHECK_EQUAL(st.busy_workers.front().second, interactive_batch);
+  }
+  MESSAGE("collect results of both batches");
+  run();
+  ids result;
+  size_t batches = 0;
+  while (batches < 2)
+    self->receive([&](ids& sub_result) { result |= sub_result; },
+                  [&](system::done_atom) { ++batches; },
+                  after(0s) >> [&] { FAIL("ran out of messages"); });
+  CHECK(st.batches.empty());
+  CHECK_EQUAL(rank(result), slice_size * taste_count);
+}
+
 TEST(iterable zeek conn log query result) {
   REQUIRE_EQUAL(zeek_conn_log.size(), 20u);
   MESSAGE("ingest conn.log slices");
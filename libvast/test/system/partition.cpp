@@ -24,12 +24,14 @@
 #include "vast/concept/parseable/vast/expression.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/type.hpp"
+#include "vast/concept/printable/vast/uuid.hpp"
 #include "vast/default_table_slice.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/detail/spawn_container_source.hpp"
 #include "vast/event.hpp"
 #include "vast/ids.hpp"
 #include "vast/system/indexer.hpp"
+#include "vast/system/partition_file.hpp"
 #include "vast/table_slice.hpp"
 
 #include "vast/test/fixtures/dummy_index.hpp"
@@ -169,6 +171,40 @@ TEST(eager initialization) {
   });
 }
 
+TEST(sealing) {
+  MESSAGE("create and persist new partition");
+  uuid id;
+  run_in_index([&] {
+    auto put = make_partition();
+    id = put->id();
+    for (auto& x : layouts)
+      CHECK_EQUAL(put->get_or_add(x).first.init(), caf::none);
+  });
+  run();
+  auto dir = idx_state->dir / to_string(id);
+  REQUIRE(exists(dir));
+  MESSAGE("consolidate partition into a single file");
+  CHECK_EQUAL(partition::seal(dir), caf::none);
+  CHECK(!exists(dir));
+  CHECK(exists(partition_file::filename(dir)));
+  MESSAGE("load sealed partition");
+  auto md = partition::load_meta_data(dir);
+  REQUIRE(md);
+  REQUIRE(md->file != nullptr);
+  CHECK_EQUAL(md->file->tables().size(), layouts.size());
+  run_in_index([&] {
+    auto put = make_partition(id);
+    put->init(std::move(*md));
+    CHECK_EQUAL(sorted_strings(put->layouts()), sorted_strings(layouts));
+    for (auto& x : layouts) {
+      auto& tbl = put->get_or_add(x).first;
+      CHECK_EQUAL(tbl.init(), caf::none);
+      CHECK_EQUAL(tbl.dirty(), false);
+    }
+    CHECK_EQUAL(put->dirty(), false);
+  });
+}
+
 /*
 TEST(integer rows lookup) {
   MESSAGE("generate partition for flat integer type");
@@ -62,11 +62,13 @@ TEST(lookup) {
   ids result;
   while (!done)
     self->receive([&](const ids& x) { result |= x; },
-                  [&](system::done_atom) { done = true; });
+                  [&](system::worker_atom, const caf::actor& worker) {
+                    MESSAGE("after completion, the supervisor should register "
+                            "itself again");
+                    CHECK(worker == sv);
+                    done = true;
+                  });
   CHECK_EQUAL(result, make_ids({{0, 9}}));
-  MESSAGE("after completion, the supervisor should register itself again");
-  expect((caf::atom_value, caf::actor),
-         from(sv).to(self).with(system::worker_atom::value, sv));
 }
 
 FIXTURE_SCOPE_END()
@@ -0,0 +1,70 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE source_command
+
+#include "vast/system/source_command.hpp"
+
+#include "vast/test/test.hpp"
+
+#include "vast/test/fixtures/filesystem.hpp"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "vast/filesystem.hpp"
+
+using namespace vast;
+using namespace vast::system;
+
+namespace {
+
+struct fixture : fixtures::filesystem {
+  fixture() {
+    for (auto name : {"conn.1.log", "conn.0.log", "dns.0.log"})
+      std::ofstream{(directory / name).str()} << "#separator \\x09\n";
+  }
+
+  std::string file(const char* name) {
+    return (directory / name).str();
+  }
+};
+
+} // namespace <anonymous>
+
+FIXTURE_SCOPE(source_command_tests, fixture)
+
+TEST(expand a single file) {
+  auto input = file("conn.0.log");
+  CHECK_EQUAL(unbox(expand_inputs(input)), std::vector<std::string>{input});
+  CHECK_EQUAL(unbox(expand_inputs("-")), std::vector<std::string>{"-"});
+}
+
+TEST(expand a directory) {
+  auto expected = std::vector<std::string>{
+    file("conn.0.log"), file("conn.1.log"), file("dns.0.log")};
+  CHECK_EQUAL(unbox(expand_inputs(directory.str())), expected);
+}
+
+TEST(expand a glob pattern) {
+  auto expected = std::vector<std::string>{
+    file("conn.0.log"), file("conn.1.log")};
+  CHECK_EQUAL(unbox(expand_inputs(file("conn.*.log"))), expected);
+  CHECK_EQUAL(unbox(expand_inputs(file("dns.?.log"))),
+              std::vector<std::string>{file("dns.0.log")});
+  MESSAGE("patterns without matches are an error");
+  CHECK(!expand_inputs(file("http.*.log")));
+}
+
+FIXTURE_SCOPE_END()
@@ -0,0 +1,193 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE source_supervisor
+
+#include "vast/system/source_supervisor.hpp"
+
+#include "vast/test/test.hpp"
+
+#include "vast/test/fixtures/actor_system.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "vast/error.hpp"
+#include "vast/system/atoms.hpp"
+
+using namespace vast;
+using namespace vast::system;
+
+namespace {
+
+struct mock_source_state {
+  caf::actor sink;
+  static inline const char* name = "mock-source";
+};
+
+using mock_source_type = caf::stateful_actor<mock_source_state>;
+
+caf::behavior mock_source(mock_source_type* self) {
+  return {
+    [=](sink_atom, const caf::actor& sink) {
+      self->state.sink = sink;
+    }
+  };
+}
+
+struct mock_importer_state {
+  std::vector<caf::actor> flush_listeners;
+  static inline const char* name = "mock-importer";
+};
+
+using mock_importer_type = caf::stateful_actor<mock_importer_state>;
+
+caf::behavior mock_importer(mock_importer_type* self) {
+  return {
+    [=](subscribe_atom, flush_atom, caf::actor& listener) {
+      self->state.flush_listeners.emplace_back(std::move(listener));
+    }
+  };
+}
+
+struct fixture : fixtures::deterministic_actor_system {
+  fixture() {
+    importer = sys.spawn(mock_importer);
+    run();
+  }
+
+  ~fixture() {
+    for (auto& src : sources)
+      self->send_exit(src, caf::exit_reason::user_shutdown);
+    self->send_exit(importer, caf::exit_reason::user_shutdown);
+    run();
+  }
+
+  caf::actor spawn_supervisor(std::vector<std::string> xs, size_t jobs,
+                              bool blocking = false) {
+    auto make_source
+      = [this](const std::string& input) -> caf::expected<caf::actor> {
+      if (input == "bad")
+        return make_error(ec::filesystem_error, "cannot read", input);
+      inputs.push_back(input);
+      sources.push_back(sys.spawn(mock_source));
+      return sources.back();
+    };
+    auto sup = sys.spawn(source_supervisor, std::move(xs),
+                         std::move(make_source), jobs, importer, caf::none,
+                         caf::none, accountant_type{}, blocking);
+    self->monitor(sup);
+    run();
+    return sup;
+  }
+
+  // Terminates a source as if it had read all of its input.
+  void finish(const caf::actor& src) {
+    self->send_exit(src, caf::exit_reason::user_shutdown);
+    run();
+  }
+
+  // Returns the exit reason of the next monitored actor that terminated.
+  caf::error down_reason(const caf::actor& x) {
+    caf::error result;
+    self->receive(
+      [&](const caf::down_msg& msg) {
+        CHECK_EQUAL(msg.source, x.address());
+        result = msg.reason;
+      },
+      caf::after(std::chrono::seconds(0)) >> [] {
+        FAIL("no DOWN message");
+      }
+    );
+    return result;
+  }
+
+  const caf::actor& sink_of(const caf::actor& src) {
+    return deref<mock_source_type>(src).state.sink;
+  }
+
+  caf::actor importer;
+  std::vector<std::string> inputs;
+  std::vector<caf::actor> sources;
+};
+
+} // namespace <anonymous>
+
+FIXTURE_SCOPE(source_supervisor_tests, fixture)
+
+TEST(spawning up to jobs sources) {
+  auto sup = spawn_supervisor({"a", "b", "c", "d"}, 2);
+  CHECK_EQUAL(inputs, (std::vector<std::string>{"a", "b"}));
+  for (auto& src : sources)
+    CHECK_EQUAL(sink_of(src), importer);
+  MESSAGE("a terminating source makes room for the next input");
+  finish(sources[0]);
+  CHECK_EQUAL(inputs, (std::vector<std::string>{"a", "b", "c"}));
+  CHECK_EQUAL(sink_of(sources[2]), importer);
+  finish(sources[1]);
+  finish(sources[2]);
+  CHECK_EQUAL(inputs, (std::vector<std::string>{"a", "b", "c", "d"}));
+  CHECK(self->mailbox().empty());
+  MESSAGE("the supervisor quits after all inputs are read");
+  finish(sources[3]);
+  CHECK_EQUAL(down_reason(sup), caf::none);
+}
+
+TEST(zero jobs) {
+  auto sup = spawn_supervisor({"a", "b"}, 0);
+  CHECK_EQUAL(inputs, std::vector<std::string>{"a"});
+  finish(sources[0]);
+  finish(sources[1]);
+  CHECK_EQUAL(down_reason(sup), caf::none);
+}
+
+TEST(factory error) {
+  MESSAGE("the first sources fail");
+  auto sup = spawn_supervisor({"bad", "a"}, 2);
+  CHECK(inputs.empty());
+  CHECK_EQUAL(down_reason(sup), ec::filesystem_error);
+  MESSAGE("a later source fails");
+  sup = spawn_supervisor({"a", "b", "bad"}, 2);
+  REQUIRE_EQUAL(sources.size(), 2u);
+  self->monitor(sources[1]);
+  finish(sources[0]);
+  CHECK_EQUAL(down_reason(sup), ec::filesystem_error);
+  MESSAGE("the supervisor terminates the running sources");
+  CHECK_EQUAL(down_reason(sources[1]), caf::exit_reason::user_shutdown);
+}
+
+TEST(shutdown) {
+  auto sup = spawn_supervisor({"a", "b"}, 2);
+  REQUIRE_EQUAL(sources.size(), 2u);
+  self->monitor(sources[0]);
+  self->send_exit(sup, caf::exit_reason::user_shutdown);
+  run();
+  CHECK_EQUAL(down_reason(sup), caf::exit_reason::user_shutdown);
+  CHECK_EQUAL(down_reason(sources[0]), caf::exit_reason::user_shutdown);
+}
+
+TEST(blocking) {
+  auto sup = spawn_supervisor({"a"}, 1, true);
+  auto& listeners = deref<mock_importer_type>(importer).state.flush_listeners;
+  finish(sources[0]);
+  MESSAGE("the supervisor waits for the importer to flush");
+  REQUIRE_EQUAL(listeners.size(), 1u);
+  CHECK_EQUAL(listeners[0], sup);
+  CHECK(self->mailbox().empty());
+  self->send(listeners[0], flush_atom::value);
+  run();
+  CHECK_EQUAL(down_reason(sup), caf::none);
+}
+
+FIXTURE_SCOPE_END()
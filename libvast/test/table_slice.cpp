@@ -23,6 +23,8 @@
 #include <caf/test/dsl.hpp>
 
 #include "vast/column_major_matrix_table_slice_builder.hpp"
+#include "vast/columnar_table_slice.hpp"
+#include "vast/columnar_table_slice_builder.hpp"
 #include "vast/default_table_slice.hpp"
 #include "vast/default_table_slice_builder.hpp"
 #include "vast/matrix_table_slice.hpp"
@@ -97,6 +99,7 @@ FIXTURE_SCOPE(table_slice_tests, fixtures::table_slices)
 TEST_TABLE_SLICE(default_table_slice)
 TEST_TABLE_SLICE(row_major_matrix_table_slice)
 TEST_TABLE_SLICE(column_major_matrix_table_slice)
+TEST_TABLE_SLICE(columnar_table_slice)
 TEST_TABLE_SLICE(rebranded_table_slice)
 
 TEST(random integer slices) {
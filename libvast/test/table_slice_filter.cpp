@@ -0,0 +1,169 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE table_slice_filter
+
+#include "vast/table_slice_filter.hpp"
+
+#include "vast/test/test.hpp"
+#include "vast/test/fixtures/events.hpp"
+
+#include <string>
+#include <vector>
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/columnar_table_slice.hpp"
+#include "vast/columnar_table_slice_builder.hpp"
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/event.hpp"
+#include "vast/expression_visitors.hpp"
+#include "vast/ids.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/to_events.hpp"
+
+using namespace vast;
+
+namespace {
+
+std::vector<id> positions(const ids& xs) {
+  std::vector<id> result;
+  for (auto rng = select(xs); rng; rng.next())
+    result.push_back(rng.get());
+  return result;
+}
+
+struct fixture : fixtures::events {
+  // Checks the candidates of every slice with the filter and compares the
+  // result against evaluating the tailored expression event by event.
+  void check(const std::vector<table_slice_ptr>& slices,
+             const std::string& query, const ids& candidates) {
+    MESSAGE("checking " << query);
+    auto expr = to<expression>(query);
+    REQUIRE(expr);
+    for (auto& slice : slices) {
+      auto filter = table_slice_filter::make(*expr, slice->layout());
+      REQUIRE(filter);
+      std::vector<id> expected;
+      for (auto& x : to_events(*slice, candidates))
+        if (caf::visit(event_evaluator{x}, filter->expr()))
+          expected.push_back(x.id());
+      CHECK_EQUAL(positions((*filter)(*slice, candidates)), expected);
+    }
+  }
+
+  // Returns every other ID of a range of slices.
+  static ids every_other(const std::vector<table_slice_ptr>& slices) {
+    ids result;
+    auto last = slices.back()->offset() + slices.back()->rows();
+    for (id i = 0; i < last; ++i)
+      result.append_bit(i % 2 == 0);
+    return result;
+  }
+
+  // Copies a range of slices into columnar table slices.
+  static std::vector<table_slice_ptr>
+  to_columnar(const std::vector<table_slice_ptr>& slices) {
+    std::vector<table_slice_ptr> result;
+    for (auto& slice : slices) {
+      columnar_table_slice_builder builder{slice->layout()};
+      for (size_t row = 0; row < slice->rows(); ++row)
+        for (size_t col = 0; col < slice->columns(); ++col)
+          REQUIRE(builder.add(slice->at(row, col)));
+      auto x = builder.finish();
+      x.unshared().offset(slice->offset());
+      result.push_back(std::move(x));
+    }
+    return result;
+  }
+
+  // Returns all IDs of a range of slices.
+  static ids all_of(const std::vector<table_slice_ptr>& slices) {
+    auto last = slices.back()->offset() + slices.back()->rows();
+    return ids(last, true);
+  }
+};
+
+} // namespace <anonymous>
+
+FIXTURE_SCOPE(table_slice_filter_tests, fixture)
+
+TEST(zeek conn log) {
+  auto queries = std::vector<std::string>{
+    ":addr in 192.168.0.0/16",
+    ":port == 53/udp",
+    ":count > 1000",
+    "service == \"dns\"",
+    "history ni \"D\"",
+    "uid ~ /.*i.*/",
+    "id.orig_h in 192.168.1.0/24 && duration > 3s",
+    "orig_bytes >= 300 || ! :addr == 192.168.1.103",
+    "! (:port == 137/udp || service == \"dns\")",
+    "#type == \"zeek.conn\"",
+    "#type != \"zeek.conn\"",
+    "#time < 2009-11-18+10:00:00",
+    "foo == 42",
+  };
+  for (auto& query : queries) {
+    check(zeek_conn_log_slices, query, all_of(zeek_conn_log_slices));
+    check(zeek_conn_log_slices, query, every_other(zeek_conn_log_slices));
+  }
+}
+
+TEST(zeek http log) {
+  auto queries = std::vector<std::string>{
+    "method == \"GET\" && status_code == 200",
+    ":string ni \"google\"",
+    "host == \"www.google.com\" || response_body_len > 10000",
+  };
+  for (auto& query : queries) {
+    check(zeek_http_log_slices, query, all_of(zeek_http_log_slices));
+    check(zeek_http_log_slices, query, every_other(zeek_http_log_slices));
+  }
+}
+
+TEST(columnar zeek conn log) {
+  // Predicates on arithmetic and time columns scan the packed columns, which
+  // must agree with checking one value at a time, including for nil values.
+  auto slices = to_columnar(zeek_conn_log_slices);
+  REQUIRE_EQUAL(slices[0]->implementation_id(),
+                columnar_table_slice::class_id);
+  auto queries = std::vector<std::string>{
+    ":count > 1000",
+    "orig_bytes == 0",
+    "orig_bytes != 0",
+    "duration >= 3s || resp_bytes < 100",
+    "! (orig_pkts <= 2)",
+    "ts > 2009-11-18+10:00:00 && :addr in 192.168.0.0/16",
+    "#time < 2009-11-18+10:00:00",
+    "#time != 2009-11-18+10:00:00",
+  };
+  for (auto& query : queries) {
+    check(slices, query, all_of(slices));
+    check(slices, query, every_other(slices));
+  }
+}
+
+TEST(candidates outside of the slice) {
+  auto& slice = zeek_conn_log_slices[1];
+  auto filter = table_slice_filter::make(*to<expression>(":count >= 0"),
+                                         slice->layout());
+  REQUIRE(filter);
+  auto result = (*filter)(*slice, ids(slice->offset() + slice->rows() + 10,
+                                      true));
+  CHECK_EQUAL(rank(result), slice->rows());
+  CHECK_EQUAL(select(result, 1), slice->offset());
+  CHECK_EQUAL(select(result, -1), slice->offset() + slice->rows() - 1);
+}
+
+FIXTURE_SCOPE_END()
@@ -16,6 +16,10 @@
 #include "vast/test/test.hpp"
 #include "vast/test/fixtures/events.hpp"
 
+#include <memory>
+#include <random>
+#include <vector>
+
 #include "vast/value_index.hpp"
 #include "vast/value_index_factory.hpp"
 #include "vast/load.hpp"
@@ -251,6 +255,98 @@ TEST(string) {
   CHECK_EQUAL(to_string(unbox(result)), "0100010000");
 }
 
+TEST(hash string) {
+  auto t = string_type{}.attributes({{"index", "hash"}, {"cardinality", "3"}});
+  auto idx = factory<value_index>::make(t);
+  REQUIRE_NOT_EQUAL(idx, nullptr);
+  REQUIRE_NOT_EQUAL(dynamic_cast<hash_index*>(idx.get()), nullptr);
+  MESSAGE("append");
+  REQUIRE(idx->append(make_data_view("foo")));
+  REQUIRE(idx->append(make_data_view("bar")));
+  REQUIRE(idx->append(make_data_view("baz")));
+  REQUIRE(idx->append(make_data_view("foo")));
+  REQUIRE(idx->append(make_data_view(caf::none)));
+  REQUIRE(idx->append(make_data_view("bar")));
+  REQUIRE(idx->append(make_data_view("qux")));
+  REQUIRE(idx->append(make_data_view("foo")));
+  CHECK_EQUAL(static_cast<hash_index&>(*idx).cardinality(), 3u);
+  MESSAGE("lookup values in the dictionary");
+  auto result = idx->lookup(equal, make_data_view("foo"));
+  CHECK_EQUAL(to_string(unbox(result)), "10010001");
+  result = idx->lookup(equal, make_data_view("bar"));
+  CHECK_EQUAL(to_string(unbox(result)), "01000100");
+  result = idx->lookup(not_equal, make_data_view("foo"));
+  CHECK_EQUAL(to_string(unbox(result)), "01100110");
+  result = idx->lookup(equal, make_data_view(caf::none));
+  CHECK_EQUAL(to_string(unbox(result)), "00001000");
+  auto xs = set{"foo", "baz"};
+  result = idx->lookup(in, make_data_view(xs));
+  CHECK_EQUAL(to_string(unbox(result)), "10110001");
+  result = idx->lookup(not_in, make_data_view(xs));
+  CHECK_EQUAL(to_string(unbox(result)), "01000110");
+  MESSAGE("lookup values beyond the dictionary capacity");
+  result = idx->lookup(equal, make_data_view("qux"));
+  CHECK_EQUAL(rank(unbox(result)), 1u);
+  CHECK_EQUAL(to_string(unbox(result)), "00000010");
+  result = idx->lookup(not_equal, make_data_view("qux"));
+  CHECK_EQUAL(to_string(unbox(result)), "11110111");
+  result = idx->lookup(match, make_data_view("foo"));
+  CHECK(!result);
+  MESSAGE("serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(save(nullptr, buf, idx), caf::none);
+  value_index_ptr idx2;
+  CHECK_EQUAL(load(nullptr, buf, idx2), caf::none);
+  REQUIRE_NOT_EQUAL(idx2, nullptr);
+  result = idx2->lookup(equal, make_data_view("foo"));
+  CHECK_EQUAL(to_string(unbox(result)), "10010001");
+  result = idx2->lookup(equal, make_data_view("qux"));
+  CHECK_EQUAL(to_string(unbox(result)), "00000010");
+}
+
+TEST(trigram string) {
+  auto t = string_type{}.attributes({{"index", "trigram"}, {"max_size", "8"}});
+  auto idx = factory<value_index>::make(t);
+  REQUIRE_NOT_EQUAL(idx, nullptr);
+  REQUIRE_NOT_EQUAL(dynamic_cast<trigram_index*>(idx.get()), nullptr);
+  MESSAGE("append");
+  REQUIRE(idx->append(make_data_view("www.example.com")));
+  REQUIRE(idx->append(make_data_view("foo.bar.org")));
+  REQUIRE(idx->append(make_data_view("example.org")));
+  REQUIRE(idx->append(make_data_view("ab")));
+  REQUIRE(idx->append(make_data_view("")));
+  REQUIRE(idx->append(make_data_view("a-very-long-host.net")));
+  auto lookup = [&](relational_operator op, auto x) {
+    return to_string(unbox(idx->lookup(op, make_data_view(x))));
+  };
+  MESSAGE("substring lookups include rows beyond the maximum length");
+  CHECK_EQUAL(lookup(ni, "example"), "101001");
+  CHECK_EQUAL(lookup(ni, "org"), "011001");
+  CHECK_EQUAL(lookup(ni, "xyz"), "000001");
+  CHECK_EQUAL(lookup(ni, "ab"), "111111");
+  CHECK_EQUAL(lookup(not_ni, "org"), "111111");
+  MESSAGE("equality lookups");
+  CHECK_EQUAL(lookup(equal, "ab"), "000100");
+  CHECK_EQUAL(lookup(equal, ""), "000010");
+  CHECK_EQUAL(lookup(equal, "example.org"), "001000");
+  CHECK_EQUAL(lookup(equal, "a-very-long-host.net"), "000001");
+  CHECK_EQUAL(lookup(not_equal, "ab"), "111111");
+  CHECK_EQUAL(lookup(in, set{"ab", ""}), "000110");
+  MESSAGE("pattern lookups");
+  CHECK_EQUAL(lookup(match, pattern{"ex.mple\\.org"}), "001001");
+  CHECK_EQUAL(lookup(match, pattern{"www\\.[a-z]+\\.com"}), "100001");
+  CHECK_EQUAL(lookup(match, pattern{"(foo|bar).*"}), "111111");
+  CHECK_EQUAL(lookup(match, pattern{"fo?o\\.bar"}), "010001");
+  MESSAGE("serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(save(nullptr, buf, idx), caf::none);
+  value_index_ptr idx2;
+  CHECK_EQUAL(load(nullptr, buf, idx2), caf::none);
+  REQUIRE_NOT_EQUAL(idx2, nullptr);
+  auto result = idx2->lookup(ni, make_data_view("example"));
+  CHECK_EQUAL(to_string(unbox(result)), "101001");
+}
+
 TEST(address) {
   address_index idx{address_type{}};
   MESSAGE("append");
@@ -511,6 +607,176 @@ TEST(none values) {
   CHECK_EQUAL(to_string(unbox(bm)), "01100011100001111111100");
 }
 
+TEST(bulk append) {
+  std::mt19937_64 gen{42};
+  // Appends the same values one by one and in bulk, starting at a position
+  // past the end of the index, and compares the results of all lookups.
+  std::vector<relational_operator> all_ops{less, less_equal, equal, not_equal,
+                                           greater_equal, greater};
+  auto check = [&](const type& t, auto make, const std::vector<data>& probes,
+                   const std::vector<relational_operator>& ops) {
+    using value_type = decltype(make());
+    constexpr size_t n = 1000;
+    constexpr id first = 10;
+    auto per_value = factory<value_index>::make(t);
+    auto bulk = factory<value_index>::make(t);
+    REQUIRE_NOT_EQUAL(per_value, nullptr);
+    REQUIRE_NOT_EQUAL(bulk, nullptr);
+    auto xs = std::make_unique<value_type[]>(n);
+    std::vector<uint64_t> validity((n + 63) / 64);
+    for (size_t i = 0; i < n; ++i) {
+      xs[i] = make();
+      if (gen() % 8 == 0) {
+        REQUIRE(per_value->append(make_data_view(caf::none), first + i));
+      } else {
+        validity[i / 64] |= uint64_t{1} << (i % 64);
+        REQUIRE(per_value->append(make_data_view(xs[i]), first + i));
+      }
+    }
+    auto ys = span<const value_type>{xs.get(), static_cast<std::ptrdiff_t>(n)};
+    REQUIRE(bulk->append(ys, span<const uint64_t>{validity}, first));
+    CHECK_EQUAL(bulk->offset(), per_value->offset());
+    for (auto op : ops)
+      for (auto& probe : probes)
+        CHECK_EQUAL(unbox(bulk->lookup(op, make_view(probe))),
+                    unbox(per_value->lookup(op, make_view(probe))));
+    for (auto op : {equal, not_equal})
+      CHECK_EQUAL(unbox(bulk->lookup(op, make_data_view(caf::none))),
+                  unbox(per_value->lookup(op, make_data_view(caf::none))));
+  };
+  MESSAGE("boolean");
+  check(boolean_type{}, [&] { return gen() % 2 == 0; }, {data{true}},
+        {equal, not_equal});
+  MESSAGE("integer");
+  check(integer_type{},
+        [&] { return static_cast<integer>(gen() % 200) - 100; },
+        {data{integer{-100}}, data{integer{0}}, data{integer{42}}}, all_ops);
+  MESSAGE("count");
+  check(count_type{}, [&] { return count{gen() % 100000}; },
+        {data{count{0}}, data{count{4711}}, data{count{99999}}}, all_ops);
+  MESSAGE("timestamp");
+  check(timestamp_type{},
+        [&] { return timestamp{std::chrono::seconds(gen() % 3600)}; },
+        {data{timestamp{}}, data{timestamp{std::chrono::seconds(1800)}}},
+        all_ops);
+  MESSAGE("string falls back to appending value by value");
+  auto idx = factory<value_index>::make(string_type{});
+  REQUIRE_NOT_EQUAL(idx, nullptr);
+  std::vector<count> counts{1, 2, 3};
+  std::vector<uint64_t> validity{0b101};
+  CHECK(!idx->append(span<const count>{counts},
+                     span<const uint64_t>{validity}, 0));
+  CHECK_EQUAL(idx->offset(), 0u);
+  MESSAGE("values of the wrong type leave the index unchanged");
+  auto ints = factory<value_index>::make(integer_type{});
+  REQUIRE_NOT_EQUAL(ints, nullptr);
+  REQUIRE(ints->append(make_data_view(integer{42}), 0));
+  CHECK(!ints->append(span<const count>{counts},
+                      span<const uint64_t>{validity}, 1));
+  CHECK_EQUAL(ints->offset(), 1u);
+  CHECK_EQUAL(unbox(ints->lookup(equal, make_data_view(integer{42}))),
+              make_ids({0}));
+  CHECK_EQUAL(rank(unbox(ints->lookup(equal, make_data_view(caf::none)))),
+              0u);
+}
+
+TEST(merge) {
+  std::mt19937_64 gen{42};
+  // Appends the same values to one index directly and to two indexes split
+  // at a gap, whose second half uses relative positions. Merging the second
+  // index into the first must yield the same lookup results.
+  auto check = [&](const type& t, auto make, const std::vector<data>& probes,
+                   const std::vector<relational_operator>& ops) {
+    constexpr size_t n = 500;
+    constexpr size_t split = 200;
+    constexpr id gap = 10;
+    constexpr id first = split + gap / 2;
+    auto whole = factory<value_index>::make(t);
+    auto merged = factory<value_index>::make(t);
+    auto delta = factory<value_index>::make(t);
+    REQUIRE_NOT_EQUAL(whole, nullptr);
+    REQUIRE_NOT_EQUAL(merged, nullptr);
+    REQUIRE_NOT_EQUAL(delta, nullptr);
+    REQUIRE(merged->mergeable());
+    for (size_t i = 0; i < n; ++i) {
+      if (gen() % 16 == 0)
+        continue;
+      auto x = gen() % 8 == 0 ? data{} : make();
+      auto pos = i < split ? i : i + gap;
+      REQUIRE(whole->append(make_view(x), pos));
+      if (i < split)
+        REQUIRE(merged->append(make_view(x), pos));
+      else
+        REQUIRE(delta->append(make_view(x), pos - first));
+    }
+    REQUIRE(merged->merge(*delta, first));
+    CHECK_EQUAL(merged->offset(), whole->offset());
+    for (auto op : ops)
+      for (auto& probe : probes)
+        CHECK_EQUAL(unbox(merged->lookup(op, make_view(probe))),
+                    unbox(whole->lookup(op, make_view(probe))));
+    for (auto op : {equal, not_equal})
+      CHECK_EQUAL(unbox(merged->lookup(op, make_data_view(caf::none))),
+                  unbox(whole->lookup(op, make_data_view(caf::none))));
+  };
+  std::vector<std::string> strings{"", "foo", "bar", "foobar", "quux"};
+  auto pick_string = [&] { return data{strings[gen() % strings.size()]}; };
+  MESSAGE("boolean");
+  check(boolean_type{}, [&] { return data{gen() % 2 == 0}; }, {data{true}},
+        {equal, not_equal});
+  MESSAGE("integer");
+  check(integer_type{},
+        [&] { return data{static_cast<integer>(gen() % 200) - 100}; },
+        {data{integer{-100}}, data{integer{0}}, data{integer{42}}},
+        {less, less_equal, equal, not_equal, greater_equal, greater});
+  MESSAGE("string");
+  check(string_type{}, pick_string, {data{"foo"}, data{"foobar"}, data{""}},
+        {equal, not_equal});
+  MESSAGE("trigram string");
+  check(string_type{}.attributes({{"index", "trigram"}}), pick_string,
+        {data{"foo"}, data{"oba"}, data{"quux"}}, {equal, not_equal, ni});
+  MESSAGE("address");
+  auto addr = [&] {
+    return data{unbox(to<address>("10.0.0." + std::to_string(gen() % 4)))};
+  };
+  check(address_type{}, addr, {data{unbox(to<address>("10.0.0.1"))}},
+        {equal, not_equal});
+  check(address_type{}, addr, {data{unbox(to<subnet>("10.0.0.0/31"))}},
+        {in, not_in});
+  MESSAGE("subnet");
+  auto sn = [&] {
+    return data{unbox(to<subnet>("10.0." + std::to_string(gen() % 4)
+                                 + ".0/24"))};
+  };
+  check(subnet_type{}, sn, {data{unbox(to<subnet>("10.0.1.0/24"))}},
+        {equal, not_equal});
+  MESSAGE("port");
+  check(port_type{},
+        [&] {
+          return data{port{static_cast<port::number_type>(gen() % 100),
+                           gen() % 2 == 0 ? port::tcp : port::udp}};
+        },
+        {data{port{42, port::tcp}}, data{port{50, port::unknown}}},
+        {equal, not_equal, less, greater_equal});
+  MESSAGE("vector");
+  check(vector_type{count_type{}},
+        [&] {
+          vector xs;
+          for (auto i = gen() % 4; i > 0; --i)
+            xs.emplace_back(count{gen() % 8});
+          return data{std::move(xs)};
+        },
+        {data{count{1}}, data{count{7}}}, {ni, not_ni});
+  MESSAGE("hash indexes do not support merging");
+  auto hash = factory<value_index>::make(
+    string_type{}.attributes({{"index", "hash"}}));
+  REQUIRE_NOT_EQUAL(hash, nullptr);
+  CHECK(!hash->mergeable());
+  CHECK(!hash->merge(*factory<value_index>::make(
+                       string_type{}.attributes({{"index", "hash"}})),
+                     0));
+}
+
 namespace {
 
 auto orig_h(const event& x) {
@@ -0,0 +1,62 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <limits>
+#include <type_traits>
+#include <typeinfo>
+
+#include "vast/min_max_synopsis.hpp"
+#include "vast/synopsis.hpp"
+#include "vast/time.hpp"
+
+namespace vast {
+
+/// A min-max synopsis for arithmetic types and time spans.
+template <class T>
+class arithmetic_synopsis final : public min_max_synopsis<T> {
+public:
+  using super = min_max_synopsis<T>;
+
+  /// Constructs an empty synopsis whose range contains no values.
+  arithmetic_synopsis(vast::type x)
+    : super{std::move(x), upper_bound(), lower_bound()} {
+    // nop
+  }
+
+  bool equals(const synopsis& other) const noexcept override {
+    if (typeid(other) != typeid(arithmetic_synopsis))
+      return false;
+    auto& dref = static_cast<const arithmetic_synopsis&>(other);
+    return this->type() == dref.type() && this->min() == dref.min()
+           && this->max() == dref.max();
+  }
+
+private:
+  static T upper_bound() {
+    if constexpr (std::is_same_v<T, timespan>)
+      return timespan::max();
+    else
+      return std::numeric_limits<T>::max();
+  }
+
+  static T lower_bound() {
+    if constexpr (std::is_same_v<T, timespan>)
+      return timespan::min();
+    else
+      return std::numeric_limits<T>::lowest();
+  }
+};
+
+} // namespace vast
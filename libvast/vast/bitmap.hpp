@@ -13,12 +13,16 @@
 
 #pragma once
 
+#include <vector>
+
 #include <caf/variant.hpp>
 #include <caf/detail/type_list.hpp>
 
 #include "vast/bitmap_base.hpp"
+#include "vast/config.hpp"
 #include "vast/ewah_bitmap.hpp"
 #include "vast/null_bitmap.hpp"
+#include "vast/roaring_bitmap.hpp"
 #include "vast/wah_bitmap.hpp"
 
 #include "vast/detail/operators.hpp"
@@ -37,13 +41,19 @@ public:
   using types = caf::detail::type_list<
     ewah_bitmap,
     null_bitmap,
-    wah_bitmap
+    wah_bitmap,
+    roaring_bitmap
   >;
 
   using variant = caf::detail::tl_apply_t<types, caf::variant>;
 
-  /// The concrete bitmap type to be used for default construction.
+  /// The concrete bitmap type to be used for default construction. Building
+  /// with `--enable-roaring` selects ::roaring_bitmap instead of EWAH.
+#ifdef VAST_USE_ROARING
+  using default_bitmap = roaring_bitmap;
+#else
   using default_bitmap = ewah_bitmap;
+#endif
 
   /// Default-constructs a bitmap of type ::default_bitmap.
   bitmap();
@@ -109,7 +119,8 @@ private:
   using range_variant = caf::variant<
     ewah_bitmap_range,
     null_bitmap_range,
-    wah_bitmap_range
+    wah_bitmap_range,
+    roaring_bitmap_range
   >;
 
   range_variant range_;
@@ -117,6 +128,31 @@ private:
 
 bitmap_bit_range bit_range(const bitmap& bm);
 
+// The following overloads use the specialized algorithms of a concrete bitmap
+// type when both operands hold the same type and fall back to the generic
+// algorithms otherwise.
+
+/// @relates bitmap
+bitmap binary_and(const bitmap& lhs, const bitmap& rhs);
+
+/// @relates bitmap
+bitmap binary_or(const bitmap& lhs, const bitmap& rhs);
+
+/// @relates bitmap
+bitmap binary_xor(const bitmap& lhs, const bitmap& rhs);
+
+/// @relates bitmap
+bitmap binary_nand(const bitmap& lhs, const bitmap& rhs);
+
+/// @relates bitmap
+bitmap nary_and(const std::vector<const bitmap*>& xs);
+
+/// @relates bitmap
+bitmap nary_or(const std::vector<const bitmap*>& xs);
+
+/// @relates bitmap
+bitmap nary_xor(const std::vector<const bitmap*>& xs);
+
 } // namespace vast
 
 namespace caf {
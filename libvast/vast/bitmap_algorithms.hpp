@@ -17,6 +17,7 @@
 #include <iterator>
 #include <queue>
 #include <type_traits>
+#include <vector>
 
 #include <caf/error.hpp>
 
@@ -41,6 +42,26 @@ struct eval_result_type {
 template <class T, class U>
 using eval_result_type_t = typename eval_result_type<T, U>::type;
 
+/// Checks whether a bitmap type provides multi-way kernels via overloads of
+/// `nary_and`, `nary_or`, and `nary_xor` that take a vector of pointers.
+template <class Bitmap, class = void>
+struct has_nary_kernel : std::false_type {};
+
+template <class Bitmap>
+struct has_nary_kernel<
+  Bitmap,
+  std::void_t<decltype(
+    nary_and(std::declval<const std::vector<const Bitmap*>&>()))>
+> : std::true_type {};
+
+template <class Iterator>
+auto make_pointers(Iterator begin, Iterator end) {
+  std::vector<const std::decay_t<decltype(*begin)>*> result;
+  for (; begin != end; ++begin)
+    result.push_back(&*begin);
+  return result;
+}
+
 } // namespace detail
 
 /// Applies a bitwise operation on two immutable bitmaps, writing the result
@@ -212,20 +233,35 @@ auto binary_nor(const LHS& lhs, const RHS& rhs) {
 
 template <class Iterator>
 auto nary_and(Iterator begin, Iterator end) {
-  auto op = [](auto x, auto y) { return x & y; };
-  return nary_eval(begin, end, op);
+  using bitmap_type = std::decay_t<decltype(*begin)>;
+  if constexpr (detail::has_nary_kernel<bitmap_type>::value) {
+    return nary_and(detail::make_pointers(begin, end));
+  } else {
+    auto op = [](auto x, auto y) { return x & y; };
+    return nary_eval(begin, end, op);
+  }
 }
 
 template <class Iterator>
 auto nary_or(Iterator begin, Iterator end) {
-  auto op = [](auto x, auto y) { return x | y; };
-  return nary_eval(begin, end, op);
+  using bitmap_type = std::decay_t<decltype(*begin)>;
+  if constexpr (detail::has_nary_kernel<bitmap_type>::value) {
+    return nary_or(detail::make_pointers(begin, end));
+  } else {
+    auto op = [](auto x, auto y) { return x | y; };
+    return nary_eval(begin, end, op);
+  }
 }
 
 template <class Iterator>
 auto nary_xor(Iterator begin, Iterator end) {
-  auto op = [](auto x, auto y) { return x ^ y; };
-  return nary_eval(begin, end, op);
+  using bitmap_type = std::decay_t<decltype(*begin)>;
+  if constexpr (detail::has_nary_kernel<bitmap_type>::value) {
+    return nary_xor(detail::make_pointers(begin, end));
+  } else {
+    auto op = [](auto x, auto y) { return x ^ y; };
+    return nary_eval(begin, end, op);
+  }
 }
 
 /// Computes the *rank* of a Bitmap, i.e., the number of occurrences of a bit
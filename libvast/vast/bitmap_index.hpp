@@ -13,11 +13,14 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <type_traits>
 
 #include "vast/base.hpp"
 #include "vast/binner.hpp"
 #include "vast/coder.hpp"
+#include "vast/detail/assert.hpp"
 #include "vast/detail/order.hpp"
 
 namespace vast {
@@ -68,6 +71,21 @@ public:
     coder_.encode(transform(binner_type::bin(x)), n);
   }
 
+  /// Appends a block of up to 64 consecutive values at once.
+  /// @param xs The values to append.
+  /// @param n The number of values in *xs*.
+  /// @param mask Has the *i*-th bit set iff *xs[i]* holds a value. All other
+  ///             positions count as skipped.
+  /// @pre `n <= 64`
+  void append_block(const value_type* xs, size_type n, uint64_t mask) {
+    VAST_ASSERT(n <= 64);
+    std::array<typename coder_type::value_type, 64> ys{};
+    for (size_type i = 0; i < n; ++i)
+      if ((mask >> i) & 1)
+        ys[i] = transform(binner_type::bin(xs[i]));
+    coder_.encode_block(ys.data(), n, mask);
+  }
+
   /// Appends the contents of another bitmap index to this one.
   /// @param other The other bitmap index.
   void append(const bitmap_index& other) {
@@ -0,0 +1,79 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <caf/optional.hpp>
+
+#include "vast/synopsis.hpp"
+
+namespace vast {
+
+/// A synopsis that tracks set membership with a Bloom filter. It answers
+/// equality and membership queries for addresses, strings, ports, and
+/// subnets. For addresses, the filter additionally contains the network
+/// prefixes at the /8, /16, and /24 boundaries for IPv4 and the /32, /48, and
+/// /64 boundaries for IPv6, which enables pruning subnet containment queries
+/// for these prefix lengths.
+///
+/// The filter derives its dimensions from the synopsis options
+/// `bloom-filter-capacity` (falling back to a default capacity, capped at
+/// `max-partition-size`) and
+/// `bloom-filter-fp-rate`. Since deserialization does not have access to the
+/// original options, the dimensions are part of the serialized state.
+class bloom_filter_synopsis final : public synopsis {
+public:
+  bloom_filter_synopsis(vast::type x, const synopsis_options& opts);
+
+  void add(data_view x) override;
+
+  caf::optional<bool> lookup(relational_operator op,
+                             data_view rhs) const override;
+
+  bool equals(const synopsis& other) const noexcept override;
+
+  caf::error serialize(caf::serializer& sink) const override;
+
+  caf::error deserialize(caf::deserializer& source) override;
+
+  /// @returns the number of bits in the filter.
+  uint64_t num_bits() const noexcept {
+    return num_bits_;
+  }
+
+  /// @returns the number of hash functions per element.
+  uint64_t num_hashes() const noexcept {
+    return num_hashes_;
+  }
+
+private:
+  void insert(uint64_t digest);
+
+  bool contains(uint64_t digest) const;
+
+  /// Tests whether the filter may contain `x`, or returns `none` if the
+  /// filter cannot answer the question.
+  caf::optional<bool> contains(data_view x) const;
+
+  uint64_t num_bits_;
+  uint64_t num_hashes_;
+
+  /// The bit array. We allocate lazily to avoid wasting memory for
+  /// synopses that never see a value, e.g., during deserialization.
+  std::vector<uint64_t> bits_;
+};
+
+} // namespace vast
@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <limits>
 #include <vector>
 #include <type_traits>
@@ -26,6 +27,7 @@
 #include "vast/operator.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/detail/operators.hpp"
+#include "vast/word.hpp"
 
 namespace vast {
 
@@ -60,6 +62,17 @@ struct coder {
   /// @pre `Bitmap::max_size - size() >= n`
   void encode(value_type x, size_type n = 1);
 
+  /// Encodes a block of up to 64 consecutive values at once. Instead of
+  /// appending bit by bit, the coder transposes the block into one word per
+  /// bitmap and appends each word as a whole.
+  /// @param xs The values to encode.
+  /// @param n The number of values in *xs*.
+  /// @param mask Has the *i*-th bit set iff *xs[i]* holds a value. The coder
+  ///             treats all other positions as skipped and ignores their
+  ///             values.
+  /// @pre `n <= 64 && Bitmap::max_size - size() >= n`
+  void encode_block(const value_type* xs, size_type n, uint64_t mask);
+
   /// Decodes a value under a relational operator.
   /// @param x The value to decode.
   /// @param op The relation operator under which to decode *x*.
@@ -112,6 +125,15 @@ public:
     bitmap_.append_bits(x, n);
   }
 
+  void encode_block(const value_type* xs, size_type n, uint64_t mask) {
+    VAST_ASSERT(n <= 64);
+    VAST_ASSERT(Bitmap::max_size - size() >= n);
+    uint64_t word = 0;
+    for (size_type i = 0; i < n; ++i)
+      word |= uint64_t{xs[i]} << i;
+    bitmap_.append_block(word & mask, n);
+  }
+
   Bitmap decode(relational_operator op, value_type x) const {
     VAST_ASSERT(op == equal || op == not_equal);
     auto result = bitmap_;
@@ -196,8 +218,25 @@ protected:
     size_ += other.size_;
   }
 
+  /// Transposes the valid values of a block into one word per value, i.e.,
+  /// the *j*-th bit of `words_[x]` is set iff `xs[j] == x`.
+  void transpose(const value_type* xs, size_type n, uint64_t mask,
+                 size_t cardinality) {
+    VAST_ASSERT(n <= 64);
+    VAST_ASSERT(Bitmap::max_size - size_ >= n);
+    words_.assign(cardinality, 0);
+    for (size_type i = 0; i < n; ++i)
+      if ((mask >> i) & 1) {
+        VAST_ASSERT(xs[i] < cardinality);
+        words_[xs[i]] |= uint64_t{1} << i;
+      }
+  }
+
   size_type size_;
   mutable std::vector<Bitmap> bitmaps_;
+
+  /// Scratch space for block-wise encoding, not part of the coder state.
+  std::vector<uint64_t> words_;
 };
 
 /// Encodes each value in its own bitmap.
@@ -233,6 +272,16 @@ public:
     this->size_ += n;
   }
 
+  void encode_block(const value_type* xs, size_type n, uint64_t mask) {
+    this->transpose(xs, n, mask, this->bitmaps_.size());
+    // Bitmaps without a 1-bit in this block stay behind and get filled
+    // lazily, just like with encode().
+    for (size_t i = 0; i < this->words_.size(); ++i)
+      if (this->words_[i] != 0)
+        bitmap_at(i).append_block(this->words_[i], n);
+    this->size_ += n;
+  }
+
   Bitmap decode(relational_operator op, value_type x) const {
     VAST_ASSERT(op == less || op == less_equal || op == equal || op == not_equal
                 || op == greater_equal || op == greater);
@@ -325,6 +374,21 @@ public:
     this->size_ += n;
   }
 
+  void encode_block(const value_type* xs, size_type n, uint64_t mask) {
+    auto& words = this->words_;
+    this->transpose(xs, n, mask, this->bitmaps_.size() + 1);
+    // Bitmap i has a 0-bit for all values greater than i. Accumulating the
+    // words from the back yields these values. Bitmaps without a 0-bit in
+    // this block stay behind and get filled lazily.
+    uint64_t zeros = 0;
+    for (auto i = this->bitmaps_.size(); i > 0; --i) {
+      zeros |= words[i];
+      if (zeros != 0)
+        bitmap_at(i - 1).append_block(~zeros, n);
+    }
+    this->size_ += n;
+  }
+
   Bitmap decode(relational_operator op, value_type x) const {
     VAST_ASSERT(op == less || op == less_equal || op == equal || op == not_equal
                 || op == greater_equal || op == greater);
@@ -407,6 +471,23 @@ public:
     this->size_ += n;
   }
 
+  void encode_block(const value_type* xs, size_type n, uint64_t mask) {
+    VAST_ASSERT(n <= 64);
+    VAST_ASSERT(Bitmap::max_size - this->size_ >= n);
+    auto& words = this->words_;
+    words.assign(this->bitmaps_.size(), 0);
+    for (size_type j = 0; j < n; ++j)
+      if ((mask >> j) & 1) {
+        auto x = ~xs[j];
+        for (auto i = 0u; i < words.size(); ++i)
+          words[i] |= uint64_t{(x >> i) & 1} << j;
+      }
+    for (auto i = 0u; i < words.size(); ++i)
+      if (words[i] != 0)
+        bitmap_at(i).append_block(words[i], n);
+    this->size_ += n;
+  }
+
   // RangeEval-Opt for the special case with uniform base 2.
   Bitmap decode(relational_operator op, value_type x) const {
     switch (op) {
@@ -523,6 +604,38 @@ public:
       coders_[i].encode(xs_[i], n);
   }
 
+  void encode_block(const value_type* xs, size_type n, uint64_t mask) {
+    VAST_ASSERT(n <= 64);
+    if (xs_.empty())
+      init();
+    // Decompose all values first and store the digits of each component
+    // contiguously, such that every coder receives a block of its own. Most
+    // values have fewer digits than the base has components, so we stop as
+    // soon as the remaining digits are all 0. Uniform bases typically use
+    // powers of two, for which shifts replace the costly divisions.
+    block_.assign(base_.size() * 64, 0);
+    for (size_type j = 0; j < n; ++j) {
+      if (((mask >> j) & 1) == 0)
+        continue;
+      uint64_t x = xs[j];
+      auto digit = block_.begin() + j;
+      for (auto b : base_) {
+        if (x == 0)
+          break;
+        if ((b & (b - 1)) == 0) {
+          *digit = x & (b - 1);
+          x >>= word<uint64_t>::count_trailing_zeros(b);
+        } else {
+          *digit = x % b;
+          x /= b;
+        }
+        digit += 64;
+      }
+    }
+    for (auto i = 0u; i < base_.size(); ++i)
+      coders_[i].encode_block(block_.data() + i * 64, n, mask);
+  }
+
   auto decode(relational_operator op, value_type x) const {
     return coders_.empty() ? bitmap_type{} : decode(coders_, op, x);
   }
@@ -665,6 +778,9 @@ private:
   base base_;
   mutable std::vector<value_type> xs_;
   std::vector<coder_type> coders_;
+
+  /// Scratch space for block-wise encoding, not part of the coder state.
+  std::vector<value_type> block_;
 };
 
 template <class T>
@@ -19,6 +19,7 @@
 #include <caf/fwd.hpp>
 
 #include "vast/bitmap.hpp"
+#include "vast/chunk.hpp"
 #include "vast/event.hpp"
 #include "vast/expression.hpp"
 #include "vast/filesystem.hpp"
@@ -36,6 +37,14 @@ caf::expected<column_index_ptr> make_column_index(caf::actor_system& sys,
                                                   type column_type,
                                                   size_t column);
 
+/// Merges the delta segments that incremental flushes appended next to a
+/// persisted column index into a single file, e.g., when sealing the
+/// partition. Does nothing if there are no delta segments.
+/// @param filename The file name of the column index.
+/// @returns An error if I/O operations fail.
+/// @relates column_index
+caf::error compact_column_index(const path& filename);
+
 // -- class definition ---------------------------------------------------------
 
 /// Indexes a specific aspect of an event, such as meta data (e.g., timestamp)
@@ -47,16 +56,25 @@ public:
   column_index(caf::actor_system& sys, type index_type, path filename,
                size_t column);
 
+  /// Constructs a read-only column index from serialized state.
+  /// @param state The serialized index or `nullptr` for an empty index.
+  column_index(caf::actor_system& sys, type index_type, chunk_ptr state,
+               size_t column);
+
   ~column_index();
 
   // -- persistence ------------------------------------------------------------
 
-  /// Materializes the index from disk if `filename()` exists, constructs a new
-  /// one otherwise. Automatically called by the factory functions.
+  /// Materializes the index from the serialized state or from disk if
+  /// `filename()` exists, constructs a new one otherwise. Automatically called
+  /// by the factory functions.
   /// @returns An error if I/O operations fail.
   caf::error init();
 
-  /// Persists the index to disk.
+  /// Persists the index to disk. If the value index supports merging, this
+  /// only appends the rows since the last flush as a compressed delta segment
+  /// to the file `filename() + ".delta"`, and rewrites the whole index
+  /// otherwise.
   caf::error flush_to_disk();
 
   // -- properties -------------------------------------------------------------
@@ -85,7 +103,7 @@ public:
     return index_type_;
   }
 
-  /// @returns the value index.
+  /// @returns the value index for all rows up to the last flush.
   /// @pre `init()` was called and did not return an error.
   const value_index& idx() const {
     VAST_ASSERT(idx_ != nullptr);
@@ -109,10 +127,20 @@ protected:
   // -- member variables -------------------------------------------------------
 
   value_index_ptr idx_;
+
+  /// Holds the rows since the last flush with positions relative to
+  /// `last_flush_`, or `nullptr` if the value index does not support merging.
+  value_index_ptr delta_;
+
   size_t col_;
   bool has_skip_attribute_;
   type index_type_;
   path filename_;
+  chunk_ptr state_;
+
+  /// Whether this index came from serialized state and has no file.
+  bool read_only_ = false;
+
   value_index::size_type last_flush_ = 0;
   caf::actor_system& sys_;
 };
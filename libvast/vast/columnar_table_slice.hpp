@@ -0,0 +1,221 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <caf/atom.hpp>
+
+#include "vast/aliases.hpp"
+#include "vast/chunk.hpp"
+#include "vast/data.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/fwd.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/word.hpp"
+
+namespace vast {
+
+/// A table slice that stores each column in a packed, typed buffer. Values of
+/// fixed-width types reside back-to-back, strings use an array of end offsets
+/// into a byte arena, and a separate bitmap tracks which cells hold a value.
+/// All buffers live in a single payload chunk that the slice can read in
+/// place, e.g., directly out of a memory-mapped segment. Types without a
+/// packed representation fall back to one `data` value per row.
+///
+/// The payload begins with a table of contents, followed by the buffers. All
+/// integers in the payload are 64-bit and in host byte order:
+///
+///     +-------------+----------------------------+-----+-------------+
+///     | num columns | validity | values | offsets | ... |   buffers   |
+///     +-------------+----------------------------+-----+-------------+
+///                   '---------- column 0 --------'
+///
+class columnar_table_slice final : public table_slice {
+public:
+  // -- friends ----------------------------------------------------------------
+
+  friend class columnar_table_slice_builder;
+
+  // -- constants --------------------------------------------------------------
+
+  static constexpr caf::atom_value class_id = caf::atom("columnar");
+
+  // -- member types -----------------------------------------------------------
+
+  /// Base type.
+  using super = table_slice;
+
+  /// The physical representation of a column.
+  enum class column_kind : uint8_t {
+    boolean,
+    integer,
+    count,
+    real,
+    timespan,
+    timestamp,
+    port,
+    address,
+    string,
+    generic,
+  };
+
+  /// The location of the buffers of a single column as byte offsets from the
+  /// beginning of the payload.
+  struct column {
+    /// The physical representation, derived from the layout.
+    column_kind kind = column_kind::generic;
+
+    /// One bit per row, set if the row holds a value and cleared for nil.
+    uint64_t validity = 0;
+
+    /// Packed values of fixed-width columns or the arena of string columns.
+    uint64_t values = 0;
+
+    /// End offsets into the arena for each row of a string column.
+    uint64_t offsets = 0;
+  };
+
+  // -- static factory functions -----------------------------------------------
+
+  static table_slice_ptr make(table_slice_header header);
+
+  // -- factory functions ------------------------------------------------------
+
+  columnar_table_slice* copy() const final;
+
+  // -- persistence ------------------------------------------------------------
+
+  caf::error serialize(caf::serializer& sink) const final;
+
+  caf::error deserialize(caf::deserializer& source) final;
+
+  /// Uses the payload in `chunk` in place and only decodes generic columns.
+  caf::error load(chunk_ptr chunk) final;
+
+  // -- visitation -------------------------------------------------------------
+
+  using table_slice::append_column_to_index;
+
+  /// Applies all values in column `col` to `idx`.
+  void append_column_to_index(size_type col, value_index& idx,
+                              id first) const final;
+
+  // -- properties -------------------------------------------------------------
+
+  data_view at(size_type row, size_type col) const final;
+
+  caf::atom_value implementation_id() const noexcept override;
+
+  /// Applies `f` to every value of a fixed-width column in a single pass,
+  /// skipping nil cells. Blocks of 64 rows without nil values run without
+  /// any per-row branches.
+  /// @param col The column to process.
+  /// @param f The function to apply to each value of type `T`, either as
+  ///          `f(value)` or as `f(row, value)` in ascending row order.
+  /// @returns `false` if column `col` does not have the physical
+  ///          representation of `T`.
+  template <class T, class F>
+  bool for_each_value(size_type col, F f) const;
+
+  /// @returns the chunk holding all packed columns.
+  const chunk_ptr& payload() const noexcept {
+    return payload_;
+  }
+
+  // -- utility functions ------------------------------------------------------
+
+  /// @returns the physical representation for values of type `t`.
+  static column_kind kind_of(const type& t);
+
+  /// @returns the physical representation for values of C++ type `T`.
+  template <class T>
+  static constexpr column_kind kind_of() noexcept {
+    if constexpr (std::is_same_v<T, boolean>)
+      return column_kind::boolean;
+    else if constexpr (std::is_same_v<T, integer>)
+      return column_kind::integer;
+    else if constexpr (std::is_same_v<T, count>)
+      return column_kind::count;
+    else if constexpr (std::is_same_v<T, real>)
+      return column_kind::real;
+    else if constexpr (std::is_same_v<T, timespan>)
+      return column_kind::timespan;
+    else if constexpr (std::is_same_v<T, timestamp>)
+      return column_kind::timestamp;
+    else if constexpr (std::is_same_v<T, port>)
+      return column_kind::port;
+    else
+      return column_kind::generic;
+  }
+
+  /// @returns the number of bytes per value for fixed-width column kinds and
+  ///          0 for `string` and `generic`.
+  static size_t width_of(column_kind kind) noexcept;
+
+private:
+  explicit columnar_table_slice(table_slice_header header);
+
+  /// Locates all column buffers in `payload` and takes ownership of it.
+  caf::error init(chunk_ptr payload);
+
+  std::vector<column> columns_;
+  chunk_ptr payload_;
+  std::vector<std::vector<data>> generic_;
+};
+
+template <class T, class F>
+bool columnar_table_slice::for_each_value(size_type col, F f) const {
+  static_assert(std::is_trivially_copyable_v<T>);
+  VAST_ASSERT(col < columns());
+  auto& c = columns_[col];
+  if (kind_of<T>() == column_kind::generic || c.kind != kind_of<T>())
+    return false;
+  // The payload may reside at an arbitrary address, e.g., in a memory-mapped
+  // segment, so we read all values with memcpy to avoid unaligned access.
+  auto validity = payload_->data() + c.validity;
+  auto values = payload_->data() + c.values;
+  auto apply = [&](size_type row) {
+    T x;
+    std::memcpy(&x, values + row * sizeof(T), sizeof(T));
+    if constexpr (std::is_invocable_v<F, size_type, T>)
+      f(row, x);
+    else
+      f(x);
+  };
+  auto n = rows();
+  for (size_type first = 0; first < n; first += 64) {
+    uint64_t bits;
+    std::memcpy(&bits, validity + first / 64 * sizeof(uint64_t),
+                sizeof(uint64_t));
+    auto last = std::min(first + 64, n);
+    if (bits == ~uint64_t{0}) {
+      for (auto row = first; row < last; ++row)
+        apply(row);
+    } else {
+      for (; bits != 0; bits &= bits - 1)
+        apply(first + word<uint64_t>::count_trailing_zeros(bits));
+    }
+  }
+  return true;
+}
+
+/// @relates columnar_table_slice
+using columnar_table_slice_ptr = caf::intrusive_cow_ptr<columnar_table_slice>;
+
+} // namespace vast
@@ -0,0 +1,80 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "vast/columnar_table_slice.hpp"
+#include "vast/data.hpp"
+#include "vast/table_slice_builder.hpp"
+
+namespace vast {
+
+/// A builder that fills the typed column buffers of a `columnar_table_slice`.
+class columnar_table_slice_builder : public table_slice_builder {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using super = table_slice_builder;
+
+  // -- class properties -------------------------------------------------------
+
+  static caf::atom_value get_implementation_id() noexcept;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  columnar_table_slice_builder(record_type layout);
+
+  // -- factory functions ------------------------------------------------------
+
+  static table_slice_builder_ptr make(record_type layout);
+
+  // -- properties -------------------------------------------------------------
+
+  bool add(data_view x) override;
+
+  table_slice_ptr finish() override;
+
+  size_t rows() const noexcept override;
+
+  void reserve(size_t num_rows) override;
+
+  caf::atom_value implementation_id() const noexcept override;
+
+private:
+  // -- member types -----------------------------------------------------------
+
+  /// Accumulates the values of a single column until `finish` packs them.
+  struct column_buffer {
+    std::vector<uint64_t> validity;
+    std::vector<char> bytes;
+    std::vector<uint64_t> offsets;
+    std::vector<data> values;
+  };
+
+  // -- utility functions ------------------------------------------------------
+
+  /// Appends `x` to the current column without type checking.
+  void append(data_view x);
+
+  // -- member variables -------------------------------------------------------
+
+  std::vector<columnar_table_slice::column_kind> kinds_;
+  std::vector<column_buffer> columns_;
+  size_t col_;
+  size_t rows_;
+};
+
+} // namespace vast
@@ -15,6 +15,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <vector>
 
 #include "vast/config.hpp"
 
@@ -65,5 +66,27 @@ bool uncompress(const char* in, size_t in_size, char* out);
 } // namespace snappy
 #endif // VAST_SNAPPY
 
+/// Compresses a contiguous byte sequence and appends the result to `out`.
+/// Falls back to copying the input verbatim if compression does not shrink
+/// the input.
+/// @param method The compression algorithm to use.
+/// @param in The beginning of the input.
+/// @param in_size The number of bytes to compress.
+/// @param out The buffer to append the output to.
+/// @returns the algorithm that was applied, i.e., either *method* or
+///          `compression::null`.
+compression compress(compression method, const char* in, size_t in_size,
+                     std::vector<char>& out);
+
+/// Uncompresses a contiguous byte sequence of known uncompressed size.
+/// @param method The compression algorithm that produced the input.
+/// @param in The beginning of the input.
+/// @param in_size The number of compressed bytes.
+/// @param out The buffer to write the uncompressed bytes into.
+/// @param out_size The number of uncompressed bytes.
+/// @returns `true` iff uncompressing yielded exactly *out_size* bytes.
+bool uncompress(compression method, const char* in, size_t in_size, char* out,
+                size_t out_size);
+
 } // namespace vast
 
@@ -0,0 +1,54 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <string_view>
+#include <type_traits>
+
+#include "vast/concept/printable/core/printer.hpp"
+#include "vast/concept/printable/vast/data.hpp"
+#include "vast/detail/type_traits.hpp"
+#include "vast/view.hpp"
+
+namespace vast {
+
+/// Prints a data view in the same format as the ::data_printer, without
+/// materializing basic values first.
+struct data_view_printer : printer<data_view_printer> {
+  using attribute = data_view;
+
+  template <class Iterator>
+  bool print(Iterator& out, const data_view& x) const {
+    return caf::visit(detail::overload(
+      [&](const auto& y) {
+        using view_type = std::decay_t<decltype(y)>;
+        if constexpr (detail::is_any_v<view_type, view<pattern>, view<vector>,
+                                       view<set>, view<map>>)
+          return data_printer{}.print(out, materialize(x));
+        else
+          return make_printer<view_type>{}(out, y);
+      },
+      [&](integer y) {
+        return printers::integral<integer, policy::force_sign>(out, y);
+      },
+      [&](std::string_view y) {
+        static auto escaper = detail::make_extra_print_escaper("\"");
+        static auto p = '"' << printers::escape(escaper) << '"';
+        return p(out, y);
+      }
+    ), x);
+  }
+};
+
+} // namespace vast
@@ -54,8 +54,11 @@ public:
 
   // -- visitation -------------------------------------------------------------
 
+  using table_slice::append_column_to_index;
+
   /// Applies all values in column `col` to `idx`.
-  void append_column_to_index(size_type col, value_index& idx) const final;
+  void append_column_to_index(size_type col, value_index& idx,
+                              id first) const final;
 
   // -- properties -------------------------------------------------------------
 
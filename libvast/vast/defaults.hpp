@@ -20,6 +20,8 @@
 #include <caf/atom.hpp>
 #include <caf/fwd.hpp>
 
+#include "vast/compression.hpp"
+
 namespace vast::defaults {
 
 // -- constants for the import command and its subcommands ---------------------
@@ -41,6 +43,10 @@ namespace import {
 caf::atom_value table_slice_type(const caf::actor_system& sys,
                                  const caf::settings& options);
 
+/// @returns the number of inputs to read in parallel from `options` if
+///          available, otherwise the number of hardware threads.
+size_t jobs(const caf::settings& options);
+
 /// Maximum number of results.
 constexpr size_t max_events = 0;
 
@@ -133,6 +139,17 @@ constexpr std::string_view read = "-";
 /// Maximum number of results.
 constexpr size_t max_events = 0;
 
+/// Number of partitions the EXPORTER requests from the INDEX before it
+/// observed any partition latency.
+constexpr size_t initial_partitions = 2;
+
+/// Maximum number of partitions per request of the EXPORTER.
+constexpr size_t max_partitions_per_request = 64;
+
+/// Targeted time for the INDEX to process a single request of the EXPORTER.
+constexpr std::chrono::milliseconds target_request_latency
+  = std::chrono::milliseconds{500};
+
 /// Contains settings for the zeek subcommand.
 struct zeek {
   /// Nested category in config files for this subcommand.
@@ -203,11 +220,19 @@ constexpr caf::atom_value table_slice_type = caf::atom("default");
 /// Maximum size for sources that generate table slices.
 constexpr size_t table_slice_size = 100;
 
+/// Number of INDEX actors per node.
+constexpr size_t index_shards = 1;
+
+/// Policy for distributing table slices over multiple INDEX actors, either
+/// `roundrobin` or `layout`.
+constexpr caf::atom_value index_routing = caf::atom("roundrobin");
+
 /// Maximum number of events per INDEX partition.
 constexpr size_t max_partition_size = 1'048'576; // 1_Mi
 
-/// Maximum number of in-memory INDEX partitions.
-constexpr size_t max_in_mem_partitions = 10;
+/// Maximum size of cached INDEX partitions in MB, measured by their size on
+/// disk.
+constexpr size_t max_resident_size = 1024;
 
 /// Number of immediately scheduled INDEX partitions.
 constexpr size_t taste_partitions = 5;
@@ -215,6 +240,30 @@ constexpr size_t taste_partitions = 5;
 /// Maximum number of concurrent INDEX queries.
 constexpr size_t num_query_supervisors = 10;
 
+/// Strategy for evaluating queries on INDEX partitions, either `actors` or
+/// `inprocess`.
+constexpr caf::atom_value index_evaluation = caf::atom("inprocess");
+
+/// Number of META INDEXER actors that compute synopses off the INDEX. A value
+/// of 0 computes all synopses in the INDEX.
+constexpr size_t num_meta_indexers = 0;
+
+/// Number of distinct values that a Bloom filter synopsis in the meta index
+/// holds at the configured false-positive rate, i.e., about 80 KB per column
+/// and partition at the default rate.
+constexpr size_t bloom_filter_capacity = 65'536;
+
+/// False-positive rate of Bloom filter synopses in the meta index.
+constexpr double bloom_filter_fp_rate = 0.01;
+
+/// Algorithm for compressing table slices in ARCHIVE segments: Snappy if
+/// available, and LZ4 otherwise.
+#ifdef VAST_HAVE_SNAPPY
+constexpr compression segment_compression = compression::snappy;
+#else
+constexpr compression segment_compression = compression::lz4;
+#endif
+
 /// Number of cached ARCHIVE segments.
 constexpr size_t segments = 10;
 
@@ -0,0 +1,45 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vast::detail {
+
+/// Computes `out[i] = x[i] & y[i]` for all *i* in *[0, n)*. The function
+/// selects the widest vector instructions of the CPU at runtime.
+/// @pre *out* may alias *x* or *y*, but no other overlap.
+void bitwise_and(const uint64_t* x, const uint64_t* y, uint64_t* out,
+                 size_t n);
+
+/// Computes `out[i] = x[i] | y[i]` for all *i* in *[0, n)*.
+/// @pre *out* may alias *x* or *y*, but no other overlap.
+void bitwise_or(const uint64_t* x, const uint64_t* y, uint64_t* out,
+                size_t n);
+
+/// Computes `out[i] = x[i] ^ y[i]` for all *i* in *[0, n)*.
+/// @pre *out* may alias *x* or *y*, but no other overlap.
+void bitwise_xor(const uint64_t* x, const uint64_t* y, uint64_t* out,
+                 size_t n);
+
+/// Computes `out[i] = x[i] & ~y[i]` for all *i* in *[0, n)*.
+/// @pre *out* may alias *x* or *y*, but no other overlap.
+void bitwise_nand(const uint64_t* x, const uint64_t* y, uint64_t* out,
+                  size_t n);
+
+/// Checks whether the bitwise kernels use AVX2 instructions.
+bool bitwise_uses_avx2();
+
+} // namespace vast::detail
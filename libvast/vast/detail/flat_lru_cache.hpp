@@ -19,8 +19,24 @@
 
 namespace vast::detail {
 
-/// A flat LRU cache for elements that have a key-like member.
-template <class T, class Predicate, class Factory>
+/// Assigns the same weight to every element of a ::flat_lru_cache, i.e.,
+/// limits the cache by its number of elements.
+struct unit_weight {
+  template <class T>
+  size_t operator()(const T&) const noexcept {
+    return 1;
+  }
+};
+
+/// Placeholder factory for a ::flat_lru_cache that only receives elements via
+/// `add`. Such a cache does not support `get_or_add`.
+struct no_factory {};
+
+/// A flat LRU cache for elements that have a key-like member. The cache
+/// evicts the least recently used elements whenever the accumulated weight of
+/// all elements exceeds its capacity.
+/// @pre The weight of an element does not change while it is in the cache.
+template <class T, class Predicate, class Factory, class Weight = unit_weight>
 class flat_lru_cache {
 public:
   // -- member types -----------------------------------------------------------
@@ -30,11 +46,14 @@ public:
   // -- constructors, destructors, and assignment operators -------------------
 
   flat_lru_cache(size_t size, Predicate pred = Predicate{},
-                 Factory fac = Factory{})
+                 Factory fac = Factory{}, Weight weigh = Weight{})
     : size_(size),
+      weight_(0),
       pred_(std::move(pred)),
-      make_(std::move(fac)) {
-    elements_.reserve(size_);
+      make_(std::move(fac)),
+      weigh_(std::move(weigh)) {
+    if constexpr (std::is_same_v<Weight, unit_weight>)
+      elements_.reserve(size_);
   }
 
   flat_lru_cache(flat_lru_cache&&) = default;
@@ -52,30 +71,39 @@ public:
     return i != last;
   }
 
-  /// Gets the element matching the predicate or creates a new one.
+  /// Gets the element matching the predicate and marks it as most recently
+  /// used.
+  /// @returns a pointer to the element or `nullptr` if the cache has none.
   template <class K>
-  T& get_or_add(const K& key) {
+  T* find(const K& key) {
     auto first = elements_.begin();
     auto last = elements_.end();
-    if (auto i = std::find_if(first, last, pred_(key)); i != last) {
-      // Move to the back unless we already access the newest element.
-      if (i != last - 1)
-        std::rotate(i, i + 1, last);
-      return elements_.back();
-    }
+    auto i = std::find_if(first, last, pred_(key));
+    if (i == last)
+      return nullptr;
+    // Move to the back unless we already access the newest element.
+    if (i != last - 1)
+      std::rotate(i, i + 1, last);
+    return &elements_.back();
+  }
+
+  /// Gets the element matching the predicate or creates a new one.
+  template <class K>
+  T& get_or_add(const K& key) {
+    if (auto ptr = find(key))
+      return *ptr;
     return add(make_(key));
   }
 
+  /// Adds a new element, evicting the oldest elements until the new element
+  /// fits. The cache always keeps the new element, even if it exceeds the
+  /// capacity on its own.
   /// @pre The new value's key does not collide with any existing element.
   T& add(T value) {
-    // Fill cache if we didn't reach capacity yet.
-    if (elements_.size() < size_)
-      return elements_.emplace_back(std::move(value));
-    // Evict oldest element by overriding it.
-    auto first = elements_.begin();
-    auto last = elements_.end();
-    std::rotate(first, first + 1, last);
-    return elements_.back() = std::move(value);
+    auto w = weigh_(value);
+    evict(size_ > w ? size_ - w : 0);
+    weight_ += w;
+    return elements_.emplace_back(std::move(value));
   }
 
   vector_type& elements() {
@@ -87,34 +115,55 @@ public:
   }
 
   void size(size_t new_size) {
-    if (new_size < elements_.size()) {
-      auto first = elements_.begin();
-      elements_.erase(first, first + (elements_.size() - new_size));
-    } else {
-      elements_.reserve(size_);
-    }
+    evict(new_size);
+    if constexpr (std::is_same_v<Weight, unit_weight>)
+      elements_.reserve(new_size);
     size_ = new_size;
   }
 
+  /// @returns the capacity of the cache.
   size_t size() const noexcept {
     return size_;
   }
 
+  /// @returns the accumulated weight of all elements.
+  size_t weight() const noexcept {
+    return weight_;
+  }
+
 private:
+  // -- utility functions ------------------------------------------------------
+
+  /// Evicts the oldest elements until the accumulated weight is at most
+  /// `limit`.
+  void evict(size_t limit) {
+    auto first = elements_.begin();
+    auto i = first;
+    for (; i != elements_.end() && weight_ > limit; ++i)
+      weight_ -= weigh_(*i);
+    elements_.erase(first, i);
+  }
+
   // -- member variables -------------------------------------------------------
 
   /// Flat store for elements. New elements are at the back, old elements are
   /// evicted from the front.
   vector_type elements_;
 
-  /// Maximum number of elements.
+  /// Maximum accumulated weight of all elements.
   size_t size_;
 
+  /// Accumulated weight of all elements.
+  size_t weight_;
+
   /// Implements key lookups for `T`.
   Predicate pred_;
 
   /// Creates new instances of `T`.
   Factory make_;
+
+  /// Computes the weight of an element.
+  Weight weigh_;
 };
 
 } // namespace vast::detail
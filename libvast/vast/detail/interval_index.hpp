@@ -0,0 +1,146 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "vast/detail/assert.hpp"
+
+namespace vast::detail {
+
+/// A static index over closed intervals *[min, max]* that answers stabbing
+/// and one-sided range queries in *O(log n + k log n)* for *k* results.
+///
+/// The index sorts the intervals by their lower bound and maintains an
+/// implicit segment tree over the upper bounds in that order. Queries on the
+/// lower bound reduce to a binary search, and queries on the upper bound
+/// descend only into subtrees whose maximum upper bound qualifies.
+/// @tparam T The totally ordered point type.
+template <class T>
+class interval_index {
+public:
+  using point_type = T;
+
+  /// An interval with an associated identifier.
+  struct interval {
+    T min;
+    T max;
+    size_t id;
+  };
+
+  interval_index() = default;
+
+  /// Constructs an index from a list of intervals.
+  /// @param xs The intervals to index.
+  explicit interval_index(std::vector<interval> xs)
+    : intervals_{std::move(xs)} {
+    auto cmp = [](auto& x, auto& y) { return x.min < y.min; };
+    std::sort(intervals_.begin(), intervals_.end(), cmp);
+    if (!intervals_.empty()) {
+      max_tree_.resize(4 * intervals_.size());
+      build(1, 0, intervals_.size());
+    }
+  }
+
+  /// @returns the number of indexed intervals.
+  size_t size() const noexcept {
+    return intervals_.size();
+  }
+
+  /// @returns `true` if the index contains no intervals.
+  bool empty() const noexcept {
+    return intervals_.empty();
+  }
+
+  /// Visits the IDs of all intervals that contain *x*, i.e., for which
+  /// *min <= x && x <= max*.
+  template <class F>
+  void stab(const T& x, F f) const {
+    report(min_upper_bound(x), [&](const T& max) { return x <= max; }, f);
+  }
+
+  /// Visits the IDs of all intervals for which *min < x*, or *min <= x* if
+  /// *inclusive* is `true`.
+  template <class F>
+  void min_below(const T& x, bool inclusive, F f) const {
+    auto end = inclusive ? min_upper_bound(x) : min_lower_bound(x);
+    for (size_t i = 0; i < end; ++i)
+      f(intervals_[i].id);
+  }
+
+  /// Visits the IDs of all intervals for which *max > x*, or *max >= x* if
+  /// *inclusive* is `true`.
+  template <class F>
+  void max_above(const T& x, bool inclusive, F f) const {
+    if (inclusive)
+      report(intervals_.size(), [&](const T& max) { return x <= max; }, f);
+    else
+      report(intervals_.size(), [&](const T& max) { return x < max; }, f);
+  }
+
+private:
+  void build(size_t node, size_t first, size_t last) {
+    if (last - first == 1) {
+      max_tree_[node] = intervals_[first].max;
+      return;
+    }
+    auto mid = first + (last - first) / 2;
+    build(2 * node, first, mid);
+    build(2 * node + 1, mid, last);
+    max_tree_[node] = std::max(max_tree_[2 * node], max_tree_[2 * node + 1]);
+  }
+
+  // Returns the number of intervals with *min < x*.
+  size_t min_lower_bound(const T& x) const {
+    auto i = std::partition_point(intervals_.begin(), intervals_.end(),
+                                  [&](auto& y) { return y.min < x; });
+    return static_cast<size_t>(i - intervals_.begin());
+  }
+
+  // Returns the number of intervals with *min <= x*.
+  size_t min_upper_bound(const T& x) const {
+    auto i = std::partition_point(intervals_.begin(), intervals_.end(),
+                                  [&](auto& y) { return y.min <= x; });
+    return static_cast<size_t>(i - intervals_.begin());
+  }
+
+  // Visits all intervals among the first *end* ones whose upper bound
+  // satisfies *pred*.
+  template <class Predicate, class F>
+  void report(size_t end, Predicate pred, F& f) const {
+    if (end > 0)
+      report(1, 0, intervals_.size(), end, pred, f);
+  }
+
+  template <class Predicate, class F>
+  void report(size_t node, size_t first, size_t last, size_t end,
+              Predicate& pred, F& f) const {
+    if (first >= end || !pred(max_tree_[node]))
+      return;
+    if (last - first == 1) {
+      f(intervals_[first].id);
+      return;
+    }
+    auto mid = first + (last - first) / 2;
+    report(2 * node, first, mid, end, pred, f);
+    report(2 * node + 1, mid, last, end, pred, f);
+  }
+
+  std::vector<interval> intervals_;
+  std::vector<T> max_tree_;
+};
+
+} // namespace vast::detail
@@ -0,0 +1,66 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vast::detail {
+
+/// A regular expression in ECMAScript syntax that compiles once into a
+/// Thompson NFA, which in turn gets converted lazily into a DFA while
+/// matching. Before running the automaton, inputs must contain all literal
+/// substrings that the expression requires. Expressions outside the supported
+/// subset, e.g., with backreferences, lookaheads, or word boundaries, fall
+/// back to `std::regex`.
+/// @note Matching is thread-safe. Every thread builds its own DFA states, so
+///       concurrent matching does not contend on a lock.
+class regex {
+public:
+  /// Compiles a regular expression.
+  /// @param str The regular expression.
+  /// @throws std::regex_error if *str* is not a valid regular expression.
+  explicit regex(std::string_view str);
+
+  ~regex();
+
+  /// Matches the expression against an entire string.
+  /// @param x The string to match.
+  /// @returns `true` if the expression matches exactly *x*.
+  bool match(std::string_view x) const;
+
+  /// Searches the expression in a string.
+  /// @param x The string to search.
+  /// @returns `true` if the expression matches inside *x*.
+  bool search(std::string_view x) const;
+
+  /// @returns `true` if the expression runs on the automaton-based engine.
+  bool native() const;
+
+private:
+  struct impl;
+  std::unique_ptr<impl> impl_;
+};
+
+/// Extracts literal substrings of at least three characters that every string
+/// matching a regular expression must contain. The extraction is
+/// conservative: it gives up on alternations and ignores everything inside
+/// groups and character classes.
+/// @param rx The regular expression.
+/// @returns The required literals of *rx*.
+std::vector<std::string> required_literals(std::string_view rx);
+
+} // namespace vast::detail
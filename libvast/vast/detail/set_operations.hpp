@@ -14,6 +14,8 @@
 #pragma once
 
 #include <algorithm>
+#include <iterator>
+#include <utility>
 
 namespace vast::detail {
 
@@ -27,20 +29,25 @@ T intersect(const T& xs, const T& ys) {
 
 template <class T>
 void inplace_intersect(T& result, const T& xs) {
-  // Adapted from https://stackoverflow.com/a/1773620/1170277.
+  // Compact the common elements at the front in a single pass, because
+  // erasing non-matching elements one at a time takes quadratic time.
+  auto out = result.begin();
   auto i = result.begin();
   auto j = xs.begin();
   while (i != result.end() && j != xs.end()) {
     if (*i < *j) {
-      i = result.erase(i);
+      ++i;
     } else if (*i > *j) {
       ++j;
     } else {
+      if (out != i)
+        *out = std::move(*i);
+      ++out;
       ++i;
       ++j;
     }
   }
-  result.erase(i, result.end());
+  result.erase(out, result.end());
 }
 
 template <class T>
@@ -0,0 +1,186 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace vast::detail {
+
+/// The number of words that the evaluation functions process at once.
+constexpr size_t word_eval_chunk_size = 256;
+
+/// The segment size of an exhausted cursor.
+constexpr size_t word_eval_infinite = std::numeric_limits<size_t>::max();
+
+/// Accumulates the result of a word-wise evaluation into a bitmap.
+/// @tparam Bitmap The bitmap type to construct.
+/// @tparam Width The number of bits per word.
+template <class Bitmap, size_t Width>
+class word_eval_builder {
+public:
+  using size_type = typename Bitmap::size_type;
+
+  explicit word_eval_builder(size_type bits) : remaining_{bits} {
+    // nop
+  }
+
+  /// @returns the number of words left to append.
+  size_t words() const {
+    return (remaining_ + Width - 1) / Width;
+  }
+
+  /// Appends *n* words of a single bit value.
+  void run(bool bit, size_t n) {
+    auto bits = std::min(remaining_, size_type{n} * Width);
+    result_.append_bits(bit, bits);
+    remaining_ -= bits;
+  }
+
+  /// Appends a literal word.
+  void literal(uint64_t x) {
+    auto bits = std::min(remaining_, size_type{Width});
+    result_.append_block(x, bits);
+    remaining_ -= bits;
+  }
+
+  Bitmap finish() {
+    return std::move(result_);
+  }
+
+private:
+  Bitmap result_;
+  size_type remaining_;
+};
+
+/// Evaluates a bitwise operation between two compressed bitmaps segment by
+/// segment. A *cursor* exposes a bitmap as a sequence of *clean* segments,
+/// i.e., runs of words with identical value, and *literal* segments, i.e.,
+/// contiguous words in memory. An exhausted cursor yields an endless clean
+/// segment of 0-bits. It has the following interface:
+///
+///     bool clean() const;            // Is the current segment clean?
+///     uint64_t value() const;        // The word of a clean segment.
+///     const uint64_t* data() const;  // The words of a literal segment.
+///     size_t size() const;           // The number of words in the segment.
+///     void advance(size_t n);        // Consumes n <= size() words.
+///
+/// @param out The builder for the result.
+/// @param lhs The cursor of the left operand.
+/// @param rhs The cursor of the right operand.
+/// @param full A word with all bits set.
+/// @param op The operation on two words.
+/// @param kernel The operation on two arrays of words.
+template <class Builder, class Cursor, class Operation, class Kernel>
+void word_eval(Builder& out, Cursor lhs, Cursor rhs, uint64_t full,
+               Operation op, Kernel kernel) {
+  std::array<uint64_t, word_eval_chunk_size> buffer;
+  // Checks whether a clean word on one side determines the result.
+  auto constant = [&](auto f) { return f(0) == f(full); };
+  while (out.words() > 0) {
+    auto n = std::min({lhs.size(), rhs.size(), out.words()});
+    if (lhs.clean() && rhs.clean()) {
+      out.run(op(lhs.value(), rhs.value()) != 0, n);
+    } else if (lhs.clean()) {
+      auto x = lhs.value();
+      auto f = [&](uint64_t y) { return op(x, y); };
+      if (constant(f)) {
+        out.run(f(0) != 0, n);
+      } else {
+        auto ys = rhs.data();
+        for (size_t i = 0; i < n; ++i)
+          out.literal(f(ys[i]));
+      }
+    } else if (rhs.clean()) {
+      auto y = rhs.value();
+      auto f = [&](uint64_t x) { return op(x, y); };
+      if (constant(f)) {
+        out.run(f(0) != 0, n);
+      } else {
+        auto xs = lhs.data();
+        for (size_t i = 0; i < n; ++i)
+          out.literal(f(xs[i]));
+      }
+    } else {
+      auto xs = lhs.data();
+      auto ys = rhs.data();
+      for (size_t i = 0; i < n; i += buffer.size()) {
+        auto m = std::min(buffer.size(), n - i);
+        kernel(xs + i, ys + i, buffer.data(), m);
+        for (size_t j = 0; j < m; ++j)
+          out.literal(buffer[j]);
+      }
+    }
+    lhs.advance(n);
+    rhs.advance(n);
+  }
+}
+
+/// Evaluates an associative and commutative bitwise operation over multiple
+/// compressed bitmaps at once, without materializing intermediate results.
+/// @param out The builder for the result.
+/// @param xs The cursors of the operands.
+/// @param full A word with all bits set.
+/// @param op The operation on two words.
+/// @param kernel The operation on two arrays of words.
+/// @see word_eval
+template <class Builder, class Cursor, class Operation, class Kernel>
+void word_eval(Builder& out, std::vector<Cursor> xs, uint64_t full,
+               Operation op, Kernel kernel) {
+  std::array<uint64_t, word_eval_chunk_size> buffer;
+  std::vector<const Cursor*> literals;
+  literals.reserve(xs.size());
+  while (out.words() > 0) {
+    auto n = out.words();
+    for (auto& x : xs)
+      n = std::min(n, x.size());
+    // Fold all clean segments into a single word.
+    auto have_clean = false;
+    uint64_t clean = 0;
+    literals.clear();
+    for (auto& x : xs) {
+      if (!x.clean()) {
+        literals.push_back(&x);
+      } else if (have_clean) {
+        clean = op(clean, x.value());
+      } else {
+        clean = x.value();
+        have_clean = true;
+      }
+    }
+    if (literals.empty()) {
+      out.run(clean != 0, n);
+    } else if (have_clean && op(clean, 0) == op(clean, full)) {
+      out.run(op(clean, 0) != 0, n);
+    } else {
+      for (size_t i = 0; i < n; i += buffer.size()) {
+        auto m = std::min(buffer.size(), n - i);
+        auto first = literals[0]->data() + i;
+        std::copy(first, first + m, buffer.data());
+        for (size_t j = 1; j < literals.size(); ++j)
+          kernel(buffer.data(), literals[j]->data() + i, buffer.data(), m);
+        for (size_t j = 0; j < m; ++j)
+          out.literal(have_clean ? op(buffer[j], clean) : buffer[j]);
+      }
+    }
+    for (auto& x : xs)
+      x.advance(n);
+  }
+}
+
+} // namespace vast::detail
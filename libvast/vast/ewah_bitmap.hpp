@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "vast/bitmap_base.hpp"
 #include "vast/bitvector.hpp"
 #include "vast/word.hpp"
@@ -160,4 +162,31 @@ private:
 
 ewah_bitmap_range bit_range(const ewah_bitmap& bm);
 
+// The following overloads operate directly on the block vectors: they skip
+// clean words in bulk and combine literal words with vector instructions.
+
+/// @relates ewah_bitmap
+ewah_bitmap binary_and(const ewah_bitmap& lhs, const ewah_bitmap& rhs);
+
+/// @relates ewah_bitmap
+ewah_bitmap binary_or(const ewah_bitmap& lhs, const ewah_bitmap& rhs);
+
+/// @relates ewah_bitmap
+ewah_bitmap binary_xor(const ewah_bitmap& lhs, const ewah_bitmap& rhs);
+
+/// @relates ewah_bitmap
+ewah_bitmap binary_nand(const ewah_bitmap& lhs, const ewah_bitmap& rhs);
+
+/// Computes the bitwise AND of multiple bitmaps in a single pass.
+/// @relates ewah_bitmap
+ewah_bitmap nary_and(const std::vector<const ewah_bitmap*>& xs);
+
+/// Computes the bitwise OR of multiple bitmaps in a single pass.
+/// @relates ewah_bitmap
+ewah_bitmap nary_or(const std::vector<const ewah_bitmap*>& xs);
+
+/// Computes the bitwise XOR of multiple bitmaps in a single pass.
+/// @relates ewah_bitmap
+ewah_bitmap nary_xor(const std::vector<const ewah_bitmap*>& xs);
+
 } // namespace vast
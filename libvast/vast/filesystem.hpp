@@ -303,6 +303,12 @@ std::vector<path> split(const path& p);
 /// @returns `true` if *p* exists.
 bool exists(const path& p);
 
+/// Computes the accumulated size of all regular files at a path.
+/// @param p The path to a file or directory.
+/// @returns The number of bytes of all regular files at *p*, descending into
+///          directories, or 0 if *p* does not exist.
+size_t disk_usage(const path& p);
+
 /// Creates a symlink (aka. "soft link").
 /// @param target The existing file that should be linked.
 /// @param link The symlink that points to *target*.
@@ -14,8 +14,13 @@
 #pragma once
 
 #include "vast/concept/printable/core.hpp"
+#include "vast/concept/printable/string.hpp"
 #include "vast/concept/printable/vast/event.hpp"
+#include "vast/concept/printable/vast/view.hpp"
 #include "vast/format/printer_writer.hpp"
+#include "vast/format/writer.hpp"
+#include "vast/ids.hpp"
+#include "vast/table_slice.hpp"
 
 namespace vast::format::ascii {
 
@@ -26,6 +31,21 @@ struct ascii_printer : printer<ascii_printer> {
   bool print(Iterator&& out, const event& e) const {
     return event_printer{}.print(out, e);
   }
+
+  template <class Iterator>
+  bool print(Iterator& out, const table_slice& x, const ids& selection) const {
+    return each_selected_row(x, selection, [&](auto row) {
+      if (!printers::any.print(out, '<'))
+        return false;
+      for (size_t col = 0; col < x.columns(); ++col) {
+        if (col > 0 && !printers::str.print(out, ", "))
+          return false;
+        if (!data_view_printer{}.print(out, x.at(row, col)))
+          return false;
+      }
+      return printers::str.print(out, ">\n");
+    });
+  }
 };
 
 class writer : public printer_writer<ascii_printer>{
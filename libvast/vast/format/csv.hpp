@@ -13,6 +13,9 @@
 
 #pragma once
 
+#include <string_view>
+#include <type_traits>
+
 #include <caf/none.hpp>
 
 #include "vast/config.hpp"
@@ -22,8 +25,14 @@
 #include "vast/concept/printable/string.hpp"
 #include "vast/concept/printable/vast/data.hpp"
 #include "vast/detail/escapers.hpp"
+#include "vast/detail/overload.hpp"
 #include "vast/detail/string.hpp"
+#include "vast/detail/type_traits.hpp"
 #include "vast/format/printer_writer.hpp"
+#include "vast/format/writer.hpp"
+#include "vast/ids.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/view.hpp"
 
 namespace vast::format::csv {
 
@@ -101,22 +110,62 @@ struct value_printer : printer<value_printer> {
     Iterator out_;
   };
 
+  /// Renders a single value of a table slice. Basic values print directly
+  /// from the view, everything else goes through the ::renderer.
+  template <class Iterator>
+  static bool render(Iterator& out, const type& t, data_view x) {
+    auto fallback = [&] {
+      return caf::visit(renderer<Iterator>{out}, t, materialize(x));
+    };
+    return caf::visit(detail::overload(
+      [&](caf::none_t) {
+        return true;
+      },
+      [&](real r) {
+        if (caf::holds_alternative<real_type>(t))
+          return real_printer<real, 6>{}.print(out, r);
+        return make_printer<real>{}.print(out, r);
+      },
+      [&](std::string_view str) {
+        if (!caf::holds_alternative<string_type>(t))
+          return fallback();
+        static auto escaper = detail::make_double_escaper("\"|");
+        auto p = '"' << printers::escape(escaper) << '"';
+        return p.print(out, str);
+      },
+      [&](const auto& y) {
+        using view_type = std::decay_t<decltype(y)>;
+        if constexpr (detail::is_any_v<view_type, boolean, integer, count,
+                                       timespan, timestamp, address, subnet,
+                                       port>)
+          return make_printer<view_type>{}.print(out, y);
+        else
+          return fallback();
+      }
+    ), x);
+  }
+
+  template <class Iterator>
+  bool print_header(Iterator& out, const type& t) const {
+    if (t == event_type)
+      return true;
+    event_type = t;
+    auto hdr = std::string{"type,id,timestamp"};
+    if (auto r = caf::get_if<record_type>(&t))
+      for (auto& i : record_type::each{*r})
+        hdr += ',' + i.key();
+    else
+      hdr += ",data";
+    auto p = printers::str << '\n';
+    return p.print(out, hdr);
+  }
+
   template <class Iterator>
   bool print(Iterator& out, const event& e) const {
     using namespace printers;
     // Print a new header each time we encounter a new event type.
     auto header_guard = [&] {
-      if (e.type() == event_type)
-        return true;
-      event_type = e.type();
-      auto hdr = "type,id,timestamp"s;
-      if (auto r = caf::get_if<record_type>(&e.type()))
-        for (auto& i : record_type::each{*r})
-          hdr += ',' + i.key();
-      else
-        hdr += ",data";
-      auto p = printers::str << '\n';
-      return p.print(out, hdr);
+      return print_header(out, e.type());
     };
     auto header = eps.with(header_guard);
     // Print event data.
@@ -129,6 +178,37 @@ struct value_printer : printer<value_printer> {
     return p(out, e.type().name(), e.id(), e.timestamp());
   }
 
+  template <class Iterator>
+  bool print(Iterator& out, const table_slice& x, const ids& selection) const {
+    using namespace printers;
+    auto& layout = x.layout();
+    if (layout.name().empty() || layout.fields.size() != x.columns())
+      return false;
+    if (!print_header(out, type{layout}))
+      return false;
+    auto time_column = find_time_column(layout);
+    auto row_prefix = layout.name() + ',';
+    return each_selected_row(x, selection, [&](auto row) {
+      timestamp ts;
+      if (time_column) {
+        auto v = x.at(row, *time_column);
+        if (auto t = caf::get_if<timestamp>(&v))
+          ts = *t;
+      }
+      auto p = str << u64 << ',' << u64 << ',';
+      if (!p(out, row_prefix, x.offset() + row,
+             ts.time_since_epoch().count()))
+        return false;
+      // Values without a CSV representation render as empty fields.
+      for (size_t col = 0; col < x.columns(); ++col) {
+        if (col > 0 && !str.print(out, separator))
+          return false;
+        render(out, layout.fields[col].type, x.at(row, col));
+      }
+      return any.print(out, '\n');
+    });
+  }
+
   // FIXME: relax print() constness constraint?!
   mutable type event_type;
 };
@@ -13,10 +13,21 @@
 
 #pragma once
 
+#include <string_view>
+
+#include "vast/concept/printable/core.hpp"
+#include "vast/concept/printable/string.hpp"
 #include "vast/concept/printable/vast/json.hpp"
 #include "vast/data.hpp"
+#include "vast/detail/escapers.hpp"
+#include "vast/detail/narrow.hpp"
+#include "vast/detail/overload.hpp"
 #include "vast/format/printer_writer.hpp"
+#include "vast/format/writer.hpp"
+#include "vast/ids.hpp"
 #include "vast/json.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/view.hpp"
 
 namespace vast::format::json {
 
@@ -30,6 +41,60 @@ struct event_printer : printer<event_printer> {
       return false;
     return printers::json<policy::oneline>.print(out, j);
   }
+
+  /// Prints the selected rows of a table slice as one JSON object per line.
+  /// Unlike printing events, this does not build a ::json tree per row, but
+  /// prints each value straight from the table slice.
+  template <class Iterator>
+  bool print(Iterator& out, const table_slice& x, const ids& selection) const {
+    using namespace printers;
+    auto& layout = x.layout();
+    if (layout.fields.size() != x.columns())
+      return false;
+    auto quoted = '"' << escape(detail::json_escaper) << '"';
+    auto& p = printers::json<policy::oneline>;
+    auto value = [&](data_view v) {
+      return caf::visit(detail::overload(
+        [&](const auto&) {
+          vast::json j;
+          return convert(materialize(v), j) && p.print(out, j);
+        },
+        [&](caf::none_t) {
+          return p.print(out, vast::json::null{});
+        },
+        [&](boolean b) {
+          return p.print(out, vast::json::boolean{b});
+        },
+        [&](integer i) {
+          return p.print(out, detail::narrow_cast<vast::json::number>(i));
+        },
+        [&](count c) {
+          return p.print(out, detail::narrow_cast<vast::json::number>(c));
+        },
+        [&](real r) {
+          return p.print(out, detail::narrow_cast<vast::json::number>(r));
+        },
+        [&](port n) {
+          return p.print(out, vast::json::number{n.number()});
+        },
+        [&](std::string_view str) {
+          return quoted.print(out, str);
+        }
+      ), v);
+    };
+    return each_selected_row(x, selection, [&](auto row) {
+      if (!any.print(out, '{'))
+        return false;
+      for (size_t col = 0; col < x.columns(); ++col) {
+        if (col > 0 && !str.print(out, ", "))
+          return false;
+        if (!quoted.print(out, layout.fields[col].name) || !str.print(out, ": ")
+            || !value(x.at(row, col)))
+          return false;
+      }
+      return str.print(out, "}\n");
+    });
+  }
 };
 
 class writer : public printer_writer<event_printer>{
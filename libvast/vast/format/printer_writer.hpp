@@ -16,16 +16,21 @@
 #include <iterator>
 #include <memory>
 #include <ostream>
+#include <string>
 
 #include "vast/error.hpp"
 #include "vast/event.hpp"
 #include "vast/expected.hpp"
+#include "vast/ids.hpp"
+#include "vast/table_slice.hpp"
 
 #include "vast/format/writer.hpp"
 
 namespace vast::format {
 
-/// A writer that operates with a given printer.
+/// A writer that operates with a given printer. Besides printing events, the
+/// printer must provide an overload `print(out, slice, selection)` that prints
+/// the selected rows of a table slice, each followed by a newline.
 template <class Printer>
 class printer_writer : public writer {
 public:
@@ -45,6 +50,17 @@ public:
     return {};
   }
 
+  expected<void> write(const table_slice& x, const ids& selection) override {
+    // Render all rows into the buffer first and hand them to the stream at
+    // once.
+    buffer_.clear();
+    auto i = std::back_inserter(buffer_);
+    if (!printer_.print(i, x, selection))
+      return make_error(ec::print_error, "failed to print table slice");
+    out_->write(buffer_.data(), buffer_.size());
+    return {};
+  }
+
   expected<void> flush() override {
     out_->flush();
     if (!*out_)
@@ -55,6 +71,7 @@ public:
 private:
   std::unique_ptr<std::ostream> out_;
   Printer printer_;
+  std::string buffer_;
 };
 
 } // namespace vast::format
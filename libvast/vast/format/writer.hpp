@@ -15,7 +15,10 @@
 
 #include <caf/expected.hpp>
 
+#include "vast/bitmap_algorithms.hpp"
 #include "vast/fwd.hpp"
+#include "vast/ids.hpp"
+#include "vast/table_slice.hpp"
 
 namespace vast::format {
 
@@ -29,6 +32,15 @@ public:
   /// @returns `caf::none` on success.
   virtual caf::expected<void> write(const event& x)  = 0;
 
+  /// Processes the selected rows of a table slice.
+  /// @param x The table slice to write.
+  /// @param selection The IDs of the rows to write. IDs outside of *x* have
+  ///                  no effect.
+  /// @returns `caf::none` on success.
+  /// The default implementation converts each selected row into an event and
+  /// writes it with `write(const event&)`.
+  virtual caf::expected<void> write(const table_slice& x, const ids& selection);
+
   /// Called periodically to flush state.
   /// @returns `caf::none` on success.
   /// The default implementation does nothing.
@@ -38,4 +50,24 @@ public:
   virtual const char* name() const = 0;
 };
 
+/// Invokes a function with the row number of every row in a table slice whose
+/// ID is in a selection, in ascending order.
+/// @param x The table slice.
+/// @param selection The IDs of the rows to visit.
+/// @param f The function to invoke with each row number. Returning `false`
+///          stops the iteration.
+/// @returns `false` if *f* stopped the iteration.
+template <class F>
+bool each_selected_row(const table_slice& x, const ids& selection, F f) {
+  auto begin = x.offset();
+  auto end = begin + x.rows();
+  auto rng = select(selection);
+  if (rng && rng.get() < begin)
+    rng.next_from(begin);
+  for (; rng && rng.get() < end; rng.next())
+    if (!f(rng.get() - begin))
+      return false;
+  return true;
+}
+
 } // namespace vast::format
@@ -16,6 +16,7 @@
 #include <chrono>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -35,6 +36,7 @@
 #include "vast/fwd.hpp"
 #include "vast/schema.hpp"
 #include "vast/table_slice_builder.hpp"
+#include "vast/view.hpp"
 
 namespace vast::format::zeek {
 
@@ -247,8 +249,6 @@ protected:
 private:
   using iterator_type = std::string_view::const_iterator;
 
-  void patch(std::vector<data>& xs);
-
   caf::error parse_header();
 
   std::unique_ptr<std::istream> input_;
@@ -261,8 +261,13 @@ private:
   type type_;
   record_type layout_;
   caf::optional<size_t> proto_field_;
-  std::vector<size_t> port_fields_;
+  port::port_type default_protocol_ = port::unknown;
   std::vector<rule<iterator_type, data>> parsers_;
+  // Per-line scratch space, reused to avoid allocations on the critical path.
+  std::vector<std::string_view> fields_;
+  std::vector<data_view> views_;
+  std::vector<std::string> unescaped_;
+  std::vector<data> containers_;
 };
 
 /// A Zeek writer.
@@ -279,14 +284,21 @@ public:
 
   expected<void> write(const event& e) override;
 
+  expected<void> write(const table_slice& x, const ids& selection) override;
+
   expected<void> flush() override;
 
   const char* name() const override;
 
 private:
+  /// Retrieves the output stream for a layout, creating the log file and
+  /// printing the header if necessary.
+  expected<std::ostream*> stream(const type& layout);
+
   path dir_;
   type previous_layout_;
   std::unordered_map<std::string, std::unique_ptr<std::ostream>> streams_;
+  std::string buffer_;
 };
 
 } // namespace vast::format::zeek
@@ -0,0 +1,82 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "vast/expression.hpp"
+#include "vast/ids.hpp"
+#include "vast/offset.hpp"
+
+namespace vast {
+
+/// An operator tree over the hits of the predicates in an expression that
+/// evaluates lazily. Every connective caches its result and only gets
+/// re-evaluated after the hits of a predicate below it change. Connectives
+/// combine all their operands in a single pass, conjunctions stop at the first
+/// operand without hits, and negations below a conjunction turn into a
+/// difference instead of materializing the complement.
+class ids_expression {
+public:
+  /// Constructs an empty tree that evaluates to no IDs.
+  ids_expression();
+
+  /// Constructs the operator tree for an expression. The predicates of *expr*
+  /// have no hits initially.
+  explicit ids_expression(const expression& expr);
+
+  /// Binds the hits of a predicate and marks all enclosing connectives for
+  /// re-evaluation. The tree only stores a reference to *hits*, which must
+  /// outlive the tree. Users must bind the hits again after modifying them.
+  /// @param position The position of the predicate in the expression.
+  /// @param hits The IDs matching the predicate.
+  /// @returns `false` if there is no predicate at *position*.
+  bool bind(const offset& position, const ids& hits);
+
+  /// Re-evaluates all connectives with modified operands.
+  /// @returns the IDs matching the expression.
+  const ids& evaluate();
+
+private:
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  enum class node_kind { none, conjunction, disjunction, negation, predicate };
+
+  struct node {
+    node_kind kind;
+    size_t parent;
+    std::vector<size_t> children;
+    const ids* hits = nullptr;
+    ids result;
+    bool stale = true;
+  };
+
+  struct builder;
+
+  const ids& evaluate(size_t i);
+
+  void evaluate_conjunction(node& x);
+
+  /// Computes the size of the result of a node without evaluating it, which
+  /// is the size of the largest predicate hits below it.
+  ids::size_type size(const node& x) const;
+
+  std::vector<node> nodes_;
+  std::map<offset, size_t> predicates_;
+};
+
+} // namespace vast
@@ -0,0 +1,81 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <caf/error.hpp>
+#include <caf/meta/load_callback.hpp>
+
+#include "vast/type.hpp"
+
+namespace vast {
+
+/// A dictionary of layouts, content-addressed by their digest. Containers of
+/// many table slices store each distinct layout once in a registry and refer
+/// to it by a compact ID.
+class layout_registry {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// Identifies a layout within a registry.
+  using id_type = uint32_t;
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Adds a layout unless the registry already contains it.
+  /// @param layout The layout to add.
+  /// @returns the ID of *layout*.
+  id_type add(const record_type& layout);
+
+  // -- properties -------------------------------------------------------------
+
+  /// Looks up a layout by its ID.
+  /// @param x The ID of the layout.
+  /// @returns the layout with ID *x* or `nullptr` if no such layout exists.
+  const record_type* find(id_type x) const;
+
+  /// @returns the number of layouts in the registry.
+  size_t size() const;
+
+  // -- concepts ---------------------------------------------------------------
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, layout_registry& x) {
+    auto load = [&]() -> caf::error {
+      x.index_.clear();
+      for (size_t i = 0; i < x.layouts_.size(); ++i)
+        x.index_.emplace(to_digest(x.layouts_[i]), static_cast<id_type>(i));
+      return caf::none;
+    };
+    return f(x.layouts_, caf::meta::load_callback(load));
+  }
+
+  friend bool operator==(const layout_registry& x, const layout_registry& y);
+
+  friend bool operator!=(const layout_registry& x, const layout_registry& y);
+
+private:
+  std::vector<record_type> layouts_;
+
+  /// Maps digests to layout IDs. Digests may collide, in which case multiple
+  /// layouts share a key.
+  std::unordered_multimap<std::string, id_type> index_;
+};
+
+} // namespace vast
@@ -102,8 +102,11 @@ public:
     return caf::none;
   }
 
-  void append_column_to_index(size_type col, value_index& idx) const override {
-    auto row = offset();
+  using table_slice::append_column_to_index;
+
+  void append_column_to_index(size_type col, value_index& idx,
+                              id first) const override {
+    auto row = first;
     for (auto& x : column(col))
       idx.append(make_view(x), row++);
   }
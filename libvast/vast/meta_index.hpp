@@ -17,12 +17,17 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <caf/fwd.hpp>
+#include <caf/variant.hpp>
 
+#include "vast/aliases.hpp"
+#include "vast/detail/interval_index.hpp"
 #include "vast/fwd.hpp"
 #include "vast/synopsis.hpp"
+#include "vast/time.hpp"
 #include "vast/type.hpp"
 #include "vast/uuid.hpp"
 
@@ -31,14 +36,42 @@ namespace vast {
 /// The meta index is the first data structure that queries hit. The result
 /// represents a list of candidate partition IDs that may contain the desired
 /// data. The meta index may return false positives but never false negatives.
+///
+/// On top of the per-partition synopses, the meta index maintains secondary
+/// structures that avoid visiting every partition for every predicate: a
+/// table that resolves extractors to the columns of all known layouts, and
+/// per-column interval indexes over the bounds of min-max synopses that prune
+/// range and point queries in logarithmic time.
 class meta_index {
 public:
+  // -- member types -----------------------------------------------------------
+
+  /// Synopsis structures for a given layout.
+  using table_synopsis = std::vector<synopsis_ptr>;
+
+  /// Contains synopses per table layout.
+  using partition_synopsis = std::unordered_map<record_type, table_synopsis>;
+
+  // -- API --------------------------------------------------------------------
+
   /// Adds all data from a table slice belonging to a given partition to the
   /// index.
   /// @param slice The table slice to extract data from.
   /// @param partition The partition ID that *slice* belongs to.
   void add(const uuid& partition, const table_slice& slice);
 
+  /// Adds a partition without synopses, e.g., because another actor computes
+  /// them. The partition is a candidate for every query until it has
+  /// synopses.
+  /// @param partition The partition ID.
+  void add(const uuid& partition);
+
+  /// Merges synopses that were computed outside of the meta index.
+  /// @param partition The partition ID that *synopses* belong to.
+  /// @param synopses The synopses per layout.
+  /// @pre The partition has no synopses for the layouts in *synopses*.
+  void merge(const uuid& partition, partition_synopsis synopses);
+
   /// Retrieves the list of candidate partition IDs for a given expression.
   /// @param expr The expression to lookup.
   /// @returns A vector of UUIDs representing candidate partitions.
@@ -55,11 +88,80 @@ public:
   friend caf::error inspect(caf::deserializer&, meta_index&);
 
 private:
-  // Synopsis structures for a givn layout.
-  using table_synopsis = std::vector<synopsis_ptr>;
+  /// Identifies a column as pair of layout ID and column index.
+  using column_id = std::pair<size_t, size_t>;
 
-  /// Contains synopses per table layout.
-  using partition_synopsis = std::unordered_map<record_type, table_synopsis>;
+  /// The interval indexes over the bounds of min-max synopses.
+  using bounds_index = caf::variant<
+    caf::none_t,
+    detail::interval_index<integer>,
+    detail::interval_index<count>,
+    detail::interval_index<real>,
+    detail::interval_index<timespan>,
+    detail::interval_index<timestamp>
+  >;
+
+  /// The synopses of one column across all partitions with the same layout.
+  struct column_synopses {
+    /// The synopses, aligned with the partitions of the layout.
+    std::vector<synopsis_ptr> synopses;
+
+    /// The index over the bounds of the synopses, built lazily on lookup.
+    mutable bounds_index bounds;
+
+    /// The number of synopses that *bounds* covers.
+    mutable size_t num_indexed = 0;
+
+    /// Positions of synopses that changed after building *bounds*.
+    mutable std::vector<size_t> stale;
+
+    /// Flags the positions in *stale*.
+    mutable std::vector<bool> is_stale;
+
+    /// Set once building *bounds* failed because of a synopsis other than a
+    /// min-max synopsis. Synopses never get replaced, so the column can skip
+    /// all further attempts.
+    mutable bool unbounded = false;
+  };
+
+  /// The synopses of all partitions for one layout.
+  struct layout_synopses {
+    /// The layout.
+    record_type layout;
+
+    /// The partitions that contain data of this layout.
+    std::vector<uuid> partitions;
+
+    /// Maps partition IDs to their position in *partitions*.
+    std::unordered_map<uuid, size_t> positions;
+
+    /// The synopses per column.
+    std::vector<column_synopses> columns;
+  };
+
+  /// Retrieves the candidate partitions for a single predicate.
+  std::vector<uuid> lookup(const predicate& x) const;
+
+  /// @returns the sorted IDs of all partitions.
+  std::vector<uuid> all_partitions() const;
+
+  /// Adds a partition to the list of partitions without synopses.
+  void make_opaque(const uuid& partition);
+
+  /// Removes a partition from the list of partitions without synopses.
+  void make_transparent(const uuid& partition);
+
+  /// Registers the synopses of a partition for a layout in the secondary
+  /// structures.
+  void index_synopses(const uuid& partition, const record_type& layout,
+                      const table_synopsis& table_syn);
+
+  /// Resolves the columns with synopses that a key extractor matches.
+  const std::vector<column_id>& resolve(const std::string& key) const;
+
+  /// Collects the candidate partitions for a predicate on a single column.
+  void lookup(const column_id& col, relational_operator op, data_view rhs,
+              std::vector<uuid>& result) const;
 
   /// Layouts for which we cannot generate a synopsis structure.
   std::unordered_set<record_type> blacklisted_layouts_;
@@ -67,8 +169,22 @@ private:
   /// Maps a partition ID to the synopses for that partition.
   std::unordered_map<uuid, partition_synopsis> partition_synopses_;
 
+  /// The sorted IDs of all partitions without any synopsis. Since we cannot
+  /// rule them out, they are candidates for every query.
+  std::vector<uuid> opaque_partitions_;
+
   /// The factory function to construct a synopsis structure for a type.
   synopsis_options synopsis_options_;
+
+  /// All known layouts with their synopses, derived from
+  /// *partition_synopses_*.
+  std::vector<layout_synopses> layouts_;
+
+  /// Maps layouts to their position in *layouts_*.
+  std::unordered_map<record_type, size_t> layout_ids_;
+
+  /// Caches the columns that a key extractor resolves to.
+  mutable std::unordered_map<std::string, std::vector<column_id>> key_columns_;
 };
 
 } // namespace vast
@@ -19,9 +19,22 @@
 #include <caf/sum_type.hpp>
 
 #include "vast/synopsis.hpp"
+#include "vast/table_slice.hpp"
 
 namespace vast {
 
+namespace detail {
+
+/// Widens `[min, max]` to include all values of column `col` in a single pass
+/// if `slice` stores the column as packed values of type `T`.
+/// @returns `false` if `slice` does not offer such a fast path, in which case
+///          `min` and `max` remain unchanged.
+/// @note Defined for the arithmetic types and `timestamp` only.
+template <class T>
+bool update_min_max(const table_slice& slice, size_t col, T& min, T& max);
+
+} // namespace detail
+
 /// A synopsis structure that keeps track of the minimum and maximum value.
 template <class T>
 class min_max_synopsis : public synopsis {
@@ -42,6 +55,25 @@ public:
       max_ = *y;
   }
 
+  void add_column(const table_slice& slice, size_t col) override {
+    if (detail::update_min_max(slice, col, min_, max_))
+      return;
+    // We accumulate into locals, which the compiler can keep in registers.
+    auto min = min_;
+    auto max = max_;
+    for (size_t row = 0; row < slice.rows(); ++row) {
+      auto x = slice.at(row, col);
+      if (auto y = caf::get_if<view<T>>(&x)) {
+        if (*y < min)
+          min = *y;
+        if (*y > max)
+          max = *y;
+      }
+    }
+    min_ = min;
+    max_ = max;
+  }
+
   caf::optional<bool> lookup(relational_operator op,
                              data_view rhs) const override {
     auto do_lookup = [this](relational_operator op,
@@ -66,10 +98,8 @@ public:
       case in:
         return membership();
       case not_in:
-        if (auto result = membership())
-          return !*result;
-        else
-          return result;
+        // A range that contains some of the values can still contain others.
+        return caf::none;
       case equal:
       case not_equal:
       case less:
@@ -127,7 +157,7 @@ private:
       case equal:
         return min_ <= x && x <= max_;
       case not_equal:
-        return !(min_ <= x && x <= max_);
+        return !(min_ == max_ && min_ == x);
       case less:
         return min_ < x;
       case less_equal:
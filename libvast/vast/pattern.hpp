@@ -13,16 +13,27 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
+#include <caf/error.hpp>
+#include <caf/meta/load_callback.hpp>
+
 #include "vast/detail/operators.hpp"
 
+namespace vast::detail {
+
+class regex;
+
+} // namespace vast::detail
+
 namespace vast {
 
 struct access;
 class json;
 
-/// A regular expression.
+/// A regular expression. The first match compiles the expression into an
+/// automaton, which all copies of the pattern share subsequently.
 class pattern : detail::totally_ordered<pattern>,
                 detail::addable<pattern>,
                 detail::orable<pattern>,
@@ -48,6 +59,14 @@ public:
   /// @param str The string containing the pattern.
   explicit pattern(std::string str);
 
+  pattern(const pattern& other);
+
+  pattern(pattern&&) = default;
+
+  pattern& operator=(const pattern& other);
+
+  pattern& operator=(pattern&&) = default;
+
   /// Matches a string against the pattern.
   /// @param str The string to match.
   /// @returns `true` if the pattern matches exactly *str*.
@@ -82,13 +101,21 @@ public:
 
   template <class Inspector>
   friend auto inspect(Inspector& f, pattern& p) {
-    return f(p.str_);
+    auto load = [&]() -> caf::error {
+      p.regex_.reset();
+      return {};
+    };
+    return f(p.str_, caf::meta::load_callback(load));
   }
 
   friend bool convert(const pattern& p, json& j);
 
 private:
+  /// @returns the compiled expression, compiling it on first use.
+  std::shared_ptr<const detail::regex> compiled() const;
+
   std::string str_;
+  mutable std::shared_ptr<const detail::regex> regex_;
 };
 
 } // namespace vast
@@ -0,0 +1,210 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "vast/bitmap_base.hpp"
+#include "vast/detail/operators.hpp"
+
+namespace vast {
+
+class roaring_bitmap_range;
+
+/// A bitmap that partitions its bits into blocks of 2^16 bits and represents
+/// each non-empty block with one of three container types, depending on which
+/// is smallest:
+///
+/// 1. *array*: a sorted list of the positions of all 1-bits,
+/// 2. *dense*: an uncompressed bitset,
+/// 3. *run*: a sorted list of runs of 1-bits.
+///
+/// Locating the block of a bit takes a binary search over the containers, and
+/// bitwise operations between two roaring bitmaps run container by container
+/// with specialized algorithms for each pair of container types.
+class roaring_bitmap : public bitmap_base<roaring_bitmap>,
+                       detail::equality_comparable<roaring_bitmap> {
+  friend roaring_bitmap_range;
+
+public:
+  /// The number of bits per container.
+  static constexpr size_type container_bits = size_type{1} << 16;
+
+  /// The maximum number of 1-bits in an array container.
+  static constexpr uint32_t max_array_size = 4096;
+
+  /// The bits of a single block.
+  struct container {
+    static constexpr uint8_t array = 0;
+    static constexpr uint8_t dense = 1;
+    static constexpr uint8_t run = 2;
+
+    /// The block number, i.e., the offset of the container divided by
+    /// ::container_bits.
+    size_type key = 0;
+
+    /// The container type.
+    uint8_t kind = array;
+
+    /// The number of 1-bits.
+    uint32_t cardinality = 0;
+
+    /// For array containers the sorted positions of the 1-bits, and for run
+    /// containers alternating positions of the first and last bit in a run.
+    std::vector<uint16_t> values;
+
+    /// For dense containers the bitset.
+    std::vector<block_type> words;
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, container& x) {
+      return f(x.key, x.kind, x.cardinality, x.values, x.words);
+    }
+  };
+
+  roaring_bitmap() = default;
+
+  explicit roaring_bitmap(size_type n, bool bit = false);
+
+  // -- inspectors -----------------------------------------------------------
+
+  bool empty() const;
+
+  size_type size() const;
+
+  const std::vector<container>& containers() const;
+
+  // -- element access -------------------------------------------------------
+
+  /// Accesses the *i*-th bit with a binary search over the containers.
+  /// @pre `i < size()`
+  bool operator[](size_type i) const;
+
+  // -- modifiers ------------------------------------------------------------
+
+  void append_bit(bool bit);
+
+  void append_bits(bool bit, size_type n);
+
+  void append_block(block_type bits, size_type n = word_type::width);
+
+  void flip();
+
+  /// Converts every container into its smallest representation.
+  void optimize();
+
+  // -- bitwise operations ---------------------------------------------------
+
+  roaring_bitmap& operator&=(const roaring_bitmap& other);
+
+  roaring_bitmap& operator|=(const roaring_bitmap& other);
+
+  roaring_bitmap& operator^=(const roaring_bitmap& other);
+
+  roaring_bitmap& operator-=(const roaring_bitmap& other);
+
+  // -- concepts -------------------------------------------------------------
+
+  friend bool operator==(const roaring_bitmap& x, const roaring_bitmap& y);
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, roaring_bitmap& bm) {
+    return f(bm.containers_, bm.num_bits_);
+  }
+
+  friend roaring_bitmap_range bit_range(const roaring_bitmap& bm);
+
+private:
+  /// Sets the bits *[first, last]*.
+  /// @pre `first >= size()`
+  void set_range(size_type first, size_type last);
+
+  /// @returns the container for block *key*, creating it if necessary.
+  /// @pre `containers_.empty() || containers_.back().key <= key`
+  container& back(size_type key);
+
+  std::vector<container> containers_;
+  size_type num_bits_ = 0;
+};
+
+/// @relates roaring_bitmap
+roaring_bitmap binary_and(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+/// @relates roaring_bitmap
+roaring_bitmap binary_or(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+/// @relates roaring_bitmap
+roaring_bitmap binary_xor(const roaring_bitmap& lhs, const roaring_bitmap& rhs);
+
+/// @relates roaring_bitmap
+roaring_bitmap binary_nand(const roaring_bitmap& lhs,
+                           const roaring_bitmap& rhs);
+
+/// Computes the rank of a roaring bitmap up to and including position *i*.
+/// @relates roaring_bitmap
+roaring_bitmap::size_type rank1(const roaring_bitmap& bm,
+                                roaring_bitmap::size_type i);
+
+/// Locates the *i*-th 1-bit of a roaring bitmap.
+/// @relates roaring_bitmap
+roaring_bitmap::size_type select1(const roaring_bitmap& bm,
+                                  roaring_bitmap::size_type i);
+
+/// @relates roaring_bitmap
+template <bool Bit = true>
+roaring_bitmap::size_type rank(const roaring_bitmap& bm,
+                               roaring_bitmap::size_type i) {
+  VAST_ASSERT(i < bm.size());
+  auto result = rank1(bm, i);
+  return Bit ? result : i + 1 - result;
+}
+
+/// @relates roaring_bitmap
+template <bool Bit = true>
+roaring_bitmap::size_type rank(const roaring_bitmap& bm) {
+  return bm.empty() ? 0 : rank<Bit>(bm, bm.size() - 1);
+}
+
+/// @relates roaring_bitmap
+template <bool Bit = true>
+auto select(const roaring_bitmap& bm, roaring_bitmap::size_type i)
+-> std::enable_if_t<Bit, roaring_bitmap::size_type> {
+  return select1(bm, i);
+}
+
+class roaring_bitmap_range
+  : public bit_range_base<roaring_bitmap_range, roaring_bitmap::block_type> {
+public:
+  using word_type = roaring_bitmap::word_type;
+
+  roaring_bitmap_range() = default;
+
+  explicit roaring_bitmap_range(const roaring_bitmap& bm);
+
+  void next();
+  bool done() const;
+
+private:
+  void scan();
+
+  const roaring_bitmap* bm_ = nullptr;
+  size_t container_ = 0;
+  size_t cursor_ = 0;
+  roaring_bitmap::size_type position_ = 0;
+  bool done_ = true;
+};
+
+} // namespace vast
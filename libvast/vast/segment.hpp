@@ -24,8 +24,10 @@
 
 #include "vast/aliases.hpp"
 #include "vast/chunk.hpp"
+#include "vast/compression.hpp"
 #include "vast/fwd.hpp"
 #include "vast/ids.hpp"
+#include "vast/layout_registry.hpp"
 #include "vast/segment_header.hpp"
 #include "vast/uuid.hpp"
 
@@ -58,6 +60,10 @@ using segment_ptr = caf::intrusive_ptr<segment>;
 ///               .                                         . v
 ///               +-----------------------------------------+
 ///
+/// Starting with version 2, each table slice is compressed independently,
+/// such that a lookup only needs to uncompress the selected table slices.
+/// Starting with version 3, table slices omit their layout. Instead, the meta
+/// data holds every distinct layout once and each slice refers to it by ID.
 class segment : public caf::ref_counted {
   friend segment_builder;
 
@@ -68,19 +74,23 @@ public:
   static inline constexpr segment_magic_type magic = 0x2a547ea8;
 
   /// The current version of the segment format.
-  static inline constexpr segment_version_type version = 1;
+  static inline constexpr segment_version_type version = 3;
 
   /// Per-slice meta data.
   struct table_slice_synopsis {
-    int64_t start;    ///< The byte offset from the beginning of the payload.
-    int64_t end;      ///< The byte offset to one past the end of the slice.
-    id offset;        ///< The offset in the ID space where the slice starts.
-    uint64_t size;    ///< The number of rows in the slice.
+    int64_t start;       ///< The byte offset from the beginning of the payload.
+    int64_t end;         ///< The byte offset to one past the end of the slice.
+    id offset;           ///< The offset in the ID space where the slice starts.
+    uint64_t size;       ///< The number of rows in the slice.
+    compression method;  ///< The compression algorithm of the slice bytes.
+    uint64_t raw_size;   ///< The number of bytes after uncompressing.
+    layout_registry::id_type layout; ///< The ID of the slice layout.
   };
 
   /// Meta data for a segment.
   struct meta_data {
     std::vector<table_slice_synopsis> slices;
+    layout_registry layouts;
   };
 
   /// Constructs a segment.
@@ -129,13 +139,14 @@ private:
 /// @relates segment::table_slice_synopsis
 template <class Inspector>
 auto inspect(Inspector& f, segment::table_slice_synopsis& x) {
-  return f(x.start, x.end, x.offset, x.size);
+  return f(x.start, x.end, x.offset, x.size, x.method, x.raw_size,
+           x.layout);
 }
 
 /// @relates segment::meta_data
 template <class Inspector>
 auto inspect(Inspector& f, segment::meta_data& x) {
-  return f(x.slices);
+  return f(x.slices, x.layouts);
 }
 
 /// @relates segment::meta_data
@@ -20,6 +20,8 @@
 #include <caf/fwd.hpp>
 
 #include "vast/aliases.hpp"
+#include "vast/compression.hpp"
+#include "vast/defaults.hpp"
 #include "vast/segment.hpp"
 #include "vast/uuid.hpp"
 
@@ -30,7 +32,9 @@ namespace vast {
 class segment_builder {
 public:
   /// Constructs a segment builder.
-  segment_builder();
+  /// @param method The algorithm for compressing each table slice.
+  explicit segment_builder(
+    compression method = defaults::system::segment_compression);
 
   /// Adds a table slice to the segment.
   /// @returns An error if adding the table slice failed.
@@ -52,7 +56,7 @@ public:
   /// @returns The UUID for the segment under construction.
   const uuid& id() const;
 
-  /// @returns The number of bytes of the current segment.
+  /// @returns The number of (compressed) bytes of the current segment.
   size_t table_slice_bytes() const;
 
   /// @returns the meta data for the segment.
@@ -69,7 +73,9 @@ private:
   uuid id_;
   // Table slice state
   vast::id min_table_slice_offset_;
+  compression method_;
   std::vector<char> table_slice_buffer_;
+  std::vector<char> scratch_;
   // Lookup cache
   std::vector<table_slice_ptr> slices_;
 };
@@ -46,6 +46,14 @@ public:
   /// @pre `type_check(type(), x)`
   virtual void add(data_view x) = 0;
 
+  /// Adds all values of a column from a table slice, skipping nil values. The
+  /// default implementation calls `add` for every value. Synopses override
+  /// this function to process an entire column in a single pass.
+  /// @param slice The table slice to process.
+  /// @param col The column in *slice* to add.
+  /// @pre `type_check(type(), slice.layout().fields[col].type)`
+  virtual void add_column(const table_slice& slice, size_t col);
+
   /// Tests whether a predicate matches. The synopsis is implicitly the LHS of
   /// the predicate.
   /// @param op The operator of the predicate.
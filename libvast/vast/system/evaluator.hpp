@@ -23,6 +23,7 @@
 #include "vast/aliases.hpp"
 #include "vast/expression.hpp"
 #include "vast/ids.hpp"
+#include "vast/ids_expression.hpp"
 #include "vast/offset.hpp"
 #include "vast/uuid.hpp"
 
@@ -44,7 +45,8 @@ struct evaluator_state {
   /// tree.
   void handle_missing_result(const offset& position, const caf::error& err);
 
-  /// Evaluates the predicate-tree and may produces new deltas.
+  /// Re-evaluates the parts of the expression tree with new predicate hits and
+  /// may produce new deltas.
   void evaluate();
 
   /// Decrements the `pending_responses` and sends 'done' to the client when it
@@ -63,6 +65,10 @@ struct evaluator_state {
   /// Stores hits for the expression.
   ids hits;
 
+  /// Combines `predicate_hits` according to the connectives of `expr` and
+  /// caches the results of unchanged subexpressions.
+  ids_expression tree;
+
   /// Points to the parent actor.
   caf::event_based_actor* self;
 
@@ -79,6 +85,15 @@ struct evaluator_state {
   static inline const char* name = "evaluator";
 };
 
+/// Combines the hits of all predicates according to the connectives of an
+/// expression.
+/// @param expr The query expression.
+/// @param hits The hits per predicate position in *expr*.
+/// @returns the IDs matching *expr*.
+/// @relates evaluator
+ids evaluate(const expression& expr,
+             const evaluator_state::predicate_hits_map& hits);
+
 /// Wraps a query expression in an actor. Upon receiving hits from INDEXER
 /// actors, re-evaluates the expression and relays new hits to its sinks.
 /// @pre `!eval.empty()`
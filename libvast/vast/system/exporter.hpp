@@ -16,13 +16,17 @@
 #include <chrono>
 #include <deque>
 #include <memory>
+#include <utility>
 #include <unordered_map>
+#include <vector>
 
 #include "vast/aliases.hpp"
 #include "vast/event.hpp"
 #include "vast/expression.hpp"
 #include "vast/ids.hpp"
 #include "vast/query_options.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/table_slice_filter.hpp"
 #include "vast/uuid.hpp"
 
 #include "vast/system/accountant.hpp"
@@ -31,18 +35,39 @@
 
 namespace vast::system {
 
+/// The progress of a query at a single INDEX actor.
+struct index_lookup {
+  /// The INDEX actor.
+  caf::actor index;
+
+  /// The query ID at the INDEX.
+  uuid id;
+
+  /// Number of candidate partitions the INDEX has not scheduled yet.
+  size_t remaining;
+};
+
 struct exporter_state {
   caf::settings status();
 
   archive_type archive;
-  caf::actor index;
+  std::vector<caf::actor> indexes;
+  std::vector<index_lookup> lookups;
+  size_t pending_responses = 0;
+  size_t pending_batches = 0;
   caf::actor sink;
   accountant_type accountant;
   ids hits;
-  std::unordered_map<type, expression> checkers;
+  std::unordered_map<type, table_slice_filter> checkers;
   std::deque<event> candidates;
-  std::vector<event> results;
+  /// Table slices along with the IDs of their rows that fulfill the query,
+  /// waiting for shipment to the sink.
+  std::deque<std::pair<table_slice_ptr, ids>> results;
+  /// The number of rows in `results`.
+  uint64_t num_results = 0;
   std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point last_request;
+  timespan partition_latency = timespan::zero();
   query_status query;
   query_options options;
   uuid id;
@@ -52,7 +77,8 @@ struct exporter_state {
 
 /// The EXPORTER receives index hits, looks up the corresponding events in the
 /// archive, and performs a candidate check to select the resulting stream of
-/// matching events.
+/// matching events. Historical queries fan out to all registered INDEX actors
+/// and complete once every INDEX reported all of its partitions.
 /// @param self The actor handle.
 /// @param ast The AST of query.
 /// @param qos The query options.
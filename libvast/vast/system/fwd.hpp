@@ -31,9 +31,11 @@ class import_command;
 class indexer_stage_driver;
 class node_command;
 class partition;
+class partition_file;
 class pcap_reader_command;
 class pcap_writer_command;
 class remote_command;
+class sealed_columns;
 class sink_command;
 class source_command;
 class start_command;
@@ -14,8 +14,10 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <vector>
 
+#include <caf/broadcast_downstream_manager.hpp>
 #include <caf/event_based_actor.hpp>
 #include <caf/stateful_actor.hpp>
 
@@ -30,6 +32,40 @@
 
 namespace vast::system {
 
+/// @relates importer_state
+/// Policies for distributing table slices over multiple INDEX actors.
+enum class index_routing : uint8_t {
+  /// Cycles through all INDEX actors, one ID block at a time.
+  round_robin,
+  /// Sends all slices with the same layout name to the same INDEX actor.
+  layout,
+};
+
+/// @relates importer_state
+/// Filter type for dispatching slices to downstream actors. Each INDEX actor
+/// receives only the slices of its shard, whereas all other paths keep the
+/// default-constructed filter and receive everything.
+struct importer_stage_filter {
+  /// Position of the INDEX actor among all registered INDEX actors.
+  uint32_t shard = 0;
+
+  /// Number of registered INDEX actors, or 0 to select every slice.
+  uint32_t num_shards = 0;
+
+  /// Number of IDs the IMPORTER assigns per slice.
+  uint32_t block_size = 1;
+
+  /// Policy for mapping slices to shards.
+  index_routing routing = index_routing::round_robin;
+};
+
+/// @relates importer_state
+/// Selects downstream actors for a slice based on their filter.
+struct importer_stage_selector {
+  bool operator()(const importer_stage_filter& f,
+                  const table_slice_ptr& x) const;
+};
+
 /// Receives chunks from SOURCEs, imbues them with an ID, and relays them to
 /// ARCHIVE, INDEX and continuous queries.
 struct importer_state {
@@ -42,7 +78,9 @@ struct importer_state {
   using output_type = table_slice_ptr;
 
   /// Stream object for managing downstream actors.
-  using downstream_manager = caf::broadcast_downstream_manager<output_type>;
+  using downstream_manager
+    = caf::broadcast_downstream_manager<output_type, importer_stage_filter,
+                                        importer_stage_selector>;
 
   /// Base type for stream drivers implementing the importer.
   using driver_base = caf::stream_stage_driver<input_type, downstream_manager>;
@@ -105,8 +143,13 @@ struct importer_state {
   caf::dictionary<caf::config_value> status() const;
 
   /// Forwards listeners to all INDEX actors and clears the listeners vector.
+  /// Each listener receives a single 'flush' after all INDEX actors flushed.
   void notify_flush_listeners();
 
+  /// Adds an INDEX actor as new shard and redistributes the stream over all
+  /// shards.
+  caf::outbound_stream_slot<output_type> add_index(caf::actor index);
+
   /// Stores how many slices inbound paths can still send us.
   int32_t in_flight_slices = 0;
 
@@ -142,6 +185,12 @@ struct importer_state {
   /// Stores all actor handles of connected INDEX actors.
   std::vector<caf::actor> index_actors;
 
+  /// Stores the outbound slot for each entry in `index_actors`.
+  std::vector<caf::stream_slot> index_slots;
+
+  /// Policy for distributing slices over `index_actors`.
+  index_routing routing = index_routing::round_robin;
+
   accountant_type accountant;
 
   /// Name of this actor in log events.
@@ -153,8 +202,9 @@ using importer_actor = caf::stateful_actor<importer_state>;
 /// Spawns an IMPORTER.
 /// @param self The actor handle.
 /// @param dir The directory for persistent state.
-/// @param batch_size The initial number of IDs to request when replenishing.
+/// @param max_table_slice_size The number of IDs to assign per slice.
+/// @param routing The policy for distributing slices over INDEX actors.
 caf::behavior importer(importer_actor* self, path dir,
-                       size_t max_table_slice_size);
+                       size_t max_table_slice_size, index_routing routing);
 
 } // namespace vast::system
@@ -0,0 +1,107 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <caf/expected.hpp>
+#include <caf/fwd.hpp>
+
+#include "vast/expression.hpp"
+#include "vast/fwd.hpp"
+#include "vast/ids.hpp"
+#include "vast/system/partition_file.hpp"
+#include "vast/value_index.hpp"
+#include "vast/view.hpp"
+
+namespace vast::system {
+
+/// The decoded value indexes of a sealed partition, shared by all in-process
+/// evaluations of the partition. Each column gets decoded at most once, on
+/// first access. Safe to use from multiple threads: lookups on the same column
+/// run one at a time, because value indexes update the lazy state of their
+/// coders even when looking up values.
+class sealed_columns {
+public:
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// @pre `file != nullptr`
+  explicit sealed_columns(std::shared_ptr<const partition_file> file);
+
+  // -- properties -------------------------------------------------------------
+
+  /// @returns the consolidated partition file.
+  const partition_file& file() const noexcept {
+    return *file_;
+  }
+
+  /// Looks up a value in the value index for `column` of `x`.
+  /// @param x The table of the column.
+  /// @param column The column to look up.
+  /// @param op The relational operator.
+  /// @param rhs The value to look up.
+  /// @returns the hits, which are empty if the column has no persistent state
+  ///          or fails to deserialize, or an error if the lookup fails.
+  /// @pre `column < x.columns.size()`
+  caf::expected<ids> lookup(const partition_file::table& x, size_t column,
+                            relational_operator op, data_view rhs);
+
+private:
+  /// A lazily decoded column.
+  struct column {
+    /// Serializes decoding and lookups.
+    std::mutex mtx;
+    bool decoded = false;
+    value_index_ptr idx;
+  };
+
+  /// @returns the column state for `column` of `x`.
+  column& at(const partition_file::table& x, size_t column);
+
+  /// The consolidated partition file.
+  std::shared_ptr<const partition_file> file_;
+
+  /// Protects `columns_`.
+  std::mutex mtx_;
+
+  /// The columns of each table.
+  std::unordered_map<const partition_file::table*,
+                     std::vector<std::unique_ptr<column>>>
+    columns_;
+};
+
+/// Evaluates an expression against all tables of a sealed partition by
+/// querying the value indexes directly.
+/// @param expr The query expression.
+/// @param columns The columns of the sealed partition.
+/// @returns the IDs matching *expr*.
+/// @relates sealed_columns
+ids evaluate(const expression& expr, sealed_columns& columns);
+
+/// Evaluates a query expression for a sealed partition in a single actor
+/// instead of spawning one INDEXER per column and one EVALUATOR per
+/// partition. Responds to `caf::actor` like the EVALUATOR: sends the hits to
+/// the given client and responds with `done_atom` afterwards.
+/// @param self The actor handle.
+/// @param expr The query expression.
+/// @param columns The columns of the sealed partition.
+/// @returns the initial behavior of the IN-PROCESS EVALUATOR.
+caf::behavior in_process_evaluator(caf::event_based_actor* self,
+                                   expression expr,
+                                   std::shared_ptr<sealed_columns> columns);
+
+} // namespace vast::system
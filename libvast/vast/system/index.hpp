@@ -13,7 +13,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <caf/fwd.hpp>
@@ -26,6 +32,7 @@
 #include "vast/system/partition.hpp"
 #include "vast/system/query_supervisor.hpp"
 #include "vast/system/spawn_indexer.hpp"
+#include "vast/time.hpp"
 #include "vast/uuid.hpp"
 
 #include "vast/detail/flat_lru_cache.hpp"
@@ -33,6 +40,18 @@
 
 namespace vast::system {
 
+/// Strategies for evaluating queries on partitions that are not active.
+/// @relates index_state
+enum class evaluation_engine : uint8_t {
+  /// Spawns one INDEXER per queried column and an EVALUATOR that collects
+  /// their hits.
+  actors,
+  /// Evaluates sealed partitions in a single actor that queries the decoded
+  /// column indexes directly. Falls back to `actors` for all other
+  /// partitions.
+  in_process,
+};
+
 /// State of an INDEX actor.
 struct index_state {
   // -- member types -----------------------------------------------------------
@@ -54,23 +73,20 @@ struct index_state {
     }
   };
 
-  /// Loads partitions from disk by UUID.
-  class partition_factory {
+  /// Weighs partitions in the LRU cache by their size on disk.
+  class partition_weight {
   public:
-    partition_factory(index_state* st) : st_(st) {
-      // nop
+    size_t operator()(const partition_ptr& ptr) const {
+      return std::max(ptr->disk_usage(), size_t{1});
     }
-
-    partition_ptr operator()(const uuid& id) const;
-
-  private:
-    index_state* st_;
   };
 
-  /// Stores partitions sorted by access frequency.
+  /// Stores partitions sorted by access frequency. Only the PARTITION LOADER
+  /// adds partitions to the cache, which keeps disk I/O off the INDEX.
   using partition_cache_type = detail::flat_lru_cache<partition_ptr,
                                                       partition_lookup,
-                                                      partition_factory>;
+                                                      detail::no_factory,
+                                                      partition_weight>;
 
   /// Stores context information for unfinished queries.
   struct lookup_state {
@@ -81,6 +97,51 @@ struct index_state {
     std::vector<uuid> partitions;
   };
 
+  /// Scheduling priorities of query tasks, from most to least urgent. The
+  /// initial partitions of a query are interactive, whereas all partitions a
+  /// client requests afterwards are bulk extraction.
+  enum task_priority : uint8_t {
+    interactive_in_memory,
+    interactive_on_disk,
+    bulk_in_memory,
+    bulk_on_disk,
+    num_task_priorities,
+  };
+
+  /// The evaluation of a query on a single partition.
+  struct query_task {
+    /// The batch this task belongs to.
+    uint64_t batch;
+
+    /// The partition to evaluate.
+    uuid partition;
+
+    /// The queue of the task.
+    task_priority priority;
+
+    /// The time when the task entered the queue.
+    std::chrono::steady_clock::time_point enqueued;
+  };
+
+  /// All tasks scheduled by a single client request. The INDEX sends 'done'
+  /// to the client after the last task completed.
+  struct query_batch {
+    /// The ID of the query.
+    uuid query;
+
+    /// The issued query.
+    expression expr;
+
+    /// The receiver of all hits.
+    caf::actor client;
+
+    /// Number of tasks that did not complete yet.
+    size_t open_tasks;
+
+    /// The longest time a task of this batch waited for a worker.
+    timespan queueing_delay;
+  };
+
   // -- constructors, destructors, and assignment operators --------------------
 
   index_state(caf::stateful_actor<index_state>* self);
@@ -88,8 +149,8 @@ struct index_state {
   ~index_state();
 
   /// Initializes the state.
-  caf::error init(const path& dir, size_t max_events, uint32_t max_parts,
-                  uint32_t taste_parts);
+  caf::error init(const path& dir, size_t max_events,
+                  size_t max_resident_size, uint32_t taste_parts);
 
   // -- persistence ------------------------------------------------------------
 
@@ -108,7 +169,7 @@ struct index_state {
   bool worker_available();
 
   /// Takes the next worker from the idle workers stack and returns it.
-  /// @pre `has_worker()`
+  /// @pre `worker_available()`
   caf::actor next_worker();
 
   /// @returns various status metrics.
@@ -117,6 +178,10 @@ struct index_state {
   /// Creates a new partition owned by the INDEX (stored as `active`).
   void reset_active_partition();
 
+  /// Adds a table slice of the active partition to the meta index, either
+  /// directly or via a META INDEXER.
+  void update_meta_index(const table_slice_ptr& slice);
+
   /// @returns a new partition with random ID.
   partition_ptr make_partition();
 
@@ -127,6 +192,10 @@ struct index_state {
   caf::actor make_indexer(path dir, type column_type, size_t column,
                           uuid partition_id, atomic_measurement* m);
 
+  /// @returns a new INDEXER actor for a column of a sealed partition.
+  caf::actor make_indexer(chunk_ptr state, type column_type, size_t column,
+                          uuid partition_id, atomic_measurement* m);
+
   /// Decrements the indexer count for a partition.
   void decrement_indexer_count(uuid pid);
 
@@ -134,12 +203,37 @@ struct index_state {
   ///          partition matches.
   partition* find_unpersisted(const uuid& id);
 
-  /// Locates all INDEXER actors in range [first, last) and spawns one
-  /// evaluator per identified INDEXER set.
-  /// @returns a query map for passing to INDEX workers over the spawned
-  ///          EVALUATOR actors.
-  /// @pre num_partitions > 0
-  query_map launch_evaluators(lookup_state& lookup, uint32_t num_partitions);
+  /// @returns whether the partition matching `id` resides in memory.
+  bool in_memory(const uuid& id);
+
+  /// Moves up to `num_partitions` partitions of a lookup into the task
+  /// queues, preferring partitions that reside in memory.
+  /// @param lookup The lookup state of the query.
+  /// @param num_partitions The maximum number of partitions to schedule.
+  /// @param query_id The ID of the query.
+  /// @param client The receiver of all hits and the final 'done'.
+  /// @param interactive Whether the tasks belong to the initial request.
+  /// @returns the number of scheduled partitions.
+  size_t enqueue_tasks(lookup_state& lookup, uint32_t num_partitions,
+                       const uuid& query_id, caf::actor client,
+                       bool interactive);
+
+  /// Asks the INDEX to load the next `num_partitions` candidates of a lookup
+  /// into memory before a client requests them.
+  void prefetch(const lookup_state& lookup, size_t num_partitions);
+
+  /// Asks the PARTITION LOADER to read the meta data of a partition. Once
+  /// loaded, the partition enters the LRU cache and all tasks parked for it
+  /// return to the front of their queues.
+  void load_partition(const uuid& id);
+
+  /// Hands the most urgent queued tasks to idle workers. Tasks for partitions
+  /// that reside on disk wait in `loading` until their partition arrives.
+  void dispatch_tasks();
+
+  /// Marks a task of `batch` as completed and sends 'done' to the client
+  /// after completing the last task of the batch.
+  void complete_task(uint64_t batch);
 
   void send_report();
 
@@ -157,6 +251,16 @@ struct index_state {
   /// Allows to select partitions with timestamps.
   meta_index meta_idx;
 
+  /// Actors that compute synopses off the INDEX. If empty, the INDEX updates
+  /// the meta index directly.
+  std::vector<caf::actor> meta_indexers;
+
+  /// The META INDEXER for the active partition.
+  caf::actor active_meta_indexer;
+
+  /// The number of partitions assigned to META INDEXERS so far.
+  size_t meta_indexer_assignments = 0;
+
   /// Base directory for all partitions of the index.
   path dir;
 
@@ -169,9 +273,8 @@ struct index_state {
   /// The number of partitions to schedule immediately for each query.
   uint32_t taste_partitions;
 
-  /// Allows the index to multiplex between waiting for ready workers and
-  /// queries.
-  caf::behavior has_worker;
+  /// The strategy for evaluating queries on partitions.
+  evaluation_engine engine = evaluation_engine::in_process;
 
   /// Maps query IDs to pending lookup state.
   std::unordered_map<uuid, lookup_state> pending;
@@ -179,6 +282,25 @@ struct index_state {
   /// Caches idle workers.
   std::vector<caf::actor> idle_workers;
 
+  /// Maps workers to the batch of the task they currently evaluate.
+  std::vector<std::pair<caf::actor, uint64_t>> busy_workers;
+
+  /// Queued tasks, one queue per priority.
+  std::array<std::deque<query_task>, num_task_priorities> task_queues;
+
+  /// Maps batch IDs to batches with incomplete tasks.
+  std::unordered_map<uint64_t, query_batch> batches;
+
+  /// The ID of the next batch.
+  uint64_t next_batch = 0;
+
+  /// Reads partitions from disk off the INDEX.
+  caf::actor loader;
+
+  /// Maps partitions that the PARTITION LOADER currently reads to the tasks
+  /// waiting for them.
+  std::unordered_map<uuid, std::vector<query_task>> loading;
+
   /// Spawns an INDEXER actor. Default-initialized to `spawn_indexer`, but
   /// allows users to redirect to other implementations (primarily for unit
   /// testing).
@@ -190,7 +312,7 @@ struct index_state {
   /// Active indexer count for the current partition.
   size_t active_partition_indexers;
 
-  /// Recently accessed partitions.
+  /// Recently accessed partitions, limited by their accumulated size on disk.
   partition_cache_type lru_partitions;
 
   /// Stores partitions that are no longer active but have not persisted their
@@ -209,12 +331,18 @@ struct index_state {
 /// Indexes events in horizontal partitions.
 /// @param dir The directory of the index.
 /// @param max_partition_size The maximum number of events per partition.
-/// @param in_mem_partitions The maximum number of partitions to hold in memory.
+/// @param max_resident_size The maximum number of bytes of cached partitions,
+///                          measured by their size on disk.
 /// @param taste_partitions The number of partitions to schedule immediately
 ///                         for each query
-/// @pre `max_partition_size > 0 && in_mem_partitions > 0`
+/// @param num_workers The maximum number of concurrently evaluated partitions.
+/// @param num_meta_indexers The number of actors that compute synopses for
+///                          the meta index, or 0 to compute them in the INDEX.
+/// @param engine The strategy for evaluating queries on partitions.
+/// @pre `max_partition_size > 0 && max_resident_size > 0`
 caf::behavior index(caf::stateful_actor<index_state>* self, const path& dir,
-                    size_t max_partition_size, size_t in_mem_partitions,
-                    size_t taste_partitions, size_t num_workers);
+                    size_t max_partition_size, size_t max_resident_size,
+                    size_t taste_partitions, size_t num_workers,
+                    size_t num_meta_indexers, evaluation_engine engine);
 
 } // namespace vast::system
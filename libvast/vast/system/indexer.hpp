@@ -19,6 +19,7 @@
 #include <caf/event_based_actor.hpp>
 #include <caf/stateful_actor.hpp>
 
+#include "vast/chunk.hpp"
 #include "vast/column_index.hpp"
 #include "vast/filesystem.hpp"
 #include "vast/system/fwd.hpp"
@@ -38,6 +39,10 @@ struct indexer_state {
                   size_t column, caf::actor index, uuid partition_id,
                   atomic_measurement* m);
 
+  caf::error init(caf::event_based_actor* self, chunk_ptr state,
+                  type column_type, size_t column, caf::actor index,
+                  uuid partition_id, atomic_measurement* m);
+
   // -- member variables -------------------------------------------------------
 
   union { column_index col; };
@@ -65,4 +70,19 @@ caf::behavior indexer(caf::stateful_actor<indexer_state>* self, path dir,
                       type column_type, size_t column, caf::actor index,
                       uuid partition_id, atomic_measurement* m);
 
+/// Answers queries for a single column of a sealed partition.
+/// @param self The actor handle.
+/// @param state The serialized column index or `nullptr` for an empty index.
+/// @param column_type The type of the indexed column.
+/// @param column The indexed column.
+/// @param index A handle to the index actor.
+/// @param partition_id The partition ID that this INDEXER belongs to.
+/// @param m A pointer to the measuring probe used for perfomance data
+///        accumulation.
+/// @returns the initial behavior of the INDEXER.
+caf::behavior sealed_indexer(caf::stateful_actor<indexer_state>* self,
+                             chunk_ptr state, type column_type, size_t column,
+                             caf::actor index, uuid partition_id,
+                             atomic_measurement* m);
+
 } // namespace vast::system
@@ -0,0 +1,50 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <unordered_map>
+
+#include <caf/stateful_actor.hpp>
+
+#include "vast/fwd.hpp"
+#include "vast/meta_index.hpp"
+#include "vast/synopsis.hpp"
+#include "vast/uuid.hpp"
+
+namespace vast::system {
+
+struct meta_indexer_state {
+  // -- member variables -------------------------------------------------------
+
+  /// Options for constructing synopses.
+  synopsis_options options;
+
+  /// The synopses of all partitions that did not complete yet.
+  std::unordered_map<uuid, meta_index::partition_synopsis> partitions;
+
+  static inline const char* name = "meta-indexer";
+};
+
+/// Computes the synopses of partitions on behalf of the INDEX, which takes
+/// the per-cell work of the meta index off the ingestion path of the INDEX.
+/// The INDEX forwards all table slices of a partition via
+/// `(uuid, table_slice_ptr)` and collects the synopses once the partition is
+/// complete via `(get_atom, uuid)`.
+/// @param self The actor handle.
+/// @param opts The options for constructing synopses.
+/// @returns the initial behavior of the META INDEXER.
+caf::behavior meta_indexer(caf::stateful_actor<meta_indexer_state>* self,
+                           synopsis_options opts);
+
+} // namespace vast::system
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 
 #include <caf/detail/unordered_flat_map.hpp>
 #include <caf/event_based_actor.hpp>
@@ -23,6 +24,7 @@
 #include "vast/detail/assert.hpp"
 #include "vast/fwd.hpp"
 #include "vast/system/fwd.hpp"
+#include "vast/system/partition_file.hpp"
 #include "vast/system/spawn_indexer.hpp"
 #include "vast/system/table_indexer.hpp"
 #include "vast/type.hpp"
@@ -44,6 +46,12 @@ public:
 
     /// Stores whether we modified `types` after loading it.
     bool dirty = false;
+
+    /// The number of bytes the partition occupies on disk. Not persisted.
+    size_t disk_usage = 0;
+
+    /// The consolidated file of a sealed partition. Not persisted.
+    std::shared_ptr<const partition_file> file;
   };
 
   // -- constructors, destructors, and assignment operators --------------------
@@ -64,6 +72,23 @@ public:
   /// @returns an error if I/O operations fail.
   caf::error init();
 
+  /// Materializes the partition layouts from previously loaded meta data.
+  void init(meta_data md);
+
+  /// Reads the meta data of a partition from disk without constructing the
+  /// partition, which allows other actors to perform the I/O. Prefers the
+  /// consolidated file of a sealed partition over the directory.
+  /// @param dir The directory of the partition.
+  /// @returns the meta data or an error if I/O operations fail.
+  static caf::expected<meta_data> load_meta_data(const path& dir);
+
+  /// Consolidates a persisted partition into a single ::partition_file and
+  /// removes its directory afterwards. Compacts the delta segments of all
+  /// column indexes beforehand. Sealed partitions are read-only.
+  /// @param dir The directory of the partition.
+  /// @returns an error if I/O operations fail.
+  static caf::error seal(const path& dir);
+
   /// Persists the partition layouts to disk.
   /// @returns an error if I/O operations fail.
   caf::error flush_to_disk();
@@ -85,6 +110,22 @@ public:
     return *state_;
   }
 
+  /// @returns the number of bytes the partition occupied on disk when
+  ///          loading it.
+  auto disk_usage() const noexcept {
+    return meta_data_.disk_usage;
+  }
+
+  /// @returns the consolidated file if the partition is sealed, `nullptr`
+  ///          otherwise.
+  const partition_file* file() const noexcept {
+    return meta_data_.file.get();
+  }
+
+  /// @returns the decoded columns of a sealed partition for in-process
+  ///          evaluation, or `nullptr` if the partition is not sealed.
+  std::shared_ptr<sealed_columns> columns();
+
   /// @returns the remaining capacity in this partition.
   auto capacity() const noexcept {
     return capacity_;
@@ -148,6 +189,9 @@ private:
   /// Remaining capacity in this partition.
   size_t capacity_;
 
+  /// Lazily decoded columns of a sealed partition.
+  std::shared_ptr<sealed_columns> columns_;
+
   friend struct index_state;
 };
 
@@ -0,0 +1,152 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <caf/detail/unordered_flat_map.hpp>
+#include <caf/expected.hpp>
+#include <caf/fwd.hpp>
+
+#include "vast/chunk.hpp"
+#include "vast/filesystem.hpp"
+#include "vast/ids.hpp"
+#include "vast/type.hpp"
+
+namespace vast::system {
+
+/// A persisted partition consolidated into a single file, which replaces the
+/// directory tree with one file per INDEXER. The layout has the following
+/// format:
+///
+///               +--------------------+--------------------+
+///               |       magic        |      version       |
+///               +--------------------+--------------------+
+///               .                                         . ^
+///               .            table of contents            . | variable size
+///               .                                         . v
+///               +-----------------------------------------+
+///               .                                         . ^
+///               .                                         . |
+///               .             column indexes              . | variable size
+///               .                                         . |
+///               .                                         . v
+///               +-----------------------------------------+
+///
+/// The table of contents stores layout, row IDs, and the byte range of each
+/// column index per table. The column indexes keep the serialization format
+/// of the INDEXER files, such that an INDEXER can deserialize its column
+/// straight from a memory-mapped slice of the file. Hence, loading a partition
+/// only reads the table of contents, and a query only decodes the columns it
+/// touches.
+class partition_file {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// The location of a serialized column index relative to the first byte
+  /// after the table of contents.
+  struct column_range {
+    uint64_t offset; ///< The byte offset of the column index.
+    uint64_t size;   ///< The number of bytes, or 0 for columns without state.
+  };
+
+  /// The table of contents entry for a single layout.
+  struct table {
+    record_type layout;                ///< The layout of the table.
+    ids row_ids;                       ///< The IDs of all rows in the table.
+    std::vector<column_range> columns; ///< The column indexes by position.
+  };
+
+  /// Maps type digests to tables.
+  using table_map = caf::detail::unordered_flat_map<std::string, table>;
+
+  // -- constants --------------------------------------------------------------
+
+  /// A magic constant that identifies partition files.
+  static inline constexpr uint32_t magic = 0x56415354; // "VAST"
+
+  /// The current version of the partition file format.
+  static inline constexpr uint32_t version = 1;
+
+  // -- factory functions ------------------------------------------------------
+
+  /// Reads the table of contents of a partition file.
+  /// @param chunk The (memory-mapped) file contents.
+  /// @returns the partition file or an error if the contents are malformed.
+  static caf::expected<partition_file> make(chunk_ptr chunk);
+
+  /// Writes a partition file by concatenating existing column index files.
+  /// @param filename The file to write.
+  /// @param tables The table of contents. The column ranges get computed.
+  /// @param columns The column index files of each table, indexed by type
+  ///                digest and column. Missing files result in empty ranges.
+  /// @returns an error if I/O operations fail.
+  static caf::error
+  write(const path& filename, table_map tables,
+        const caf::detail::unordered_flat_map<std::string, std::vector<path>>&
+          columns);
+
+  /// @returns the file name of the consolidated partition for the partition
+  ///          directory `dir`.
+  static path filename(const path& dir);
+
+  // -- properties -------------------------------------------------------------
+
+  /// @returns the table of contents.
+  const table_map& tables() const noexcept {
+    return tables_;
+  }
+
+  /// @returns the number of bytes of the entire file.
+  size_t size() const noexcept {
+    return chunk_->size();
+  }
+
+  /// @returns the table for the layout with type digest `digest` or `nullptr`
+  ///          if the partition has no such table.
+  const table* find(const std::string& digest) const;
+
+  /// @returns a slice of the serialized index for `column` of `x` or `nullptr`
+  ///          if the column has no persistent state.
+  /// @pre `column < x.columns.size()`
+  chunk_ptr column(const table& x, size_t column) const;
+
+private:
+  partition_file() = default;
+
+  /// The file contents.
+  chunk_ptr chunk_;
+
+  /// The byte offset of the first column index.
+  size_t payload_offset_ = 0;
+
+  /// The table of contents.
+  table_map tables_;
+};
+
+/// @relates partition_file::column_range
+template <class Inspector>
+auto inspect(Inspector& f, partition_file::column_range& x) {
+  return f(x.offset, x.size);
+}
+
+/// @relates partition_file::table
+template <class Inspector>
+auto inspect(Inspector& f, partition_file::table& x) {
+  return f(x.layout, x.row_ids, x.columns);
+}
+
+} // namespace vast::system
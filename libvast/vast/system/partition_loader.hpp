@@ -0,0 +1,32 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <caf/fwd.hpp>
+
+#include "vast/filesystem.hpp"
+#include "vast/system/partition.hpp"
+
+namespace vast::system {
+
+/// Reads partition meta data from disk on behalf of the INDEX, which keeps
+/// answering queries and ingesting events while the I/O is in progress.
+/// Responds to `(load_atom, path)` with the ::partition::meta_data of the
+/// partition in the given directory. Consolidates completely persisted
+/// partitions into a single file on `(persist_atom, path)`.
+/// @param self The actor handle.
+/// @returns the initial behavior of the PARTITION LOADER.
+caf::behavior partition_loader(caf::event_based_actor* self);
+
+} // namespace vast::system
@@ -42,6 +42,11 @@ struct query_supervisor_state {
   std::string name;
 };
 
+/// Relays a query to the EVALUATOR actors of a query map. Registers itself
+/// at the master with a `worker_atom` on launch and after all EVALUATOR actors
+/// responded, which also signals completion of the previous assignment.
+/// @param self The actor handle.
+/// @param master The actor that assigns work.
 caf::behavior
 query_supervisor(caf::stateful_actor<query_supervisor_state>* self,
                  caf::actor master);
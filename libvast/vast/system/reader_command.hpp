@@ -16,6 +16,7 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <caf/config_value.hpp>
 #include <caf/io/middleman.hpp>
@@ -100,13 +101,37 @@ caf::message reader_command(const command& cmd, caf::actor_system& sys,
     }
   } else {
     auto uds = get_or(options, category + ".uds", false);
-    auto in = detail::make_input_stream(*file, uds);
-    if (!in)
-      return caf::make_message(std::move(in.error()));
-    Reader reader{slice_type, std::move(*in)};
-    auto src = sys.spawn(source<Reader>, std::move(reader), factory, slice_size,
-                         max_events);
-    return source_command(cmd, sys, std::move(src), options, first, last);
+    std::vector<std::string> inputs{*file};
+    if (!uds) {
+      auto xs = expand_inputs(*file);
+      if (!xs)
+        return caf::make_message(std::move(xs.error()));
+      inputs = std::move(*xs);
+    }
+    // Each source counts its own events, so a limit can only apply to a
+    // single input.
+    if (max_events && inputs.size() > 1)
+      return caf::make_message(make_error(
+        ec::invalid_configuration,
+        "cannot limit the number of events when reading multiple files"));
+    // The source supervisor owns this factory, so capture everything but the
+    // actor system by value.
+    caf::optional<size_t> limit;
+    if (max_events)
+      limit = *max_events;
+    auto make_source
+      = [&sys, uds, slice_type, factory, slice_size,
+         limit](const std::string& input) -> caf::expected<caf::actor> {
+      auto in = detail::make_input_stream(input, uds);
+      if (!in)
+        return std::move(in.error());
+      Reader reader{slice_type, std::move(*in)};
+      return sys.spawn(source<Reader>, std::move(reader), factory, slice_size,
+                       limit);
+    };
+    auto jobs = defaults::import::jobs(options);
+    return source_command(cmd, sys, std::move(inputs), std::move(make_source),
+                          jobs, options, first, last);
   }
 }
 
@@ -23,10 +23,13 @@
 #include <caf/event_based_actor.hpp>
 #include <caf/stateful_actor.hpp>
 
+#include "vast/bitmap_algorithms.hpp"
 #include "vast/concept/printable/stream.hpp"
 #include "vast/concept/printable/vast/uuid.hpp"
 #include "vast/event.hpp"
 #include "vast/format/writer.hpp"
+#include "vast/ids.hpp"
+#include "vast/table_slice.hpp"
 #include "vast/system/accountant.hpp"
 #include "vast/system/atoms.hpp"
 #include "vast/system/instrumentation.hpp"
@@ -76,6 +79,15 @@ caf::behavior sink(caf::stateful_actor<sink_state<Writer>>* self,
       self->quit(msg.reason);
     }
   );
+  auto flush_if_due = [=] {
+    auto& st = self->state;
+    auto now = steady_clock::now();
+    if (now - st.last_flush > st.flush_interval) {
+      st.writer.flush();
+      st.last_flush = now;
+      st.send_report();
+    }
+  };
   return {
     [=](const std::vector<event>& xs) {
       VAST_DEBUG(self, "got:", xs.size(), "events from",
@@ -97,12 +109,40 @@ caf::behavior sink(caf::stateful_actor<sink_state<Writer>>* self,
         }
       }
       t.stop(xs.size());
-      auto now = steady_clock::now();
-      if (now - st.last_flush > st.flush_interval) {
-        st.writer.flush();
-        st.last_flush = now;
+      flush_if_due();
+    },
+    [=](const table_slice_ptr& slice, const ids& selection) {
+      auto& st = self->state;
+      // Restrict the selection to the rows of the slice.
+      ids xs{slice->offset(), false};
+      xs.append_bits(true, slice->rows());
+      xs &= selection;
+      auto n = rank(xs);
+      VAST_DEBUG(self, "got:", n, "events from", self->current_sender());
+      if (n == 0)
+        return;
+      // Cut the selection short if it exceeds the maximum number of events.
+      auto capped = st.max_events > 0 && st.processed + n >= st.max_events;
+      if (capped) {
+        n = st.max_events - st.processed;
+        xs &= ids(select(xs, n) + 1, true);
+      }
+      auto t = timer::start(st.measurement);
+      auto r = st.writer.write(*slice, xs);
+      if (!r) {
+        VAST_ERROR(self, self->system().render(r.error()));
+        self->quit(r.error());
+        return;
+      }
+      st.processed += n;
+      t.stop(n);
+      if (capped) {
+        VAST_INFO(self, "reached max_events:", st.max_events, "events");
         st.send_report();
+        self->quit();
+        return;
       }
+      flush_if_due();
     },
     [=](const uuid& id, const query_status&) {
       VAST_IGNORE_UNUSED(id);
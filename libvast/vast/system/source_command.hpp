@@ -13,8 +13,16 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
+#include <caf/expected.hpp>
+#include <caf/fwd.hpp>
+
 #include "vast/command.hpp"
 
+#include "vast/system/source_supervisor.hpp"
+
 namespace vast::system {
 
 /// Format-independent implementation for import sub-commands.
@@ -23,4 +31,27 @@ caf::message source_command(const command& cmd, caf::actor_system& sys,
                             command::argument_iterator first,
                             command::argument_iterator last);
 
+/// Format-independent implementation for import sub-commands that read
+/// several inputs. Spawns a source per input, of which up to *jobs* stream
+/// into the importer at the same time.
+/// @param inputs The inputs to read.
+/// @param make_source Spawns the source for an input.
+/// @param jobs The maximum number of sources running in parallel.
+caf::message source_command(const command& cmd, caf::actor_system& sys,
+                            std::vector<std::string> inputs,
+                            source_factory make_source, size_t jobs,
+                            caf::settings& options,
+                            command::argument_iterator first,
+                            command::argument_iterator last);
+
+/// Expands the input of an import into the files to read. A directory
+/// expands to the regular files it contains, and a path whose last component
+/// contains the wildcards `*` or `?` expands to the regular files matching
+/// the glob pattern.
+/// @param input The path or pattern to expand.
+/// @returns the sorted list of files, or *input* itself if it is neither a
+///          directory nor a pattern.
+caf::expected<std::vector<std::string>>
+expand_inputs(const std::string& input);
+
 } // namespace vast::system
@@ -0,0 +1,97 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <caf/actor.hpp>
+#include <caf/expected.hpp>
+#include <caf/optional.hpp>
+#include <caf/stateful_actor.hpp>
+
+#include "vast/expression.hpp"
+#include "vast/schema.hpp"
+
+#include "vast/system/accountant.hpp"
+
+namespace vast::system {
+
+/// Spawns the source actor for a single input of an import.
+using source_factory
+  = std::function<caf::expected<caf::actor>(const std::string& input)>;
+
+struct source_supervisor_state {
+  // -- member variables -------------------------------------------------------
+
+  /// The inputs to read.
+  std::vector<std::string> inputs;
+
+  /// The position of the next input to read.
+  size_t next = 0;
+
+  /// Spawns the source for an input.
+  source_factory make_source;
+
+  /// The maximum number of sources running in parallel.
+  size_t jobs = 1;
+
+  /// The sources that currently stream into the importer.
+  std::vector<caf::actor> sources;
+
+  /// The importer that receives the table slices of all sources.
+  caf::actor importer;
+
+  /// An alternate schema for all sources.
+  caf::optional<vast::schema> schema;
+
+  /// A filter expression for all sources.
+  caf::optional<expression> expr;
+
+  /// The accountant for all sources, if available.
+  accountant_type accountant;
+
+  /// Whether to wait for the importer to flush after all sources finished.
+  bool blocking = false;
+
+  static inline const char* name = "source-supervisor";
+};
+
+/// Reads several inputs of an import by spawning a source per input, of which
+/// up to *jobs* stream into the importer at the same time. Spawns a new source
+/// whenever a source terminates and quits after all inputs are read. In
+/// blocking mode, quits only after the importer flushed. Quits with the error
+/// of *make_source* if spawning a source fails, and terminates all running
+/// sources when exiting.
+/// @param self The actor handle.
+/// @param inputs The inputs to read.
+/// @param make_source Spawns the source for an input.
+/// @param jobs The maximum number of sources running in parallel.
+/// @param importer The importer that receives the table slices.
+/// @param schema An alternate schema for all sources.
+/// @param expr A filter expression for all sources.
+/// @param accountant The accountant for all sources, if available.
+/// @param blocking Whether to wait for the importer to flush.
+/// @returns the initial behavior of the SOURCE SUPERVISOR.
+caf::behavior
+source_supervisor(caf::stateful_actor<source_supervisor_state>* self,
+                  std::vector<std::string> inputs, source_factory make_source,
+                  size_t jobs, caf::actor importer,
+                  caf::optional<vast::schema> schema,
+                  caf::optional<expression> expr, accountant_type accountant,
+                  bool blocking);
+
+} // namespace vast::system
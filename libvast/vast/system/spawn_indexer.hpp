@@ -36,4 +36,19 @@ caf::actor spawn_indexer(caf::local_actor* parent, path dir, type column_type,
                          size_t column, caf::actor index, uuid partition_id,
                          atomic_measurement* m);
 
+/// Spawns an INDEXER actor for a column of a sealed partition.
+/// @param parent The parent actor.
+/// @param state The serialized column index or `nullptr` for an empty index.
+/// @param column_type The type of the indexed field.
+/// @param column The column ID for the indexed field.
+/// @param index A handle to the index actor.
+/// @param partition_id The partition ID that this INDEXER belongs to.
+/// @param m A pointer to the measuring probe used for perfomance data
+///        accumulation.
+/// @returns the new INDEXER actor.
+caf::actor spawn_sealed_indexer(caf::local_actor* parent, chunk_ptr state,
+                                type column_type, size_t column,
+                                caf::actor index, uuid partition_id,
+                                atomic_measurement* m);
+
 } // namespace vast::system
@@ -30,6 +30,7 @@
 #include "vast/ids.hpp"
 #include "vast/system/fwd.hpp"
 #include "vast/system/instrumentation.hpp"
+#include "vast/system/partition_file.hpp"
 #include "vast/type.hpp"
 
 namespace vast::system {
@@ -52,7 +53,8 @@ public:
 
   // -- persistence ------------------------------------------------------------
 
-  /// Loads state from disk.
+  /// Loads state from disk, or from the consolidated file of a sealed
+  /// partition.
   caf::error init();
 
   /// Persists all indexes to disk.
@@ -123,6 +125,11 @@ public:
   /// @returns the file name for `column`.
   path column_file(size_t column) const;
 
+  /// @returns the file name for `column` of `layout` in the table directory
+  ///          `base_dir`.
+  static path column_file(const path& base_dir, const record_type& layout,
+                          size_t column);
+
   /// Indexes a slice for all columns.
   /// @param x Table slice for ingestion.
   void add(const table_slice_ptr& x);
@@ -165,6 +172,9 @@ private:
   /// Stores IDs of skipped columns.
   bitvector<> skip_mask_;
 
+  /// Points to the table of contents entry if the parent partition is sealed.
+  const partition_file::table* sealed_;
+
   friend struct index_state;
 };
 
@@ -75,7 +75,12 @@ public:
   // -- visitation -------------------------------------------------------------
 
   /// Appends all values in column `col` to `idx`.
-  virtual void append_column_to_index(size_type col, value_index& idx) const;
+  void append_column_to_index(size_type col, value_index& idx) const;
+
+  /// Appends all values in column `col` to `idx`, where the first row has the
+  /// positional identifier `first` instead of `offset()`.
+  virtual void append_column_to_index(size_type col, value_index& idx,
+                                      id first) const;
 
   // -- properties -------------------------------------------------------------
 
@@ -189,4 +194,14 @@ caf::error inspect(caf::serializer& sink, table_slice_ptr& ptr);
 /// @relates table_slice
 caf::error inspect(caf::deserializer& source, table_slice_ptr& ptr);
 
+/// Serializes a table slice like `inspect`, but omits the layout. Containers
+/// of many table slices use this to store each layout only once. Use
+/// `factory<table_slice>::traits::make(chunk, layout)` to restore the slice.
+/// @param sink The serializer to write to.
+/// @param ptr The table slice to serialize.
+/// @pre `ptr != nullptr`
+/// @relates table_slice
+caf::error serialize_without_layout(caf::serializer& sink,
+                                    const table_slice_ptr& ptr);
+
 } // namespace vast
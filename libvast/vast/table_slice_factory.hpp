@@ -45,6 +45,13 @@ struct factory_traits<table_slice> {
   /// calls `table_slice::load` on the chunk.
   /// @returns a table slice loaded from *chunk* or `nullptr` on failure.
   static result_type make(chunk_ptr chunk);
+
+  /// Constructs a table slice from a chunk written by
+  /// `serialize_without_layout`.
+  /// @param chunk The chunk holding the table slice.
+  /// @param layout The layout of the table slice.
+  /// @returns a table slice loaded from *chunk* or `nullptr` on failure.
+  static result_type make(chunk_ptr chunk, record_type layout);
 };
 
 } // namespace vast
@@ -0,0 +1,100 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include <caf/expected.hpp>
+#include <caf/optional.hpp>
+
+#include "vast/expression.hpp"
+#include "vast/fwd.hpp"
+#include "vast/ids.hpp"
+#include "vast/type.hpp"
+#include "vast/view.hpp"
+
+namespace vast {
+
+/// A predicate program that checks the rows of table slices with a given
+/// layout against an expression. Construction tailors the expression to the
+/// layout once and resolves all extractors into column indexes. Evaluation
+/// runs one predicate at a time over a column, restricted to the rows that
+/// can still change the outcome: conjunctions only pass on the rows that
+/// survived the previous operand, and disjunctions only the rows that no
+/// previous operand matched.
+class table_slice_filter {
+public:
+  /// Compiles an expression for table slices with a given layout.
+  /// @param expr The expression to check.
+  /// @param layout The layout of the table slices to filter.
+  /// @returns the filter or an error if *expr* cannot be tailored to *layout*.
+  static caf::expected<table_slice_filter> make(const expression& expr,
+                                                record_type layout);
+
+  /// Selects the candidate rows of a table slice that fulfill the expression.
+  /// @param slice The table slice to filter.
+  /// @param candidates The IDs of the rows to check. IDs outside of *slice*
+  ///                   do not contribute to the result.
+  /// @returns the subset of *candidates* within *slice* that fulfills the
+  ///          expression.
+  /// @pre `slice.layout() == layout()`
+  ids operator()(const table_slice& slice, const ids& candidates) const;
+
+  /// @returns the expression tailored to the layout.
+  const expression& expr() const;
+
+  /// @returns the layout of the table slices to filter.
+  const record_type& layout() const;
+
+private:
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  enum class node_kind {
+    constant,
+    conjunction,
+    disjunction,
+    negation,
+    predicate
+  };
+
+  struct node {
+    node_kind kind;
+    std::vector<size_t> children;
+    /// The outcome of a constant.
+    bool value = false;
+    /// The column of a predicate, or `npos` to check the entire row.
+    size_t column = npos;
+    /// Checks a single value of a predicate.
+    std::function<bool(data_view)> check;
+    /// Selects the matching rows of the entire column of a predicate at
+    /// once, if the slice supports it.
+    std::function<caf::optional<ids>(const table_slice&, size_t)> scan;
+  };
+
+  struct compiler;
+
+  table_slice_filter() = default;
+
+  /// Evaluates a node over the candidate rows of a slice.
+  ids evaluate(size_t i, const table_slice& slice, const ids& xs) const;
+
+  expression expr_;
+  record_type layout_;
+  std::vector<node> nodes_;
+};
+
+} // namespace vast
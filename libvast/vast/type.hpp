@@ -813,6 +813,12 @@ inline bool has_skip_attribute(const type& t) {
   return has_attribute(t, "skip");
 }
 
+/// Finds the field that holds the event timestamp.
+/// @param layout The record type to search.
+/// @returns the index of the first field of *layout* with a "time" attribute.
+/// @relates has_attribute record_type
+caf::optional<size_t> find_time_column(const record_type& layout);
+
 /// @relates type
 bool convert(const type& t, json& j);
 
@@ -14,12 +14,18 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include <caf/deserializer.hpp>
 #include <caf/error.hpp>
 #include <caf/serializer.hpp>
+#include <caf/variant.hpp>
 
 #include "vast/ewah_bitmap.hpp"
 #include "vast/ids.hpp"
@@ -31,6 +37,7 @@
 #include "vast/die.hpp"
 #include "vast/error.hpp"
 #include "vast/expected.hpp"
+#include "vast/span.hpp"
 #include "vast/type.hpp"
 #include "vast/value_index_factory.hpp"
 #include "vast/view.hpp"
@@ -51,6 +58,16 @@ public:
 
   using size_type = typename ids::size_type;
 
+  /// A contiguous sequence of values of a fixed-width type.
+  using value_span = caf::variant<
+    span<const boolean>,
+    span<const integer>,
+    span<const count>,
+    span<const real>,
+    span<const timespan>,
+    span<const timestamp>
+  >;
+
   /// Appends a data value.
   /// @param x The data to append to the index.
   /// @returns `true` if appending succeeded.
@@ -62,6 +79,17 @@ public:
   /// @returns `true` if appending succeeded.
   expected<void> append(data_view x, id pos);
 
+  /// Appends a sequence of values at consecutive positions in bulk. Indexes
+  /// for arithmetic values transpose the values in blocks of 64 and append
+  /// whole words to their bitmaps, all other indexes append value by value.
+  /// @param xs The values to append.
+  /// @param validity One bit per value, where the *i*-th bit of
+  ///                 `validity[i / 64]` is set iff `xs[i]` is not nil.
+  /// @param first The positional identifier of the first value in *xs*.
+  /// @returns `true` if appending succeeded.
+  expected<void> append(value_span xs, span<const uint64_t> validity,
+                        id first);
+
   /// Looks up data under a relational operator. If the value to look up is
   /// `nil`, only `==` and `!=` are valid operations. The concrete index
   /// type determines validity of other values.
@@ -70,10 +98,18 @@ public:
   /// @returns The result of the lookup or an error upon failure.
   expected<ids> lookup(relational_operator op, data_view x) const;
 
-  /// Merges another value index with this one.
+  /// Appends the contents of another value index of the same type, whose
+  /// positions are relative to *first*, i.e., position *i* in *other* becomes
+  /// position `first + i` in this index.
   /// @param other The value index to merge.
-  /// @returns `true` on success.
-  //bool merge(const value_index& other);
+  /// @param first The position of the first row of *other* in this index.
+  /// @returns An error if the indexes have different types or if the
+  ///          concrete index does not support merging.
+  /// @pre `mergeable()`
+  expected<void> merge(const value_index& other, id first);
+
+  /// @returns `true` iff the concrete index supports `merge`.
+  virtual bool mergeable() const;
 
   /// Retrieves the ID of the last append operation.
   /// @returns The largest ID in the index.
@@ -91,9 +127,19 @@ public:
 private:
   virtual bool append_impl(data_view x, id pos) = 0;
 
+  /// Appends the non-nil values of a sequence. The default implementation
+  /// calls `append_impl` for each value. Implementations must not modify the
+  /// index if they return `false`.
+  virtual bool
+  bulk_append_impl(const value_span& xs, const uint64_t* validity, id first);
+
   virtual expected<ids>
   lookup_impl(relational_operator op, data_view x) const = 0;
 
+  /// Appends the concrete state of *other* at position *first*. The default
+  /// implementation fails.
+  virtual bool merge_impl(const value_index& other, id first);
+
   ewah_bitmap mask_;
   ewah_bitmap none_;
   const vast::type type_;
@@ -224,6 +270,10 @@ public:
                             [&] { return source(bmi_); });
   }
 
+  bool mergeable() const override {
+    return true;
+  }
+
 private:
   bool append_impl(data_view d, id pos) override {
     auto append = [&](auto x) {
@@ -242,6 +292,42 @@ private:
     ), d);
   }
 
+  bool bulk_append_impl(const value_span& xs, const uint64_t* validity,
+                        id first) override {
+    auto rep = [](auto x) {
+      using input_type = decltype(x);
+      if constexpr (std::is_same_v<input_type, timespan>)
+        return x.count();
+      else if constexpr (std::is_same_v<input_type, timestamp>)
+        return x.time_since_epoch().count();
+      else
+        return x;
+    };
+    auto ys = caf::get_if<span<const T>>(&xs);
+    if (ys == nullptr)
+      return false;
+    bmi_.skip(first - bmi_.size());
+    auto n = static_cast<size_t>(ys->size());
+    std::array<value_type, 64> block{};
+    for (size_t i = 0; i < n; i += 64) {
+      auto m = std::min(n - i, size_t{64});
+      auto mask = validity[i / 64];
+      for (size_t j = 0; j < m; ++j)
+        block[j] = static_cast<value_type>(rep((*ys)[i + j]));
+      bmi_.append_block(block.data(), m, mask);
+    }
+    return true;
+  }
+
+  bool merge_impl(const value_index& other, id first) override {
+    auto x = dynamic_cast<const arithmetic_index*>(&other);
+    if (x == nullptr)
+      return false;
+    bmi_.skip(first - bmi_.size());
+    bmi_.append(x->bmi_);
+    return true;
+  }
+
   expected<ids>
   lookup_impl(relational_operator op, data_view d) const override {
     return caf::visit(detail::overload(
@@ -279,6 +365,8 @@ public:
 
   caf::error deserialize(caf::deserializer& source) override;
 
+  bool mergeable() const override;
+
 private:
   /// The index which holds each character.
   using char_bitmap_index = bitmap_index<uint8_t, bitslice_coder<ewah_bitmap>>;
@@ -291,6 +379,8 @@ private:
 
   bool append_impl(data_view x, id pos) override;
 
+  bool merge_impl(const value_index& other, id first) override;
+
   expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
@@ -299,6 +389,89 @@ private:
   std::vector<char_bitmap_index> chars_;
 };
 
+/// An index for strings that interns each distinct value in a dictionary and
+/// maps it to a single bitmap, which makes equality lookups a constant-time
+/// bitmap fetch and the index size proportional to the number of distinct
+/// values. Once the dictionary holds *max_cardinality* values, previously
+/// unseen strings fall into one of *num_buckets* hashed buckets. Lookups for
+/// such strings may contain false positives. Hash indexes do not support
+/// `merge`, because the buckets of another index lose the information which
+/// value a row held.
+class hash_index : public value_index {
+public:
+  /// Constructs a hash index.
+  /// @param t An instance of `string_type`.
+  /// @param max_cardinality The maximum number of distinct values to keep in
+  ///                        the dictionary.
+  /// @param num_buckets The number of hash buckets for values that exceed
+  ///                    the dictionary capacity.
+  explicit hash_index(vast::type t, size_t max_cardinality = 1 << 16,
+                      size_t num_buckets = 1024);
+
+  /// @returns the number of distinct values in the dictionary.
+  size_t cardinality() const;
+
+  caf::error serialize(caf::serializer& sink) const override;
+
+  caf::error deserialize(caf::deserializer& source) override;
+
+private:
+  /// Locates the bitmap for a string.
+  /// @param x The string to look up.
+  /// @param exact Set to `true` iff the result contains exactly the rows
+  ///              equal to *x*.
+  /// @returns The bitmap for *x* or `nullptr` if *x* never occurred.
+  const ids* find(std::string_view x, bool& exact) const;
+
+  size_t bucket(std::string_view x) const;
+
+  bool append_impl(data_view x, id pos) override;
+
+  expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  size_t max_cardinality_;
+  size_t num_buckets_;
+  std::unordered_map<std::string, uint32_t> dictionary_;
+  std::vector<ids> bitmaps_;
+  std::vector<ids> buckets_;
+};
+
+/// An index for strings that keeps one posting bitmap per trigram. Substring
+/// and pattern lookups decompose their argument into required trigrams and
+/// intersect the corresponding postings, which yields a superset of the
+/// matching rows. Equality lookups use trigrams delimited by begin and end
+/// markers.
+class trigram_index : public value_index {
+public:
+  /// Constructs a trigram index.
+  /// @param t An instance of `string_type`.
+  /// @param max_length The maximum string length to index. Rows with longer
+  ///                   strings are candidates for every substring lookup.
+  explicit trigram_index(vast::type t, size_t max_length = 1024);
+
+  caf::error serialize(caf::serializer& sink) const override;
+
+  caf::error deserialize(caf::deserializer& source) override;
+
+  bool mergeable() const override;
+
+private:
+  /// Intersects the postings of a set of trigrams.
+  ids intersect(const std::vector<uint32_t>& grams) const;
+
+  bool append_impl(data_view x, id pos) override;
+
+  bool merge_impl(const value_index& other, id first) override;
+
+  expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  size_t max_length_;
+  std::unordered_map<uint32_t, ids> postings_;
+  ids truncated_;
+};
+
 /// An index for IP addresses.
 class address_index : public value_index {
 public:
@@ -311,11 +484,15 @@ public:
 
   caf::error deserialize(caf::deserializer& source) override;
 
+  bool mergeable() const override;
+
 private:
   void init();
 
   bool append_impl(data_view x, id pos) override;
 
+  bool merge_impl(const value_index& other, id first) override;
+
   expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
@@ -334,11 +511,15 @@ public:
 
   caf::error deserialize(caf::deserializer& source) override;
 
+  bool mergeable() const override;
+
 private:
   void init();
 
   bool append_impl(data_view x, id pos) override;
 
+  bool merge_impl(const value_index& other, id first) override;
+
   expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
@@ -367,11 +548,15 @@ public:
 
   caf::error deserialize(caf::deserializer& source) override;
 
+  bool mergeable() const override;
+
 private:
   void init();
 
   bool append_impl(data_view x, id pos) override;
 
+  bool merge_impl(const value_index& other, id first) override;
+
   expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
@@ -396,11 +581,15 @@ public:
 
   caf::error deserialize(caf::deserializer& source) override;
 
+  bool mergeable() const override;
+
 private:
   void init();
 
   bool append_impl(data_view x, id pos) override;
 
+  bool merge_impl(const value_index& other, id first) override;
+
   expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "vast/bitmap_base.hpp"
 #include "vast/bitvector.hpp"
 #include "vast/word.hpp"
@@ -144,6 +146,33 @@ private:
 
 wah_bitmap_range bit_range(const wah_bitmap& bm);
 
+// The following overloads operate directly on the block vectors: they skip
+// fill words in bulk and combine literal words with vector instructions.
+
+/// @relates wah_bitmap
+wah_bitmap binary_and(const wah_bitmap& lhs, const wah_bitmap& rhs);
+
+/// @relates wah_bitmap
+wah_bitmap binary_or(const wah_bitmap& lhs, const wah_bitmap& rhs);
+
+/// @relates wah_bitmap
+wah_bitmap binary_xor(const wah_bitmap& lhs, const wah_bitmap& rhs);
+
+/// @relates wah_bitmap
+wah_bitmap binary_nand(const wah_bitmap& lhs, const wah_bitmap& rhs);
+
+/// Computes the bitwise AND of multiple bitmaps in a single pass.
+/// @relates wah_bitmap
+wah_bitmap nary_and(const std::vector<const wah_bitmap*>& xs);
+
+/// Computes the bitwise OR of multiple bitmaps in a single pass.
+/// @relates wah_bitmap
+wah_bitmap nary_or(const std::vector<const wah_bitmap*>& xs);
+
+/// Computes the bitwise XOR of multiple bitmaps in a single pass.
+/// @relates wah_bitmap
+wah_bitmap nary_xor(const std::vector<const wah_bitmap*>& xs);
+
 } // namespace vast
 
 
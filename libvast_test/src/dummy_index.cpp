@@ -45,7 +45,8 @@ actor spawn_dummy_indexer(local_actor* self, path, type, size_t, caf::actor,
 
 behavior dummy_index_actor(stateful_actor<index_state>* self,
                            path dir) {
-  self->state.init(std::move(dir), std::numeric_limits<size_t>::max(), 10, 5);
+  self->state.init(std::move(dir), std::numeric_limits<size_t>::max(),
+                   std::numeric_limits<size_t>::max(), 5);
   self->state.factory = spawn_dummy_indexer;
   return {[](std::function<void()> f) { f(); }};
 }
@@ -0,0 +1,130 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <caf/message_builder.hpp>
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/ewah_bitmap.hpp"
+#include "vast/wah_bitmap.hpp"
+
+#include "vast/detail/bitwise.hpp"
+
+using namespace caf;
+using namespace std;
+using namespace std::chrono;
+using namespace vast;
+
+namespace {
+
+template <class F>
+auto measure(size_t iterations, F f) {
+  auto start = steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    f();
+  auto total = duration_cast<microseconds>(steady_clock::now() - start);
+  return total.count() / iterations;
+}
+
+// Generates a bitmap of alternating runs of 0s and random literals.
+// *density* is the fraction of 1-bits within literals, and *clean* is the
+// fraction of bits in runs.
+template <class Bitmap>
+Bitmap make_bitmap(std::mt19937_64& gen, size_t rows, double density,
+                   double clean) {
+  std::bernoulli_distribution bit{density};
+  std::bernoulli_distribution run{clean};
+  Bitmap result;
+  while (result.size() < rows) {
+    auto n = std::min(size_t{4096}, rows - result.size());
+    if (run(gen)) {
+      result.append_bits(false, n);
+    } else {
+      for (size_t i = 0; i < n; ++i)
+        result.append_bit(bit(gen));
+    }
+  }
+  return result;
+}
+
+template <class Bitmap>
+void run(const std::string& name, const std::string& input, size_t rows,
+         double density, double clean, size_t fan_in, size_t iterations) {
+  std::mt19937_64 gen{42};
+  std::vector<Bitmap> xs;
+  for (size_t i = 0; i < fan_in; ++i)
+    xs.push_back(make_bitmap<Bitmap>(gen, rows, density, clean));
+  auto& x = xs[0];
+  auto& y = xs[1];
+  auto report = [&](const char* op, auto generic, auto kernel) {
+    auto t0 = measure(iterations, generic);
+    auto t1 = measure(iterations, kernel);
+    cout << name << '\t' << input << '\t' << op << "\tgeneric " << t0
+         << "us\tkernel " << t1 << "us" << endl;
+  };
+  report("and", [&] { return binary_and<Bitmap, Bitmap>(x, y); },
+         [&] { return binary_and(x, y); });
+  report("or", [&] { return binary_or<Bitmap, Bitmap>(x, y); },
+         [&] { return binary_or(x, y); });
+  report("xor", [&] { return binary_xor<Bitmap, Bitmap>(x, y); },
+         [&] { return binary_xor(x, y); });
+  report("nand", [&] { return binary_nand<Bitmap, Bitmap>(x, y); },
+         [&] { return binary_nand(x, y); });
+  auto pairwise_or = [](const Bitmap& lhs, const Bitmap& rhs) {
+    return binary_or<Bitmap, Bitmap>(lhs, rhs);
+  };
+  report("nary_or", [&] { return nary_eval(xs.begin(), xs.end(), pairwise_or); },
+         [&] { return nary_or(xs.begin(), xs.end()); });
+}
+
+template <class Bitmap>
+void run_all(const std::string& name, size_t rows, size_t fan_in,
+             size_t iterations) {
+  run<Bitmap>(name, "dense", rows, 0.5, 0.0, fan_in, iterations);
+  run<Bitmap>(name, "sparse", rows, 0.001, 0.9, fan_in, iterations);
+  run<Bitmap>(name, "mixed", rows, 0.1, 0.5, fan_in, iterations);
+}
+
+} // namespace <anonymous>
+
+// Compares the generic binary_eval and nary_eval algorithms with the kernels
+// that operate directly on the blocks of EWAH and WAH bitmaps.
+int main(int argc, char** argv) {
+  size_t rows = 1'000'000;
+  size_t fan_in = 16;
+  size_t iterations = 10;
+  auto r = message_builder{argv + 1, argv + argc}.extract_opts({
+    {"rows,r", "number of bits per bitmap", rows},
+    {"fan-in,f", "number of bitmaps for n-ary operations", fan_in},
+    {"iterations,i", "number of iterations per operation", iterations},
+  });
+  if (r.opts.count("help") > 0) {
+    cout << r.helptext;
+    return 0;
+  }
+  if (!r.error.empty()) {
+    cerr << r.error << endl;
+    return 1;
+  }
+  fan_in = std::max(fan_in, size_t{2});
+  cout << "avx2 " << (detail::bitwise_uses_avx2() ? "yes" : "no") << endl;
+  run_all<ewah_bitmap>("ewah", rows, fan_in, iterations);
+  run_all<wah_bitmap>("wah", rows, fan_in, iterations);
+  return 0;
+}
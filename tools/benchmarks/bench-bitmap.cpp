@@ -0,0 +1,141 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <caf/message_builder.hpp>
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/ewah_bitmap.hpp"
+#include "vast/roaring_bitmap.hpp"
+
+using namespace caf;
+using namespace std;
+using namespace std::chrono;
+using namespace vast;
+
+namespace {
+
+size_t memory_usage(const ewah_bitmap& bm) {
+  return bm.blocks().size() * sizeof(ewah_bitmap::block_type);
+}
+
+size_t memory_usage(const roaring_bitmap& bm) {
+  size_t result = 0;
+  for (auto& c : bm.containers())
+    result += sizeof(c) + c.values.size() * sizeof(uint16_t)
+              + c.words.size() * sizeof(roaring_bitmap::block_type);
+  return result;
+}
+
+template <class F>
+auto measure(size_t iterations, F f) {
+  auto start = steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    f();
+  auto total = duration_cast<microseconds>(steady_clock::now() - start);
+  return total.count() / iterations;
+}
+
+// Generates bitmaps that resemble the output of value indexes: a few dense
+// masks with long runs, like the ones of type or time range lookups, and
+// many sparse hit lists, like the ones of equality lookups.
+template <class Bitmap>
+struct workload {
+  workload(size_t rows, size_t num_sparse, double density) {
+    std::mt19937_64 gen{42};
+    std::bernoulli_distribution hit{density};
+    std::geometric_distribution<size_t> run{1.0 / 50'000};
+    // A mask of alternating runs.
+    auto bit = false;
+    while (mask.size() < rows) {
+      auto n = std::min(run(gen) + 1, rows - mask.size());
+      mask.append_bits(bit, n);
+      bit = !bit;
+    }
+    // Sparse hit lists.
+    for (size_t i = 0; i < num_sparse; ++i) {
+      Bitmap bm;
+      for (size_t j = 0; j < rows; ++j)
+        bm.append_bit(hit(gen));
+      sparse.push_back(std::move(bm));
+    }
+  }
+
+  Bitmap mask;
+  std::vector<Bitmap> sparse;
+};
+
+template <class Bitmap>
+void run(const std::string& name, size_t rows, size_t num_sparse,
+         double density, size_t iterations) {
+  workload<Bitmap> w{rows, num_sparse, density};
+  size_t bytes = memory_usage(w.mask);
+  for (auto& bm : w.sparse)
+    bytes += memory_usage(bm);
+  cout << name << "\tmemory " << bytes / 1024 << "KiB";
+  auto t = measure(iterations, [&] {
+    auto result = w.sparse[0] & w.mask;
+    return vast::rank(result);
+  });
+  cout << "\tsparse&mask " << t << "us";
+  t = measure(iterations, [&] {
+    auto result = w.sparse[0] - w.mask;
+    return vast::rank(result);
+  });
+  cout << "\tsparse-mask " << t << "us";
+  t = measure(iterations, [&] {
+    auto result = nary_or(w.sparse.begin(), w.sparse.end());
+    return vast::rank(result);
+  });
+  cout << "\tnary_or " << t << "us";
+  t = measure(iterations, [&] {
+    size_t result = 0;
+    for (size_t i = 1; i <= 1000; ++i)
+      result += vast::select(w.sparse[0], i * 7);
+    return result;
+  });
+  cout << "\tselect " << t << "us" << endl;
+}
+
+} // namespace <anonymous>
+
+// Compares EWAH and roaring bitmaps on typical index workloads.
+int main(int argc, char** argv) {
+  size_t rows = 10'000'000;
+  size_t num_sparse = 16;
+  double density = 0.001;
+  size_t iterations = 10;
+  auto r = message_builder{argv + 1, argv + argc}.extract_opts({
+    {"rows,r", "number of bits per bitmap", rows},
+    {"sparse,s", "number of sparse bitmaps", num_sparse},
+    {"density,d", "fraction of 1-bits in sparse bitmaps", density},
+    {"iterations,i", "number of iterations per operation", iterations},
+  });
+  if (r.opts.count("help") > 0) {
+    cout << r.helptext;
+    return 0;
+  }
+  if (!r.error.empty()) {
+    cerr << r.error << endl;
+    return 1;
+  }
+  run<ewah_bitmap>("ewah", rows, num_sparse, density, iterations);
+  run<roaring_bitmap>("roaring", rows, num_sparse, density, iterations);
+  return 0;
+}
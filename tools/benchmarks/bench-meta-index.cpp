@@ -0,0 +1,97 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <caf/message_builder.hpp>
+
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/default_table_slice_builder.hpp"
+#include "vast/expression.hpp"
+#include "vast/factory.hpp"
+#include "vast/meta_index.hpp"
+#include "vast/synopsis_factory.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/uuid.hpp"
+
+using namespace caf;
+using namespace std;
+using namespace std::chrono;
+using namespace vast;
+
+// Measures the cost of meta index lookups against synthetic partitions. Every
+// partition covers one second of event time and a range of 1,000 counts.
+int main(int argc, char** argv) {
+  size_t num_partitions = 100'000;
+  size_t num_iterations = 100;
+  auto r = message_builder{argv + 1, argv + argc}.extract_opts({
+    {"partitions,p", "number of synthetic partitions", num_partitions},
+    {"iterations,i", "number of lookups per query", num_iterations},
+  });
+  if (r.opts.count("help") > 0) {
+    cout << r.helptext;
+    return 0;
+  }
+  if (!r.error.empty()) {
+    cerr << r.error << endl;
+    return 1;
+  }
+  factory<synopsis>::initialize();
+  meta_index meta_idx;
+  auto layout = record_type{
+    {"ts", timestamp_type{}.attributes({{"time"}})},
+    {"id", count_type{}}
+  }.name("bench");
+  auto builder = default_table_slice_builder::make(layout);
+  cerr << "generating " << num_partitions << " partitions" << endl;
+  auto start = steady_clock::now();
+  for (count i = 0; i < num_partitions; ++i) {
+    for (count j = 0; j < 2; ++j) {
+      builder->add(make_data_view(timestamp{seconds(i) + milliseconds(j)}));
+      builder->add(make_data_view(i * 1'000 + j * 999));
+    }
+    meta_idx.add(uuid::random(), *builder->finish());
+  }
+  auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+  cerr << "generated partitions in " << elapsed.count() << "ms" << endl;
+  auto queries = std::vector<std::string>{
+    "#time == 1970-01-01+12:00:00.0",
+    "#time >= 1970-01-02+03:00:00.0",
+    "#time >= 1970-01-01+01:00:00.0 && #time <= 1970-01-01+01:00:10.0",
+    "id == 4242424",
+    "id < 1000000",
+    ":count > 99999000",
+    "id == 4242424 || id == 1337",
+  };
+  for (auto& query : queries) {
+    auto expr = to<expression>(query);
+    if (!expr) {
+      cerr << "failed to parse query: " << query << endl;
+      return 1;
+    }
+    // Builds the secondary structures outside of the measurement.
+    auto candidates = meta_idx.lookup(*expr).size();
+    start = steady_clock::now();
+    for (size_t i = 0; i < num_iterations; ++i)
+      meta_idx.lookup(*expr);
+    auto total = duration_cast<nanoseconds>(steady_clock::now() - start);
+    cout << query << '\t' << candidates << " candidates\t"
+         << total.count() / 1'000 / num_iterations << "us/lookup" << endl;
+  }
+  return 0;
+}
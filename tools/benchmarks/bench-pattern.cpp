@@ -0,0 +1,86 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <caf/message_builder.hpp>
+
+#include "vast/pattern.hpp"
+
+using namespace caf;
+using namespace std;
+using namespace std::chrono;
+using namespace vast;
+
+// Measures the cost of matching patterns against synthetic domain names, and
+// compares it to compiling a std::regex per match.
+int main(int argc, char** argv) {
+  size_t num_strings = 1'000'000;
+  size_t num_baseline = 10'000;
+  auto r = message_builder{argv + 1, argv + argc}.extract_opts({
+    {"strings,n", "number of strings to match", num_strings},
+    {"baseline,b", "number of strings to match with std::regex", num_baseline},
+  });
+  if (r.opts.count("help") > 0) {
+    cout << r.helptext;
+    return 0;
+  }
+  if (!r.error.empty()) {
+    cerr << r.error << endl;
+    return 1;
+  }
+  cerr << "generating " << num_strings << " domains" << endl;
+  auto tlds = std::vector<std::string>{".com", ".org", ".net", ".io"};
+  std::mt19937_64 gen{42};
+  std::uniform_int_distribution<size_t> length{4, 24};
+  std::uniform_int_distribution<int> letter{'a', 'z'};
+  std::vector<std::string> domains;
+  domains.reserve(num_strings);
+  for (size_t i = 0; i < num_strings; ++i) {
+    std::string domain = i % 2 == 0 ? "www." : "";
+    for (auto n = length(gen); n > 0; --n)
+      domain += static_cast<char>(letter(gen));
+    domain += tlds[i % tlds.size()];
+    domains.push_back(std::move(domain));
+  }
+  num_baseline = std::min(num_baseline, num_strings);
+  auto patterns = std::vector<std::string>{
+    "www\\.[a-z]+\\.com",
+    ".*\\.(org|net)",
+    "[a-z]*xyz[a-z]*\\.io",
+    "^w{3}\\.\\w+\\.[a-z]{2,3}$",
+  };
+  for (auto& str : patterns) {
+    auto p = pattern{str};
+    size_t matches = 0;
+    auto start = steady_clock::now();
+    for (auto& domain : domains)
+      matches += p.match(domain) ? 1 : 0;
+    auto total = duration_cast<nanoseconds>(steady_clock::now() - start);
+    cout << str << '\t' << matches << " matches\tpattern "
+         << total.count() / num_strings << "ns/match";
+    start = steady_clock::now();
+    for (size_t i = 0; i < num_baseline; ++i)
+      std::regex_match(domains[i], std::regex{str});
+    total = duration_cast<nanoseconds>(steady_clock::now() - start);
+    cout << "\tstd::regex " << total.count() / num_baseline << "ns/match"
+         << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,109 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <caf/message_builder.hpp>
+
+#include "vast/span.hpp"
+#include "vast/type.hpp"
+#include "vast/value_index.hpp"
+#include "vast/value_index_factory.hpp"
+#include "vast/view.hpp"
+
+using namespace caf;
+using namespace std;
+using namespace std::chrono;
+using namespace vast;
+
+namespace {
+
+template <class F>
+auto measure(F f) {
+  auto start = steady_clock::now();
+  f();
+  return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+// Appends the same column to one index value by value and to another index in
+// bulk, and reports the throughput of both.
+template <class T, class Generator>
+void run(const std::string& name, const vast::type& t, size_t rows,
+         double nils, Generator make) {
+  std::mt19937_64 gen{42};
+  std::bernoulli_distribution nil{nils};
+  auto xs = std::make_unique<T[]>(rows);
+  std::vector<uint64_t> validity((rows + 63) / 64);
+  for (size_t i = 0; i < rows; ++i) {
+    xs[i] = make(gen);
+    if (!nil(gen))
+      validity[i / 64] |= uint64_t{1} << (i % 64);
+  }
+  auto per_value = factory<value_index>::make(t);
+  auto bulk = factory<value_index>::make(t);
+  auto t0 = measure([&] {
+    for (size_t i = 0; i < rows; ++i)
+      if ((validity[i / 64] >> (i % 64)) & 1)
+        per_value->append(make_data_view(xs[i]), i);
+      else
+        per_value->append(caf::none, i);
+  });
+  auto t1 = measure([&] {
+    auto ys = span<const T>{xs.get(), static_cast<std::ptrdiff_t>(rows)};
+    bulk->append(ys, span<const uint64_t>{validity}, 0);
+  });
+  auto rate = [&](auto us) { return us > 0 ? rows * 1'000'000 / us : 0; };
+  cout << name << "\tper-value " << t0 << "us (" << rate(t0)
+       << " rows/s)\tbulk " << t1 << "us (" << rate(t1) << " rows/s)" << endl;
+}
+
+} // namespace <anonymous>
+
+// Measures the indexing throughput of appending a column value by value and
+// in bulk to arithmetic value indexes.
+int main(int argc, char** argv) {
+  size_t rows = 1'000'000;
+  double nils = 0.01;
+  auto r = message_builder{argv + 1, argv + argc}.extract_opts({
+    {"rows,r", "number of values per column", rows},
+    {"nils,n", "fraction of nil values", nils},
+  });
+  if (r.opts.count("help") > 0) {
+    cout << r.helptext;
+    return 0;
+  }
+  if (!r.error.empty()) {
+    cerr << r.error << endl;
+    return 1;
+  }
+  factory<value_index>::initialize();
+  run<count>("count", count_type{}, rows, nils,
+             [](auto& gen) { return count{gen() % 65536}; });
+  run<integer>("integer", integer_type{}, rows, nils, [](auto& gen) {
+    return static_cast<integer>(gen() % 2'000'000) - 1'000'000;
+  });
+  // Timestamps increase monotonically with some jitter, as in event logs.
+  auto now = timestamp{seconds{1'500'000'000}};
+  run<timestamp>("timestamp", timestamp_type{}, rows, nils,
+                 [&, i = 0](auto& gen) mutable {
+                   return now + milliseconds(++i * 10 + gen() % 100);
+                 });
+  return 0;
+}
@@ -0,0 +1,95 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <caf/message_builder.hpp>
+
+#include "vast/columnar_table_slice.hpp"
+#include "vast/default_table_slice.hpp"
+#include "vast/error.hpp"
+#include "vast/factory.hpp"
+#include "vast/format/zeek.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/table_slice_builder_factory.hpp"
+
+using namespace caf;
+using namespace std;
+using namespace std::chrono;
+using namespace vast;
+
+// Measures the throughput of the Zeek reader on a log file that gets repeated
+// in memory, such that the benchmark does not measure disk I/O.
+int main(int argc, char** argv) {
+  std::string input;
+  size_t repeat = 100;
+  size_t slice_size = 65'536;
+  auto r = message_builder{argv + 1, argv + argc}.extract_opts({
+    {"input,i", "path to a Zeek log file", input},
+    {"repeat,r", "number of times to repeat the log", repeat},
+    {"slice-size,s", "maximum number of rows per table slice", slice_size},
+  });
+  if (r.opts.count("help") > 0) {
+    cout << r.helptext;
+    return 0;
+  }
+  if (!r.error.empty()) {
+    cerr << r.error << endl;
+    return 1;
+  }
+  if (input.empty()) {
+    cerr << "no input file given" << endl;
+    return 1;
+  }
+  std::ifstream file{input};
+  if (!file) {
+    cerr << "failed to open " << input << endl;
+    return 1;
+  }
+  std::stringstream ss;
+  ss << file.rdbuf();
+  auto log = ss.str();
+  std::string buf;
+  buf.reserve(log.size() * repeat);
+  for (size_t i = 0; i < repeat; ++i)
+    buf += log;
+  factory<table_slice_builder>::initialize();
+  for (auto id : {default_table_slice::class_id,
+                  columnar_table_slice::class_id}) {
+    format::zeek::reader reader{id, std::make_unique<std::istringstream>(buf)};
+    auto f = [](table_slice_ptr) {
+      // Discard the slices, we only measure parsing.
+    };
+    auto start = steady_clock::now();
+    auto [err, produced] = reader.read(std::numeric_limits<size_t>::max(),
+                                       slice_size, f);
+    auto total = duration_cast<nanoseconds>(steady_clock::now() - start);
+    if (err && err != ec::end_of_input) {
+      cerr << "failed to read input: " << render(err) << endl;
+      return 1;
+    }
+    auto secs = duration_cast<duration<double>>(total).count();
+    cout << to_string(id) << '\t' << produced << " events\t"
+         << static_cast<size_t>(produced / secs) << " events/s\t"
+         << static_cast<size_t>(buf.size() / secs / 1'000'000) << " MB/s"
+         << endl;
+  }
+  return 0;
+}